@@ -13,6 +13,7 @@ constexpr const char* APP_NAME = "VideoQCTool_ControlPanel";
 // Settings Keys -> Paths
 constexpr const char* K_QCTOOLS_PATH = "qctoolsPath";
 constexpr const char* K_QCCLI_PATH = "qcliPath";
+constexpr const char* K_FFMPEG_PATH = "ffmpegPath";
 
 // Settings Keys -> Error Detection Config
 constexpr const char* K_DETECT_BLACK_FRAMES = "detectBlackFrames";
@@ -24,6 +25,52 @@ constexpr const char* K_ORPHAN_THRESH = "orphanThreshold";
 constexpr const char* K_SCENE_THRESH = "sceneThreshold";
 constexpr const char* K_HAS_TRANSITIONS = "hasTransitions";
 constexpr const char* K_REWIND_FRAMES = "rewindFrames";
+constexpr const char* K_DROP_FRAME_TIMECODE = "dropFrameTimecode";
+constexpr const char* K_SHOW_THUMBNAILS = "showThumbnails";
+constexpr const char* K_THUMB_DISK_CACHE = "thumbnailDiskCache";
+constexpr const char* K_RESULT_CACHE = "resultCache";
+constexpr const char* K_WATCH_ENABLED = "watchEnabled";
+constexpr const char* K_WATCH_DIR = "watchDir";
+constexpr const char* K_WATCH_OUTPUT_DIR = "watchOutputDir";
+constexpr const char* K_WATCH_MAX_JOBS = "watchMaxJobs";
+constexpr const char* K_WATCH_SCAN_SEC = "watchScanSeconds";
+constexpr const char* K_WATCH_STABLE_SEC = "watchStableSeconds";
+constexpr const char* K_API_ENABLED = "apiEnabled";
+constexpr const char* K_API_PORT = "apiPort";
+constexpr const char* K_API_MAX_JOBS = "apiMaxJobs";
+// Giới hạn bộ nhớ cho số liệu theo frame (MB); vượt quá thì chuyển sang file tạm. 0 = không giới hạn
+constexpr const char* K_FRAME_MEMORY_MB = "frameMemoryBudgetMB";
+// Chỉ dùng trong map gửi cho QCToolsManager: thư mục ghi báo cáo thay cho thư mục của video
+constexpr const char* K_REPORT_DIR = "reportDir";
+constexpr const char* K_LOG_TO_FILE = "logToFile";
+constexpr const char* K_LOG_MAX_FILE_MB = "logMaxFileMB";
+
+// Số file nhật ký cũ được giữ lại khi xoay vòng
+constexpr int LOG_FILE_BACKUPS = 3;
+
+// Bộ máy phân tích video: qcli (tiến trình riêng, qua báo cáo XML) hoặc libav trong tiến trình
+constexpr const char* K_ANALYSIS_ENGINE = "analysisEngine";
+constexpr const char* ENGINE_QCLI = "qcli";
+constexpr const char* ENGINE_LIBAV = "libav";
+// Bộ máy libav: số đoạn giải mã song song cho một video. 0 = theo số nhân CPU, 1 = không chia
+constexpr const char* K_ANALYSIS_SEGMENTS = "analysisSegments";
+// Bộ máy libav: quét nhanh hai tầng (lấy mẫu trước, phân tích đầy đủ quanh mẫu đáng ngờ) và khoảng cách mẫu (frame, 0 = 1 giây)
+constexpr const char* K_FAST_SCAN = "fastScan";
+constexpr const char* K_FAST_SCAN_STEP = "fastScanStep";
+// Bộ máy libav: chỉ phân tích đầy đủ các vùng này (QVariantList các cặp [frame đầu, frame cuối]), ví dụ sau lượt quét keyframe
+constexpr const char* K_ANALYSIS_WINDOWS = "analysisWindows";
+// Bộ máy libav: chỉ phân tích đoạn giữa điểm vào/ra ([frame đầu, frame cuối], frame cuối -1: tới hết file); không lưu
+constexpr const char* K_ANALYSIS_RANGE = "analysisRange";
+// Bộ máy libav: phân tích frame đã giảm độ phân giải 1/N (1 = đầy đủ, 2, 4)
+constexpr const char* K_ANALYSIS_DOWNSCALE = "analysisDownscale";
+// Số frame đọc nhanh từ header khi chọn file (-1: không biết), để ước lượng tiến độ và cấp trước bộ nhớ; không lưu
+constexpr const char* K_PROBED_FRAME_COUNT = "probedFrameCount";
+// Bộ máy libav: báo cáo QCTools của bản trước của video (được giao lại); chỉ phân tích lại các GOP đã đổi
+// so với chỉ mục GOP lưu cạnh báo cáo đó, phần còn lại lấy từ báo cáo; không lưu
+constexpr const char* K_INCREMENTAL_REPORT = "incrementalReport";
+// Bộ máy libav: sau mỗi lần chạy qcli, lập chỉ mục GOP của video cạnh báo cáo (thêm một lượt đọc file) để lần giao
+// lại sau dùng được K_INCREMENTAL_REPORT; mặc định tắt
+constexpr const char* K_WRITE_GOP_INDEX = "writeGopIndex";
 
 // Settings Keys -> Advanced
 constexpr const char* K_USE_HW_ACCEL = "useHwAccel";
@@ -34,11 +81,6 @@ const QString ERR_BLACK_FRAME = QStringLiteral("Frame Đen");
 const QString ERR_BLACK_BORDER = QStringLiteral("Viền Đen");
 const QString ERR_ORPHAN_FRAME = QStringLiteral("Frame Dư");
 
-// Internal "tags" for marking frames
-const QString TAG_IS_BLACK = QStringLiteral("IS_BLACK");
-const QString TAG_HAS_BORDER = QStringLiteral("HAS_BORDER");
-const QString TAG_IS_SCENE_CUT = QStringLiteral("IS_SCENE_CUT");
-
 } // namespace AppConstants
 
 #endif // CONSTANTS_H
@@ -0,0 +1,153 @@
+// src/core/FrameStore.cpp
+#include "FrameStore.h"
+#include <QDir>
+#include <QMutexLocker>
+#include <QTemporaryFile>
+#include <type_traits>
+
+// Khối được ghi nguyên dạng nhị phân ra file tạm của chính tiến trình này
+static_assert(std::is_trivially_copyable<FrameData>::value, "FrameData phải sao chép được bằng memcpy");
+
+struct FrameStore::HeapChunk : Chunk::Data {
+    QVector<FrameData> storage;
+};
+
+struct FrameStore::MappedChunk : Chunk::Data {
+    const FrameStore* store = nullptr;
+    uchar* address = nullptr;
+    ~MappedChunk() override
+    {
+        QMutexLocker locker(&store->m_mutex);
+        store->m_spillFile->unmap(address);
+    }
+};
+
+FrameStore::FrameStore(qint64 memoryBudgetBytes)
+    : m_budget(qMax<qint64>(0, memoryBudgetBytes))
+{
+}
+
+FrameStore::~FrameStore()
+{
+    // Gỡ các ánh xạ trước khi đóng file tạm
+    QMutexLocker locker(&m_mutex);
+    m_mapped.clear();
+}
+
+void FrameStore::append(const FrameData &frame)
+{
+    if (m_heapChunks.isEmpty() || m_heapChunks.last()->storage.size() == CHUNK_FRAMES) {
+        if (!m_heapChunks.isEmpty() && m_budget > 0) {
+            if (isSpilled()) {
+                // Khối vừa đầy được ghi ra file tạm ngay, trong bộ nhớ chỉ còn khối đang ghi
+                if (writeChunk(m_heapChunks.last()->storage)) {
+                    m_heapChunks.removeLast();
+                    ++m_spilledChunks;
+                }
+            } else if (qint64(m_heapChunks.size() + 1) * CHUNK_BYTES > m_budget) {
+                spill();
+            }
+        }
+        auto chunk = QSharedPointer<HeapChunk>::create();
+        chunk->storage.reserve(CHUNK_FRAMES);
+        m_heapChunks.append(chunk);
+    }
+
+    HeapChunk &tail = *m_heapChunks.last();
+    tail.storage.append(frame);
+    tail.frames = tail.storage.constData();
+    tail.count = int(tail.storage.size());
+    ++m_size;
+}
+
+void FrameStore::reserve(int expectedFrames)
+{
+    if (m_size > 0 || expectedFrames <= 0) return;
+    if (m_budget > 0 && qint64(expectedFrames) * qint64(sizeof(FrameData)) > m_budget) {
+        spill();
+        return;
+    }
+    m_heapChunks.reserve((expectedFrames + CHUNK_FRAMES - 1) / CHUNK_FRAMES);
+}
+
+void FrameStore::spill()
+{
+    m_spillFile = std::make_unique<QTemporaryFile>(QDir::tempPath() + "/videoqc_frames_XXXXXX.bin");
+    if (!m_spillFile->open()) {
+        m_spillError = m_spillFile->errorString();
+        m_spillFile.reset();
+        m_budget = 0;
+        return;
+    }
+    // Một khối là bộ đệm ghi, phần còn lại của budget dành cho các khối được ánh xạ khi đọc
+    m_maxMapped = int(qMax<qint64>(2, m_budget / CHUNK_BYTES - 1));
+
+    while (!m_heapChunks.isEmpty()) {
+        if (!writeChunk(m_heapChunks.first()->storage)) return;
+        m_heapChunks.removeFirst();
+        ++m_spilledChunks;
+    }
+}
+
+bool FrameStore::writeChunk(const QVector<FrameData> &frames)
+{
+    const qint64 bytes = qint64(frames.size()) * qint64(sizeof(FrameData));
+    const bool ok = m_spillFile->write(reinterpret_cast<const char*>(frames.constData()), bytes) == bytes
+                 && m_spillFile->flush();
+    if (!ok) {
+        // Ổ đĩa đầy...: giữ phần còn lại trong bộ nhớ, các khối đã ghi vẫn đọc được
+        m_spillError = m_spillFile->errorString();
+        m_budget = 0;
+    }
+    return ok;
+}
+
+FrameStore::Chunk FrameStore::chunk(int chunkIndex) const
+{
+    Chunk out;
+    if (chunkIndex < 0 || chunkIndex >= chunkCount()) return out;
+    out.m_firstIndex = chunkIndex * CHUNK_FRAMES;
+    if (chunkIndex >= m_spilledChunks) {
+        out.m_frames = m_heapChunks.at(chunkIndex - m_spilledChunks);
+        return out;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < m_mapped.size(); ++i) {
+        if (m_mapped.at(i).first == chunkIndex) {
+            out.m_frames = m_mapped.at(i).second;
+            m_mapped.move(i, m_mapped.size() - 1);
+            return out;
+        }
+    }
+
+    QSharedPointer<const Chunk::Data> data;
+    if (uchar *address = m_spillFile->map(qint64(chunkIndex) * CHUNK_BYTES, CHUNK_BYTES)) {
+        auto mapped = QSharedPointer<MappedChunk>::create();
+        mapped->store = this;
+        mapped->address = address;
+        mapped->frames = reinterpret_cast<const FrameData*>(address);
+        mapped->count = CHUNK_FRAMES;
+        data = mapped;
+    } else {
+        // Hệ thống không cho ánh xạ: đọc khối vào bộ nhớ, vẫn chịu giới hạn số khối như trên
+        auto heap = QSharedPointer<HeapChunk>::create();
+        heap->storage.resize(CHUNK_FRAMES);
+        m_spillFile->seek(qint64(chunkIndex) * CHUNK_BYTES);
+        m_spillFile->read(reinterpret_cast<char*>(heap->storage.data()), CHUNK_BYTES);
+        heap->frames = heap->storage.constData();
+        heap->count = CHUNK_FRAMES;
+        data = heap;
+    }
+
+    m_mapped.append({ chunkIndex, data });
+    while (m_mapped.size() > m_maxMapped) m_mapped.removeFirst();
+    out.m_frames = data;
+    return out;
+}
+
+FrameData FrameStore::at(int index) const
+{
+    const Chunk c = chunk(index / CHUNK_FRAMES);
+    return c[index - c.firstIndex()];
+}
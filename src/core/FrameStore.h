@@ -0,0 +1,112 @@
+// src/core/FrameStore.h
+#ifndef FRAMESTORE_H
+#define FRAMESTORE_H
+
+#include <QList>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "core/frame_data.h"
+
+class QTemporaryFile;
+
+// CẢI TIẾN: Số liệu theo frame của một báo cáo, lưu theo từng khối (chunk) CHUNK_FRAMES frame.
+// Khi tổng dung lượng vượt memoryBudgetBytes, các khối đầy được ghi ra một file tạm và chỉ được
+// ánh xạ (mmap) lại khi cần đọc; tối đa budget / kích thước khối khối được ánh xạ cùng lúc, khối
+// lâu không dùng nhất bị gỡ trước. Nhờ vậy bản ghi 10+ giờ không giữ hàng triệu frame trong RAM.
+// Budget = 0: mọi khối nằm trong bộ nhớ như trước.
+//
+// Chỉ một luồng được append(), và phải append xong trước khi đọc. Sau đó đọc từ nhiều luồng
+// là an toàn (luồng phân tích và biểu đồ timeline cùng đọc một store).
+class FrameStore
+{
+public:
+    static constexpr int CHUNK_FRAMES = 16384;     // ~640 KB mỗi khối
+    static constexpr qint64 CHUNK_BYTES = qint64(CHUNK_FRAMES) * sizeof(FrameData);
+
+    explicit FrameStore(qint64 memoryBudgetBytes = 0);
+    ~FrameStore();
+
+    FrameStore(const FrameStore&) = delete;
+    FrameStore& operator=(const FrameStore&) = delete;
+
+    void append(const FrameData& frame);
+    // Gọi trước append() đầu tiên khi biết trước (ước lượng) số frame, ví dụ nb_frames đọc từ header: dành sẵn chỗ cho
+    // danh sách khối, hoặc chuyển ngay sang file tạm nếu chắc chắn vượt budget thay vì gom đầy budget rồi ghi dồn một lần
+    void reserve(int expectedFrames);
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    int chunkCount() const { return (m_size + CHUNK_FRAMES - 1) / CHUNK_FRAMES; }
+    // Đã chuyển sang file tạm (chế độ ngoài bộ nhớ)
+    bool isSpilled() const { return m_spillFile != nullptr; }
+    qint64 memoryBudget() const { return m_budget; }
+    // Lỗi khi ghi file tạm; khi đó dữ liệu được giữ lại trong bộ nhớ
+    QString spillError() const { return m_spillError; }
+
+    // Một khối đang được nạp; giữ đối tượng này thì khối không bị gỡ khỏi bộ nhớ
+    class Chunk {
+    public:
+        const FrameData* data() const { return m_frames ? m_frames->frames : nullptr; }
+        int size() const { return m_frames ? m_frames->count : 0; }
+        int firstIndex() const { return m_firstIndex; }
+        const FrameData& operator[](int i) const { return m_frames->frames[i]; }
+    private:
+        friend class FrameStore;
+        struct Data {
+            virtual ~Data() = default;
+            const FrameData* frames = nullptr;
+            int count = 0;
+        };
+        QSharedPointer<const Data> m_frames;
+        int m_firstIndex = 0;
+    };
+
+    Chunk chunk(int chunkIndex) const;
+    FrameData at(int index) const;
+    FrameData first() const { return at(0); }
+
+    // Đọc tuần tự hoặc gần tuần tự: chỉ tra khối mới khi chỉ số ra khỏi khối đang giữ
+    class Reader {
+    public:
+        explicit Reader(const FrameStore& store) : m_store(store) {}
+        const FrameData& at(int index) {
+            const int local = index - m_chunk.firstIndex();
+            if (local < 0 || local >= m_chunk.size()) {
+                m_chunk = m_store.chunk(index / CHUNK_FRAMES);
+                return m_chunk[index - m_chunk.firstIndex()];
+            }
+            return m_chunk[local];
+        }
+    private:
+        const FrameStore& m_store;
+        Chunk m_chunk;
+    };
+
+private:
+    struct HeapChunk;
+    struct MappedChunk;
+
+    void spill();
+    bool writeChunk(const QVector<FrameData>& frames);
+
+    qint64 m_budget = 0;
+    int m_size = 0;
+    QString m_spillError;
+
+    // Khối trong bộ nhớ. Khi đã chuyển sang file tạm chỉ còn khối cuối (đang ghi) ở đây.
+    QList<QSharedPointer<HeapChunk>> m_heapChunks;
+    int m_spilledChunks = 0;                // Số khối đầu tiên đã nằm trong file tạm
+    std::unique_ptr<QTemporaryFile> m_spillFile;
+
+    // Các khối đang được ánh xạ, mới dùng nhất ở cuối
+    mutable QRecursiveMutex m_mutex;
+    mutable QList<QPair<int, QSharedPointer<const Chunk::Data>>> m_mapped;
+    int m_maxMapped = 2;
+};
+
+using FrameStorePtr = QSharedPointer<const FrameStore>;
+
+#endif // FRAMESTORE_H
@@ -0,0 +1,150 @@
+// src/core/GopIndex.cpp
+#include "GopIndex.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <algorithm>
+
+namespace {
+
+constexpr quint32 INDEX_MAGIC = 0x56514347;    // "VQCG"
+// Tăng khi đổi định dạng file hoặc cách băm, để chỉ mục cũ tự bị bỏ qua
+constexpr quint32 INDEX_VERSION = 2;
+
+} // namespace
+
+int GopIndex::totalFrames() const
+{
+    int total = 0;
+    for (const Gop &gop : gops) total += gop.frameCount;
+    return total;
+}
+
+bool GopIndex::matchesFile(const QString &videoPath) const
+{
+    const QFileInfo info(videoPath);
+    return info.exists() && info.size() == videoSize && info.lastModified().toMSecsSinceEpoch() == videoModified;
+}
+
+QString GopIndex::pathForReport(const QString &reportPath)
+{
+    QString base = reportPath;
+    if (base.endsWith(".xml.gz", Qt::CaseInsensitive)) base.chop(7);
+    else if (base.endsWith(".xml", Qt::CaseInsensitive)) base.chop(4);
+    return base + ".gops";
+}
+
+bool GopIndex::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << INDEX_MAGIC << INDEX_VERSION << frameRate.num << frameRate.den << codec << extradataHash
+        << videoSize << videoModified << qint32(gops.size());
+    for (const Gop &gop : gops) out << qint32(gop.firstFrame) << qint32(gop.frameCount) << gop.hash;
+    out << reportEngine << reportFilters << qint32(reportFrames) << reportNumberedFromZero;
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool GopIndex::load(const QString &path, GopIndex *index)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0;
+    in >> magic >> version;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION) return false;
+
+    GopIndex loaded;
+    qint32 count = 0;
+    in >> loaded.frameRate.num >> loaded.frameRate.den >> loaded.codec >> loaded.extradataHash
+       >> loaded.videoSize >> loaded.videoModified >> count;
+    // Mỗi GOP ít nhất 12 byte: kiểm tra trước khi cấp phát để file hỏng không làm cấp phát mảng khổng lồ
+    if (in.status() != QDataStream::Ok || count < 0 || qint64(count) * 12 > file.bytesAvailable()) return false;
+    loaded.gops.resize(count);
+    for (Gop &gop : loaded.gops) {
+        qint32 firstFrame = 0, frameCount = 0;
+        in >> firstFrame >> frameCount >> gop.hash;
+        gop.firstFrame = firstFrame;
+        gop.frameCount = frameCount;
+    }
+    qint32 reportFrames = -1;
+    in >> loaded.reportEngine >> loaded.reportFilters >> reportFrames >> loaded.reportNumberedFromZero;
+    loaded.reportFrames = reportFrames;
+    if (in.status() != QDataStream::Ok) return false;
+
+    *index = std::move(loaded);
+    return true;
+}
+
+bool GopIndex::changedWindows(const GopIndex &previous, const GopIndex &current, QVector<QPair<int, int>> *windows,
+                              int *changedGops, QString *reason)
+{
+    windows->clear();
+    *changedGops = 0;
+    if (previous.codec != current.codec || previous.extradataHash != current.extradataHash) {
+        *reason = QString("codec hoặc thông số codec đã đổi (%1 -> %2)").arg(previous.codec, current.codec);
+        return false;
+    }
+    if (previous.frameRate != current.frameRate) {
+        *reason = QString("tốc độ khung hình đã đổi (%1/%2 -> %3/%4)").arg(previous.frameRate.num).arg(previous.frameRate.den)
+                      .arg(current.frameRate.num).arg(current.frameRate.den);
+        return false;
+    }
+    const int total = current.totalFrames();
+    if (previous.totalFrames() != total) {
+        *reason = QString("tổng số frame đã đổi (%1 -> %2), số frame sau chỗ sửa không còn khớp với báo cáo cũ")
+                      .arg(previous.totalFrames()).arg(total);
+        return false;
+    }
+
+    // Cấu trúc GOP có thể đổi cục bộ quanh chỗ sửa: so theo frame đầu thay vì theo thứ tự GOP
+    QHash<int, const Gop*> previousByFirst;
+    previousByFirst.reserve(previous.gops.size());
+    for (const Gop &gop : previous.gops) previousByFirst.insert(gop.firstFrame, &gop);
+
+    QVector<QPair<int, int>> changed;
+    for (const Gop &gop : current.gops) {
+        const Gop *old = previousByFirst.value(gop.firstFrame, nullptr);
+        if (old && old->frameCount == gop.frameCount && old->hash == gop.hash) continue;
+        ++*changedGops;
+        changed.append({ qMax(0, gop.firstFrame - MARGIN_FRAMES),
+                         qMin(total - 1, gop.firstFrame + gop.frameCount - 1 + MARGIN_FRAMES) });
+    }
+
+    std::sort(changed.begin(), changed.end());
+    for (const auto &window : std::as_const(changed)) {
+        if (!windows->isEmpty() && window.first <= windows->last().second + 1) windows->last().second = qMax(windows->last().second, window.second);
+        else windows->append(window);
+    }
+    return true;
+}
+
+bool GopIndex::reportSpliceable(const GopIndex &index, const QString &engine, const QString &filters, QString *reason)
+{
+    if (index.reportEngine != engine) {
+        *reason = QString("báo cáo cũ do bộ máy khác tạo (%1)").arg(index.reportEngine.isEmpty() ? QString("không rõ") : index.reportEngine);
+        return false;
+    }
+    if (index.reportFilters != filters) {
+        *reason = QString("báo cáo cũ chạy bộ lọc khác (%1, cấu hình hiện tại cần %2)").arg(index.reportFilters, filters);
+        return false;
+    }
+    if (!index.reportNumberedFromZero) {
+        *reason = "pkt_pts của báo cáo cũ không chạy liên tục từ 0, frameNum của báo cáo không phải số thứ tự frame";
+        return false;
+    }
+    if (index.reportFrames != index.totalFrames()) {
+        *reason = QString("báo cáo cũ có %1 frame nhưng chỉ mục GOP có %2 frame").arg(index.reportFrames).arg(index.totalFrames());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+// src/core/GopIndex.h
+#ifndef GOPINDEX_H
+#define GOPINDEX_H
+
+#include <QByteArray>
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include "core/Timecode.h"
+
+// CẢI TIẾN: Chỉ mục nội dung theo GOP của một video, lưu cạnh báo cáo QCTools (<video>.qctools.gops).
+// Mỗi GOP (từ một keyframe tới trước keyframe kế tiếp, theo thứ tự gói) được băm từ dữ liệu nén của các gói, không
+// giải mã, nên lập chỉ mục chỉ tốn một lượt đọc file. Khi video được giao lại, so chỉ mục của bản mới với chỉ mục
+// của bản cũ để biết GOP nào đã đổi: chỉ các GOP đó cần giải mã và phân tích lại, phần còn lại lấy từ báo cáo cũ.
+struct GopIndex
+{
+    struct Gop {
+        int firstFrame = 0;     // Frame hiển thị sớm nhất của GOP (theo timestamp)
+        int frameCount = 0;     // Số gói video của GOP
+        QByteArray hash;        // MD5 dữ liệu các gói
+    };
+
+    // Số frame đệm mỗi bên vùng thay đổi: phủ các frame B đầu GOP kế tiếp (GOP mở) vẫn tham chiếu GOP đã đổi,
+    // và để YDIF ở hai chỗ nối được tính với frame không đổi
+    static constexpr int MARGIN_FRAMES = 8;
+
+    FrameRate frameRate;
+    QString codec;
+    QByteArray extradataHash;   // Thông số codec (SPS/PPS...); khác nhau thì không GOP nào so được
+    qint64 videoSize = 0;       // Dung lượng và thời gian sửa của video lúc lập chỉ mục
+    qint64 videoModified = 0;
+    QVector<Gop> gops;
+    // Báo cáo đi kèm: bộ máy và bộ lọc đã tạo nó (ví dụ "qcli", "cropdetect+signalstats"), số frame, và frameNum
+    // (pkt_pts) có chạy 0, 1, 2... không. Chỉ ghép được số liệu báo cáo với frame phân tích lại (đánh số theo
+    // timestamp, như các GOP) khi frameNum của báo cáo chính là số thứ tự frame.
+    QString reportEngine;
+    QString reportFilters;
+    int reportFrames = -1;
+    bool reportNumberedFromZero = false;
+
+    int totalFrames() const;
+    // Video ở `videoPath` vẫn là bản đã lập chỉ mục (cùng dung lượng và thời gian sửa)
+    bool matchesFile(const QString& videoPath) const;
+
+    bool save(const QString& path) const;
+    static bool load(const QString& path, GopIndex* index);
+    // File chỉ mục đi kèm báo cáo (.qctools.xml hoặc .qctools.xml.gz): <video>.qctools.gops
+    static QString pathForReport(const QString& reportPath);
+
+    // Các vùng [frame đầu, frame cuối] của `current` cần phân tích lại so với `previous`, đã đệm MARGIN_FRAMES,
+    // gộp và cắt trong [0, tổng số frame). GOP không đổi = cùng frame đầu, cùng số frame và cùng hash.
+    // false nếu không ghép được với số liệu của bản cũ (khác codec, thông số codec, tốc độ khung hình hoặc tổng số
+    // frame — số frame của phần sau chỗ sửa sẽ lệch), lý do trong `reason`.
+    static bool changedWindows(const GopIndex& previous, const GopIndex& current, QVector<QPair<int, int>>* windows,
+                               int* changedGops, QString* reason);
+    // Số liệu trong báo cáo đi kèm `index` ghép được theo số frame với bộ máy `engine` chạy bộ lọc `filters`:
+    // cùng bộ máy, cùng bộ lọc, frameNum chạy liên tục từ 0 và đủ số frame của chỉ mục. false: lý do trong `reason`
+    static bool reportSpliceable(const GopIndex& index, const QString& engine, const QString& filters, QString* reason);
+};
+
+#endif // GOPINDEX_H
@@ -0,0 +1,201 @@
+// src/core/LogSink.cpp
+#include "LogSink.h"
+#include <QTimer>
+#include <QThread>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMutexLocker>
+
+// =============================================================================
+// LogFileWriter
+// =============================================================================
+
+LogFileWriter::LogFileWriter(const QString &filePath, qint64 maxBytes, int maxBackups)
+    : m_filePath(filePath), m_maxBytes(maxBytes), m_maxBackups(qMax(0, maxBackups))
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    if (m_file) {
+        m_file->close();
+        delete m_file;
+    }
+}
+
+bool LogFileWriter::openFile()
+{
+    if (m_file && m_file->isOpen()) return true;
+    QDir().mkpath(QFileInfo(m_filePath).absolutePath());
+    if (!m_file) m_file = new QFile(m_filePath);
+    return m_file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
+
+void LogFileWriter::rotate()
+{
+    m_file->close();
+
+    const QFileInfo info(m_filePath);
+    auto backupPath = [&](int index) {
+        return info.absolutePath() + "/" + info.completeBaseName() + QString(".%1.").arg(index) + info.suffix();
+    };
+
+    if (m_maxBackups == 0) {
+        QFile::remove(m_filePath);
+    } else {
+        QFile::remove(backupPath(m_maxBackups));
+        for (int i = m_maxBackups - 1; i >= 1; --i) {
+            if (QFile::exists(backupPath(i))) QFile::rename(backupPath(i), backupPath(i + 1));
+        }
+        QFile::rename(m_filePath, backupPath(1));
+    }
+}
+
+void LogFileWriter::writeLines(const QStringList &lines)
+{
+    if (lines.isEmpty() || !openFile()) return;
+
+    m_file->write(lines.join('\n').toUtf8());
+    m_file->write("\n");
+    m_file->flush();
+
+    if (m_maxBytes > 0 && m_file->size() >= m_maxBytes) {
+        rotate();
+    }
+}
+
+// =============================================================================
+// LogSink
+// =============================================================================
+
+LogSink::LogSink(int capacity, QObject *parent)
+    : QObject(parent), m_capacity(qMax(1, capacity))
+{
+    qRegisterMetaType<LogEntry>("LogEntry");
+    m_ring.resize(m_capacity);
+
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &LogSink::flushPending);
+}
+
+LogSink::~LogSink()
+{
+    flushPending();
+    disableFileSink();
+}
+
+void LogSink::append(LogLevel level, const QString &message)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_size == m_capacity) ++m_dropped;
+        else ++m_size;
+        m_ring[m_head] = LogEntry{level, message};
+        m_head = (m_head + 1) % m_capacity;
+
+        // Dòng chờ hiển thị cũng bị giới hạn, phòng khi giao diện không kịp xử lý
+        if (m_pending.size() >= m_capacity) m_pending.removeFirst();
+        m_pending.append(LogEntry{level, message});
+    }
+
+    // Chỉ một sự kiện queued cho mỗi cửa sổ gộp, không phải cho mỗi dòng
+    if (!m_flushScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, "scheduleFlush", Qt::QueuedConnection);
+    }
+}
+
+void LogSink::appendMessage(const QString &message)
+{
+    append(inferLevel(message), message);
+}
+
+LogLevel LogSink::inferLevel(const QString &message)
+{
+    const QString head = message.left(16);
+    if (head.contains(QLatin1String("[ERROR]"))) return LogLevel::Error;
+    if (head.contains(QLatin1String("[WARNING]"))) return LogLevel::Warning;
+    if (head.contains(QLatin1String("[DEBUG]"))) return LogLevel::Debug;
+    return LogLevel::Info;
+}
+
+QList<LogEntry> LogSink::snapshot(LogLevel minLevel) const
+{
+    QMutexLocker locker(&m_mutex);
+    QList<LogEntry> entries;
+    entries.reserve(m_size);
+    const int start = (m_head - m_size + m_capacity) % m_capacity;
+    for (int i = 0; i < m_size; ++i) {
+        const LogEntry& e = m_ring[(start + i) % m_capacity];
+        if (e.level >= minLevel) entries.append(e);
+    }
+    return entries;
+}
+
+void LogSink::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (auto& e : m_ring) e.text.clear();
+    m_head = 0;
+    m_size = 0;
+    m_dropped = 0;
+    m_pending.clear();
+}
+
+quint64 LogSink::droppedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+void LogSink::enableFileSink(const QString &filePath, qint64 maxBytes, int maxBackups)
+{
+    disableFileSink();
+
+    m_fileThread = new QThread(this);
+    m_fileWriter = new LogFileWriter(filePath, maxBytes, maxBackups);
+    m_fileWriter->moveToThread(m_fileThread);
+    connect(m_fileThread, &QThread::finished, m_fileWriter, &QObject::deleteLater);
+    connect(this, &LogSink::linesReadyForFile, m_fileWriter, &LogFileWriter::writeLines, Qt::QueuedConnection);
+    m_fileThread->start(QThread::LowPriority);
+}
+
+void LogSink::disableFileSink()
+{
+    if (!m_fileThread) return;
+    disconnect(this, &LogSink::linesReadyForFile, nullptr, nullptr);
+    // Dừng luồng sau khi các lô đã gửi trước đó được ghi xong (hàng đợi sự kiện theo thứ tự FIFO)
+    QThread* thread = m_fileThread;
+    QMetaObject::invokeMethod(m_fileWriter, [thread]() { thread->quit(); }, Qt::QueuedConnection);
+    m_fileThread->wait();
+    delete m_fileThread;
+    m_fileThread = nullptr;
+    m_fileWriter = nullptr;
+}
+
+void LogSink::scheduleFlush()
+{
+    if (!m_flushTimer->isActive()) m_flushTimer->start();
+}
+
+void LogSink::flushPending()
+{
+    QList<LogEntry> batch;
+    {
+        QMutexLocker locker(&m_mutex);
+        batch.swap(m_pending);
+        m_flushScheduled = false;
+    }
+    if (batch.isEmpty()) return;
+
+    emit entriesAppended(batch);
+
+    if (m_fileThread) {
+        QStringList lines;
+        lines.reserve(batch.size());
+        for (const auto& e : batch) lines.append(e.text);
+        emit linesReadyForFile(lines);
+    }
+}
@@ -0,0 +1,101 @@
+// src/core/LogSink.h
+#ifndef LOGSINK_H
+#define LOGSINK_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QMutex>
+#include <QMetaType>
+#include <atomic>
+
+class QTimer;
+class QThread;
+class QFile;
+
+enum class LogLevel : quint8 { Debug = 0, Info, Warning, Error };
+
+struct LogEntry {
+    LogLevel level = LogLevel::Info;
+    QString text;
+};
+Q_DECLARE_METATYPE(LogEntry)
+
+// Ghi nhật ký ra file trên một luồng riêng, tự xoay vòng file khi vượt quá kích thước cho phép.
+// VideoQC.log -> VideoQC.1.log -> ... -> VideoQC.<maxBackups>.log (file cũ nhất bị xóa)
+class LogFileWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    LogFileWriter(const QString& filePath, qint64 maxBytes, int maxBackups);
+    ~LogFileWriter();
+
+public slots:
+    void writeLines(const QStringList& lines);
+
+private:
+    bool openFile();
+    void rotate();
+
+    QString m_filePath;
+    qint64 m_maxBytes;
+    int m_maxBackups;
+    QFile* m_file = nullptr;
+};
+
+// Bộ đệm nhật ký dùng chung cho cả ứng dụng.
+// - append() an toàn đa luồng: luồng phân tích ghi trực tiếp, không cần một tín hiệu queued cho mỗi dòng.
+// - Lưu tối đa `capacity` dòng trong bộ đệm vòng, dòng cũ nhất bị ghi đè.
+// - Giao diện được cập nhật theo lô bằng một timer (FLUSH_INTERVAL_MS), mỗi lô chỉ phát một tín hiệu.
+class LogSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_CAPACITY = 20000;
+    static constexpr int FLUSH_INTERVAL_MS = 150;
+
+    explicit LogSink(int capacity = DEFAULT_CAPACITY, QObject *parent = nullptr);
+    ~LogSink();
+
+    void append(LogLevel level, const QString& message);
+    // Mức log được suy ra từ tiền tố quen thuộc: [ERROR], [WARNING], [INFO], [DEBUG]
+    void appendMessage(const QString& message);
+
+    QList<LogEntry> snapshot(LogLevel minLevel = LogLevel::Debug) const;
+    void clear();
+    int capacity() const { return m_capacity; }
+    quint64 droppedCount() const;
+
+    void enableFileSink(const QString& filePath, qint64 maxBytes, int maxBackups);
+    void disableFileSink();
+
+    static LogLevel inferLevel(const QString& message);
+
+signals:
+    // Phát trên luồng giao diện, mỗi lần một lô
+    void entriesAppended(const QList<LogEntry>& entries);
+    void linesReadyForFile(const QStringList& lines);
+
+private slots:
+    void scheduleFlush();
+    void flushPending();
+
+private:
+    const int m_capacity;
+    mutable QMutex m_mutex;
+    QVector<LogEntry> m_ring;
+    int m_head = 0;         // Vị trí ghi tiếp theo
+    int m_size = 0;
+    quint64 m_dropped = 0;  // Số dòng đã bị ghi đè
+    QList<LogEntry> m_pending;
+    std::atomic<bool> m_flushScheduled{false};
+
+    QTimer* m_flushTimer;
+    QThread* m_fileThread = nullptr;
+    LogFileWriter* m_fileWriter = nullptr;
+};
+
+#endif // LOGSINK_H
@@ -0,0 +1,447 @@
+// src/core/LumaStats.cpp
+#include "LumaStats.h"
+#include "LumaStatsKernels.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LUMASTATS_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace LumaStats {
+namespace {
+
+using detail::Accumulator;
+using detail::BorderOps;
+
+template <typename T>
+const T* rowOf(const Plane& plane, int y)
+{
+    return reinterpret_cast<const T*>(static_cast<const unsigned char*>(plane.data) + plane.stride * y);
+}
+
+// Bản vô hướng, làm chuẩn đối chiếu và xử lý phần đuôi hàng của các bản SIMD
+template <typename T>
+void accumulateRowScalar(const T* cur, const T* prev, int from, int to, Accumulator& acc)
+{
+    for (int x = from; x < to; ++x) {
+        const int v = cur[x];
+        acc.sum += static_cast<unsigned>(v);
+        acc.min = std::min(acc.min, v);
+        acc.max = std::max(acc.max, v);
+        if (prev)
+            acc.diff += static_cast<unsigned>(std::abs(v - static_cast<int>(prev[x])));
+    }
+}
+
+template <typename T>
+void accumulateScalar(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    for (int y = 0; y < current.height; ++y)
+        accumulateRowScalar(rowOf<T>(current, y), previous ? rowOf<T>(*previous, y) : nullptr, 0, current.width, acc);
+}
+
+template <typename T>
+std::uint64_t rowSumScalar(const Plane& plane, int y)
+{
+    const T* row = rowOf<T>(plane, y);
+    std::uint64_t sum = 0;
+    for (int x = 0; x < plane.width; ++x)
+        sum += row[x];
+    return sum;
+}
+
+// Cộng theo hàng (đọc liền mạch) vào `count` tổng cột thay vì đi dọc từng cột
+template <typename T>
+void columnSumsScalar(const Plane& plane, int x0, int count, std::uint32_t* sums)
+{
+    std::fill(sums, sums + count, 0u);
+    for (int y = 0; y < plane.height; ++y) {
+        const T* row = rowOf<T>(plane, y) + x0;
+        for (int i = 0; i < count; ++i)
+            sums[i] += row[i];
+    }
+}
+
+constexpr int SCALAR_COLUMN_BLOCK = 16;
+
+template <typename T>
+void columnBlockScalar(const Plane& plane, int x0, std::uint32_t* sums)
+{
+    columnSumsScalar<T>(plane, x0, SCALAR_COLUMN_BLOCK, sums);
+}
+
+#ifdef LUMASTATS_HAVE_SSE2
+std::uint64_t sumLanes64(__m128i v)
+{
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return lanes[0] + lanes[1];
+}
+
+std::uint64_t sumLanes32(__m128i v)
+{
+    alignas(16) std::uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+    return std::uint64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+}
+
+// Gộp min/max theo làn vào bộ cộng dồn; chỉ chạy một lần mỗi frame
+template <typename T>
+void mergeExtremes(__m128i vmin, __m128i vmax, Accumulator& acc)
+{
+    constexpr int N = 16 / sizeof(T);
+    alignas(16) T lo[N], hi[N];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lo), vmin);
+    _mm_store_si128(reinterpret_cast<__m128i*>(hi), vmax);
+    for (int i = 0; i < N; ++i) {
+        acc.min = std::min(acc.min, int(lo[i]));
+        acc.max = std::max(acc.max, int(hi[i]));
+    }
+}
+
+// 8 bit: _mm_sad_epu8 cộng dồn 16 điểm ảnh (hoặc 16 hiệu tuyệt đối) vào hai làn 64 bit, không lo tràn
+template <bool WithDiff>
+void accumulateSse2Bytes(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vsum = zero, vdiff = zero, vmax = zero;
+    __m128i vmin = _mm_set1_epi8(static_cast<char>(0xFF));
+    const int vecWidth = current.width & ~15;
+
+    for (int y = 0; y < current.height; ++y) {
+        const unsigned char* cur = rowOf<unsigned char>(current, y);
+        const unsigned char* prev = WithDiff ? rowOf<unsigned char>(*previous, y) : nullptr;
+        for (int x = 0; x < vecWidth; x += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x));
+            vsum = _mm_add_epi64(vsum, _mm_sad_epu8(a, zero));
+            vmin = _mm_min_epu8(vmin, a);
+            vmax = _mm_max_epu8(vmax, a);
+            if (WithDiff) {
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + x));
+                vdiff = _mm_add_epi64(vdiff, _mm_sad_epu8(a, b));
+            }
+        }
+        accumulateRowScalar(cur, prev, vecWidth, current.width, acc);
+    }
+
+    if (vecWidth == 0)
+        return;
+    acc.sum += sumLanes64(vsum);
+    acc.diff += sumLanes64(vdiff);
+    mergeExtremes<unsigned char>(vmin, vmax, acc);
+}
+
+// 9..14 bit: _mm_madd_epi16 với 1 cộng từng cặp vào làn 32 bit; gom về 64 bit sau mỗi hàng nên không tràn
+template <bool WithDiff>
+void accumulateSse2Words(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i vmin = _mm_set1_epi16(0x7FFF), vmax = _mm_setzero_si128();
+    const int vecWidth = current.width & ~7;
+
+    for (int y = 0; y < current.height; ++y) {
+        const std::uint16_t* cur = rowOf<std::uint16_t>(current, y);
+        const std::uint16_t* prev = WithDiff ? rowOf<std::uint16_t>(*previous, y) : nullptr;
+        __m128i rowSum = _mm_setzero_si128(), rowDiff = _mm_setzero_si128();
+        for (int x = 0; x < vecWidth; x += 8) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cur + x));
+            rowSum = _mm_add_epi32(rowSum, _mm_madd_epi16(a, ones));
+            vmin = _mm_min_epi16(vmin, a);
+            vmax = _mm_max_epi16(vmax, a);
+            if (WithDiff) {
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + x));
+                const __m128i d = _mm_sub_epi16(_mm_max_epi16(a, b), _mm_min_epi16(a, b));
+                rowDiff = _mm_add_epi32(rowDiff, _mm_madd_epi16(d, ones));
+            }
+        }
+        acc.sum += sumLanes32(rowSum);
+        if (WithDiff)
+            acc.diff += sumLanes32(rowDiff);
+        accumulateRowScalar(cur, prev, vecWidth, current.width, acc);
+    }
+
+    if (vecWidth == 0)
+        return;
+    mergeExtremes<std::uint16_t>(vmin, vmax, acc);
+}
+
+void accumulateSse2(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    if (current.bitDepth <= 8) {
+        if (previous) accumulateSse2Bytes<true>(current, previous, acc);
+        else accumulateSse2Bytes<false>(current, previous, acc);
+    } else {
+        if (previous) accumulateSse2Words<true>(current, previous, acc);
+        else accumulateSse2Words<false>(current, previous, acc);
+    }
+}
+
+std::uint64_t rowSumSse2Bytes(const Plane& plane, int y)
+{
+    const unsigned char* row = rowOf<unsigned char>(plane, y);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vsum = zero;
+    const int vecWidth = plane.width & ~15;
+    for (int x = 0; x < vecWidth; x += 16)
+        vsum = _mm_add_epi64(vsum, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)), zero));
+    std::uint64_t sum = sumLanes64(vsum);
+    for (int x = vecWidth; x < plane.width; ++x)
+        sum += row[x];
+    return sum;
+}
+
+std::uint64_t rowSumSse2Words(const Plane& plane, int y)
+{
+    const std::uint16_t* row = rowOf<std::uint16_t>(plane, y);
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i vsum = _mm_setzero_si128();
+    const int vecWidth = plane.width & ~7;
+    for (int x = 0; x < vecWidth; x += 8)
+        vsum = _mm_add_epi32(vsum, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)), ones));
+    std::uint64_t sum = sumLanes32(vsum);
+    for (int x = vecWidth; x < plane.width; ++x)
+        sum += row[x];
+    return sum;
+}
+
+// 16 cột 8 bit: cộng vào làn 16 bit, cứ 256 hàng (chưa thể tràn) thì dồn sang làn 32 bit
+void columnSumsSse2Bytes(const Plane& plane, int x0, std::uint32_t* sums)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo16 = zero, hi16 = zero;
+    __m128i s0 = zero, s1 = zero, s2 = zero, s3 = zero;
+    int pending = 0;
+    for (int y = 0; y < plane.height; ++y) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowOf<unsigned char>(plane, y) + x0));
+        lo16 = _mm_add_epi16(lo16, _mm_unpacklo_epi8(a, zero));
+        hi16 = _mm_add_epi16(hi16, _mm_unpackhi_epi8(a, zero));
+        if (++pending == 256 || y == plane.height - 1) {
+            s0 = _mm_add_epi32(s0, _mm_unpacklo_epi16(lo16, zero));
+            s1 = _mm_add_epi32(s1, _mm_unpackhi_epi16(lo16, zero));
+            s2 = _mm_add_epi32(s2, _mm_unpacklo_epi16(hi16, zero));
+            s3 = _mm_add_epi32(s3, _mm_unpackhi_epi16(hi16, zero));
+            lo16 = hi16 = zero;
+            pending = 0;
+        }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), s0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + 4), s1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + 8), s2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + 12), s3);
+}
+
+// 8 cột 9..14 bit: làn 16 bit chứa được 65535 / giá trị lớn nhất hàng trước khi phải dồn sang 32 bit
+void columnSumsSse2Words(const Plane& plane, int x0, std::uint32_t* sums)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const int rowsPerFlush = 0xFFFF / ((1 << plane.bitDepth) - 1);
+    __m128i acc16 = zero, s0 = zero, s1 = zero;
+    int pending = 0;
+    for (int y = 0; y < plane.height; ++y) {
+        acc16 = _mm_add_epi16(acc16, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowOf<std::uint16_t>(plane, y) + x0)));
+        if (++pending == rowsPerFlush || y == plane.height - 1) {
+            s0 = _mm_add_epi32(s0, _mm_unpacklo_epi16(acc16, zero));
+            s1 = _mm_add_epi32(s1, _mm_unpackhi_epi16(acc16, zero));
+            acc16 = zero;
+            pending = 0;
+        }
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), s0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + 4), s1);
+}
+#endif
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // Hệ điều hành phải lưu/khôi phục thanh ghi YMM
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+bool avx2Usable()
+{
+    static const bool usable = cpuHasAvx2() && detail::avx2Compiled();
+    return usable;
+}
+
+bool sse2Usable()
+{
+#ifdef LUMASTATS_HAVE_SSE2
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool samePlaneShape(const Plane& a, const Plane* b)
+{
+    return b && b->data && b->width == a.width && b->height == a.height && b->bitDepth == a.bitDepth;
+}
+
+BorderOps scalarBorderOps(int bitDepth)
+{
+    BorderOps ops;
+    ops.rowSum = bitDepth <= 8 ? rowSumScalar<unsigned char> : rowSumScalar<std::uint16_t>;
+    ops.columnSums = bitDepth <= 8 ? columnBlockScalar<unsigned char> : columnBlockScalar<std::uint16_t>;
+    ops.columnBlock = SCALAR_COLUMN_BLOCK;
+    return ops;
+}
+
+BorderOps borderOpsFor(Isa isa, int bitDepth)
+{
+    BorderOps ops;
+    if (bitDepth <= detail::MAX_SIMD_BIT_DEPTH) {
+        if (isa == Isa::Avx2 && avx2Usable() && detail::borderOpsAvx2(bitDepth, &ops))
+            return ops;
+#ifdef LUMASTATS_HAVE_SSE2
+        if (isa != Isa::Scalar) {
+            ops.rowSum = bitDepth <= 8 ? rowSumSse2Bytes : rowSumSse2Words;
+            ops.columnSums = bitDepth <= 8 ? columnSumsSse2Bytes : columnSumsSse2Words;
+            ops.columnBlock = bitDepth <= 8 ? 16 : 8;
+            return ops;
+        }
+#endif
+    }
+    return scalarBorderOps(bitDepth);
+}
+
+// Tổng Y của các cột [x0, x0 + count): khối đủ cột dùng bản SIMD, phần lẻ ở mép dùng bản vô hướng
+void columnSums(const Plane& plane, const BorderOps& ops, int x0, int count, std::uint32_t* sums)
+{
+    if (count == ops.columnBlock) ops.columnSums(plane, x0, sums);
+    else if (plane.bitDepth <= 8) columnSumsScalar<unsigned char>(plane, x0, count, sums);
+    else columnSumsScalar<std::uint16_t>(plane, x0, count, sums);
+}
+
+} // namespace
+
+Borders findBordersWith(Isa isa, const Plane& plane, double limit)
+{
+    const int width = plane.width, height = plane.height;
+    Borders borders;
+    if (!plane.data || width <= 0 || height <= 0)
+        return borders;
+
+    const BorderOps ops = borderOpsFor(isa, plane.bitDepth);
+    // Như checkline() của cropdetect: hàng/cột không đen khi tổng Y > limit * số điểm ảnh của nó
+    const double rowLimit = limit * width;
+    const double columnLimit = limit * height;
+
+    // Cùng thứ tự và giới hạn quét như FIND() của cropdetect với vùng vừa được đặt lại
+    borders.y1 = height - 1;
+    for (int y = 0; y < height - 1; ++y) {
+        if (double(ops.rowSum(plane, y)) > rowLimit) { borders.y1 = y; break; }
+    }
+    for (int y = height - 1; y > std::max(0, borders.y1); --y) {
+        if (double(ops.rowSum(plane, y)) > rowLimit) { borders.y2 = y; break; }
+    }
+
+    std::uint32_t sums[detail::MAX_COLUMN_BLOCK];
+    borders.x1 = width - 1;
+    bool found = false;
+    for (int x0 = 0; x0 < width - 1 && !found; x0 += ops.columnBlock) {
+        const int count = std::min(ops.columnBlock, width - 1 - x0);
+        columnSums(plane, ops, x0, count, sums);
+        for (int i = 0; i < count; ++i) {
+            if (double(sums[i]) > columnLimit) { borders.x1 = x0 + i; found = true; break; }
+        }
+    }
+    const int stop = std::max(0, borders.x1);
+    found = false;
+    for (int last = width - 1; last > stop && !found; last -= ops.columnBlock) {
+        const int x0 = std::max(stop + 1, last - ops.columnBlock + 1);
+        const int count = last - x0 + 1;
+        columnSums(plane, ops, x0, count, sums);
+        for (int i = count - 1; i >= 0; --i) {
+            if (double(sums[i]) > columnLimit) { borders.x2 = x0 + i; found = true; break; }
+        }
+    }
+    return borders;
+}
+
+Borders findBorders(const Plane& plane, double limit)
+{
+    return findBordersWith(activeIsa(), plane, limit);
+}
+
+Result computeWith(Isa isa, const Plane& current, const Plane* previous)
+{
+    Result result;
+    if (!current.data || current.width <= 0 || current.height <= 0)
+        return result;
+
+    const Plane* prev = samePlaneShape(current, previous) ? previous : nullptr;
+    const bool simdDepth = current.bitDepth <= detail::MAX_SIMD_BIT_DEPTH;
+    Accumulator acc;
+    bool done = false;
+
+    if (simdDepth && isa == Isa::Avx2 && avx2Usable())
+        done = detail::accumulateAvx2(current, prev, acc);
+#ifdef LUMASTATS_HAVE_SSE2
+    if (!done && simdDepth && isa != Isa::Scalar && sse2Usable()) {
+        accumulateSse2(current, prev, acc);
+        done = true;
+    }
+#endif
+    if (!done) {
+        if (current.bitDepth <= 8) accumulateScalar<unsigned char>(current, prev, acc);
+        else accumulateScalar<std::uint16_t>(current, prev, acc);
+    }
+
+    const double pixels = double(current.width) * double(current.height);
+    result.yavg = double(acc.sum) / pixels;
+    result.ydif = prev ? double(acc.diff) / pixels : 0.0;
+    result.ymin = acc.min;
+    result.ymax = acc.max;
+    return result;
+}
+
+Result compute(const Plane& current, const Plane* previous)
+{
+    return computeWith(activeIsa(), current, previous);
+}
+
+Isa activeIsa()
+{
+    if (avx2Usable())
+        return Isa::Avx2;
+    if (sse2Usable())
+        return Isa::Sse2;
+    return Isa::Scalar;
+}
+
+const char* isaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::Avx2: return "AVX2";
+    case Isa::Sse2: return "SSE2";
+    case Isa::Scalar: break;
+    }
+    return "C";
+}
+
+} // namespace LumaStats
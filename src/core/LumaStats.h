@@ -0,0 +1,58 @@
+// src/core/LumaStats.h
+#ifndef LUMASTATS_H
+#define LUMASTATS_H
+
+#include <cstddef>
+
+// CẢI TIẾN: Bộ đếm thống kê độ sáng (kênh Y) của một frame đã giải mã, thay cho bộ lọc signalstats trong bộ máy libav.
+// Cùng định nghĩa với lavfi.signalstats nên các ngưỡng phát hiện lỗi giữ nguyên ý nghĩa:
+//   YAVG = tổng Y / số điểm ảnh, YMIN/YMAX = giá trị nhỏ/lớn nhất,
+//   YDIF = tổng |Y - Y của frame trước| / số điểm ảnh (0 với frame đầu tiên),
+// giá trị theo thang của độ sâu bit (0..255 với 8 bit, 0..1023 với 10 bit) như signalstats.
+// Đọc thẳng mặt phẳng Y với stride bất kỳ (kể cả âm), không sao chép. Có ba bản cài đặt cho kết quả giống hệt nhau:
+// AVX2 và SSE2 (chọn lúc chạy theo CPU) và bản vô hướng làm chuẩn đối chiếu (tools/LumaStatsCheck.cpp so chúng).
+// findBorders() thay cho bộ lọc cropdetect trên cùng mặt phẳng Y, cũng với ba bản cài đặt đó.
+namespace LumaStats {
+
+struct Plane {
+    const void* data = nullptr;     // Điểm ảnh đầu tiên của hàng đầu
+    std::ptrdiff_t stride = 0;      // Số byte từ đầu hàng này tới đầu hàng sau
+    int width = 0;
+    int height = 0;
+    int bitDepth = 8;               // 8: một byte mỗi điểm ảnh; 9..16: hai byte little-endian, giá trị ở các bit thấp
+};
+
+struct Result {
+    double yavg = 0.0;
+    int ymin = 0;
+    int ymax = 0;
+    double ydif = 0.0;
+};
+
+// Vùng ảnh không đen, cùng quy ước với lavfi.cropdetect.x1/y1/x2/y2 (cột/hàng đầu và cuối, tính cả hai đầu).
+// Frame đen hoàn toàn: x1 = width - 1, y1 = height - 1, x2 = y2 = 0 như cropdetect.
+struct Borders {
+    int x1 = 0;
+    int y1 = 0;
+    int x2 = 0;
+    int y2 = 0;
+};
+
+enum class Isa { Scalar, Sse2, Avx2 };
+
+// `previous` = nullptr hoặc khác kích thước/độ sâu bit: YDIF = 0
+Result compute(const Plane& current, const Plane* previous);
+// Như compute() nhưng ép dùng một bản cài đặt (bản không có trên máy này thì lùi xuống bản thấp hơn), để đối chiếu
+Result computeWith(Isa isa, const Plane& current, const Plane* previous);
+// Dò viền đen như cropdetect (mode=black, max_outliers=0): một hàng/cột là đen khi Y trung bình của nó không vượt
+// `limit` (theo thang của độ sâu bit). Quét từ mỗi mép vào trong và dừng ở hàng/cột không đen đầu tiên, nên frame
+// không có viền chỉ tốn vài hàng và một khối cột ở mỗi bên; cột được cộng theo khối 8-32 cột liền nhau.
+Borders findBorders(const Plane& plane, double limit);
+Borders findBordersWith(Isa isa, const Plane& plane, double limit);
+// Bản cài đặt compute() dùng trên máy này
+Isa activeIsa();
+const char* isaName(Isa isa);
+
+} // namespace LumaStats
+
+#endif // LUMASTATS_H
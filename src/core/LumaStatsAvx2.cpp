@@ -0,0 +1,250 @@
+// src/core/LumaStatsAvx2.cpp
+// Tệp này được dịch riêng với /arch:AVX2 (MSVC) hoặc -mavx2 (GCC/Clang), xem CMakeLists.txt.
+// Chỉ được gọi sau khi LumaStats.cpp đã kiểm tra CPU có AVX2.
+#include "LumaStatsKernels.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace LumaStats {
+namespace detail {
+
+#if defined(__AVX2__)
+namespace {
+
+template <typename T>
+const T* rowOf(const Plane& plane, int y)
+{
+    return reinterpret_cast<const T*>(static_cast<const unsigned char*>(plane.data) + plane.stride * y);
+}
+
+template <typename T>
+void accumulateTail(const T* cur, const T* prev, int from, int to, Accumulator& acc)
+{
+    for (int x = from; x < to; ++x) {
+        const int v = cur[x];
+        acc.sum += static_cast<unsigned>(v);
+        acc.min = std::min(acc.min, v);
+        acc.max = std::max(acc.max, v);
+        if (prev)
+            acc.diff += static_cast<unsigned>(std::abs(v - static_cast<int>(prev[x])));
+    }
+}
+
+std::uint64_t sumLanes64(__m256i v)
+{
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+std::uint64_t sumLanes32(__m256i v)
+{
+    alignas(32) std::uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), v);
+    std::uint64_t total = 0;
+    for (std::uint32_t lane : lanes)
+        total += lane;
+    return total;
+}
+
+template <typename T>
+void mergeExtremes(__m256i vmin, __m256i vmax, Accumulator& acc)
+{
+    constexpr int N = 32 / sizeof(T);
+    alignas(32) T lo[N], hi[N];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lo), vmin);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hi), vmax);
+    for (int i = 0; i < N; ++i) {
+        acc.min = std::min(acc.min, int(lo[i]));
+        acc.max = std::max(acc.max, int(hi[i]));
+    }
+}
+
+template <bool WithDiff>
+void accumulateBytes(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vsum = zero, vdiff = zero, vmax = zero;
+    __m256i vmin = _mm256_set1_epi8(static_cast<char>(0xFF));
+    const int vecWidth = current.width & ~31;
+
+    for (int y = 0; y < current.height; ++y) {
+        const unsigned char* cur = rowOf<unsigned char>(current, y);
+        const unsigned char* prev = WithDiff ? rowOf<unsigned char>(*previous, y) : nullptr;
+        for (int x = 0; x < vecWidth; x += 32) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x));
+            vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(a, zero));
+            vmin = _mm256_min_epu8(vmin, a);
+            vmax = _mm256_max_epu8(vmax, a);
+            if (WithDiff) {
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + x));
+                vdiff = _mm256_add_epi64(vdiff, _mm256_sad_epu8(a, b));
+            }
+        }
+        accumulateTail(cur, prev, vecWidth, current.width, acc);
+    }
+
+    if (vecWidth == 0)
+        return;
+    acc.sum += sumLanes64(vsum);
+    acc.diff += sumLanes64(vdiff);
+    mergeExtremes<unsigned char>(vmin, vmax, acc);
+}
+
+template <bool WithDiff>
+void accumulateWords(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i vmin = _mm256_set1_epi16(0x7FFF), vmax = _mm256_setzero_si256();
+    const int vecWidth = current.width & ~15;
+
+    for (int y = 0; y < current.height; ++y) {
+        const std::uint16_t* cur = rowOf<std::uint16_t>(current, y);
+        const std::uint16_t* prev = WithDiff ? rowOf<std::uint16_t>(*previous, y) : nullptr;
+        __m256i rowSum = _mm256_setzero_si256(), rowDiff = _mm256_setzero_si256();
+        for (int x = 0; x < vecWidth; x += 16) {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cur + x));
+            rowSum = _mm256_add_epi32(rowSum, _mm256_madd_epi16(a, ones));
+            vmin = _mm256_min_epi16(vmin, a);
+            vmax = _mm256_max_epi16(vmax, a);
+            if (WithDiff) {
+                const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + x));
+                const __m256i d = _mm256_sub_epi16(_mm256_max_epi16(a, b), _mm256_min_epi16(a, b));
+                rowDiff = _mm256_add_epi32(rowDiff, _mm256_madd_epi16(d, ones));
+            }
+        }
+        acc.sum += sumLanes32(rowSum);
+        if (WithDiff)
+            acc.diff += sumLanes32(rowDiff);
+        accumulateTail(cur, prev, vecWidth, current.width, acc);
+    }
+
+    if (vecWidth == 0)
+        return;
+    mergeExtremes<std::uint16_t>(vmin, vmax, acc);
+}
+
+std::uint64_t rowSumBytes(const Plane& plane, int y)
+{
+    const unsigned char* row = rowOf<unsigned char>(plane, y);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vsum = zero;
+    const int vecWidth = plane.width & ~31;
+    for (int x = 0; x < vecWidth; x += 32)
+        vsum = _mm256_add_epi64(vsum, _mm256_sad_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x)), zero));
+    std::uint64_t sum = sumLanes64(vsum);
+    for (int x = vecWidth; x < plane.width; ++x)
+        sum += row[x];
+    return sum;
+}
+
+std::uint64_t rowSumWords(const Plane& plane, int y)
+{
+    const std::uint16_t* row = rowOf<std::uint16_t>(plane, y);
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i vsum = _mm256_setzero_si256();
+    const int vecWidth = plane.width & ~15;
+    for (int x = 0; x < vecWidth; x += 16)
+        vsum = _mm256_add_epi32(vsum, _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x)), ones));
+    std::uint64_t sum = sumLanes32(vsum);
+    for (int x = vecWidth; x < plane.width; ++x)
+        sum += row[x];
+    return sum;
+}
+
+// Giãn bằng cvtepu8/cvtepu16 (không dùng unpack) để thứ tự cột không bị xáo giữa hai nửa 128 bit
+void columnSumsBytes(const Plane& plane, int x0, std::uint32_t* sums)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo16 = zero, hi16 = zero;
+    __m256i s[4] = {zero, zero, zero, zero};
+    int pending = 0;
+    for (int y = 0; y < plane.height; ++y) {
+        const unsigned char* row = rowOf<unsigned char>(plane, y) + x0;
+        lo16 = _mm256_add_epi16(lo16, _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row))));
+        hi16 = _mm256_add_epi16(hi16, _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16))));
+        if (++pending == 256 || y == plane.height - 1) {
+            s[0] = _mm256_add_epi32(s[0], _mm256_cvtepu16_epi32(_mm256_castsi256_si128(lo16)));
+            s[1] = _mm256_add_epi32(s[1], _mm256_cvtepu16_epi32(_mm256_extracti128_si256(lo16, 1)));
+            s[2] = _mm256_add_epi32(s[2], _mm256_cvtepu16_epi32(_mm256_castsi256_si128(hi16)));
+            s[3] = _mm256_add_epi32(s[3], _mm256_cvtepu16_epi32(_mm256_extracti128_si256(hi16, 1)));
+            lo16 = hi16 = zero;
+            pending = 0;
+        }
+    }
+    for (int i = 0; i < 4; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + 8 * i), s[i]);
+}
+
+void columnSumsWords(const Plane& plane, int x0, std::uint32_t* sums)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const int rowsPerFlush = 0xFFFF / ((1 << plane.bitDepth) - 1);
+    __m256i acc16 = zero, s0 = zero, s1 = zero;
+    int pending = 0;
+    for (int y = 0; y < plane.height; ++y) {
+        acc16 = _mm256_add_epi16(acc16, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowOf<std::uint16_t>(plane, y) + x0)));
+        if (++pending == rowsPerFlush || y == plane.height - 1) {
+            s0 = _mm256_add_epi32(s0, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(acc16)));
+            s1 = _mm256_add_epi32(s1, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(acc16, 1)));
+            acc16 = zero;
+            pending = 0;
+        }
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), s0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums + 8), s1);
+}
+
+} // namespace
+
+bool avx2Compiled()
+{
+    return true;
+}
+
+bool accumulateAvx2(const Plane& current, const Plane* previous, Accumulator& acc)
+{
+    if (current.bitDepth <= 8) {
+        if (previous) accumulateBytes<true>(current, previous, acc);
+        else accumulateBytes<false>(current, previous, acc);
+    } else {
+        if (previous) accumulateWords<true>(current, previous, acc);
+        else accumulateWords<false>(current, previous, acc);
+    }
+    return true;
+}
+
+bool borderOpsAvx2(int bitDepth, BorderOps* ops)
+{
+    ops->rowSum = bitDepth <= 8 ? rowSumBytes : rowSumWords;
+    ops->columnSums = bitDepth <= 8 ? columnSumsBytes : columnSumsWords;
+    ops->columnBlock = bitDepth <= 8 ? 32 : 16;
+    return true;
+}
+
+#else
+
+bool avx2Compiled()
+{
+    return false;
+}
+
+bool accumulateAvx2(const Plane&, const Plane*, Accumulator&)
+{
+    return false;
+}
+
+bool borderOpsAvx2(int, BorderOps*)
+{
+    return false;
+}
+
+#endif
+
+} // namespace detail
+} // namespace LumaStats
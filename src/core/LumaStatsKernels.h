@@ -0,0 +1,40 @@
+// src/core/LumaStatsKernels.h
+#ifndef LUMASTATSKERNELS_H
+#define LUMASTATSKERNELS_H
+
+#include "LumaStats.h"
+#include <cstdint>
+
+// Phần nội bộ của LumaStats, chỉ dùng giữa LumaStats.cpp và LumaStatsAvx2.cpp
+namespace LumaStats {
+namespace detail {
+
+struct Accumulator {
+    std::uint64_t sum = 0;
+    std::uint64_t diff = 0;
+    int min = 0xFFFF;
+    int max = 0;
+};
+
+// Độ sâu bit lớn nhất mà nhánh 16 bit của SIMD xử lý được (so sánh và madd có dấu trên int16)
+constexpr int MAX_SIMD_BIT_DEPTH = 14;
+
+// Phép cơ bản của findBorders(): tổng Y của một hàng, và tổng Y theo cột (qua mọi hàng) của `columnBlock` cột
+// liền nhau bắt đầu từ x0
+struct BorderOps {
+    std::uint64_t (*rowSum)(const Plane& plane, int y) = nullptr;
+    void (*columnSums)(const Plane& plane, int x0, std::uint32_t* sums) = nullptr;
+    int columnBlock = 0;
+};
+constexpr int MAX_COLUMN_BLOCK = 32;
+
+// Có trong LumaStatsAvx2.cpp; chỉ biên dịch thật khi tệp đó được dịch với AVX2 (xem CMakeLists.txt)
+bool avx2Compiled();
+// `previous` = nullptr: không tính diff. Trả về false nếu bản AVX2 không được biên dịch vào chương trình.
+bool accumulateAvx2(const Plane& current, const Plane* previous, Accumulator& acc);
+bool borderOpsAvx2(int bitDepth, BorderOps* ops);
+
+} // namespace detail
+} // namespace LumaStats
+
+#endif // LUMASTATSKERNELS_H
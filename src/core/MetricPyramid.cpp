@@ -0,0 +1,196 @@
+// src/core/MetricPyramid.cpp
+#include "MetricPyramid.h"
+#include <QtMath>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+float MetricPyramid::channelValue(const FrameData &fd, Channel channel, int videoWidth, int videoHeight)
+{
+    // Độ dày viền đen tính giống CropValues::fromFrameData của QCToolsManager
+    const bool hasCrop = videoWidth > 0 && videoHeight > 0 && fd.crop_w >= 0;
+    switch (channel) {
+        case Yavg: return float(fd.yavg);
+        case Ydif: return float(fd.ydif);
+        case CropTop: if (hasCrop) return float(fd.crop_y); break;
+        case CropBottom: if (hasCrop) return float(videoHeight - (fd.crop_y + fd.crop_h)); break;
+        case CropLeft: if (hasCrop) return float(fd.crop_x); break;
+        case CropRight: if (hasCrop) return float(videoWidth - (fd.crop_x + fd.crop_w)); break;
+        default: break;
+    }
+    return std::numeric_limits<float>::quiet_NaN();
+}
+
+QSharedPointer<const MetricPyramid> MetricPyramid::build(const FrameStorePtr &frames, int videoWidth, int videoHeight)
+{
+    QSharedPointer<MetricPyramid> pyramid(new MetricPyramid());
+    const int n = frames ? frames->size() : 0;
+    pyramid->m_frameCount = n;
+    pyramid->m_firstFrameNumber = n > 0 ? frames->first().frameNum : 0;
+    pyramid->m_videoWidth = videoWidth;
+    pyramid->m_videoHeight = videoHeight;
+
+    // Store đã nằm ngoài bộ nhớ: giữ tham chiếu tới store thay vì chép tầng 0
+    const bool keepBase = n > 0 && !frames->isSpilled();
+    if (n > 0 && !keepBase) pyramid->m_frames = frames;
+    if (keepBase) {
+        for (int c = 0; c < ChannelCount; ++c) pyramid->m_base[c].resize(n);
+    }
+
+    // Tầng 1 dựng trực tiếp khi duyệt từng khối, CHUNK_FRAMES chia hết cho DECIMATION
+    static_assert(FrameStore::CHUNK_FRAMES % DECIMATION == 0, "Khối của FrameStore phải chứa trọn các ô tầng 1");
+    QVector<Range> level1[ChannelCount];
+    for (int c = 0; c < ChannelCount; ++c) level1[c].resize((n + DECIMATION - 1) / DECIMATION);
+
+    for (int k = 0; k < (frames ? frames->chunkCount() : 0); ++k) {
+        const FrameStore::Chunk chunk = frames->chunk(k);
+        for (int j = 0; j < chunk.size(); ++j) {
+            const int i = chunk.firstIndex() + j;
+            for (int c = 0; c < ChannelCount; ++c) {
+                const float v = channelValue(chunk[j], Channel(c), videoWidth, videoHeight);
+                if (keepBase) pyramid->m_base[c][i] = v;
+                if (!std::isnan(v)) level1[c][i / DECIMATION].include(v);
+            }
+        }
+    }
+
+    pyramid->buildLevels(level1);
+    return pyramid;
+}
+
+QSharedPointer<const MetricPyramid> MetricPyramid::fromChannels(const QVector<float> (&channels)[ChannelCount], int firstFrameNumber,
+                                                                int videoWidth, int videoHeight)
+{
+    const int n = int(channels[0].size());
+    for (int c = 1; c < ChannelCount; ++c) {
+        if (channels[c].size() != n) return {};
+    }
+
+    QSharedPointer<MetricPyramid> pyramid(new MetricPyramid());
+    pyramid->m_frameCount = n;
+    pyramid->m_firstFrameNumber = firstFrameNumber;
+    pyramid->m_videoWidth = videoWidth;
+    pyramid->m_videoHeight = videoHeight;
+    for (int c = 0; c < ChannelCount; ++c) pyramid->m_base[c] = channels[c];
+    pyramid->buildLevelsFromBase();
+    return pyramid;
+}
+
+void MetricPyramid::buildLevelsFromBase()
+{
+    const int n = m_frameCount;
+    QVector<Range> level1[ChannelCount];
+    for (int c = 0; c < ChannelCount; ++c) {
+        const QVector<float> &base = m_base[c];
+        QVector<Range> &level = level1[c];
+        level.resize((n + DECIMATION - 1) / DECIMATION);
+        for (int b = 0; b < level.size(); ++b) {
+            Range r;
+            const int end = qMin(n, (b + 1) * DECIMATION);
+            for (int i = b * DECIMATION; i < end; ++i) {
+                if (!std::isnan(base[i])) r.include(base[i]);
+            }
+            level[b] = r;
+        }
+    }
+    buildLevels(level1);
+}
+
+void MetricPyramid::buildLevels(QVector<Range> (&level1)[ChannelCount])
+{
+    for (int c = 0; c < ChannelCount; ++c) {
+        auto &levels = m_levels[c];
+        levels.clear();
+        QVector<Range> level = std::move(level1[c]);
+
+        // Các tầng tiếp theo gộp tầng ngay dưới, dừng khi chỉ còn một ô
+        while (level.size() > 1) {
+            QVector<Range> next((level.size() + DECIMATION - 1) / DECIMATION);
+            for (int b = 0; b < next.size(); ++b) {
+                Range r;
+                const int end = qMin(int(level.size()), (b + 1) * DECIMATION);
+                for (int i = b * DECIMATION; i < end; ++i) r.include(level[i]);
+                next[b] = r;
+            }
+            levels.append(std::move(level));
+            level = std::move(next);
+        }
+        m_totals[c] = level.isEmpty() ? Range() : level.first();
+        if (!level.isEmpty()) levels.append(std::move(level));
+    }
+}
+
+QVector<float> MetricPyramid::channelValues(Channel channel) const
+{
+    if (!m_frames) return m_base[channel];
+    QVector<float> values(m_frameCount);
+    for (int k = 0; k < m_frames->chunkCount(); ++k) {
+        const FrameStore::Chunk chunk = m_frames->chunk(k);
+        for (int j = 0; j < chunk.size(); ++j) {
+            values[chunk.firstIndex() + j] = channelValue(chunk[j], channel, m_videoWidth, m_videoHeight);
+        }
+    }
+    return values;
+}
+
+float MetricPyramid::baseValue(Channel channel, int position, FrameStore::Reader *reader) const
+{
+    if (!m_frames) return m_base[channel][position];
+    return channelValue(reader->at(position), channel, m_videoWidth, m_videoHeight);
+}
+
+float MetricPyramid::valueAt(Channel channel, int position) const
+{
+    if (position < 0 || position >= m_frameCount) return std::numeric_limits<float>::quiet_NaN();
+    if (!m_frames) return m_base[channel][position];
+    FrameStore::Reader reader(*m_frames);
+    return baseValue(channel, position, &reader);
+}
+
+MetricPyramid::Range MetricPyramid::blockRange(Channel channel, int level, int block, FrameStore::Reader *reader) const
+{
+    if (level == 0) {
+        Range r;
+        const float v = baseValue(channel, block, reader);
+        if (!std::isnan(v)) r.include(v);
+        return r;
+    }
+    return m_levels[channel][level - 1][block];
+}
+
+void MetricPyramid::query(Channel channel, double firstPosition, double framesPerPixel, int pixelCount, Range *out) const
+{
+    if (pixelCount <= 0) return;
+    if (m_frameCount == 0 || framesPerPixel <= 0) {
+        for (int p = 0; p < pixelCount; ++p) out[p] = Range();
+        return;
+    }
+
+    // Chọn tầng thô nhất có kích thước khối không lớn hơn số frame của một pixel
+    int level = 0;
+    qint64 blockSize = 1;
+    while (level < m_levels[channel].size() && blockSize * DECIMATION <= framesPerPixel) {
+        blockSize *= DECIMATION;
+        ++level;
+    }
+    const int blockCount = level == 0 ? m_frameCount : int(m_levels[channel][level - 1].size());
+    // Chỉ tầng 0 cần đọc store; ở mức phóng to này cả khung nhìn thường nằm trong một hai khối
+    std::optional<FrameStore::Reader> reader;
+    if (level == 0 && m_frames) reader.emplace(*m_frames);
+
+    for (int p = 0; p < pixelCount; ++p) {
+        const double a = firstPosition + p * framesPerPixel;
+        const double b = a + framesPerPixel;
+        qint64 first = qint64(std::floor(a));
+        qint64 last = qMax(first, qint64(std::ceil(b)) - 1);   // frame cuối (tính cả)
+        Range r;
+        if (last >= 0 && first < m_frameCount) {
+            first = qMax<qint64>(0, first);
+            last = qMin<qint64>(m_frameCount - 1, last);
+            const int firstBlock = int(first / blockSize);
+            const int lastBlock = qMin(blockCount - 1, int(last / blockSize));
+            for (int blk = firstBlock; blk <= lastBlock; ++blk) r.include(blockRange(channel, level, blk, reader ? &*reader : nullptr));
+        }
+        out[p] = r;
+    }
+}
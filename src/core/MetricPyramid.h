@@ -0,0 +1,77 @@
+// src/core/MetricPyramid.h
+#ifndef METRICPYRAMID_H
+#define METRICPYRAMID_H
+
+#include <QList>
+#include <QVector>
+#include <QSharedPointer>
+#include <QMetaType>
+#include "core/frame_data.h"
+#include "core/FrameStore.h"
+
+// CẢI TIẾN: Kim tự tháp min/max của các chỉ số theo frame, dùng cho biểu đồ timeline.
+// Tầng 0 là giá trị gốc của từng frame; mỗi tầng tiếp theo gộp DECIMATION ô của tầng dưới thành một cặp (min, max).
+// Khi vẽ, mỗi pixel chỉ đọc tối đa vài ô của tầng thô nhất vẫn còn mịn hơn một pixel,
+// nên thời gian vẽ tỉ lệ với chiều rộng widget chứ không tỉ lệ với số frame.
+// Bộ nhớ: khoảng 6 kênh x (4 byte + 8 byte / 3) ~ 40 byte cho mỗi frame.
+// Khi FrameStore đã chuyển ra file tạm (bản ghi rất dài), tầng 0 không được chép vào đây mà đọc từ
+// các khối của store khi cần (phóng to sát mức frame, hover), còn lại khoảng 16 byte cho mỗi frame.
+class MetricPyramid
+{
+public:
+    enum Channel { Yavg = 0, Ydif, CropTop, CropBottom, CropLeft, CropRight, ChannelCount };
+
+    struct Range {
+        float min = 0.0f;
+        float max = -1.0f;     // min > max: không có dữ liệu
+        bool isValid() const { return min <= max; }
+        void include(float value) { if (!isValid()) { min = max = value; } else { min = qMin(min, value); max = qMax(max, value); } }
+        void include(const Range& other) { if (other.isValid()) { include(other.min); include(other.max); } }
+    };
+
+    static constexpr int DECIMATION = 4;
+
+    // Được gọi một lần trên luồng phân tích sau khi đọc xong báo cáo
+    static QSharedPointer<const MetricPyramid> build(const FrameStorePtr& frames, int videoWidth, int videoHeight);
+    // Dựng lại từ giá trị gốc đã lưu (cache kết quả); trả về null nếu các kênh không cùng độ dài
+    static QSharedPointer<const MetricPyramid> fromChannels(const QVector<float> (&channels)[ChannelCount], int firstFrameNumber,
+                                                            int videoWidth, int videoHeight);
+
+    int frameCount() const { return m_frameCount; }
+    // frameNum của frame đầu tiên, để đổi vị trí trong pyramid sang số frame của kết quả
+    int firstFrameNumber() const { return m_firstFrameNumber; }
+    int videoWidth() const { return m_videoWidth; }
+    int videoHeight() const { return m_videoHeight; }
+
+    // Khoảng giá trị trên toàn bộ file
+    Range channelRange(Channel channel) const { return m_totals[channel]; }
+    // Giá trị gốc tại một vị trí frame (NaN nếu frame không có dữ liệu cho kênh này)
+    float valueAt(Channel channel, int position) const;
+    // Toàn bộ giá trị gốc của một kênh (tầng 0); được dựng lại từ FrameStore nếu tầng 0 không nằm trong bộ nhớ
+    QVector<float> channelValues(Channel channel) const;
+
+    // Điền `pixelCount` khoảng min/max, pixel thứ p phủ các frame [first + p*fpp, first + (p+1)*fpp)
+    void query(Channel channel, double firstPosition, double framesPerPixel, int pixelCount, Range* out) const;
+
+private:
+    MetricPyramid() = default;
+    void buildLevels(QVector<Range> (&level1)[ChannelCount]);
+    void buildLevelsFromBase();
+    float baseValue(Channel channel, int position, FrameStore::Reader* reader) const;
+    Range blockRange(Channel channel, int level, int block, FrameStore::Reader* reader) const;
+    static float channelValue(const FrameData& fd, Channel channel, int videoWidth, int videoHeight);
+
+    int m_frameCount = 0;
+    int m_firstFrameNumber = 0;
+    int m_videoWidth = 0;
+    int m_videoHeight = 0;
+    QVector<float> m_base[ChannelCount];            // Rỗng nếu tầng 0 đọc từ m_frames
+    FrameStorePtr m_frames;
+    QVector<QVector<Range>> m_levels[ChannelCount];   // m_levels[c][0] là tầng 1 (khối DECIMATION frame)
+    Range m_totals[ChannelCount];
+};
+
+using MetricPyramidPtr = QSharedPointer<const MetricPyramid>;
+Q_DECLARE_METATYPE(MetricPyramidPtr)
+
+#endif // METRICPYRAMID_H
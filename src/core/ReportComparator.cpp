@@ -0,0 +1,193 @@
+// src/core/ReportComparator.cpp
+#include "ReportComparator.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Tích vô hướng với 8 bộ cộng độc lập: không phụ thuộc -ffast-math để được vector hóa
+// và cũng không bị giới hạn bởi độ trễ của một bộ cộng duy nhất
+double dot(const float* a, const float* b, int n)
+{
+    float acc[8] = {};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int k = 0; k < 8; ++k) acc[k] += a[i + k] * b[i + k];
+    }
+    double sum = 0.0;
+    for (int k = 0; k < 8; ++k) sum += acc[k];
+    for (; i < n; ++i) sum += double(a[i]) * b[i];
+    return sum;
+}
+
+// Chuẩn hóa về trung bình 0, độ lệch chuẩn 1; frame thiếu dữ liệu thành 0 để không ảnh hưởng tương quan
+QVector<float> normalized(const QVector<float>& values, bool* ok)
+{
+    double sum = 0.0, sumSq = 0.0;
+    int count = 0;
+    for (float v : values) {
+        if (std::isnan(v)) continue;
+        sum += v;
+        sumSq += double(v) * v;
+        ++count;
+    }
+    *ok = false;
+    QVector<float> out(values.size(), 0.0f);
+    if (count < 2) return out;
+    const double mean = sum / count;
+    const double variance = sumSq / count - mean * mean;
+    if (variance <= 1e-12) return out;
+    const float invStd = float(1.0 / std::sqrt(variance));
+    const float fmean = float(mean);
+    for (int i = 0; i < values.size(); ++i) {
+        const float v = values[i];
+        out[i] = std::isnan(v) ? 0.0f : (v - fmean) * invStd;
+    }
+    *ok = true;
+    return out;
+}
+
+// Chênh lệch tuyệt đối của hai cột đã căn chỉnh; `scale` quy giá trị tham chiếu về độ phân giải của bản cần kiểm tra
+void diffColumns(const float* reference, const float* candidate, int n, float scale, float tolerance,
+                 int firstCandidateFrame, ReportComparison::ChannelStats& stats)
+{
+    double sum = 0.0;
+    float maxDiff = 0.0f;
+    int maxAt = -1, over = 0, compared = 0;
+    for (int i = 0; i < n; ++i) {
+        const float d = std::fabs(reference[i] * scale - candidate[i]);
+        if (std::isnan(d)) continue;
+        sum += d;
+        ++compared;
+        if (d > tolerance) ++over;
+        if (d > maxDiff) { maxDiff = d; maxAt = i; }
+    }
+    stats.comparedFrames = compared;
+    stats.meanAbsDiff = compared > 0 ? sum / compared : 0.0;
+    stats.maxAbsDiff = maxDiff;
+    stats.maxAtFrame = maxAt >= 0 ? firstCandidateFrame + maxAt : -1;
+    stats.framesOverTolerance = over;
+}
+
+bool edgesClose(const CropEdges& reference, const CropEdges& candidate, double scaleX, double scaleY, int tolerance)
+{
+    return qAbs(qRound(reference.top * scaleY) - candidate.top) <= tolerance
+        && qAbs(qRound(reference.bottom * scaleY) - candidate.bottom) <= tolerance
+        && qAbs(qRound(reference.left * scaleX) - candidate.left) <= tolerance
+        && qAbs(qRound(reference.right * scaleX) - candidate.right) <= tolerance;
+}
+
+} // namespace
+
+int ReportComparator::findOffset(const QVector<float> &referenceYdif, const QVector<float> &candidateYdif,
+                                 int maxOffset, double *correlation)
+{
+    if (correlation) *correlation = 0.0;
+    bool refOk = false, candOk = false;
+    const QVector<float> ref = normalized(referenceYdif, &refOk);
+    const QVector<float> cand = normalized(candidateYdif, &candOk);
+    if (!refOk || !candOk) return 0;
+
+    const int nRef = int(ref.size());
+    const int nCand = int(cand.size());
+    // Vùng chồng nhau phải đủ dài, nếu không một đoạn ngắn ở rìa có thể cho tương quan cao ngẫu nhiên
+    const int minOverlap = qMax(1, qMin(nRef, nCand) / 2);
+
+    int bestOffset = 0;
+    double bestScore = -2.0;
+    for (int lag = -maxOffset; lag <= maxOffset; ++lag) {
+        const int begin = qMax(0, -lag);
+        const int end = qMin(nRef, nCand - lag);
+        const int length = end - begin;
+        if (length < minOverlap) continue;
+        const double score = dot(ref.constData() + begin, cand.constData() + begin + lag, length) / length;
+        // Khi bằng nhau, ưu tiên offset gần 0 hơn
+        if (score > bestScore + 1e-9 || (qAbs(score - bestScore) <= 1e-9 && qAbs(lag) < qAbs(bestOffset))) {
+            bestScore = score;
+            bestOffset = lag;
+        }
+    }
+    if (bestScore < -1.0) return 0;
+    if (correlation) *correlation = bestScore;
+    return bestOffset;
+}
+
+ReportComparison ReportComparator::compare(const MetricPyramid &reference, const QList<AnalysisResult> &referenceResults,
+                                           const MetricPyramid &candidate, const QList<AnalysisResult> &candidateResults,
+                                           int maxOffset)
+{
+    ReportComparison out;
+    out.offset = findOffset(reference.channelValues(MetricPyramid::Ydif), candidate.channelValues(MetricPyramid::Ydif),
+                            maxOffset, &out.correlation);
+
+    // Bản transcode có thể đổi độ phân giải: quy viền đen của bản gốc về kích thước của bản cần kiểm tra
+    const double scaleX = reference.videoWidth() > 0 && candidate.videoWidth() > 0
+                              ? double(candidate.videoWidth()) / reference.videoWidth() : 1.0;
+    const double scaleY = reference.videoHeight() > 0 && candidate.videoHeight() > 0
+                              ? double(candidate.videoHeight()) / reference.videoHeight() : 1.0;
+
+    // --- Chênh lệch theo từng frame trên vùng chồng nhau ---
+    const int begin = qMax(0, -out.offset);
+    const int end = qMin(reference.frameCount(), candidate.frameCount() - out.offset);
+    out.alignedFrames = qMax(0, end - begin);
+    if (out.alignedFrames > 0) {
+        const int firstCandidateFrame = candidate.firstFrameNumber() + begin + out.offset;
+        for (int c = 0; c < MetricPyramid::ChannelCount; ++c) {
+            const auto channel = MetricPyramid::Channel(c);
+            const bool isLuma = channel == MetricPyramid::Yavg || channel == MetricPyramid::Ydif;
+            const bool isVertical = channel == MetricPyramid::CropTop || channel == MetricPyramid::CropBottom;
+            const float scale = isLuma ? 1.0f : float(isVertical ? scaleY : scaleX);
+            diffColumns(reference.channelValues(channel).constData() + begin,
+                        candidate.channelValues(channel).constData() + begin + out.offset,
+                        out.alignedFrames, scale, isLuma ? LUMA_TOLERANCE : float(CROP_TOLERANCE),
+                        firstCandidateFrame, out.channels[c]);
+        }
+    }
+
+    // --- Lỗi mới / thay đổi ---
+    // Các nhóm lỗi cùng loại không chồng lên nhau, nên sau khi sắp xếp theo startFrame thì endFrame cũng tăng dần
+    QVector<AnalysisResult> byType[3];
+    for (const AnalysisResult &r : referenceResults) {
+        const int t = int(r.type);
+        if (t >= 0 && t < 3) byType[t].append(r);
+    }
+    for (auto &list : byType) {
+        std::sort(list.begin(), list.end(), [](const AnalysisResult &a, const AnalysisResult &b) { return a.startFrame < b.startFrame; });
+    }
+
+    const int toReference = reference.firstFrameNumber() - candidate.firstFrameNumber() - out.offset;
+    for (const AnalysisResult &c : candidateResults) {
+        const int t = int(c.type);
+        if (t < 0 || t >= 3) continue;
+        const QVector<AnalysisResult> &refs = byType[t];
+        const int qStart = c.startFrame + toReference - FRAME_TOLERANCE;
+        const int qEnd = c.endFrame + toReference + FRAME_TOLERANCE;
+
+        auto it = std::partition_point(refs.cbegin(), refs.cend(), [qStart](const AnalysisResult &r) { return r.endFrame < qStart; });
+        const AnalysisResult *best = nullptr;
+        int bestOverlap = -1;
+        for (; it != refs.cend() && it->startFrame <= qEnd; ++it) {
+            const int overlap = qMin(qEnd, it->endFrame) - qMax(qStart, it->startFrame);
+            if (overlap > bestOverlap) { bestOverlap = overlap; best = &*it; }
+        }
+
+        if (!best) {
+            out.newErrors.append(c);
+            continue;
+        }
+
+        bool same = qAbs(best->startFrame - (c.startFrame + toReference)) <= FRAME_TOLERANCE
+                 && qAbs(best->endFrame - (c.endFrame + toReference)) <= FRAME_TOLERANCE;
+        if (same && c.type == ErrorType::BlackFrame) {
+            same = std::fabs(best->meanYavg - c.meanYavg) <= LUMA_TOLERANCE;
+        } else if (same && c.type == ErrorType::BlackBorder) {
+            same = edgesClose(best->minCrop, c.minCrop, scaleX, scaleY, CROP_TOLERANCE)
+                && edgesClose(best->maxCrop, c.maxCrop, scaleX, scaleY, CROP_TOLERANCE);
+        }
+
+        if (same) ++out.unchangedErrors;
+        else out.changedErrors.append({ c, *best });
+    }
+    return out;
+}
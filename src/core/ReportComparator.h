@@ -0,0 +1,61 @@
+// src/core/ReportComparator.h
+#ifndef REPORTCOMPARATOR_H
+#define REPORTCOMPARATOR_H
+
+#include <QList>
+#include <QVector>
+#include "core/types.h"
+#include "core/MetricPyramid.h"
+
+// Kết quả so sánh một báo cáo (bản cần kiểm tra, ví dụ bản transcode) với báo cáo tham chiếu (bản gốc)
+struct ReportComparison {
+    // Chênh lệch của một kênh trên các frame đã căn chỉnh (bỏ qua frame thiếu dữ liệu ở một trong hai bên)
+    struct ChannelStats {
+        double meanAbsDiff = 0.0;
+        float maxAbsDiff = 0.0f;
+        int maxAtFrame = -1;        // Số frame (của bản cần kiểm tra) có chênh lệch lớn nhất
+        int framesOverTolerance = 0;
+        int comparedFrames = 0;
+    };
+
+    struct ChangedError {
+        AnalysisResult candidate;   // Theo số frame của bản cần kiểm tra
+        AnalysisResult reference;   // Theo số frame của bản gốc
+    };
+
+    int offset = 0;                 // Vị trí frame của bản cần kiểm tra = vị trí frame của bản gốc + offset
+    double correlation = 0.0;       // Hệ số tương quan YDIF tại offset đã chọn (-1..1)
+    int alignedFrames = 0;
+    ChannelStats channels[MetricPyramid::ChannelCount];
+
+    QList<AnalysisResult> newErrors;
+    QList<ChangedError> changedErrors;
+    int unchangedErrors = 0;
+};
+
+// CẢI TIẾN: So sánh hai báo cáo theo từng frame.
+// - Các cột số liệu theo frame là tầng gốc của MetricPyramid (mảng float liên tục cho từng kênh),
+//   nên vòng lặp tính chênh lệch chỉ đọc tuần tự hai mảng và trình biên dịch có thể vector hóa.
+// - Độ lệch frame giữa hai bản (thêm/bớt vài frame ở đầu) được tìm bằng tương quan chéo YDIF
+//   trong khoảng ±maxOffset frame. Chi phí O(N x maxOffset), vài trăm triệu phép nhân-cộng cho file 2 giờ.
+// - Chỉ báo các lỗi mới hoặc thay đổi của bản cần kiểm tra; lỗi trùng với bản gốc được đếm nhưng không liệt kê.
+class ReportComparator
+{
+public:
+    static constexpr int DEFAULT_MAX_OFFSET = 250;
+    // Sai lệch vị trí tối đa (frame) để hai nhóm lỗi được coi là cùng một lỗi
+    static constexpr int FRAME_TOLERANCE = 2;
+    // Ngưỡng chênh lệch được đếm trong framesOverTolerance và để coi một lỗi là đã thay đổi
+    static constexpr float LUMA_TOLERANCE = 2.0f;
+    static constexpr int CROP_TOLERANCE = 2;
+
+    static ReportComparison compare(const MetricPyramid& reference, const QList<AnalysisResult>& referenceResults,
+                                    const MetricPyramid& candidate, const QList<AnalysisResult>& candidateResults,
+                                    int maxOffset = DEFAULT_MAX_OFFSET);
+
+    // Tìm offset có tương quan YDIF cao nhất; `correlation` nhận hệ số tương quan tại đó
+    static int findOffset(const QVector<float>& referenceYdif, const QVector<float>& candidateYdif,
+                          int maxOffset, double* correlation = nullptr);
+};
+
+#endif // REPORTCOMPARATOR_H
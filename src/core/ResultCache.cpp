@@ -0,0 +1,243 @@
+// src/core/ResultCache.cpp
+#include "ResultCache.h"
+#include "core/Constants.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace {
+
+constexpr quint32 CACHE_MAGIC = 0x56514352;    // "VQCR"
+// Tăng khi đổi định dạng file hoặc thuật toán phát hiện lỗi, để các mục cũ tự bị bỏ qua
+constexpr quint32 CACHE_VERSION = 1;
+constexpr const char* ENTRY_SUFFIX = ".vqcr";
+constexpr const char* INDEX_GROUP = "reports";
+
+// Bảo vệ chỉ mục và việc xóa bớt mục; đọc/ghi từng mục đã an toàn nhờ QSaveFile
+QMutex s_mutex;
+
+QString indexPath()
+{
+    return ResultCache::cacheRoot() + "/index.ini";
+}
+
+QString indexKey(const QFileInfo& info)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(info.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QString indexValue(const QFileInfo& info)
+{
+    return QString("%1|%2").arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+void writeMediaInfo(QDataStream& out, const MediaInfo& info)
+{
+    out << info.formatName << info.duration << info.size << info.bitrate << info.creationTime
+        << qint32(info.width) << qint32(info.height) << info.frameRate.num << info.frameRate.den << info.fps
+        << info.videoCodec << info.pixelFormat << info.colorSpace
+        << info.audioCodec << qint32(info.sampleRate) << info.channelLayout;
+}
+
+void readMediaInfo(QDataStream& in, MediaInfo& info)
+{
+    qint32 width = 0, height = 0, sampleRate = 0;
+    in >> info.formatName >> info.duration >> info.size >> info.bitrate >> info.creationTime
+       >> width >> height >> info.frameRate.num >> info.frameRate.den >> info.fps
+       >> info.videoCodec >> info.pixelFormat >> info.colorSpace
+       >> info.audioCodec >> sampleRate >> info.channelLayout;
+    info.width = width;
+    info.height = height;
+    info.sampleRate = sampleRate;
+}
+
+} // namespace
+
+QString ResultCache::cacheRoot()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/results";
+}
+
+QString ResultCache::entryPath(const QByteArray &fingerprint, const QByteArray &profile)
+{
+    return QString("%1/%2_%3%4").arg(cacheRoot(), QString::fromLatin1(fingerprint), QString::fromLatin1(profile), ENTRY_SUFFIX);
+}
+
+QByteArray ResultCache::profileHash(const QVariantMap &settings)
+{
+    // Giá trị mặc định giống QCToolsManager, để map thiếu khóa và map có khóa mặc định cho cùng một kết quả
+    const QList<QPair<const char*, QVariant>> keys = {
+        { AppConstants::K_DETECT_BLACK_FRAMES, true },
+        { AppConstants::K_DETECT_BLACK_BORDERS, true },
+        { AppConstants::K_DETECT_ORPHAN_FRAMES, true },
+        { AppConstants::K_BLACK_FRAME_THRESH, 17.0 },
+        { AppConstants::K_BORDER_THRESH, 0.2 },
+        { AppConstants::K_ORPHAN_THRESH, 5 },
+        { AppConstants::K_SCENE_THRESH, 30.0 },
+        { AppConstants::K_HAS_TRANSITIONS, false },
+    };
+
+    QByteArray text = "v" + QByteArray::number(CACHE_VERSION);
+    for (const auto &key : keys) {
+        const QVariant value = settings.value(key.first, key.second);
+        text += '|';
+        text += key.first;
+        text += '=';
+        // Số thực ghi theo dạng ngắn nhất còn khôi phục đúng, để 0.2 và 0.20000 cho cùng khóa
+        if (value.typeId() == QMetaType::Double || value.typeId() == QMetaType::Float) {
+            text += QByteArray::number(value.toDouble(), 'g', 17);
+        } else if (value.typeId() == QMetaType::Bool) {
+            text += value.toBool() ? "1" : "0";
+        } else {
+            text += value.toString().toUtf8();
+        }
+    }
+    return QCryptographicHash::hash(text, QCryptographicHash::Sha1).toHex();
+}
+
+QByteArray ResultCache::indexedFingerprint(const QString &reportPath)
+{
+    const QFileInfo info(reportPath);
+    if (!info.exists()) return QByteArray();
+
+    QMutexLocker locker(&s_mutex);
+    QSettings index(indexPath(), QSettings::IniFormat);
+    index.beginGroup(INDEX_GROUP);
+    const QStringList parts = index.value(indexKey(info)).toString().split('|');
+    // Dạng lưu: dung lượng|thời gian sửa|dấu vân tay
+    if (parts.size() != 3 || parts.at(0) + '|' + parts.at(1) != indexValue(info)) return QByteArray();
+    return parts.at(2).toLatin1();
+}
+
+QByteArray ResultCache::reportFingerprint(const QString &reportPath, bool *hashed)
+{
+    if (hashed) *hashed = false;
+    const QByteArray indexed = indexedFingerprint(reportPath);
+    if (!indexed.isEmpty()) return indexed;
+
+    QFile file(reportPath);
+    if (!file.open(QIODevice::ReadOnly)) return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file)) return QByteArray();
+    const QByteArray fingerprint = hash.result().toHex();
+    if (hashed) *hashed = true;
+
+    // Lấy lại thông tin sau khi đọc xong; nếu file đổi trong lúc băm thì lần sau sẽ băm lại
+    const QFileInfo info(reportPath);
+    QMutexLocker locker(&s_mutex);
+    QDir().mkpath(cacheRoot());
+    QSettings index(indexPath(), QSettings::IniFormat);
+    index.beginGroup(INDEX_GROUP);
+    index.setValue(indexKey(info), indexValue(info) + '|' + QString::fromLatin1(fingerprint));
+    return fingerprint;
+}
+
+bool ResultCache::contains(const QByteArray &fingerprint, const QByteArray &profile)
+{
+    return !fingerprint.isEmpty() && QFile::exists(entryPath(fingerprint, profile));
+}
+
+bool ResultCache::load(const QByteArray &fingerprint, const QByteArray &profile, Entry *entry)
+{
+    if (fingerprint.isEmpty() || !entry) return false;
+
+    QFile file(entryPath(fingerprint, profile));
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0, resultSize = 0;
+    in >> magic >> version >> resultSize;
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION || resultSize != sizeof(AnalysisResult)) return false;
+
+    Entry loaded;
+    qint32 totalFrames = 0;
+    readMediaInfo(in, loaded.mediaInfo);
+    in >> totalFrames;
+    loaded.totalFrames = totalFrames;
+
+    // AnalysisResult là kiểu POD nên đọc thẳng cả mảng
+    qint32 resultCount = 0;
+    in >> resultCount;
+    const qint64 resultBytes = qint64(resultCount) * qint64(sizeof(AnalysisResult));
+    // Kiểm tra độ dài trước khi cấp phát, để file hỏng không làm cấp phát một mảng khổng lồ
+    if (in.status() != QDataStream::Ok || resultCount < 0 || resultBytes > file.bytesAvailable()) return false;
+    loaded.results.resize(resultCount);
+    if (resultBytes > 0 && in.readRawData(reinterpret_cast<char*>(loaded.results.data()), int(resultBytes)) != resultBytes) return false;
+
+    qint32 frameCount = 0, firstFrame = 0, width = 0, height = 0;
+    in >> frameCount >> firstFrame >> width >> height;
+    if (in.status() != QDataStream::Ok || frameCount < 0
+        || qint64(frameCount) * qint64(sizeof(float)) * MetricPyramid::ChannelCount > file.bytesAvailable()) return false;
+    if (frameCount > 0) {
+        QVector<float> channels[MetricPyramid::ChannelCount];
+        for (auto &channel : channels) {
+            channel.resize(frameCount);
+            const qint64 bytes = qint64(frameCount) * qint64(sizeof(float));
+            if (in.readRawData(reinterpret_cast<char*>(channel.data()), int(bytes)) != bytes) return false;
+        }
+        loaded.metrics = MetricPyramid::fromChannels(channels, firstFrame, width, height);
+    }
+    if (in.status() != QDataStream::Ok) return false;
+
+    // Thời gian sửa của mục là mốc "dùng gần nhất" khi xóa bớt
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    *entry = std::move(loaded);
+    return true;
+}
+
+bool ResultCache::store(const QByteArray &fingerprint, const QByteArray &profile, const Entry &entry)
+{
+    if (fingerprint.isEmpty()) return false;
+    QDir().mkpath(cacheRoot());
+
+    QSaveFile file(entryPath(fingerprint, profile));
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+
+    out << CACHE_MAGIC << CACHE_VERSION << quint32(sizeof(AnalysisResult));
+    writeMediaInfo(out, entry.mediaInfo);
+    out << qint32(entry.totalFrames);
+
+    out << qint32(entry.results.size());
+    out.writeRawData(reinterpret_cast<const char*>(entry.results.constData()),
+                     int(entry.results.size() * qsizetype(sizeof(AnalysisResult))));
+
+    const MetricPyramid *metrics = entry.metrics.data();
+    out << qint32(metrics ? metrics->frameCount() : 0) << qint32(metrics ? metrics->firstFrameNumber() : 0)
+        << qint32(metrics ? metrics->videoWidth() : 0) << qint32(metrics ? metrics->videoHeight() : 0);
+    if (metrics && metrics->frameCount() > 0) {
+        for (int c = 0; c < MetricPyramid::ChannelCount; ++c) {
+            const QVector<float> &values = metrics->channelValues(MetricPyramid::Channel(c));
+            out.writeRawData(reinterpret_cast<const char*>(values.constData()), int(values.size() * qsizetype(sizeof(float))));
+        }
+    }
+
+    if (out.status() != QDataStream::Ok || !file.commit()) return false;
+    prune();
+    return true;
+}
+
+void ResultCache::prune()
+{
+    QMutexLocker locker(&s_mutex);
+    QDir dir(cacheRoot());
+    const QFileInfoList entries = dir.entryInfoList({ QString("*") + ENTRY_SUFFIX }, QDir::Files, QDir::Time);
+    // QDir::Time: mới nhất trước
+    for (int i = MAX_ENTRIES; i < entries.size(); ++i) QFile::remove(entries.at(i).absoluteFilePath());
+}
+
+void ResultCache::clear()
+{
+    QMutexLocker locker(&s_mutex);
+    QDir(cacheRoot()).removeRecursively();
+}
@@ -0,0 +1,56 @@
+// src/core/ResultCache.h
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QVariantMap>
+#include "core/types.h"
+#include "core/media_info.h"
+#include "core/MetricPyramid.h"
+
+// CẢI TIẾN: Cache kết quả phát hiện lỗi trên đĩa.
+// - Khóa = (SHA-1 nội dung file báo cáo, SHA-1 của các thiết lập phát hiện lỗi). Đổi ngưỡng hay bật/tắt
+//   bộ phát hiện nào thì khóa đổi theo; file báo cáo bị ghi đè thì nội dung đổi theo.
+// - Mỗi mục lưu MediaInfo, danh sách kết quả (mảng AnalysisResult thô) và giá trị gốc của biểu đồ timeline,
+//   nên lần mở lại không phải giải nén, đọc XML hay chạy lại bộ phát hiện.
+// - Băm nội dung một báo cáo lớn vẫn tốn thời gian đọc file, nên có thêm chỉ mục
+//   (đường dẫn, dung lượng, thời gian sửa) -> dấu vân tay: file không đổi thì tra chỉ mục là đủ,
+//   và giao diện có thể kiểm tra cache mà không phải đọc file.
+// Mọi hàm đều an toàn khi gọi từ nhiều luồng.
+class ResultCache
+{
+public:
+    // Số mục tối đa; khi vượt quá, mục lâu không dùng nhất bị xóa
+    static constexpr int MAX_ENTRIES = 200;
+
+    struct Entry {
+        MediaInfo mediaInfo;
+        int totalFrames = 0;
+        QList<AnalysisResult> results;
+        MetricPyramidPtr metrics;   // Có thể null
+    };
+
+    // Khóa của bộ thiết lập phát hiện lỗi (chỉ các thiết lập ảnh hưởng tới kết quả)
+    static QByteArray profileHash(const QVariantMap& settings);
+
+    // Dấu vân tay nội dung file báo cáo. Dùng chỉ mục nếu file chưa đổi, nếu không thì băm lại cả file;
+    // `hashed` cho biết đã phải băm. Trả về rỗng nếu không đọc được file.
+    static QByteArray reportFingerprint(const QString& reportPath, bool* hashed = nullptr);
+    // Chỉ tra chỉ mục, không đọc file; rỗng nếu chưa có hoặc file đã thay đổi
+    static QByteArray indexedFingerprint(const QString& reportPath);
+
+    static bool contains(const QByteArray& fingerprint, const QByteArray& profile);
+    static bool load(const QByteArray& fingerprint, const QByteArray& profile, Entry* entry);
+    static bool store(const QByteArray& fingerprint, const QByteArray& profile, const Entry& entry);
+
+    static QString cacheRoot();
+    static void clear();
+
+private:
+    static QString entryPath(const QByteArray& fingerprint, const QByteArray& profile);
+    static void prune();
+};
+
+#endif // RESULTCACHE_H
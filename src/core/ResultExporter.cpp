@@ -0,0 +1,384 @@
+// src/core/ResultExporter.cpp
+#include "ResultExporter.h"
+#include "core/ResultFormat.h"
+#include <QIODevice>
+#include <QBuffer>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+namespace {
+
+constexpr int BUFFER_FLUSH_BYTES = 64 * 1024;
+constexpr int ERROR_TYPE_COUNT = 3;
+
+// Căn trái và thêm khoảng trắng cho đủ `width` ký tự (tính theo ký tự, không theo byte UTF-8)
+inline void appendPadded(QByteArray &buf, const char *data, int length, int charCount, int width)
+{
+    buf.append(data, length);
+    if (charCount < width) buf.append(width - charCount, ' ');
+}
+
+inline void appendPadded(QByteArray &buf, const QByteArray &utf8, int charCount, int width)
+{
+    appendPadded(buf, utf8.constData(), int(utf8.size()), charCount, width);
+}
+
+inline void appendNumber(QByteArray &buf, qint64 value)
+{
+    char tmp[24];
+    const int n = qsnprintf(tmp, sizeof(tmp), "%lld", static_cast<long long>(value));
+    buf.append(tmp, n);
+}
+
+inline void appendTimecode(QByteArray &buf, const Timecode &tc, qint64 frame)
+{
+    char tmp[Timecode::BUFFER_SIZE];
+    buf.append(tmp, tc.formatSmpte(frame, tmp));
+}
+
+// Trường CSV theo RFC 4180: bọc trong "" khi chứa dấu phẩy, nháy kép hoặc xuống dòng
+void appendCsvField(QByteArray &buf, const QByteArray &utf8)
+{
+    const bool needsQuote = utf8.contains(',') || utf8.contains('"') || utf8.contains('\n') || utf8.contains('\r');
+    if (!needsQuote) {
+        buf.append(utf8);
+        return;
+    }
+    buf.append('"');
+    for (char c : utf8) {
+        if (c == '"') buf.append('"');
+        buf.append(c);
+    }
+    buf.append('"');
+}
+
+// Tên loại lỗi được chuyển sang UTF-8 một lần cho mỗi lần xuất
+struct TypeNames {
+    QByteArray utf8[ERROR_TYPE_COUNT];
+    int chars[ERROR_TYPE_COUNT];
+    TypeNames() {
+        for (int i = 0; i < ERROR_TYPE_COUNT; ++i) {
+            const QString name = ResultFormat::errorTypeName(static_cast<ErrorType>(i));
+            utf8[i] = name.toUtf8();
+            chars[i] = int(name.size());
+        }
+    }
+    const QByteArray &name(ErrorType t) const { return utf8[int(t)]; }
+    int length(ErrorType t) const { return chars[int(t)]; }
+};
+
+const char *typeKey(ErrorType type)
+{
+    switch (type) {
+        case ErrorType::BlackFrame: return "black_frame";
+        case ErrorType::BlackBorder: return "black_border";
+        case ErrorType::OrphanFrame: return "orphan_frame";
+    }
+    return "unknown";
+}
+
+const char *resolveMarkerColor(ErrorType type)
+{
+    switch (type) {
+        case ErrorType::BlackFrame: return "ResolveColorRed";
+        case ErrorType::BlackBorder: return "ResolveColorYellow";
+        case ErrorType::OrphanFrame: return "ResolveColorBlue";
+    }
+    return "ResolveColorBlue";
+}
+
+QJsonObject cropToJson(const CropEdges &e)
+{
+    return QJsonObject{{"top", e.top}, {"bottom", e.bottom}, {"left", e.left}, {"right", e.right}};
+}
+
+QString frameRateText(const FrameRate &rate)
+{
+    if (!rate.isValid()) return QString();
+    return rate.den == 1 ? QString::number(rate.num) : QString("%1/%2").arg(rate.num).arg(rate.den);
+}
+
+} // namespace
+
+ResultExporter::ResultExporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QString ResultExporter::formatName(ExportFormat format)
+{
+    switch (format) {
+        case ExportFormat::Txt: return "TXT";
+        case ExportFormat::Csv: return "CSV";
+        case ExportFormat::Json: return "JSON";
+        case ExportFormat::Edl: return "EDL";
+    }
+    return QString();
+}
+
+QString ResultExporter::fileSuffix(ExportFormat format)
+{
+    switch (format) {
+        case ExportFormat::Txt: return "txt";
+        case ExportFormat::Csv: return "csv";
+        case ExportFormat::Json: return "json";
+        case ExportFormat::Edl: return "edl";
+    }
+    return "txt";
+}
+
+QString ResultExporter::fileFilter(ExportFormat format)
+{
+    switch (format) {
+        case ExportFormat::Txt: return "Text Files (*.txt)";
+        case ExportFormat::Csv: return "CSV Files (*.csv)";
+        case ExportFormat::Json: return "JSON Files (*.json)";
+        case ExportFormat::Edl: return "CMX3600 EDL (*.edl)";
+    }
+    return QString();
+}
+
+void ResultExporter::run(const ExportJob &job)
+{
+    if (m_cancelRequested) {
+        emit exportFinished(false, "Đã hủy xuất file.", QByteArray());
+        return;
+    }
+
+    if (job.outputPath.isEmpty()) {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        QString error;
+        const bool ok = write(&buffer, job, &error);
+        emit exportFinished(ok, error, ok ? data : QByteArray());
+        return;
+    }
+
+    // QSaveFile: file đích chỉ bị thay thế khi ghi xong, hủy giữa chừng không để lại file dở dang
+    QSaveFile file(job.outputPath);
+    const QIODevice::OpenMode mode = job.format == ExportFormat::Json
+                                         ? QIODevice::WriteOnly
+                                         : QIODevice::WriteOnly | QIODevice::Text;
+    if (!file.open(mode)) {
+        emit exportFinished(false, QString("Không thể mở file để ghi: %1").arg(file.errorString()), QByteArray());
+        return;
+    }
+
+    QString error;
+    if (!write(&file, job, &error)) {
+        file.cancelWriting();
+        emit exportFinished(false, error, QByteArray());
+        return;
+    }
+    if (!file.commit()) {
+        emit exportFinished(false, QString("Không thể lưu file: %1").arg(file.errorString()), QByteArray());
+        return;
+    }
+    emit exportFinished(true, QString("Đã xuất file %1 thành công.").arg(formatName(job.format)), QByteArray());
+}
+
+bool ResultExporter::write(QIODevice *device, const ExportJob &job, QString *errorMessage)
+{
+    m_buffer.clear();
+    m_buffer.reserve(BUFFER_FLUSH_BYTES + 4096);
+    m_error.clear();
+    m_lastProgressRow = 0;
+
+    bool ok = false;
+    switch (job.format) {
+        case ExportFormat::Txt: ok = writeTxt(device, job); break;
+        case ExportFormat::Csv: ok = writeCsv(device, job); break;
+        case ExportFormat::Json: ok = writeJson(device, job); break;
+        case ExportFormat::Edl: ok = writeEdl(device, job); break;
+    }
+    ok = ok && flushBuffer(device, true);
+    if (ok) emit progressUpdated(int(job.results.size()), int(job.results.size()));
+
+    if (!ok && m_error.isEmpty()) m_error = "Đã hủy xuất file.";
+    if (errorMessage) *errorMessage = m_error;
+    m_buffer = QByteArray();
+    return ok;
+}
+
+bool ResultExporter::flushBuffer(QIODevice *device, bool force)
+{
+    if (m_buffer.isEmpty() || (!force && m_buffer.size() < BUFFER_FLUSH_BYTES)) return true;
+    if (device->write(m_buffer) != m_buffer.size()) {
+        m_error = QString("Lỗi ghi file: %1").arg(device->errorString());
+        return false;
+    }
+    m_buffer.clear();
+    return true;
+}
+
+bool ResultExporter::reportRow(int row, int total)
+{
+    // Báo tiến độ khoảng 1% một lần, đồng thời kiểm tra yêu cầu hủy
+    const int step = qMax(1, total / 100);
+    if (row - m_lastProgressRow >= step) {
+        m_lastProgressRow = row;
+        emit progressUpdated(row, total);
+        if (m_cancelRequested) return false;
+    }
+    return true;
+}
+
+bool ResultExporter::writeTxt(QIODevice *device, const ExportJob &job)
+{
+    // Giữ nguyên bố cục của báo cáo TXT trước đây
+    const TypeNames types;
+    const int width = job.mediaInfo.width, height = job.mediaInfo.height;
+    const int total = int(job.results.size());
+
+    m_buffer.append("File: ").append(QDir::toNativeSeparators(job.sourceFile).toUtf8()).append("\n\n");
+    const QString header = QString("%1\t%2\t%3\t%4\n").arg("Timecode", -15).arg("Thời lượng (fr)", -15).arg("Loại lỗi", -20).arg("Chi tiết");
+    m_buffer.append(header.toUtf8());
+    m_buffer.append(80, '-').append('\n');
+
+    char tc[Timecode::BUFFER_SIZE];
+    char count[24];
+    for (int i = 0; i < total; ++i) {
+        const AnalysisResult &res = job.results.at(i);
+        const int tcLength = job.timecode.formatSmpte(res.startFrame, tc);
+        appendPadded(m_buffer, tc, tcLength, tcLength, 15);
+        m_buffer.append('\t');
+        const int countLength = qsnprintf(count, sizeof(count), "%d", res.count);
+        appendPadded(m_buffer, count, countLength, countLength, 15);
+        m_buffer.append('\t');
+        appendPadded(m_buffer, types.name(res.type), types.length(res.type), 20);
+        m_buffer.append('\t');
+        m_buffer.append(ResultFormat::details(res, width, height).toUtf8());
+        m_buffer.append('\n');
+
+        if (!flushBuffer(device, false) || !reportRow(i + 1, total)) return false;
+    }
+
+    if (width > 0) {
+        m_buffer.append("\n\n==================== THÔNG TIN FILE ====================\n");
+        m_buffer.append(" File: ").append(QFileInfo(job.sourceFile).fileName().toUtf8()).append('\n');
+        m_buffer.append(job.mediaInfo.toFormattedString().toUtf8());
+        m_buffer.append("\n====================================================\n");
+    }
+    return true;
+}
+
+bool ResultExporter::writeCsv(QIODevice *device, const ExportJob &job)
+{
+    const TypeNames types;
+    const int width = job.mediaInfo.width, height = job.mediaInfo.height;
+    const int total = int(job.results.size());
+
+    // BOM để Excel nhận đúng tiếng Việt
+    m_buffer.append("\xEF\xBB\xBF");
+    m_buffer.append("start_frame,end_frame,frame_count,timecode_in,timecode_end,type,type_name,details\n");
+
+    for (int i = 0; i < total; ++i) {
+        const AnalysisResult &res = job.results.at(i);
+        appendNumber(m_buffer, res.startFrame);
+        m_buffer.append(',');
+        appendNumber(m_buffer, res.endFrame);
+        m_buffer.append(',');
+        appendNumber(m_buffer, res.count);
+        m_buffer.append(',');
+        appendTimecode(m_buffer, job.timecode, res.startFrame);
+        m_buffer.append(',');
+        appendTimecode(m_buffer, job.timecode, res.endFrame);
+        m_buffer.append(',').append(typeKey(res.type)).append(',');
+        appendCsvField(m_buffer, types.name(res.type));
+        m_buffer.append(',');
+        appendCsvField(m_buffer, ResultFormat::details(res, width, height).toUtf8());
+        m_buffer.append('\n');
+
+        if (!flushBuffer(device, false) || !reportRow(i + 1, total)) return false;
+    }
+    return true;
+}
+
+bool ResultExporter::writeJson(QIODevice *device, const ExportJob &job)
+{
+    const int width = job.mediaInfo.width, height = job.mediaInfo.height;
+    const int total = int(job.results.size());
+
+    // Phần đầu được tạo bằng QJsonObject rồi bỏ dấu '}' cuối để nối mảng "results" theo kiểu streaming
+    QJsonObject header{
+        {"source", QDir::toNativeSeparators(job.sourceFile)},
+        {"frameRate", frameRateText(job.timecode.rate())},
+        {"dropFrame", job.timecode.isDropFrame()},
+        {"width", width},
+        {"height", height},
+        {"resultCount", total}
+    };
+    QByteArray head = QJsonDocument(header).toJson(QJsonDocument::Compact);
+    head.chop(1);
+    m_buffer.append(head).append(",\"results\":[\n");
+
+    const TypeNames types;
+    for (int i = 0; i < total; ++i) {
+        const AnalysisResult &res = job.results.at(i);
+        QJsonObject row{
+            {"id", res.id},
+            {"type", typeKey(res.type)},
+            {"typeName", QString::fromUtf8(types.name(res.type))},
+            {"startFrame", res.startFrame},
+            {"endFrame", res.endFrame},
+            {"count", res.count},
+            {"timecode", job.timecode.toString(res.startFrame)},
+            {"details", ResultFormat::details(res, width, height)}
+        };
+        if (res.type == ErrorType::BlackFrame) {
+            row.insert("meanYavg", double(res.meanYavg));
+        } else if (res.type == ErrorType::BlackBorder) {
+            row.insert("minCrop", cropToJson(res.minCrop));
+            row.insert("maxCrop", cropToJson(res.maxCrop));
+        }
+        if (i > 0) m_buffer.append(",\n");
+        m_buffer.append(QJsonDocument(row).toJson(QJsonDocument::Compact));
+
+        if (!flushBuffer(device, false) || !reportRow(i + 1, total)) return false;
+    }
+    m_buffer.append("\n]}\n");
+    return true;
+}
+
+bool ResultExporter::writeEdl(QIODevice *device, const ExportJob &job)
+{
+    // CMX3600: mỗi lỗi là một event cắt (C) trên track V, kèm dòng marker theo cú pháp của DaVinci Resolve
+    // (|C:màu |M:tên |D:số frame). Premiere/Avid bỏ qua dòng này và đọc phần "* COMMENT".
+    const TypeNames types;
+    const int width = job.mediaInfo.width, height = job.mediaInfo.height;
+    const int total = int(job.results.size());
+    const QByteArray clipName = QFileInfo(job.sourceFile).fileName().toUtf8();
+
+    m_buffer.append("TITLE: ").append(QFileInfo(job.sourceFile).completeBaseName().toUtf8()).append('\n');
+    m_buffer.append(job.timecode.isDropFrame() ? "FCM: DROP FRAME\n\n" : "FCM: NON-DROP FRAME\n\n");
+
+    char eventNo[16];
+    for (int i = 0; i < total; ++i) {
+        const AnalysisResult &res = job.results.at(i);
+        // Chuẩn CMX3600 chỉ có 3 chữ số cho số event; từ event 1000 trở đi số được ghi đầy đủ
+        const int n = qsnprintf(eventNo, sizeof(eventNo), "%03d", i + 1);
+        m_buffer.append(eventNo, n).append("  AX       V     C        ");
+        appendTimecode(m_buffer, job.timecode, res.startFrame);
+        m_buffer.append(' ');
+        appendTimecode(m_buffer, job.timecode, res.endFrame + 1);
+        m_buffer.append(' ');
+        appendTimecode(m_buffer, job.timecode, res.startFrame);
+        m_buffer.append(' ');
+        appendTimecode(m_buffer, job.timecode, res.endFrame + 1);
+        m_buffer.append("\n* FROM CLIP NAME: ").append(clipName);
+        m_buffer.append("\n* COMMENT: ").append(types.name(res.type)).append(" - ");
+        m_buffer.append(ResultFormat::details(res, width, height).toUtf8());
+        m_buffer.append("\n |C:").append(resolveMarkerColor(res.type));
+        m_buffer.append(" |M:").append(types.name(res.type));
+        m_buffer.append(" |D:");
+        appendNumber(m_buffer, res.count);
+        m_buffer.append("\n\n");
+
+        if (!flushBuffer(device, false) || !reportRow(i + 1, total)) return false;
+    }
+    return true;
+}
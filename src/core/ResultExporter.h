@@ -0,0 +1,76 @@
+// src/core/ResultExporter.h
+#ifndef RESULTEXPORTER_H
+#define RESULTEXPORTER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <atomic>
+#include "core/types.h"
+#include "core/media_info.h"
+#include "core/Timecode.h"
+
+class QIODevice;
+
+enum class ExportFormat { Txt = 0, Csv, Json, Edl };
+
+// Toàn bộ dữ liệu cần cho một lần xuất, được sao chép sang luồng xuất
+struct ExportJob {
+    ExportFormat format = ExportFormat::Txt;
+    QString outputPath;                 // Rỗng: ghi vào bộ nhớ (dùng cho clipboard)
+    QString sourceFile;
+    MediaInfo mediaInfo;
+    Timecode timecode;
+    QList<AnalysisResult> results;      // Đã sắp xếp theo startFrame
+};
+Q_DECLARE_METATYPE(ExportJob)
+
+// CẢI TIẾN: Xuất kết quả trên luồng riêng.
+// Từng dòng được định dạng vào một bộ đệm nhỏ và ghi xuống file mỗi khi đầy,
+// nên không bao giờ dựng toàn bộ nội dung báo cáo trong bộ nhớ (trừ khi xuất ra clipboard).
+class ResultExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ResultExporter(QObject *parent = nullptr);
+
+    static QString formatName(ExportFormat format);
+    static QString fileSuffix(ExportFormat format);
+    static QString fileFilter(ExportFormat format);
+
+    // Ghi đồng bộ vào một thiết bị đã mở. Trả về false nếu lỗi ghi hoặc bị hủy.
+    bool write(QIODevice *device, const ExportJob &job, QString *errorMessage = nullptr);
+
+    // An toàn khi gọi từ luồng khác
+    void requestCancel() { m_cancelRequested = true; }
+    // Gọi khi đưa một job vào hàng đợi của luồng xuất (trước run()), để yêu cầu hủy gửi tới trước khi job
+    // bắt đầu chạy vẫn có hiệu lực
+    void resetCancel() { m_cancelRequested = false; }
+
+public slots:
+    void run(const ExportJob &job);
+
+signals:
+    void progressUpdated(int done, int total);
+    // data chỉ có nội dung khi outputPath rỗng
+    void exportFinished(bool success, const QString &message, const QByteArray &data);
+
+private:
+    bool writeTxt(QIODevice *device, const ExportJob &job);
+    bool writeCsv(QIODevice *device, const ExportJob &job);
+    bool writeJson(QIODevice *device, const ExportJob &job);
+    bool writeEdl(QIODevice *device, const ExportJob &job);
+
+    // Ghi phần đệm xuống thiết bị khi vượt quá ngưỡng; force = true để ghi hết
+    bool flushBuffer(QIODevice *device, bool force);
+    bool reportRow(int row, int total);
+
+    QByteArray m_buffer;
+    QString m_error;
+    int m_lastProgressRow = 0;
+    std::atomic<bool> m_cancelRequested{false};
+};
+
+#endif // RESULTEXPORTER_H
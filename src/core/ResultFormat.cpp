@@ -0,0 +1,60 @@
+// src/core/ResultFormat.cpp
+#include "ResultFormat.h"
+#include "core/Constants.h"
+#include <QStringList>
+#include <QtMath>
+
+namespace ResultFormat {
+
+QString errorTypeName(ErrorType type)
+{
+    switch (type) {
+        case ErrorType::BlackFrame: return AppConstants::ERR_BLACK_FRAME;
+        case ErrorType::BlackBorder: return AppConstants::ERR_BLACK_BORDER;
+        case ErrorType::OrphanFrame: return AppConstants::ERR_ORPHAN_FRAME;
+    }
+    return QString();
+}
+
+QString countText(const AnalysisResult &res)
+{
+    return QString::number(res.count);
+}
+
+QString details(const AnalysisResult &res, int videoWidth, int videoHeight)
+{
+    switch (res.type) {
+        case ErrorType::BlackFrame:
+            return QString("Frame tối (YAVG TB: %1), từ frame %2 đến %3")
+                .arg(res.meanYavg, 0, 'f', 2)
+                .arg(res.startFrame)
+                .arg(res.endFrame);
+        case ErrorType::BlackBorder:
+            return cropDetails(res.minCrop, res.maxCrop, videoWidth, videoHeight) +
+                   QString(", từ frame %1 đến %2").arg(res.startFrame).arg(res.endFrame);
+        case ErrorType::OrphanFrame:
+            return QString("Cảnh ngắn bất thường, từ frame %1 đến %2").arg(res.startFrame).arg(res.endFrame);
+    }
+    return QString();
+}
+
+QString cropDetails(const CropEdges &minEdges, const CropEdges &maxEdges, int videoWidth, int videoHeight)
+{
+    if (videoWidth <= 0 || videoHeight <= 0) return "Kích thước video không xác định";
+    QStringList parts;
+    auto formatSide = [&](const QString& name, int minVal, int maxVal, int total) {
+        if (maxVal < 0 || total <= 0) return;
+        if (maxVal == 0 && minVal == 0) return;
+        QString valStr = (minVal == maxVal) ? QString("%1px").arg(minVal) : QString("%1>%2px").arg(minVal).arg(maxVal);
+        double minP = (double)minVal / total * 100.0, maxP = (double)maxVal / total * 100.0;
+        QString pStr = (qAbs(minP - maxP) < 0.1) ? QString("(%1%)").arg(minP, 0, 'f', 1) : QString("(%1>%2%)").arg(minP, 0, 'f', 1).arg(maxP, 0, 'f', 1);
+        parts << QString("%1: %2 %3").arg(name, valStr, pStr);
+    };
+    formatSide("Trên", minEdges.top, maxEdges.top, videoHeight);
+    formatSide("Dưới", minEdges.bottom, maxEdges.bottom, videoHeight);
+    formatSide("Trái", minEdges.left, maxEdges.left, videoWidth);
+    formatSide("Phải", minEdges.right, maxEdges.right, videoWidth);
+    return parts.join(", ");
+}
+
+} // namespace ResultFormat
@@ -0,0 +1,19 @@
+// src/core/ResultFormat.h
+#ifndef RESULTFORMAT_H
+#define RESULTFORMAT_H
+
+#include <QString>
+#include "core/types.h"
+
+// Các hàm định dạng kết quả thành chuỗi, chỉ được gọi khi hiển thị hoặc xuất báo cáo
+namespace ResultFormat {
+
+QString errorTypeName(ErrorType type);
+QString countText(const AnalysisResult& res);
+// Cần kích thước video để tính tỉ lệ % của viền đen
+QString details(const AnalysisResult& res, int videoWidth, int videoHeight);
+QString cropDetails(const CropEdges& minEdges, const CropEdges& maxEdges, int videoWidth, int videoHeight);
+
+} // namespace ResultFormat
+
+#endif // RESULTFORMAT_H
@@ -0,0 +1,126 @@
+// src/core/SpscRingBuffer.h
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <QThread>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// CẢI TIẾN: Hàng đợi vòng có giới hạn, một luồng ghi và một luồng đọc, không dùng khóa.
+// Mỗi phía chỉ ghi chỉ số của mình (release) và đọc chỉ số của phía kia (acquire); chỉ số phía kia
+// được nhớ tạm nên phần lớn các lần push/pop không phải đọc biến dùng chung.
+// - Áp lực ngược (backpressure): push() chờ khi hàng đợi đầy, nên luồng nhanh không chạy quá xa luồng chậm
+//   và bộ nhớ dùng cho dữ liệu trung gian bị chặn bởi dung lượng hàng đợi.
+// - Hủy hợp tác: push()/pop() trả về false ngay khi `cancelled()` trả về true.
+// - close(): luồng ghi báo hết dữ liệu; pop() vẫn trả hết phần còn lại rồi mới trả về false.
+// Khi phải chờ, luồng xoay vài vòng rồi nhường CPU và ngủ ngắn, không dùng biến điều kiện.
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(size_t capacity)
+        : m_slots(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)), m_mask(m_slots.size() - 1)
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    size_t capacity() const { return m_slots.size(); }
+
+    // Chỉ gọi từ luồng ghi. `value` chỉ bị move khi push thành công.
+    bool tryPush(T& value)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == m_slots.size()) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == m_slots.size()) return false;
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Chỉ gọi từ luồng đọc
+    bool tryPop(T& out)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) return false;
+        }
+        out = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename Cancelled>
+    bool push(T&& value, Cancelled cancelled)
+    {
+        Backoff backoff;
+        while (!tryPush(value)) {
+            if (cancelled()) return false;
+            ++m_fullWaits;
+            backoff.wait();
+        }
+        return true;
+    }
+
+    template <typename Cancelled>
+    bool pop(T& out, Cancelled cancelled)
+    {
+        Backoff backoff;
+        while (!tryPop(out)) {
+            // Mọi phần tử được push trước close() đều thấy được sau khi đọc m_closed (acquire)
+            if (m_closed.load(std::memory_order_acquire)) return tryPop(out);
+            if (cancelled()) return false;
+            ++m_emptyWaits;
+            backoff.wait();
+        }
+        return true;
+    }
+
+    // Chỉ gọi từ luồng ghi, sau phần tử cuối cùng
+    void close() { m_closed.store(true, std::memory_order_release); }
+
+    // Số lần phía ghi phải chờ vì đầy / phía đọc phải chờ vì rỗng. Mỗi số chỉ do một luồng ghi,
+    // đọc sau khi các luồng đã kết thúc để biết giai đoạn nào là nút thắt.
+    quint64 fullWaits() const { return m_fullWaits; }
+    quint64 emptyWaits() const { return m_emptyWaits; }
+
+private:
+    struct Backoff {
+        int rounds = 0;
+        void wait()
+        {
+            if (++rounds <= 64) std::this_thread::yield();
+            else QThread::usleep(rounds <= 256 ? 50 : 200);
+        }
+    };
+
+    static size_t roundUpToPowerOfTwo(size_t n)
+    {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // Phía đọc
+    alignas(64) std::atomic<size_t> m_head{0};
+    size_t m_tailCache = 0;
+    quint64 m_emptyWaits = 0;
+
+    // Phía ghi
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_headCache = 0;
+    quint64 m_fullWaits = 0;
+
+    alignas(64) std::atomic<bool> m_closed{false};
+    std::vector<T> m_slots;
+    const size_t m_mask;
+};
+
+#endif // SPSCRINGBUFFER_H
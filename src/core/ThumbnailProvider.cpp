@@ -0,0 +1,193 @@
+// src/core/ThumbnailProvider.cpp
+#include "ThumbnailProvider.h"
+#include <QProcess>
+#include <QFileInfo>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QThread>
+
+namespace {
+
+constexpr int DEFAULT_MEMORY_LIMIT_MB = 64;
+constexpr int DECODE_TIMEOUT_MS = 20000;
+
+} // namespace
+
+ThumbnailProvider::ThumbnailProvider(QObject *parent)
+    : QObject(parent)
+{
+    // Mỗi tiến trình ffmpeg đã tự dùng nhiều luồng giải mã, nên pool chỉ cần nhỏ
+    m_pool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() / 2, 4));
+    m_cache.setMaxCost(DEFAULT_MEMORY_LIMIT_MB * 1024);
+}
+
+ThumbnailProvider::~ThumbnailProvider()
+{
+    ++m_generation;     // Các tiến trình đang chạy tự dừng khi thấy generation thay đổi
+    m_queue.clear();
+    m_pool.waitForDone();
+}
+
+void ThumbnailProvider::setFfmpegPath(const QString &path)
+{
+    m_ffmpegPath = path;
+    m_failed.clear();
+}
+
+void ThumbnailProvider::setDiskCacheEnabled(bool enabled)
+{
+    m_diskCacheEnabled = enabled;
+    const QString videoPath = m_videoPath;
+    m_diskCacheDir.clear();
+    if (enabled && !videoPath.isEmpty()) {
+        // Khóa theo đường dẫn + dung lượng + thời gian sửa: file bị ghi đè sẽ có thư mục đệm mới
+        const QFileInfo info(videoPath);
+        const QByteArray key = QString("%1|%2|%3").arg(info.absoluteFilePath()).arg(info.size())
+                                   .arg(info.lastModified().toMSecsSinceEpoch()).toUtf8();
+        m_diskCacheDir = diskCacheRoot() + "/" + QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+    }
+}
+
+void ThumbnailProvider::setMemoryLimitMB(int megabytes)
+{
+    m_cache.setMaxCost(qMax(1, megabytes) * 1024);
+}
+
+void ThumbnailProvider::setSource(const QString &videoPath, const FrameRate &rate)
+{
+    if (videoPath == m_videoPath && rate == m_timecode.rate()) return;
+
+    ++m_generation;
+    m_queue.clear();
+    m_queued.clear();
+    // Các tác vụ đang chạy của video cũ chỉ dừng ở lần kiểm tra generation kế tiếp: vẫn tính vào số luồng đang bận
+    m_staleInFlight += int(m_inFlight.size());
+    m_inFlight.clear();
+    m_failed.clear();
+    m_cache.clear();
+
+    m_videoPath = videoPath;
+    m_timecode = Timecode(rate, false);
+    setDiskCacheEnabled(m_diskCacheEnabled);
+}
+
+bool ThumbnailProvider::isAvailable() const
+{
+    return !m_videoPath.isEmpty() && m_timecode.isValid() && !m_ffmpegPath.isEmpty();
+}
+
+QString ThumbnailProvider::diskCacheRoot()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails";
+}
+
+QString ThumbnailProvider::diskCachePath(int frame) const
+{
+    return m_diskCacheDir.isEmpty() ? QString() : QString("%1/%2.jpg").arg(m_diskCacheDir).arg(frame);
+}
+
+QImage ThumbnailProvider::thumbnail(int frame)
+{
+    // QCache::object() đưa phần tử lên đầu danh sách LRU
+    if (QImage *cached = m_cache.object(frame)) return *cached;
+    if (!isAvailable() || frame < 0) return QImage();
+    if (m_queued.contains(frame) || m_inFlight.contains(frame) || m_failed.contains(frame)) return QImage();
+
+    m_queue.append(frame);
+    m_queued.insert(frame);
+    dispatch();
+    return QImage();
+}
+
+void ThumbnailProvider::retainOnly(const QSet<int> &frames)
+{
+    if (m_queue.isEmpty()) return;
+    m_queue.removeIf([&frames](int frame) { return !frames.contains(frame); });
+    m_queued = QSet<int>(m_queue.cbegin(), m_queue.cend());
+}
+
+void ThumbnailProvider::dispatch()
+{
+    while (!m_queue.isEmpty() && m_inFlight.size() + m_staleInFlight < m_pool.maxThreadCount()) {
+        const int frame = m_queue.takeFirst();
+        m_queued.remove(frame);
+        m_inFlight.insert(frame);
+
+        // Lùi nửa frame để ffmpeg (chế độ seek chính xác) trả về đúng frame có pts >= thời điểm này
+        const double seconds = qMax(0.0, (frame - 0.5) * m_timecode.rate().den / double(m_timecode.rate().num));
+        const QString ffmpegPath = m_ffmpegPath;
+        const QString videoPath = m_videoPath;
+        const QString cachePath = diskCachePath(frame);
+        const quint64 generation = m_generation;
+
+        m_pool.start([this, frame, seconds, ffmpegPath, videoPath, cachePath, generation]() {
+            QImage image;
+            const bool fromDisk = !cachePath.isEmpty() && image.load(cachePath);
+            if (!fromDisk) {
+                image = decodeFrame(ffmpegPath, videoPath, seconds, m_generation, generation);
+                if (!image.isNull() && !cachePath.isEmpty()) {
+                    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+                    image.save(cachePath, "JPG", 85);
+                }
+            }
+            QMetaObject::invokeMethod(this, [this, generation, frame, image]() {
+                onTaskFinished(generation, frame, image);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void ThumbnailProvider::onTaskFinished(quint64 generation, int frame, const QImage &image)
+{
+    if (generation != m_generation) {
+        // Kết quả của video trước đó: chỉ trả lại luồng, không đụng tới sổ sách của video hiện tại
+        m_staleInFlight = qMax(0, m_staleInFlight - 1);
+        dispatch();
+        return;
+    }
+
+    m_inFlight.remove(frame);
+    if (image.isNull()) {
+        m_failed.insert(frame);
+    } else {
+        m_cache.insert(frame, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+        emit thumbnailReady(frame);
+    }
+    dispatch();
+}
+
+QImage ThumbnailProvider::decodeFrame(const QString &ffmpegPath, const QString &videoPath, double seconds,
+                                      const std::atomic<quint64> &generation, quint64 expected)
+{
+    if (generation != expected) return QImage();
+
+    const QStringList args = {
+        "-hide_banner", "-loglevel", "error", "-nostdin",
+        "-ss", QString::number(seconds, 'f', 6),
+        "-i", videoPath,
+        "-frames:v", "1", "-an", "-sn", "-dn",
+        "-vf", QString("scale=%1:-2").arg(THUMB_WIDTH),
+        "-f", "image2pipe", "-c:v", "png", "pipe:1"
+    };
+
+    QProcess process;
+    process.start(ffmpegPath, args);
+    if (!process.waitForStarted(5000)) return QImage();
+
+    QElapsedTimer timer;
+    timer.start();
+    while (!process.waitForFinished(100)) {
+        if (generation != expected || timer.elapsed() > DECODE_TIMEOUT_MS) {
+            process.kill();
+            process.waitForFinished();
+            return QImage();
+        }
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) return QImage();
+
+    QImage image;
+    image.loadFromData(process.readAllStandardOutput(), "PNG");
+    return image;
+}
@@ -0,0 +1,76 @@
+// src/core/ThumbnailProvider.h
+#ifndef THUMBNAILPROVIDER_H
+#define THUMBNAILPROVIDER_H
+
+#include <QObject>
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include "core/Timecode.h"
+
+// CẢI TIẾN: Ảnh thu nhỏ của các frame lỗi.
+// - Mỗi ảnh được giải mã bằng một tiến trình ffmpeg chạy trong thread pool riêng; "-ss" đặt trước "-i"
+//   nên ffmpeg nhảy tới keyframe gần nhất rồi chỉ giải mã tiếp tới đúng frame cần lấy.
+// - Ảnh đã giải mã nằm trong QCache (LRU, giới hạn theo dung lượng) và có thể được lưu xuống đĩa.
+// - Chỉ tối đa maxThreadCount() yêu cầu chạy cùng lúc; các yêu cầu còn xếp hàng mà không còn
+//   trong tập frame đang hiển thị (retainOnly) bị hủy trước khi kịp chạy.
+class ThumbnailProvider : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int THUMB_WIDTH = 96;
+
+    explicit ThumbnailProvider(QObject *parent = nullptr);
+    ~ThumbnailProvider();
+
+    void setFfmpegPath(const QString& path);
+    void setDiskCacheEnabled(bool enabled);
+    void setMemoryLimitMB(int megabytes);
+    // Đổi video nguồn: xóa hàng đợi và bộ đệm trong RAM, các kết quả đang chạy của video cũ bị bỏ qua
+    void setSource(const QString& videoPath, const FrameRate& rate);
+
+    bool isAvailable() const;
+
+    // Trả về ảnh nếu đã có; nếu chưa có thì xếp hàng và trả về ảnh rỗng, sau đó phát thumbnailReady(frame)
+    QImage thumbnail(int frame);
+    // Hủy các yêu cầu đang xếp hàng không nằm trong tập frame này
+    void retainOnly(const QSet<int>& frames);
+
+    // Thư mục đệm trên đĩa của ảnh thu nhỏ
+    static QString diskCacheRoot();
+
+signals:
+    void thumbnailReady(int frame);
+
+private:
+    void dispatch();
+    void onTaskFinished(quint64 generation, int frame, const QImage& image);
+    QString diskCachePath(int frame) const;
+
+    // Chạy trên luồng của pool
+    static QImage decodeFrame(const QString& ffmpegPath, const QString& videoPath, double seconds,
+                              const std::atomic<quint64>& generation, quint64 expected);
+
+    QString m_ffmpegPath;
+    QString m_videoPath;
+    QString m_diskCacheDir;     // Rỗng nếu không lưu xuống đĩa
+    bool m_diskCacheEnabled = false;
+    Timecode m_timecode;
+
+    QCache<int, QImage> m_cache;
+    QList<int> m_queue;
+    QSet<int> m_queued;
+    QSet<int> m_inFlight;       // Chỉ các yêu cầu của generation hiện tại
+    int m_staleInFlight = 0;    // Yêu cầu của video trước vẫn đang giữ luồng trong pool
+    QSet<int> m_failed;         // Không thử lại các frame đã lỗi trong cùng một video
+
+    QThreadPool m_pool;
+    std::atomic<quint64> m_generation{0};
+};
+
+#endif // THUMBNAILPROVIDER_H
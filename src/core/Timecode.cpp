@@ -0,0 +1,220 @@
+// src/core/Timecode.cpp
+#include "Timecode.h"
+#include <QtMath>
+#include <numeric>
+
+namespace {
+
+// Ghi số nguyên không âm, thêm số 0 ở đầu cho đủ minDigits chữ số
+inline char* writeUInt(char* p, quint64 value, int minDigits)
+{
+    char tmp[20];
+    int n = 0;
+    do {
+        tmp[n++] = char('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    while (n < minDigits) tmp[n++] = '0';
+    while (n > 0) *p++ = tmp[--n];
+    return p;
+}
+
+inline char* writeTwoDigits(char* p, int value)
+{
+    *p++ = char('0' + value / 10);
+    *p++ = char('0' + value % 10);
+    return p;
+}
+
+// Số thực làm tròn 2 chữ số thập phân, đầu vào đã được nhân 100
+inline int writeHundredths(char* out, qint64 hundredths)
+{
+    char* p = writeUInt(out, quint64(hundredths / 100), 1);
+    *p++ = '.';
+    p = writeTwoDigits(p, int(hundredths % 100));
+    return int(p - out);
+}
+
+} // namespace
+
+// =============================================================================
+// FrameRate
+// =============================================================================
+
+FrameRate FrameRate::fromString(QStringView text)
+{
+    FrameRate rate;
+    const qsizetype slash = text.indexOf(u'/');
+    bool okNum = false, okDen = true;
+    if (slash < 0) {
+        const double value = text.trimmed().toDouble(&okNum);
+        return okNum ? fromDouble(value) : FrameRate{0, 1};
+    }
+    rate.num = text.left(slash).trimmed().toInt(&okNum);
+    rate.den = text.mid(slash + 1).trimmed().toInt(&okDen);
+    if (!okNum || !okDen || !rate.isValid()) return FrameRate{0, 1};
+
+    const int g = std::gcd(rate.num, rate.den);
+    rate.num /= g;
+    rate.den /= g;
+    return rate;
+}
+
+FrameRate FrameRate::fromDouble(double fps)
+{
+    if (!(fps > 0)) return FrameRate{0, 1};
+
+    const double rounded = qRound(fps);
+    if (qAbs(fps - rounded) < 1e-6) return FrameRate{int(rounded), 1};
+
+    // Họ NTSC: 23.976, 29.97, 47.952, 59.94, 119.88
+    const double ntscBase = qRound(fps * 1.001);
+    if (qAbs(fps - ntscBase / 1.001) < 1e-3) return FrameRate{int(ntscBase) * 1000, 1001};
+
+    FrameRate rate{qRound(fps * 1000.0), 1000};
+    const int g = std::gcd(rate.num, rate.den);
+    rate.num /= g;
+    rate.den /= g;
+    return rate;
+}
+
+// =============================================================================
+// Timecode
+// =============================================================================
+
+Timecode::Timecode(FrameRate rate, bool dropFrame)
+    : m_rate(rate)
+{
+    if (!m_rate.isValid()) return;
+
+    m_nominal = qMax(1, int((qint64(m_rate.num) + m_rate.den / 2) / m_rate.den));
+
+    // Drop-frame chỉ được định nghĩa cho 30000/1001 và 60000/1001
+    m_dropFrame = dropFrame && m_rate.den == 1001 && (m_nominal == 30 || m_nominal == 60)
+                  && qint64(m_rate.num) == qint64(m_nominal) * 1000;
+    if (m_dropFrame) {
+        m_dropPerMinute = m_nominal / 15;
+        m_framesPerMinuteDF = qint64(m_nominal) * 60 - m_dropPerMinute;
+        m_framesPer10MinDF = qint64(m_nominal) * 600 - qint64(m_dropPerMinute) * 9;
+    }
+}
+
+qint64 Timecode::frameToMilliseconds(qint64 frame) const
+{
+    if (!isValid() || frame < 0) return 0;
+    return frame * 1000 * m_rate.den / m_rate.num;
+}
+
+int Timecode::formatSmpte(qint64 frame, char* out) const
+{
+    if (!isValid() || frame < 0) frame = 0;
+
+    // Đổi số frame thực sang số frame "danh nghĩa" (tính cả các số bị bỏ qua)
+    qint64 label = frame;
+    if (m_dropFrame) {
+        const qint64 tens = frame / m_framesPer10MinDF;
+        const qint64 rem = frame % m_framesPer10MinDF;
+        label += qint64(m_dropPerMinute) * 9 * tens;
+        if (rem > m_dropPerMinute) {
+            label += qint64(m_dropPerMinute) * ((rem - m_dropPerMinute) / m_framesPerMinuteDF);
+        }
+    }
+
+    const int nominal = qMax(1, m_nominal);
+    const int ff = int(label % nominal);
+    const qint64 totalSeconds = label / nominal;
+    const int ss = int(totalSeconds % 60);
+    const int mm = int((totalSeconds / 60) % 60);
+    const qint64 hh = totalSeconds / 3600;
+
+    char* p = writeUInt(out, quint64(hh), 2);
+    *p++ = ':';
+    p = writeTwoDigits(p, mm);
+    *p++ = ':';
+    p = writeTwoDigits(p, ss);
+    *p++ = m_dropFrame ? ';' : ':';
+    // fps danh định > 99 (vd 120) cần 3 chữ số
+    p = writeUInt(p, quint64(ff), nominal > 100 ? 3 : 2);
+    return int(p - out);
+}
+
+int Timecode::formatMilliseconds(qint64 frame, char* out) const
+{
+    const qint64 totalMs = frameToMilliseconds(frame);
+    const qint64 totalSeconds = totalMs / 1000;
+
+    char* p = writeUInt(out, quint64(totalSeconds / 3600), 2);
+    *p++ = ':';
+    p = writeTwoDigits(p, int((totalSeconds / 60) % 60));
+    *p++ = ':';
+    p = writeTwoDigits(p, int(totalSeconds % 60));
+    *p++ = '.';
+    p = writeUInt(p, quint64(totalMs % 1000), 3);
+    return int(p - out);
+}
+
+int Timecode::formatSeconds(qint64 frame, char* out) const
+{
+    if (!isValid() || frame < 0) return writeHundredths(out, 0);
+    // round(frame * den / num * 100) bằng số nguyên
+    const qint64 scaledNum = frame * 200 * m_rate.den + m_rate.num;
+    return writeHundredths(out, scaledNum / (qint64(2) * m_rate.num));
+}
+
+int Timecode::formatMinutes(qint64 frame, char* out) const
+{
+    if (!isValid() || frame < 0) return writeHundredths(out, 0);
+    const qint64 divisor = qint64(m_rate.num) * 60;
+    const qint64 scaledNum = frame * 200 * m_rate.den + divisor;
+    return writeHundredths(out, scaledNum / (2 * divisor));
+}
+
+int Timecode::format(qint64 frame, Style style, char* out) const
+{
+    switch (style) {
+        case Style::Smpte: return formatSmpte(frame, out);
+        case Style::Milliseconds: return formatMilliseconds(frame, out);
+        case Style::Seconds: return formatSeconds(frame, out);
+        case Style::Minutes: return formatMinutes(frame, out);
+    }
+    return formatSmpte(frame, out);
+}
+
+QString Timecode::toString(qint64 frame, Style style) const
+{
+    char buffer[BUFFER_SIZE];
+    const int length = format(frame, style, buffer);
+    return QString::fromLatin1(buffer, length);
+}
+
+qint64 Timecode::parseSmpte(QStringView text) const
+{
+    if (!isValid()) return -1;
+
+    const QStringView trimmed = text.trimmed();
+    qint64 fields[4];
+    int count = 0;
+    qsizetype start = 0;
+    for (qsizetype i = 0; i <= trimmed.size(); ++i) {
+        if (i < trimmed.size() && trimmed[i] != u':' && trimmed[i] != u';') continue;
+        if (count == 4) return -1;
+        bool ok = false;
+        fields[count] = trimmed.mid(start, i - start).toLongLong(&ok);
+        if (!ok || fields[count] < 0) return -1;
+        ++count;
+        start = i + 1;
+    }
+    if (count != 4) return -1;
+
+    const qint64 hh = fields[0], mm = fields[1], ss = fields[2], ff = fields[3];
+    if (mm > 59 || ss > 59 || ff >= m_nominal) return -1;
+
+    const qint64 totalMinutes = hh * 60 + mm;
+    qint64 frame = (totalMinutes * 60 + ss) * m_nominal + ff;
+    if (m_dropFrame) {
+        // Nhãn 00..(drop-1) ở giây 00 của các phút không chia hết cho 10 không tồn tại
+        if (ss == 0 && ff < m_dropPerMinute && totalMinutes % 10 != 0) return -1;
+        frame -= qint64(m_dropPerMinute) * (totalMinutes - totalMinutes / 10);
+    }
+    return frame;
+}
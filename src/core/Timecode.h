@@ -0,0 +1,75 @@
+// src/core/Timecode.h
+#ifndef TIMECODE_H
+#define TIMECODE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QStringView>
+#include <QMetaType>
+
+// Tốc độ khung hình dạng phân số, giữ nguyên giá trị r_frame_rate của ffprobe (vd: 30000/1001).
+struct FrameRate {
+    qint32 num = 0;
+    qint32 den = 1;
+
+    bool isValid() const { return num > 0 && den > 0; }
+    double toDouble() const { return isValid() ? double(num) / den : 0.0; }
+    bool operator==(const FrameRate& other) const { return qint64(num) * other.den == qint64(other.num) * den; }
+    bool operator!=(const FrameRate& other) const { return !(*this == other); }
+
+    // "30000/1001", "25/1" hoặc "25"; trả về FrameRate không hợp lệ nếu không đọc được
+    static FrameRate fromString(QStringView text);
+    // Dùng khi chỉ có giá trị thực: 23.976/29.97/59.94... được đưa về dạng x000/1001
+    static FrameRate fromDouble(double fps);
+};
+Q_DECLARE_METATYPE(FrameRate)
+
+// CẢI TIẾN: Bộ chuyển đổi frame -> thời gian.
+// Các hằng số theo tốc độ khung hình được tính một lần trong constructor; các hàm format*
+// chỉ dùng số nguyên và ghi vào bộ đệm trên stack do người gọi cấp, không cấp phát bộ nhớ.
+// - Smpte: HH:MM:SS:FF đếm theo fps danh định (24, 25, 30...). Với 29.97/59.94 và dropFrame = true
+//   dùng drop-frame (bỏ số frame 00/01 — hoặc 00..03 với 59.94 — ở đầu mỗi phút, trừ các phút chia hết cho 10),
+//   dấu phân cách cuối là ';' (HH:MM:SS;FF).
+// - Milliseconds: HH:MM:SS.mmm theo thời gian thực, làm tròn xuống.
+// - Seconds / Minutes: số giây / số phút thực, làm tròn 2 chữ số thập phân.
+class Timecode
+{
+public:
+    enum class Style { Smpte, Milliseconds, Seconds, Minutes };
+
+    // Đủ cho mọi kiểu với frame 32-bit ở mọi tốc độ khung hình
+    static constexpr int BUFFER_SIZE = 32;
+
+    Timecode() = default;
+    explicit Timecode(FrameRate rate, bool dropFrame = true);
+
+    bool isValid() const { return m_rate.isValid(); }
+    bool isDropFrame() const { return m_dropFrame; }
+    FrameRate rate() const { return m_rate; }
+    int nominalFps() const { return m_nominal; }
+
+    // Ghi kết quả vào `out` (ít nhất BUFFER_SIZE byte), trả về số ký tự đã ghi (không kèm '\0')
+    int format(qint64 frame, Style style, char* out) const;
+    int formatSmpte(qint64 frame, char* out) const;
+    int formatMilliseconds(qint64 frame, char* out) const;
+    int formatSeconds(qint64 frame, char* out) const;
+    int formatMinutes(qint64 frame, char* out) const;
+
+    QString toString(qint64 frame, Style style = Style::Smpte) const;
+    // Ngược với formatSmpte(): "HH:MM:SS:FF" (dấu phân cách ':' hoặc ';') -> số frame.
+    // -1 nếu sai định dạng, vượt giới hạn (FF >= fps danh định...) hoặc là nhãn bị bỏ qua của drop-frame.
+    qint64 parseSmpte(QStringView text) const;
+
+    // Thời điểm bắt đầu của frame, tính bằng mili giây (làm tròn xuống)
+    qint64 frameToMilliseconds(qint64 frame) const;
+
+private:
+    FrameRate m_rate;
+    bool m_dropFrame = false;
+    int m_nominal = 0;                // fps danh định: round(num/den)
+    int m_dropPerMinute = 0;          // 2 với 29.97, 4 với 59.94
+    qint64 m_framesPerMinuteDF = 0;   // Số frame thực trong một phút bị drop
+    qint64 m_framesPer10MinDF = 0;    // Số frame thực trong 10 phút
+};
+
+#endif // TIMECODE_H
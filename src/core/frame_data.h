@@ -0,0 +1,11 @@
+// src/core/frame_data.h
+#ifndef FRAME_DATA_H
+#define FRAME_DATA_H
+
+// Số liệu của một frame đọc từ báo cáo QCTools (signalstats + cropdetect)
+struct FrameData {
+    int frameNum = 0; double yavg = 255.0; double ydif = 0.0;
+    int crop_x = -1, crop_y = -1, crop_w = -1, crop_h = -1;
+};
+
+#endif // FRAME_DATA_H
@@ -6,6 +6,7 @@
 #include <QDateTime>
 #include <QMetaType>
 #include <QLocale>
+#include "core/Timecode.h"
 
 struct MediaInfo {
     // General
@@ -18,7 +19,8 @@ struct MediaInfo {
     // Video Stream
     int width = 0;
     int height = 0;
-    double fps = 0.0;
+    FrameRate frameRate;    // Giá trị gốc của r_frame_rate, dùng cho timecode
+    double fps = 0.0;       // = frameRate.toDouble(), để hiển thị
     QString videoCodec;
     QString pixelFormat;
     QString colorSpace;
@@ -45,7 +47,11 @@ struct MediaInfo {
         info << "";
         info << "  --- Video Stream ---";
         if (width > 0 && height > 0) info << QString("  - Độ phân giải: %1x%2").arg(width).arg(height);
-        if (fps > 0) info << QString("  - Tốc độ Khung hình (FPS): %1").arg(fps, 0, 'f', 3);
+        if (fps > 0) {
+            QString fpsText = QString::number(fps, 'f', 3);
+            if (frameRate.isValid() && frameRate.den != 1) fpsText += QString(" (%1/%2)").arg(frameRate.num).arg(frameRate.den);
+            info << QString("  - Tốc độ Khung hình (FPS): %1").arg(fpsText);
+        }
         info << QString("  - Codec: %1").arg(videoCodec.isEmpty() ? "N/A" : videoCodec);
         info << QString("  - Định dạng Pixel: %1").arg(pixelFormat.isEmpty() ? "N/A" : pixelFormat);
         info << QString("  - Không gian màu: %1").arg(colorSpace.isEmpty() ? "N/A" : colorSpace);
@@ -2,27 +2,42 @@
 #ifndef TYPES_H
 #define TYPES_H
 
-#include <QString>
+#include <QtGlobal>
 #include <QMetaType>
-#include <QVariantMap>
-#include <atomic>
+#include <type_traits>
 
+// Loại lỗi, dùng làm chỉ số bit khi lọc kết quả
+enum class ErrorType : quint8 {
+    BlackFrame = 0,
+    BlackBorder = 1,
+    OrphanFrame = 2
+};
+
+// Độ dày viền đen (pixel) của 4 cạnh
+struct CropEdges {
+    qint16 top = 0;
+    qint16 bottom = 0;
+    qint16 left = 0;
+    qint16 right = 0;
+};
+
+// CẢI TIẾN: Kết quả chỉ chứa số liệu, không chứa chuỗi đã định dạng sẵn.
+// Timecode, tên loại lỗi và phần chi tiết được tạo khi hiển thị hoặc khi xuất báo cáo
+// (xem core/ResultFormat.h).
 struct AnalysisResult {
-    QString timecode;
-    QString duration;
-    QString errorType;
-    QString details;
+    int id = 0;             // Duy nhất trong một phiên phân tích, do QCToolsManager cấp
     int startFrame = 0;
+    int endFrame = 0;       // Frame cuối cùng của nhóm lỗi (tính cả frame này)
+    int count = 0;          // Số frame của nhóm lỗi
+    ErrorType type = ErrorType::BlackFrame;
 
-    // CẢI TIẾN: Bộ đếm ID cho kết quả, đảm bảo ID là duy nhất trong một lần chạy
-    static inline std::atomic<int> nextId = 0;
-    int id = nextId++;
-
-    // CẢI TIẾN: Hàm tĩnh để reset bộ đếm ID mỗi khi bắt đầu một phiên phân tích mới
-    static void resetIdCounter() {
-        nextId = 0;
-    }
+    // Số liệu đi kèm, tùy theo loại lỗi
+    float meanYavg = 0.0f;  // Frame Đen: YAVG trung bình của nhóm
+    CropEdges minCrop;      // Viền Đen: giá trị nhỏ nhất của từng cạnh trong nhóm
+    CropEdges maxCrop;      // Viền Đen: giá trị lớn nhất của từng cạnh trong nhóm
 };
+static_assert(std::is_trivially_copyable_v<AnalysisResult>, "AnalysisResult phải là POD để sao chép theo lô");
+
 Q_DECLARE_METATYPE(AnalysisResult)
 
 #endif // TYPES_H
@@ -0,0 +1,196 @@
+// src/qctools/CoarseScanSource.cpp
+#include "CoarseScanSource.h"
+#include "LibavFrameSource.h"
+#include <QThread>
+#include <algorithm>
+
+CoarseScanSource::CoarseScanSource(const QString &videoPath, bool signalStats, bool cropDetect, int sampleStep,
+                                   Classifier classify, const std::atomic<bool> &stopRequested)
+    : m_videoPath(videoPath), m_signalStats(signalStats), m_cropDetect(cropDetect), m_sampleStep(qMax(1, sampleStep)),
+      m_classify(std::move(classify)), m_stopRequested(stopRequested)
+{
+}
+
+CoarseScanSource::~CoarseScanSource()
+{
+    abortAll();
+    wait();
+}
+
+void CoarseScanSource::start()
+{
+    if (m_windowsGiven) {
+        finishScan();
+        return;
+    }
+    m_sampler = std::make_unique<LibavFrameSource>(m_videoPath, m_signalStats, m_cropDetect, m_stopRequested);
+    m_sampler->setSampling(m_sampleStep);
+    m_sampler->setDownscale(m_downscale);
+    m_sampler->setNativeMetrics(m_nativeMetrics);
+    m_sampler->start();
+}
+
+bool CoarseScanSource::nextBatch(FrameBatch *batch)
+{
+    if (!m_scanDone) {
+        FrameBatch samples;
+        if (m_sampler->nextBatch(&samples)) {
+            for (const FrameData &sample : std::as_const(samples.frames)) {
+                ++m_sampleCount;
+                const Candidate candidate = m_classify(m_hasPreviousSample ? &m_previousSample : nullptr, sample,
+                                                       samples.videoWidth, samples.videoHeight);
+                if (candidate == Candidate::Sample) {
+                    addWindow(sample.frameNum, sample.frameNum);
+                } else if (candidate == Candidate::SinceLastSample) {
+                    addWindow(m_hasPreviousSample ? m_previousSample.frameNum : 0, sample.frameNum);
+                }
+                if (candidate != Candidate::None) ++m_candidateCount;
+                m_previousSample = sample;
+                m_hasPreviousSample = true;
+            }
+            // Lô rỗng: luồng gọi chỉ cập nhật tiến độ trong lúc quét thô
+            *batch = FrameBatch();
+            batch->videoWidth = samples.videoWidth;
+            batch->videoHeight = samples.videoHeight;
+            return true;
+        }
+        m_sampler->wait();
+        if (m_stopRequested.load() || !m_sampler->errorString().isEmpty()) return false;
+        finishScan();
+    }
+
+    while (m_current < m_windows.size()) {
+        while (m_nextToStart < m_windows.size() && m_nextToStart - m_current < m_parallel) startWindow(m_nextToStart++);
+
+        LibavFrameSource &worker = *m_workers[m_current];
+        if (worker.nextBatch(batch)) {
+            batch->newSequence = !m_sentInWindow;
+            m_sentInWindow = true;
+            return true;
+        }
+        worker.wait();
+        if (m_stopRequested.load() || !worker.errorString().isEmpty()) {
+            abortAll();
+            return false;
+        }
+        m_windowFrames += worker.deliveredFrames();
+        // Giữ đối tượng (để đọc lỗi/thống kê) nhưng luồng đã xong, hàng đợi đã rỗng
+        ++m_current;
+        m_sentInWindow = false;
+    }
+    return false;
+}
+
+void CoarseScanSource::addWindow(int first, int last)
+{
+    const int pad = PAD_STEPS * m_sampleStep;
+    m_windows.append({ qMax(0, first - pad), last + pad });
+}
+
+void CoarseScanSource::finishScan()
+{
+    m_scanDone = true;
+    std::sort(m_windows.begin(), m_windows.end());
+    QVector<QPair<int, int>> merged;
+    for (const auto &window : std::as_const(m_windows)) {
+        if (!merged.isEmpty() && window.first <= merged.last().second + 1) merged.last().second = qMax(merged.last().second, window.second);
+        else merged.append(window);
+    }
+    m_windows = merged;
+
+    // Vài cửa sổ giải mã cùng lúc, chia đều số nhân CPU cho các bộ giải mã
+    const int cores = QThread::idealThreadCount();
+    m_parallel = qBound(1, cores / 4, qMax(1, int(m_windows.size())));
+    m_decoderThreads = qMax(1, cores / m_parallel);
+}
+
+void CoarseScanSource::startWindow(int index)
+{
+    const QPair<int, int> window = m_windows[index];
+    const int queueBatches = (window.second - window.first + 1) / LibavFrameSource::BATCH_FRAMES + 2;
+    auto worker = std::make_unique<LibavFrameSource>(m_videoPath, m_signalStats, m_cropDetect, m_stopRequested, queueBatches);
+    // Cửa sổ cuối có thể vượt quá cuối file: giải mã dừng ở cuối file
+    worker->setFrameRange(window.first, window.second + 1);
+    worker->setDecoderThreads(m_decoderThreads);
+    worker->setDownscale(m_downscale);
+    worker->setNativeMetrics(m_nativeMetrics);
+    worker->start();
+    m_workers.push_back(std::move(worker));
+}
+
+void CoarseScanSource::wait()
+{
+    if (m_sampler) m_sampler->wait();
+    for (auto &worker : m_workers) worker->wait();
+}
+
+void CoarseScanSource::abortAll()
+{
+    if (m_sampler) m_sampler->abort();
+    for (auto &worker : m_workers) worker->abort();
+}
+
+QString CoarseScanSource::errorString() const
+{
+    if (m_sampler) {
+        const QString error = m_sampler->errorString();
+        if (!error.isEmpty()) return "Quét thô: " + error;
+    }
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        const QString error = m_workers[i]->errorString();
+        if (!error.isEmpty()) return QString("Cửa sổ %1/%2: %3").arg(i + 1).arg(m_windows.size()).arg(error);
+    }
+    return QString();
+}
+
+const LibavFrameSource *CoarseScanSource::infoSource() const
+{
+    if (m_sampler) return m_sampler.get();
+    return m_workers.empty() ? nullptr : m_workers.front().get();
+}
+
+const MediaInfo &CoarseScanSource::mediaInfo() const
+{
+    static const MediaInfo empty;
+    return infoSource() ? infoSource()->mediaInfo() : empty;
+}
+
+int CoarseScanSource::nbFrames() const
+{
+    const LibavFrameSource *source = infoSource();
+    if (!source) return -1;
+    if (source->nbFrames() >= 0) return source->nbFrames();
+    // Không có nb_frames: ước theo thời lượng, vì số frame đã phân tích chỉ là một phần của file
+    const MediaInfo &info = source->mediaInfo();
+    return info.duration > 0 && info.fps > 0 ? int(info.duration * info.fps + 0.5) : -1;
+}
+
+int CoarseScanSource::progressPermille() const
+{
+    // Quét thô chiếm 30% thanh tiến độ, phần còn lại chia đều cho các cửa sổ
+    if (!m_scanDone) return m_sampler ? qMax(0, m_sampler->progressPermille()) * 3 / 10 : -1;
+    if (m_windows.isEmpty()) return 1000;
+    int current = 0;
+    if (m_current < int(m_workers.size())) current = qMax(0, m_workers[m_current]->progressPermille());
+    const int scanShare = m_windowsGiven ? 0 : 300;
+    return scanShare + int((qint64(m_current) * 1000 + current) * (1000 - scanShare) / (qint64(m_windows.size()) * 1000));
+}
+
+QString CoarseScanSource::stagesDescription() const
+{
+    if (m_windowsGiven) return QString("phân tích đầy đủ %1 vùng đã đánh dấu").arg(m_windows.size());
+    return QString("quét nhanh: lấy mẫu mỗi %1 frame, rồi phân tích đầy đủ quanh các mẫu đáng ngờ").arg(m_sampleStep);
+}
+
+QString CoarseScanSource::stageReport() const
+{
+    const int total = nbFrames();
+    QString coverage;
+    if (total > 0) coverage = QString(" (%1% số frame)").arg(double(m_windowFrames) * 100.0 / total, 0, 'f', 1);
+    if (m_windowsGiven) {
+        return QString("%1 cửa sổ, phân tích đầy đủ %2 frame%3, %4 cửa sổ song song")
+            .arg(m_windows.size()).arg(m_windowFrames).arg(coverage).arg(m_parallel);
+    }
+    return QString("quét thô %1 mẫu, %2 mẫu đáng ngờ -> %3 cửa sổ, phân tích đầy đủ %4 frame%5, %6 cửa sổ song song")
+        .arg(m_sampleCount).arg(m_candidateCount).arg(m_windows.size()).arg(m_windowFrames).arg(coverage).arg(m_parallel);
+}
@@ -0,0 +1,95 @@
+// src/qctools/CoarseScanSource.h
+#ifndef COARSESCANSOURCE_H
+#define COARSESCANSOURCE_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "FrameSource.h"
+
+class LibavFrameSource;
+
+// CẢI TIẾN: Quét hai tầng cho phân loại nhanh (chỉ có khi build với VIDEOQC_WITH_LIBAV).
+//   Tầng 1: LibavFrameSource lấy mẫu mỗi N frame; `classify` đánh dấu mẫu đáng ngờ (YAVG thấp, có viền, YDIF cao,
+//           hoặc khác hẳn mẫu trước — nghi có cắt cảnh giữa hai mẫu).
+//   Tầng 2: phân tích đầy đủ từng frame trong các cửa sổ quanh mẫu đáng ngờ (mở rộng PAD_STEPS × N frame mỗi bên,
+//           các cửa sổ chồng nhau được gộp), vài cửa sổ giải mã song song.
+// Chỉ frame của tầng 2 được giao cho luồng tìm lỗi, theo thứ tự; lô đầu mỗi cửa sổ có newSequence để bộ phát hiện
+// đóng các nhóm đang mở. Vì phần đệm không ngắn hơn khoảng cách mẫu, một đoạn lỗi chứa ít nhất một mẫu sẽ nằm trọn
+// trong cửa sổ; đoạn lỗi ngắn hơn N frame và lọt giữa hai mẫu thì có thể bị bỏ sót — đó là cái giá của chế độ này.
+// Có setWindows(): bỏ tầng 1, chỉ phân tích đầy đủ các cửa sổ cho sẵn (ví dụ các vùng mà lượt quét keyframe đánh dấu).
+class CoarseScanSource : public FrameSource
+{
+public:
+    enum class Candidate { None, Sample, SinceLastSample };
+    // `previous` = nullptr với mẫu đầu tiên
+    using Classifier = std::function<Candidate(const FrameData* previous, const FrameData& sample, int width, int height)>;
+
+    static constexpr int PAD_STEPS = 2;
+
+    CoarseScanSource(const QString& videoPath, bool signalStats, bool cropDetect, int sampleStep,
+                     Classifier classify, const std::atomic<bool>& stopRequested);
+    ~CoarseScanSource() override;
+
+    // Gọi trước start(): các cửa sổ [frame đầu, frame cuối] cần phân tích đầy đủ, không lấy mẫu
+    void setWindows(const QVector<QPair<int, int>>& windows) { m_windows = windows; m_windowsGiven = true; }
+    // Gọi trước start(), áp dụng cho cả hai tầng (xem LibavFrameSource::setDownscale())
+    void setDownscale(int factor) { m_downscale = factor; }
+    // Gọi trước start(), áp dụng cho cả hai tầng (xem LibavFrameSource::setNativeMetrics())
+    void setNativeMetrics(bool enabled) { m_nativeMetrics = enabled; }
+    // Dừng mọi luồng giải mã khi luồng tìm lỗi thôi đọc giữa chừng
+    void abort() { abortAll(); }
+
+    void start() override;
+    bool nextBatch(FrameBatch* batch) override;
+    void wait() override;
+
+    QString errorString() const override;
+    const MediaInfo& mediaInfo() const override;
+    int nbFrames() const override;
+    int progressPermille() const override;
+    QString sourceName() const override { return QStringLiteral("video"); }
+    QString stagesDescription() const override;
+    QString stageReport() const override;
+    bool contiguousFrames() const override { return false; }
+
+private:
+    void addWindow(int first, int last);
+    void finishScan();
+    void startWindow(int index);
+    void abortAll();
+    // Nguồn đọc thông tin video: bộ lấy mẫu, hoặc cửa sổ đầu tiên khi không lấy mẫu
+    const LibavFrameSource* infoSource() const;
+
+    const QString m_videoPath;
+    const bool m_signalStats;
+    const bool m_cropDetect;
+    const int m_sampleStep;
+    const Classifier m_classify;
+    const std::atomic<bool>& m_stopRequested;
+
+    std::unique_ptr<LibavFrameSource> m_sampler;
+    int m_downscale = 1;
+    bool m_nativeMetrics = true;
+    bool m_windowsGiven = false;
+    bool m_scanDone = false;
+    FrameData m_previousSample;
+    bool m_hasPreviousSample = false;
+    int m_sampleCount = 0;
+    int m_candidateCount = 0;
+
+    QVector<QPair<int, int>> m_windows;     // [frame đầu, frame cuối], sau finishScan() đã sắp xếp và gộp
+    std::vector<std::unique_ptr<LibavFrameSource>> m_workers;
+    int m_parallel = 1;
+    int m_decoderThreads = 1;
+    int m_current = 0;          // Cửa sổ đang giao frame
+    int m_nextToStart = 0;
+    bool m_sentInWindow = false;
+    qint64 m_windowFrames = 0;
+};
+
+#endif // COARSESCANSOURCE_H
@@ -0,0 +1,48 @@
+// src/qctools/FrameSource.h
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <QString>
+#include <QVector>
+#include "core/frame_data.h"
+#include "core/media_info.h"
+
+// CẢI TIẾN: Nguồn số liệu frame cho bộ tìm lỗi của QCToolsManager. Nguồn tự chạy trên luồng riêng
+// và giao frame theo lô; luồng tìm lỗi chỉ gọi nextBatch() cho tới khi hết.
+// Hai cài đặt: ReportPipeline (đọc báo cáo QCTools) và LibavFrameSource (giải mã video ngay trong tiến trình).
+class FrameSource
+{
+public:
+    struct FrameBatch {
+        QVector<FrameData> frames;
+        // Kích thước video nếu đã biết trước các frame này, 0 nếu chưa biết
+        int videoWidth = 0;
+        int videoHeight = 0;
+        // Frame đầu lô không nối tiếp frame cuối của lô trước (quét nhanh: bắt đầu một cửa sổ mới)
+        bool newSequence = false;
+    };
+
+    virtual ~FrameSource() = default;
+
+    virtual void start() = 0;
+    // Gọi từ luồng tìm lỗi; trả về false khi hết dữ liệu, bị dừng hoặc có lỗi
+    virtual bool nextBatch(FrameBatch* batch) = 0;
+    // Chờ các luồng của nguồn kết thúc; sau đó mới đọc các hàm bên dưới
+    virtual void wait() = 0;
+
+    virtual QString errorString() const = 0;
+    virtual const MediaInfo& mediaInfo() const = 0;
+    // Số frame của stream video theo metadata, -1 nếu không có
+    virtual int nbFrames() const = 0;
+    // Tiến độ 0..1000, -1 nếu chưa biết (gọi được từ bất kỳ luồng nào)
+    virtual int progressPermille() const = 0;
+    // Tên nguồn trong thông báo lỗi ("báo cáo", "video") và các giai đoạn chạy song song, cho nhật ký
+    virtual QString sourceName() const = 0;
+    virtual QString stagesDescription() const = 0;
+    // Số lần mỗi giai đoạn phải chờ giai đoạn kề nó, để biết giai đoạn nào là nút thắt
+    virtual QString stageReport() const = 0;
+    // false: chỉ một phần các frame được giao (có khoảng trống), không dựng được biểu đồ timeline liên tục
+    virtual bool contiguousFrames() const { return true; }
+};
+
+#endif // FRAMESOURCE_H
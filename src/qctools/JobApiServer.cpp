@@ -0,0 +1,527 @@
+// src/qctools/JobApiServer.cpp
+#include "JobApiServer.h"
+#include "QCToolsManager.h"
+#include "core/Constants.h"
+#include "core/ResultExporter.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+constexpr int MAX_HEADER_BYTES = 64 * 1024;
+
+QString timestamp()
+{
+    return QTime::currentTime().toString("hh:mm:ss.zzz");
+}
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 415: return "Unsupported Media Type";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+    }
+    return "Error";
+}
+
+bool isReportFile(const QString &path)
+{
+    const QString lower = path.toLower();
+    return lower.endsWith(".xml") || lower.endsWith(".xml.gz") || lower.endsWith(".qctools.mkv");
+}
+
+// Các khóa "preset" client được đặt: đúng các khóa của cấu hình ConfigWidget. Đường dẫn, thư mục báo cáo, bộ máy,
+// giới hạn bộ nhớ... luôn lấy từ cài đặt của ứng dụng.
+bool isPresetKey(const QString &key)
+{
+    static const QStringList keys = {
+        AppConstants::K_DETECT_BLACK_FRAMES, AppConstants::K_DETECT_BLACK_BORDERS, AppConstants::K_DETECT_ORPHAN_FRAMES,
+        AppConstants::K_BLACK_FRAME_THRESH, AppConstants::K_BORDER_THRESH, AppConstants::K_ORPHAN_THRESH,
+        AppConstants::K_SCENE_THRESH, AppConstants::K_HAS_TRANSITIONS,
+    };
+    return keys.contains(key);
+}
+
+bool isBoolPresetKey(const QString &key)
+{
+    return key == QLatin1String(AppConstants::K_DETECT_BLACK_FRAMES) || key == QLatin1String(AppConstants::K_DETECT_BLACK_BORDERS)
+           || key == QLatin1String(AppConstants::K_DETECT_ORPHAN_FRAMES) || key == QLatin1String(AppConstants::K_HAS_TRANSITIONS);
+}
+
+} // namespace
+
+JobApiServer::JobApiServer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+JobApiServer::~JobApiServer()
+{
+    stop();
+}
+
+void JobApiServer::start(int port, int maxJobs, const QVariantMap &baseSettings)
+{
+    stop();
+
+    m_baseSettings = baseSettings;
+    m_maxJobs = qMax(1, maxJobs);
+    m_server = new QTcpServer(this);
+    connect(m_server, &QTcpServer::newConnection, this, &JobApiServer::onNewConnection);
+    // Chỉ nhận kết nối từ chính máy này: API không có xác thực
+    if (!m_server->listen(QHostAddress::LocalHost, quint16(port))) {
+        const QString error = m_server->errorString();
+        delete m_server;
+        m_server = nullptr;
+        emit startFailed(error);
+        return;
+    }
+    emit logMessage(QString("[%1] [API] Dịch vụ job đang lắng nghe tại http://127.0.0.1:%2 (tối đa %3 job cùng lúc).")
+                        .arg(timestamp()).arg(m_server->serverPort()).arg(m_maxJobs));
+    emit started(m_server->serverPort());
+}
+
+void JobApiServer::stop()
+{
+    if (!m_server) return;
+
+    m_server->close();
+    for (auto it = m_buffers.cbegin(); it != m_buffers.cend(); ++it) it.key()->abort();
+    m_buffers.clear();
+    delete m_server;    // Các socket là con của server
+    m_server = nullptr;
+
+    for (Job *job : std::as_const(m_jobs)) {
+        if (job->manager) {
+            delete job->context;
+            job->context = nullptr;
+            job->manager->requestStop();
+            job->thread->quit();
+            job->thread->wait();
+        }
+        delete job;
+    }
+    m_jobs.clear();
+    m_queue.clear();
+    m_runningJobs = 0;
+    emit logMessage(QString("[%1] [API] Đã dừng dịch vụ job.").arg(timestamp()));
+}
+
+void JobApiServer::setBaseSettings(const QVariantMap &baseSettings)
+{
+    m_baseSettings = baseSettings;
+}
+
+// =============================================================================
+// HTTP
+// =============================================================================
+
+void JobApiServer::onNewConnection()
+{
+    while (m_server && m_server->hasPendingConnections()) {
+        QTcpSocket *socket = m_server->nextPendingConnection();
+        m_buffers.insert(socket, QByteArray());
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_buffers.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+void JobApiServer::onReadyRead(QTcpSocket *socket)
+{
+    auto it = m_buffers.find(socket);
+    if (it == m_buffers.end()) return;
+    it->append(socket->readAll());
+
+    // Một kết nối keep-alive có thể gửi nhiều request liên tiếp
+    while (true) {
+        Request request;
+        int error = 0;
+        if (!parseRequest(*it, &request, &error)) {
+            if (error != 0) {
+                send(socket, errorResponse(error, "Request không hợp lệ."), false);
+                m_buffers.remove(socket);
+            }
+            return;
+        }
+        send(socket, handle(request), request.keepAlive);
+        if (!request.keepAlive) {
+            m_buffers.remove(socket);
+            return;
+        }
+    }
+}
+
+bool JobApiServer::parseRequest(QByteArray &buffer, Request *request, int *error) const
+{
+    *error = 0;
+    const int headerEnd = int(buffer.indexOf("\r\n\r\n"));
+    if (headerEnd < 0) {
+        if (buffer.size() > MAX_HEADER_BYTES) *error = 431;
+        return false;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3) { *error = 400; return false; }
+
+    request->method = requestLine.at(0).toUpper();
+    request->path = requestLine.at(1);
+    const int query = int(request->path.indexOf('?'));
+    if (query >= 0) request->path.truncate(query);
+    const bool http10 = requestLine.at(2) == "HTTP/1.0";
+    request->keepAlive = !http10;
+
+    qint64 contentLength = 0;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const int colon = int(line.indexOf(':'));
+        if (colon <= 0) continue;
+        const QByteArray name = line.left(colon).trimmed().toLower();
+        const QByteArray value = line.mid(colon + 1).trimmed().toLower();
+        if (name == "content-length") {
+            bool ok = false;
+            contentLength = value.toLongLong(&ok);
+            if (!ok || contentLength < 0) { *error = 400; return false; }
+        } else if (name == "host") {
+            request->host = value;
+        } else if (name == "origin") {
+            request->hasOrigin = true;
+        } else if (name == "content-type") {
+            request->contentType = value;
+        } else if (name == "connection") {
+            if (value == "close") request->keepAlive = false;
+            else if (value == "keep-alive") request->keepAlive = true;
+        }
+    }
+    if (contentLength > MAX_REQUEST_BYTES) { *error = 413; return false; }
+
+    const qint64 total = headerEnd + 4 + contentLength;
+    if (buffer.size() < total) return false;
+    request->body = buffer.mid(headerEnd + 4, contentLength);
+    buffer.remove(0, total);
+    return true;
+}
+
+void JobApiServer::send(QTcpSocket *socket, const Response &response, bool keepAlive)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + ' ' + reasonPhrase(response.status) + "\r\n";
+    head += "Content-Type: " + response.contentType + "\r\n";
+    head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    head += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    socket->write(head);
+    socket->write(response.body);
+    if (!keepAlive) socket->disconnectFromHost();
+}
+
+bool JobApiServer::rejectsBrowserRequest(const Request &request, Response *response) const
+{
+    // Host khác (ví dụ tên miền của trang web trỏ về 127.0.0.1): DNS rebinding
+    const QByteArray port = QByteArray::number(m_server ? m_server->serverPort() : 0);
+    const bool defaultPort = port == "80";
+    const bool localHost = request.host == "127.0.0.1:" + port || request.host == "localhost:" + port
+                           || (defaultPort && (request.host == "127.0.0.1" || request.host == "localhost"));
+    if (!localHost) {
+        *response = errorResponse(403, "Host phải là 127.0.0.1 hoặc localhost kèm cổng của dịch vụ.");
+        return true;
+    }
+    // Trình duyệt luôn gửi Origin với request từ trang web khác; client cục bộ không cần
+    if (request.hasOrigin) {
+        *response = errorResponse(403, "Không nhận request từ trình duyệt (có header Origin).");
+        return true;
+    }
+    // Trang web chỉ gửi được POST "đơn giản" (text/plain, form) mà không qua preflight
+    if (request.method == "POST" && !request.contentType.startsWith("application/json")) {
+        *response = errorResponse(415, "POST phải có Content-Type: application/json.");
+        return true;
+    }
+    return false;
+}
+
+JobApiServer::Response JobApiServer::handle(const Request &request)
+{
+    Response rejected;
+    if (rejectsBrowserRequest(request, &rejected)) return rejected;
+
+    const QList<QByteArray> parts = request.path.split('/');
+    // "/jobs/12/results" -> ["", "jobs", "12", "results"]
+    if (request.path == "/health") {
+        if (request.method != "GET") return errorResponse(405, "Chỉ hỗ trợ GET.");
+        return jsonResponse(200, QJsonObject{ {"status", "ok"}, {"running", m_runningJobs}, {"queued", int(m_queue.size())} });
+    }
+    if (parts.size() < 2 || parts.at(1) != "jobs") return errorResponse(404, "Không có endpoint này.");
+
+    if (parts.size() == 2 || (parts.size() == 3 && parts.at(2).isEmpty())) {
+        if (request.method == "POST") return submitJob(request.body);
+        if (request.method == "GET") return listJobs();
+        return errorResponse(405, "Chỉ hỗ trợ GET hoặc POST.");
+    }
+
+    bool ok = false;
+    const int id = parts.at(2).toInt(&ok);
+    if (!ok) return errorResponse(404, "Mã job không hợp lệ.");
+
+    if (parts.size() == 3) {
+        if (request.method == "GET") return jobStatus(id);
+        if (request.method == "DELETE") return cancelJob(id);
+        return errorResponse(405, "Chỉ hỗ trợ GET hoặc DELETE.");
+    }
+    if (parts.size() == 4 && parts.at(3) == "results") {
+        if (request.method != "GET") return errorResponse(405, "Chỉ hỗ trợ GET.");
+        return jobResults(id);
+    }
+    if (parts.size() == 4 && parts.at(3) == "cancel" && request.method == "POST") return cancelJob(id);
+    return errorResponse(404, "Không có endpoint này.");
+}
+
+JobApiServer::Response JobApiServer::jsonResponse(int status, const QJsonObject &object)
+{
+    Response response;
+    response.status = status;
+    response.body = QJsonDocument(object).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+JobApiServer::Response JobApiServer::errorResponse(int status, const QString &message)
+{
+    return jsonResponse(status, QJsonObject{ {"error", message} });
+}
+
+// =============================================================================
+// JOBS
+// =============================================================================
+
+QByteArray JobApiServer::statusName(JobStatus status)
+{
+    switch (status) {
+        case JobStatus::Queued: return "queued";
+        case JobStatus::Running: return "running";
+        case JobStatus::Finished: return "finished";
+        case JobStatus::Failed: return "failed";
+        case JobStatus::Cancelled: return "cancelled";
+    }
+    return "unknown";
+}
+
+QJsonObject JobApiServer::jobToJson(const Job &job) const
+{
+    // Tiến độ tổng ước lượng từ "Bước x/y" của QCToolsManager và tiến độ trong bước
+    double progress = job.status == JobStatus::Finished ? 1.0 : 0.0;
+    if (job.status == JobStatus::Running) {
+        static const QRegularExpression stepPattern(QStringLiteral("(\\d+)/(\\d+)"));
+        const QRegularExpressionMatch match = stepPattern.match(job.step);
+        const double inStep = job.stepMax > 0 ? qBound(0.0, double(job.stepValue) / job.stepMax, 1.0) : 0.0;
+        if (match.hasMatch() && match.captured(2).toInt() > 0) {
+            progress = qBound(0.0, (match.captured(1).toInt() - 1 + inStep) / match.captured(2).toInt(), 1.0);
+        }
+    }
+
+    QJsonObject object{
+        {"id", job.id},
+        {"path", job.path},
+        {"status", QString::fromLatin1(statusName(job.status))},
+        {"progress", progress},
+        {"step", job.step},
+        {"resultCount", int(job.results.size())},
+        {"created", QDateTime::fromMSecsSinceEpoch(job.createdMs).toString(Qt::ISODateWithMs)},
+    };
+    if (job.startedMs > 0) object["started"] = QDateTime::fromMSecsSinceEpoch(job.startedMs).toString(Qt::ISODateWithMs);
+    if (job.finishedMs > 0) object["finished"] = QDateTime::fromMSecsSinceEpoch(job.finishedMs).toString(Qt::ISODateWithMs);
+    if (!job.error.isEmpty()) object["error"] = job.error;
+    return object;
+}
+
+JobApiServer::Response JobApiServer::submitJob(const QByteArray &body)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(body, &parseError);
+    if (!doc.isObject()) return errorResponse(400, QString("JSON không hợp lệ: %1").arg(parseError.errorString()));
+
+    const QJsonObject object = doc.object();
+    const QString path = object.value("path").toString();
+    if (path.isEmpty() || !QFileInfo(path).isFile()) return errorResponse(400, "Trường \"path\" phải là một file tồn tại.");
+    if (object.contains("preset") && !object.value("preset").isObject()) return errorResponse(400, "Trường \"preset\" phải là một object.");
+
+    const QJsonObject preset = object.value("preset").toObject();
+    for (auto it = preset.constBegin(); it != preset.constEnd(); ++it) {
+        if (!isPresetKey(it.key())) return errorResponse(400, QString("Khóa \"%1\" không được đặt qua \"preset\".").arg(it.key()));
+        if (isBoolPresetKey(it.key()) ? !it.value().isBool() : !it.value().isDouble())
+            return errorResponse(400, QString("Giá trị của \"%1\" phải là %2.").arg(it.key(), isBoolPresetKey(it.key()) ? "true/false" : "một số"));
+    }
+
+    auto *job = new Job;
+    job->id = m_nextJobId++;
+    job->path = QFileInfo(path).absoluteFilePath();
+    job->settings = m_baseSettings;
+    for (auto it = preset.constBegin(); it != preset.constEnd(); ++it) job->settings.insert(it.key(), it.value().toVariant());
+    job->createdMs = QDateTime::currentMSecsSinceEpoch();
+
+    m_jobs.insert(job->id, job);
+    m_queue.enqueue(job->id);
+    emit logMessage(QString("[%1] [API] Nhận job #%2: %3").arg(timestamp()).arg(job->id).arg(job->path));
+
+    pruneJobs();
+    dispatch();
+    return jsonResponse(202, jobToJson(*job));
+}
+
+JobApiServer::Response JobApiServer::listJobs() const
+{
+    QJsonArray jobs;
+    for (const Job *job : m_jobs) jobs.append(jobToJson(*job));
+    return jsonResponse(200, QJsonObject{ {"jobs", jobs} });
+}
+
+JobApiServer::Response JobApiServer::jobStatus(int id) const
+{
+    const Job *job = m_jobs.value(id);
+    if (!job) return errorResponse(404, "Không tìm thấy job.");
+    return jsonResponse(200, jobToJson(*job));
+}
+
+JobApiServer::Response JobApiServer::jobResults(int id) const
+{
+    const Job *job = m_jobs.value(id);
+    if (!job) return errorResponse(404, "Không tìm thấy job.");
+    if (job->status != JobStatus::Finished) return errorResponse(409, "Job chưa hoàn tất.");
+
+    const QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    ExportJob exportJob;
+    exportJob.format = ExportFormat::Json;
+    exportJob.sourceFile = job->path;
+    exportJob.mediaInfo = job->mediaInfo;
+    exportJob.timecode = Timecode(job->mediaInfo.frameRate, qsettings.value(AppConstants::K_DROP_FRAME_TIMECODE, true).toBool());
+    exportJob.results = job->results;
+
+    Response response;
+    QBuffer buffer(&response.body);
+    buffer.open(QIODevice::WriteOnly);
+    ResultExporter exporter;
+    QString error;
+    if (!exporter.write(&buffer, exportJob, &error)) return errorResponse(500, error);
+    return response;
+}
+
+JobApiServer::Response JobApiServer::cancelJob(int id)
+{
+    Job *job = m_jobs.value(id);
+    if (!job) return errorResponse(404, "Không tìm thấy job.");
+
+    if (job->status == JobStatus::Queued) {
+        m_queue.removeAll(id);
+        job->status = JobStatus::Cancelled;
+        job->finishedMs = QDateTime::currentMSecsSinceEpoch();
+    } else if (job->status == JobStatus::Running && !job->cancelRequested) {
+        // Manager sẽ phát analysisFinished(false), lúc đó job được đánh dấu đã hủy
+        job->cancelRequested = true;
+        job->manager->requestStop();
+    } else if (job->status != JobStatus::Running) {
+        return errorResponse(409, "Job đã kết thúc.");
+    }
+    emit logMessage(QString("[%1] [API] Hủy job #%2.").arg(timestamp()).arg(id));
+    return jsonResponse(200, jobToJson(*job));
+}
+
+void JobApiServer::dispatch()
+{
+    while (m_runningJobs < m_maxJobs && !m_queue.isEmpty()) {
+        Job *job = m_jobs.value(m_queue.dequeue());
+        if (job && job->status == JobStatus::Queued) startJob(job);
+    }
+}
+
+void JobApiServer::startJob(Job *job)
+{
+    job->status = JobStatus::Running;
+    job->startedMs = QDateTime::currentMSecsSinceEpoch();
+    ++m_runningJobs;
+
+    job->thread = new QThread(this);
+    job->manager = new QCToolsManager();
+    job->manager->moveToThread(job->thread);
+    connect(job->thread, &QThread::finished, job->manager, &QObject::deleteLater);
+    connect(job->thread, &QThread::finished, job->thread, &QObject::deleteLater);
+    job->context = new QObject(this);
+
+    connect(job->manager, &QCToolsManager::statusUpdated, job->context, [job](const QString &status) {
+        job->step = status;
+    }, Qt::QueuedConnection);
+    connect(job->manager, &QCToolsManager::progressUpdated, job->context, [job](int value, int max) {
+        job->stepValue = value;
+        job->stepMax = max;
+    }, Qt::QueuedConnection);
+    connect(job->manager, &QCToolsManager::resultsBatchReady, job->context, [job](const QList<AnalysisResult> &batch) {
+        job->results.append(batch);
+    }, Qt::QueuedConnection);
+    connect(job->manager, &QCToolsManager::mediaInfoReady, job->context, [job](const MediaInfo &info) {
+        job->mediaInfo = info;
+    }, Qt::QueuedConnection);
+    connect(job->manager, &QCToolsManager::errorOccurred, job->context, [job](const QString &error) {
+        job->error = error;
+    }, Qt::QueuedConnection);
+    connect(job->manager, &QCToolsManager::analysisFinished, job->context, [this, job](bool success) {
+        finishJob(job, job->cancelRequested ? JobStatus::Cancelled : (success ? JobStatus::Finished : JobStatus::Failed));
+    }, Qt::QueuedConnection);
+
+    job->thread->start();
+    const char *method = isReportFile(job->path) ? "processReportFile" : "doWork";
+    QMetaObject::invokeMethod(job->manager, method, Qt::QueuedConnection,
+                              Q_ARG(QString, job->path), Q_ARG(QVariantMap, job->settings));
+}
+
+void JobApiServer::finishJob(Job *job, JobStatus status)
+{
+    job->status = status;
+    job->finishedMs = QDateTime::currentMSecsSinceEpoch();
+    std::sort(job->results.begin(), job->results.end(), [](const AnalysisResult &a, const AnalysisResult &b) {
+        return a.startFrame < b.startFrame;
+    });
+    releaseWorker(job);
+    emit logMessage(QString("[%1] [API] Job #%2 kết thúc: %3 (%4 lỗi).")
+                        .arg(timestamp()).arg(job->id).arg(QString::fromLatin1(statusName(status))).arg(job->results.size()));
+    dispatch();
+}
+
+void JobApiServer::releaseWorker(Job *job)
+{
+    if (!job->manager) return;
+    // Đang ở trong slot của context: chỉ xóa nó sau khi slot kết thúc
+    job->context->deleteLater();
+    job->context = nullptr;
+    job->thread->quit();
+    job->thread = nullptr;
+    job->manager = nullptr;     // Tự xóa khi luồng kết thúc
+    --m_runningJobs;
+}
+
+void JobApiServer::pruneJobs()
+{
+    // Bỏ bớt các job cũ nhất đã kết thúc
+    for (auto it = m_jobs.begin(); m_jobs.size() > MAX_KEPT_JOBS && it != m_jobs.end();) {
+        Job *job = it.value();
+        if (job->status == JobStatus::Queued || job->status == JobStatus::Running) { ++it; continue; }
+        delete job;
+        it = m_jobs.erase(it);
+    }
+}
@@ -0,0 +1,137 @@
+// src/qctools/JobApiServer.h
+#ifndef JOBAPISERVER_H
+#define JOBAPISERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QQueue>
+#include <QVariantMap>
+#include "core/types.h"
+#include "core/media_info.h"
+
+class QJsonObject;
+class QTcpServer;
+class QTcpSocket;
+class QThread;
+class QCToolsManager;
+
+// CẢI TIẾN: Dịch vụ HTTP/JSON cục bộ để gửi và theo dõi các job phân tích (dùng Qt6::Network).
+// Chỉ lắng nghe trên 127.0.0.1. Các endpoint:
+//   POST   /jobs                 {"path": "...", "preset": {...}} -> 202 {"id": 1, "status": "queued"}
+//   GET    /jobs                 danh sách job
+//   GET    /jobs/<id>            trạng thái và tiến độ
+//   GET    /jobs/<id>/results    kết quả dạng JSON (giống file xuất JSON), khi job đã xong
+//   DELETE /jobs/<id>            hủy job (đang chờ hoặc đang chạy)
+//   GET    /health               kiểm tra dịch vụ
+// "preset" có cùng dạng với file cấu hình của ConfigWidget (chỉ các khóa phát hiện lỗi và ngưỡng, khóa khác bị từ
+// chối với 400); khóa nào thiếu thì dùng cấu hình hiện tại.
+// Chống trang web gọi API qua trình duyệt (CSRF, DNS rebinding): Host phải là 127.0.0.1:<cổng> hoặc localhost:<cổng>,
+// request có header Origin bị từ chối, và POST phải có Content-Type: application/json.
+// "path" là video (được phân tích bằng qcli) hoặc file báo cáo .xml/.xml.gz/.mkv (chỉ đọc báo cáo).
+//
+// Đối tượng này chạy trên luồng riêng và hoàn toàn theo sự kiện: socket không bao giờ chờ đồng bộ,
+// mỗi job chạy một QCToolsManager trên luồng của nó và chỉ gửi tín hiệu (queued) về đây,
+// nên nhiều client hỏi trạng thái cùng lúc không làm chậm các luồng phân tích.
+class JobApiServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MAX_REQUEST_BYTES = 1024 * 1024;
+    static constexpr int MAX_KEPT_JOBS = 500;
+
+    explicit JobApiServer(QObject *parent = nullptr);
+    ~JobApiServer();
+
+public slots:
+    // Gọi qua QMetaObject::invokeMethod để chạy trên luồng của server
+    void start(int port, int maxJobs, const QVariantMap& baseSettings);
+    void stop();
+    // Cấu hình mặc định cho các job gửi sau đó (khi người dùng đổi cấu hình trong giao diện)
+    void setBaseSettings(const QVariantMap& baseSettings);
+
+signals:
+    void started(quint16 port);
+    void startFailed(const QString& error);
+    void logMessage(const QString& message);
+
+private:
+    enum class JobStatus { Queued, Running, Finished, Failed, Cancelled };
+
+    struct Job {
+        int id = 0;
+        QString path;
+        QVariantMap settings;
+        JobStatus status = JobStatus::Queued;
+        bool cancelRequested = false;
+        QString step;               // Bước hiện tại do QCToolsManager báo
+        int stepValue = 0;
+        int stepMax = 0;
+        QString error;
+        QList<AnalysisResult> results;
+        MediaInfo mediaInfo;
+        qint64 createdMs = 0;
+        qint64 startedMs = 0;
+        qint64 finishedMs = 0;
+        QThread* thread = nullptr;
+        QCToolsManager* manager = nullptr;
+        QObject* context = nullptr;
+    };
+
+    struct Request {
+        QByteArray method;
+        QByteArray path;
+        QByteArray body;
+        QByteArray host;
+        QByteArray contentType;
+        bool hasOrigin = false;
+        bool keepAlive = true;
+    };
+
+    struct Response {
+        int status = 200;
+        QByteArray body;
+        QByteArray contentType = "application/json; charset=utf-8";
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    // Trả về false nếu dữ liệu chưa đủ một request; `error` khác 0 nếu request không hợp lệ
+    bool parseRequest(QByteArray& buffer, Request* request, int* error) const;
+    Response handle(const Request& request);
+    // Lỗi (403/415) nếu request có thể đến từ một trang web thay vì một client cục bộ
+    bool rejectsBrowserRequest(const Request& request, Response* response) const;
+    void send(QTcpSocket* socket, const Response& response, bool keepAlive);
+
+    Response submitJob(const QByteArray& body);
+    Response listJobs() const;
+    Response jobStatus(int id) const;
+    Response jobResults(int id) const;
+    Response cancelJob(int id);
+
+    void dispatch();
+    void startJob(Job* job);
+    void finishJob(Job* job, JobStatus status);
+    void releaseWorker(Job* job);
+    void pruneJobs();
+
+    static QByteArray statusName(JobStatus status);
+    static Response jsonResponse(int status, const QJsonObject& object);
+    static Response errorResponse(int status, const QString& message);
+    QJsonObject jobToJson(const Job& job) const;
+
+    QTcpServer* m_server = nullptr;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+
+    QVariantMap m_baseSettings;
+    int m_maxJobs = 1;
+    int m_nextJobId = 1;
+    QMap<int, Job*> m_jobs;     // Theo id, tăng dần
+    QQueue<int> m_queue;
+    int m_runningJobs = 0;
+};
+
+#endif // JOBAPISERVER_H
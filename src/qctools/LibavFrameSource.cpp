@@ -0,0 +1,958 @@
+// src/qctools/LibavFrameSource.cpp
+#include "LibavFrameSource.h"
+#include "core/LumaStats.h"
+#include "core/GopIndex.h"
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+#include <limits>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavfilter/avfilter.h>
+#include <libavfilter/buffersink.h>
+#include <libavfilter/buffersrc.h>
+#include <libavfilter/version.h>
+#include <libavformat/avformat.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/dict.h>
+#include <libavutil/pixdesc.h>
+}
+
+// Mọi đối tượng libav của một lần giải mã; được giải phóng theo thứ tự ngược khi ra khỏi run()
+struct LibavFrameSource::Context {
+    AVFormatContext* format = nullptr;
+    AVCodecContext* decoder = nullptr;
+    AVFilterGraph* graph = nullptr;
+    AVFilterContext* bufferSource = nullptr;
+    AVFilterContext* bufferSink = nullptr;
+    AVPacket* packet = nullptr;
+    AVFrame* decoded = nullptr;
+    AVFrame* filtered = nullptr;
+    AVFrame* previousLuma = nullptr;    // Frame ra khỏi bộ lọc ngay trước, để LumaStats tính YDIF như signalstats
+    int lumaBitDepth = 0;               // > 0: YAVG/YDIF do LumaStats tính, signalstats không có trong bộ lọc
+    bool nativeBorders = false;         // Viền đen do LumaStats::findBorders() dò, cropdetect không có trong bộ lọc
+    int videoStream = -1;
+    int64_t startTs = 0;          // Đầu phần được giao (đầu stream hoặc đầu đoạn), để tính tiến độ
+    int64_t streamStartTs = 0;
+    AVRational timeBase{0, 1};
+    AVRational frameDuration{0, 1};     // 1 / tốc độ khung hình danh định
+    int64_t lastTs = AV_NOPTS_VALUE;    // Timestamp của frame vừa giải mã
+    bool intraOnly = false;
+    bool seekPending = false;
+    QVector<qint64> keyframes;          // Chỉ mục keyframe của container, tăng dần
+    int64_t durationTs = 0;     // Thời lượng theo time_base của stream video, 0 nếu không biết
+    bool reachedEnd = false;    // Đã gặp frame đầu tiên sau đoạn được giao
+    FrameBatch batch;
+
+    ~Context()
+    {
+        av_frame_free(&previousLuma);
+        av_frame_free(&filtered);
+        av_frame_free(&decoded);
+        av_packet_free(&packet);
+        avfilter_graph_free(&graph);
+        avcodec_free_context(&decoder);
+        avformat_close_input(&format);
+    }
+};
+
+// Giá trị metadata lavfi.* của frame. libavfilter ghi số bằng printf nên dấu thập phân theo locale C của tiến trình,
+// có thể là dấu phẩy khi ứng dụng chạy với locale tiếng Việt.
+static double metadataValue(const AVDictionary *metadata, const char *key, double fallback)
+{
+    const AVDictionaryEntry *entry = av_dict_get(metadata, key, nullptr, 0);
+    if (!entry) return fallback;
+    bool ok = false;
+    const QByteArray text(entry->value);
+    const double value = text.toDouble(&ok);
+    if (ok) return value;
+    const double commaValue = QByteArray(text).replace(',', '.').toDouble(&ok);
+    return ok ? commaValue : fallback;
+}
+
+// Độ sâu bit của kênh Y nếu LumaStats đọc thẳng được mặt phẳng Y của định dạng này (mặt phẳng riêng, 8 bit hoặc
+// 9..16 bit little-endian nằm ở các bit thấp); 0 với RGB, YUV đóng gói, big-endian, P010, khung phần cứng...
+// và khi đó YAVG/YDIF vẫn do signalstats tính.
+static int nativeLumaDepth(int format)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(AVPixelFormat(format));
+    if (!desc || desc->nb_components < 1) return 0;
+    const uint64_t unsupported = AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL
+                                 | AV_PIX_FMT_FLAG_BITSTREAM | AV_PIX_FMT_FLAG_FLOAT;
+    if (desc->flags & unsupported) return 0;
+    const AVComponentDescriptor &luma = desc->comp[0];
+    if (luma.plane != 0 || luma.shift != 0 || luma.offset != 0) return 0;
+    if (luma.depth == 8 && luma.step == 1) return 8;
+    if (luma.depth > 8 && luma.depth <= 16 && luma.step == 2) return luma.depth;
+    return 0;
+}
+
+static LumaStats::Plane lumaPlaneOf(const AVFrame *frame, int depth)
+{
+    LumaStats::Plane plane;
+    plane.data = frame->data[0];
+    plane.stride = frame->linesize[0];
+    plane.width = frame->width;
+    plane.height = frame->height;
+    plane.bitDepth = depth;
+    return plane;
+}
+
+// YAVG/YDIF của frame vừa ra khỏi bộ lọc, so với frame ra ngay trước nó (cả frame chỉ dùng làm tham chiếu) như
+// signalstats; sau đó giữ một tham chiếu tới frame này (không sao chép) cho lần sau.
+static bool measureLuma(LibavFrameSource::Context &ctx, FrameData *frame)
+{
+    const AVFrame *current = ctx.filtered;
+    const int depth = nativeLumaDepth(current->format);
+    if (depth <= 0 || !current->data[0]) return false;
+
+    const LumaStats::Plane plane = lumaPlaneOf(current, depth);
+    LumaStats::Plane previous;
+    const AVFrame *prev = ctx.previousLuma;
+    const bool hasPrevious = prev->data[0] && prev->format == current->format;
+    if (hasPrevious) previous = lumaPlaneOf(prev, depth);
+    const LumaStats::Result stats = LumaStats::compute(plane, hasPrevious ? &previous : nullptr);
+    frame->yavg = stats.yavg;
+    frame->ydif = stats.ydif;
+
+    av_frame_unref(ctx.previousLuma);
+    // Hết bộ nhớ thì frame sau có YDIF = 0 như frame đầu tiên
+    av_frame_ref(ctx.previousLuma, current);
+    return true;
+}
+
+// Tham số mặc định của cropdetect: 2 frame đầu không có metadata vùng ảnh, ngưỡng đen 24/255.
+// qcli chạy một bộ lọc cho cả file nên chỉ frame 0 và 1 của video thiếu vùng ảnh. Ở đây mỗi luồng/đoạn/cửa sổ có bộ lọc
+// riêng, nên bộ lọc chạy với skip=0 và frame bị bỏ được chọn theo chỉ số tuyệt đối (frameNum < CROPDETECT_SKIP), không
+// theo số frame bộ lọc đã thấy; nếu không đầu mỗi đoạn sẽ mất vùng ảnh và chuỗi viền đen bị cắt ở chỗ nối.
+static constexpr int CROPDETECT_SKIP = 2;
+static constexpr double CROPDETECT_LIMIT = 24.0 / 255.0;
+
+// Tùy chọn skip của cropdetect có từ FFmpeg 5.0; bản cũ hơn vẫn bỏ 2 frame đầu của mỗi bộ lọc
+#define CROPDETECT_HAS_SKIP (LIBAVFILTER_VERSION_INT >= AV_VERSION_INT(8, 0, 100))
+
+// Vùng ảnh của frame vừa ra khỏi bộ lọc như cropdetect=reset=1 (tính lại ở mỗi frame)
+static bool measureBorders(LibavFrameSource::Context &ctx, LumaStats::Borders *borders)
+{
+    const AVFrame *current = ctx.filtered;
+    const int depth = nativeLumaDepth(current->format);
+    if (depth <= 0 || !current->data[0]) return false;
+    *borders = LumaStats::findBorders(lumaPlaneOf(current, depth), CROPDETECT_LIMIT * ((1 << depth) - 1));
+    return true;
+}
+
+static QString avErrorString(int errorCode)
+{
+    char buffer[AV_ERROR_MAX_STRING_SIZE] = {};
+    av_strerror(errorCode, buffer, sizeof(buffer));
+    return QString::fromUtf8(buffer);
+}
+
+// Timestamp keyframe trong chỉ mục của container (MP4/MOV, MXF, cue của MKV...), rỗng nếu không có
+static QVector<qint64> keyframeTimestamps(AVStream *stream)
+{
+    QVector<qint64> keyframes;
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100)
+    const int entries = avformat_index_get_entries_count(stream);
+    keyframes.reserve(entries);
+    for (int i = 0; i < entries; ++i) {
+        const AVIndexEntry *entry = avformat_index_get_entry(stream, i);
+        if (entry && (entry->flags & AVINDEX_KEYFRAME)) keyframes.append(entry->timestamp);
+    }
+    std::sort(keyframes.begin(), keyframes.end());
+#else
+    Q_UNUSED(stream);
+#endif
+    return keyframes;
+}
+
+// Chỉ số frame theo timestamp, làm tròn tới frame gần nhất
+static int frameIndexOf(const LibavFrameSource::Context &ctx, int64_t ts)
+{
+    return int(av_rescale_q_rnd(ts - ctx.streamStartTs, ctx.timeBase, ctx.frameDuration, AV_ROUND_NEAR_INF));
+}
+
+static int64_t timestampOf(const LibavFrameSource::Context &ctx, int frame)
+{
+    return ctx.streamStartTs + av_rescale_q(frame, ctx.frameDuration, ctx.timeBase);
+}
+
+LibavFrameSource::LibavFrameSource(const QString &videoPath, bool signalStats, bool cropDetect, const std::atomic<bool> &stopRequested,
+                                   int queueBatches)
+    : m_videoPath(videoPath), m_signalStats(signalStats), m_cropDetect(cropDetect), m_stopRequested(stopRequested),
+      m_batches(size_t(qMax(2, queueBatches)))
+{
+}
+
+LibavFrameSource::~LibavFrameSource()
+{
+    m_abort.store(true);
+    wait();
+}
+
+QString LibavFrameSource::filterDescription(bool signalStats, bool cropDetect, int scale)
+{
+    // Cùng tham số cropdetect như bộ lọc của QCTools: không làm tròn kích thước, tính lại ở mỗi frame. skip=0: frame
+    // đầu video không có vùng ảnh được bỏ theo frameNum khi đọc kết quả (xem CROPDETECT_SKIP)
+    QStringList filters;
+    if (signalStats) filters << "signalstats";
+#if CROPDETECT_HAS_SKIP
+    if (cropDetect) filters << "cropdetect=reset=1:round=1:skip=0";
+#else
+    if (cropDetect) filters << "cropdetect=reset=1:round=1";
+#endif
+    // area: mỗi điểm ảnh ra là trung bình khối scale x scale, YAVG gần như không đổi và mép viền đen giữ được sắc nét
+    if (scale > 1) filters.prepend(QString("scale=iw/%1:ih/%1:flags=area").arg(scale));
+    if (filters.isEmpty()) return QStringLiteral("null");
+    return filters.join(',');
+}
+
+void LibavFrameSource::start()
+{
+    m_thread.reset(QThread::create([this]() { run(); }));
+    m_thread->start();
+}
+
+bool LibavFrameSource::nextBatch(FrameBatch *batch)
+{
+    return m_batches.pop(*batch, [this]() { return isCancelled(); });
+}
+
+void LibavFrameSource::wait()
+{
+    if (m_thread) m_thread->wait();
+}
+
+QString LibavFrameSource::errorString() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_error;
+}
+
+QString LibavFrameSource::stageReport() const
+{
+    QString report = QString("giải mã chờ tìm lỗi %1 lần (hàng đợi đầy), tìm lỗi chờ giải mã %2 lần")
+                         .arg(m_batches.fullWaits()).arg(m_batches.emptyWaits());
+    if (m_corruptPackets > 0) report += QString(", bỏ qua %1 gói dữ liệu hỏng").arg(m_corruptPackets);
+    if (m_lowres > 0 || m_filterScale > 1) {
+        report += QString(", phân tích ở 1/%1 độ phân giải (lowres của bộ giải mã: 1/%2, bộ lọc scale: 1/%3)")
+                      .arg((1 << m_lowres) * m_filterScale).arg(1 << m_lowres).arg(m_filterScale);
+    }
+    QStringList native;
+    if (m_nativeLuma) native << "YAVG/YDIF thay cho signalstats";
+    if (m_nativeBorders) native << "viền đen thay cho cropdetect";
+    if (!native.isEmpty()) report += QString(", LumaStats (%1) tính %2").arg(LumaStats::isaName(LumaStats::activeIsa()), native.join(" và "));
+    return report;
+}
+
+void LibavFrameSource::fail(const QString &error)
+{
+    {
+        QMutexLocker locker(&m_errorMutex);
+        if (m_error.isEmpty()) m_error = error;
+    }
+    m_abort.store(true);
+}
+
+void LibavFrameSource::failAv(const QString &what, int errorCode)
+{
+    fail(QString("%1: %2").arg(what, avErrorString(errorCode)));
+}
+
+// --- Luồng giải mã ---
+
+void LibavFrameSource::run()
+{
+    Context ctx;
+    if (open(ctx) && openFilterGraph(ctx)) {
+        ctx.batch.videoWidth = m_mediaInfo.width;
+        ctx.batch.videoHeight = m_mediaInfo.height;
+        ctx.batch.frames.reserve(BATCH_FRAMES);
+
+        bool ok = true;
+        while (ok && !ctx.reachedEnd && !isCancelled()) {
+            if (ctx.seekPending) {
+                ok = seekToNextSample(ctx);
+                if (!ok || ctx.reachedEnd) break;
+            }
+            const int ret = av_read_frame(ctx.format, ctx.packet);
+            if (ret == AVERROR_EOF) break;
+            if (ret < 0) {
+                failAv("Lỗi khi đọc file video", ret);
+                ok = false;
+                break;
+            }
+            if (ctx.packet->stream_index == ctx.videoStream) {
+                // Lấy mẫu trên codec chỉ có frame I: gói trước frame cần thì không phải giải mã
+                // Chỉ keyframe: gói không phải keyframe thì không cần đọc vào bộ giải mã
+                const bool skip = (m_sampleStep > 0 && ctx.intraOnly && ctx.packet->pts != AV_NOPTS_VALUE
+                                   && frameIndexOf(ctx, ctx.packet->pts) < m_nextSample - 1)
+                               || (m_keyframesOnly && !(ctx.packet->flags & AV_PKT_FLAG_KEY));
+                if (!skip) ok = decodePacket(ctx, ctx.packet);
+            }
+            av_packet_unref(ctx.packet);
+        }
+
+        // Hết file hoặc hết đoạn: xả bộ giải mã (nếu còn frame thuộc đoạn) rồi bộ lọc
+        if (ok && !isCancelled()) ok = (ctx.reachedEnd || decodePacket(ctx, nullptr)) && filterFrame(ctx, nullptr);
+        if (ok && !ctx.batch.frames.isEmpty() && !isCancelled()) pushBatch(ctx);
+        if (ok && !isCancelled()) m_progress.store(1000, std::memory_order_relaxed);
+    }
+    m_batches.close();
+}
+
+bool LibavFrameSource::open(Context &ctx)
+{
+    // libavformat nhận đường dẫn UTF-8 trên mọi nền tảng
+    const QByteArray path = m_videoPath.toUtf8();
+    int ret = avformat_open_input(&ctx.format, path.constData(), nullptr, nullptr);
+    if (ret < 0) { failAv("Không thể mở file video", ret); return false; }
+    ret = avformat_find_stream_info(ctx.format, nullptr);
+    if (ret < 0) { failAv("Không đọc được thông tin stream", ret); return false; }
+
+    ctx.videoStream = av_find_best_stream(ctx.format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (ctx.videoStream < 0) { fail("Không tìm thấy stream video trong file."); return false; }
+    const AVStream *stream = ctx.format->streams[ctx.videoStream];
+
+    const AVCodec *codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if (!codec) {
+        fail(QString("Không có bộ giải mã cho codec %1.").arg(QString::fromUtf8(avcodec_get_name(stream->codecpar->codec_id))));
+        return false;
+    }
+    ctx.decoder = avcodec_alloc_context3(codec);
+    ctx.packet = av_packet_alloc();
+    ctx.decoded = av_frame_alloc();
+    ctx.filtered = av_frame_alloc();
+    ctx.previousLuma = av_frame_alloc();
+    if (!ctx.decoder || !ctx.packet || !ctx.decoded || !ctx.filtered || !ctx.previousLuma) { fail("Không đủ bộ nhớ để khởi tạo bộ giải mã."); return false; }
+
+    ret = avcodec_parameters_to_context(ctx.decoder, stream->codecpar);
+    if (ret < 0) { failAv("Không khởi tạo được bộ giải mã", ret); return false; }
+    // 0 = bộ giải mã tự chọn số luồng theo số nhân CPU
+    ctx.decoder->thread_count = m_decoderThreads;
+    ctx.decoder->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    ctx.decoder->pkt_timebase = stream->time_base;
+    if (m_keyframesOnly) ctx.decoder->skip_frame = AVDISCARD_NONKEY;
+    // Giảm độ phân giải: frame phân tích không hẹp hơn MIN_ANALYSIS_WIDTH (video SD/HD gần như không được thu nhỏ).
+    // Bộ giải mã tự giảm được (lowres) thì rẻ nhất vì bỏ qua luôn phần biến đổi ngược ở độ phân giải gốc.
+    int downscale = m_downscale;
+    while (downscale > 1 && stream->codecpar->width / downscale < MIN_ANALYSIS_WIDTH) downscale /= 2;
+    m_lowres = 0;
+    while ((2 << m_lowres) <= downscale && m_lowres < codec->max_lowres) ++m_lowres;
+    ctx.decoder->lowres = m_lowres;
+    m_filterScale = qMax(1, downscale >> m_lowres);
+    ret = avcodec_open2(ctx.decoder, codec, nullptr);
+    if (ret < 0) { failAv("Không mở được bộ giải mã", ret); return false; }
+
+    ctx.startTs = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    ctx.streamStartTs = ctx.startTs;
+    ctx.timeBase = stream->time_base;
+    const AVRational frameRate = stream->r_frame_rate.num > 0 ? stream->r_frame_rate : stream->avg_frame_rate;
+    if (frameRate.num > 0 && frameRate.den > 0) ctx.frameDuration = AVRational{ frameRate.den, frameRate.num };
+    if (stream->duration > 0) {
+        ctx.durationTs = stream->duration;
+    } else if (ctx.format->duration > 0) {
+        ctx.durationTs = av_rescale_q(ctx.format->duration, AV_TIME_BASE_Q, stream->time_base);
+    }
+
+    const bool needsFrameRate = m_sampleStep > 0 || m_keyframesOnly || m_rangeEndFrame >= 0;
+    if (needsFrameRate && (ctx.frameDuration.den <= 0 || ctx.frameDuration.num <= 0)) {
+        fail("Không xác định được tốc độ khung hình của video.");
+        return false;
+    }
+    if (m_rangeEndFrame >= 0) {
+        m_rangeStart = m_rangeFirstFrame > 0 ? timestampOf(ctx, m_rangeFirstFrame) : NO_LIMIT_START;
+        m_rangeEnd = timestampOf(ctx, m_rangeEndFrame);
+    }
+    if (m_rangeStart != NO_LIMIT_START) {
+        // Tìm về keyframe trước frame liền trước đoạn: frame đó được giải mã và lọc (để tính YDIF) rồi bỏ đi.
+        // Đoạn bắt đầu đúng tại keyframe (setStartsOnKeyframe()) thì tìm thẳng tới keyframe đó, khỏi giải mã cả GOP trước
+        // chỉ để lấy một frame tham chiếu: YDIF của frame đầu đoạn do đoạn trước đo (endBoundaryYdif())
+        // Chỉ khi codec không đảo thứ tự frame: với GOP mở, các frame B đứng trước keyframe (theo thời gian hiển thị)
+        // nằm sau nó trong file và cần GOP trước để giải mã
+        const AVCodecDescriptor *desc = avcodec_descriptor_get(stream->codecpar->codec_id);
+        m_exactStart = m_startsOnKeyframe && ((desc && (desc->props & AV_CODEC_PROP_INTRA_ONLY)) || stream->codecpar->video_delay == 0);
+        ret = av_seek_frame(ctx.format, ctx.videoStream, m_exactStart ? m_rangeStart : m_rangeStart - 1, AVSEEK_FLAG_BACKWARD);
+        if (ret < 0) { failAv("Không tìm được tới đầu đoạn video", ret); return false; }
+        ctx.startTs = m_rangeStart;
+    }
+    // Tiến độ tính trên đoạn thực sự giải mã: điểm ra có thể để mở (tới hết file) hoặc vượt quá cuối file
+    const int64_t fileEndTs = ctx.durationTs > 0 ? ctx.streamStartTs + ctx.durationTs : int64_t(NO_LIMIT_END);
+    const int64_t endTs = qMin<int64_t>(m_rangeEnd, fileEndTs);
+    if (endTs != NO_LIMIT_END && endTs > ctx.startTs) ctx.durationTs = endTs - ctx.startTs;
+
+    if (m_sampleStep > 0) {
+        const AVCodecDescriptor *desc = avcodec_descriptor_get(stream->codecpar->codec_id);
+        ctx.intraOnly = desc && (desc->props & AV_CODEC_PROP_INTRA_ONLY);
+        ctx.keyframes = keyframeTimestamps(ctx.format->streams[ctx.videoStream]);
+    }
+
+    readMediaInfo(ctx);
+    return true;
+}
+
+bool LibavFrameSource::seekToNextSample(Context &ctx)
+{
+    ctx.seekPending = false;
+    // Frame liền trước mẫu được giải mã cùng để tính YDIF
+    const int64_t target = timestampOf(ctx, qMax(0, m_nextSample - 1));
+    if (ctx.durationTs > 0 && target >= ctx.streamStartTs + ctx.durationTs) {
+        ctx.reachedEnd = true;
+        return true;
+    }
+    // Chỉ tìm khi có keyframe nằm giữa vị trí hiện tại và frame cần, và đủ xa để đáng tìm;
+    // ngược lại giải mã tiếp (frame không cần được bỏ trước bộ lọc) còn rẻ hơn
+    if (ctx.lastTs != AV_NOPTS_VALUE && frameIndexOf(ctx, target) - frameIndexOf(ctx, ctx.lastTs) <= MIN_SEEK_FRAMES) return true;
+    const auto next = std::upper_bound(ctx.keyframes.cbegin(), ctx.keyframes.cend(), ctx.lastTs == AV_NOPTS_VALUE ? ctx.streamStartTs : ctx.lastTs);
+    if (next == ctx.keyframes.cend() || *next > target) return true;
+
+    if (av_seek_frame(ctx.format, ctx.videoStream, target, AVSEEK_FLAG_BACKWARD) >= 0) {
+        avcodec_flush_buffers(ctx.decoder);
+    }
+    // Không tìm được thì giải mã tiếp từ vị trí hiện tại, kết quả vẫn đúng
+    return true;
+}
+
+// Cùng các trường mà báo cáo QCTools ghi trong <format>/<stream> (theo ffprobe), từ AVFormatContext đã mở
+// (chỉ header, hoặc thêm avformat_find_stream_info)
+static void fillMediaInfo(const AVFormatContext *format, int videoStream, MediaInfo *info, int *nbFrames)
+{
+    info->formatName = QString::fromUtf8(format->iformat->long_name ? format->iformat->long_name : format->iformat->name);
+    if (format->duration != AV_NOPTS_VALUE) info->duration = format->duration / double(AV_TIME_BASE);
+    if (format->pb) info->size = avio_size(format->pb);
+    info->bitrate = format->bit_rate;
+    if (const AVDictionaryEntry *tag = av_dict_get(format->metadata, "creation_time", nullptr, 0)) {
+        info->creationTime = QDateTime::fromString(QString::fromUtf8(tag->value), Qt::ISODateWithMs);
+    }
+
+    const AVStream *video = format->streams[videoStream];
+    const AVCodecParameters *vpar = video->codecpar;
+    const AVRational frameRate = video->r_frame_rate.num > 0 ? video->r_frame_rate : video->avg_frame_rate;
+    info->frameRate.num = frameRate.num;
+    info->frameRate.den = frameRate.den;
+    info->fps = info->frameRate.toDouble();
+    info->width = vpar->width;
+    info->height = vpar->height;
+    if (video->nb_frames > 0) *nbFrames = int(video->nb_frames);
+    if (const AVCodecDescriptor *desc = avcodec_descriptor_get(vpar->codec_id)) info->videoCodec = QString::fromUtf8(desc->long_name);
+    if (const char *pixFmt = av_get_pix_fmt_name(AVPixelFormat(vpar->format))) info->pixelFormat = QString::fromUtf8(pixFmt);
+    if (const char *space = av_color_space_name(vpar->color_space)) info->colorSpace = QString::fromUtf8(space);
+
+    const int audioIndex = av_find_best_stream(const_cast<AVFormatContext*>(format), AVMEDIA_TYPE_AUDIO, -1, videoStream, nullptr, 0);
+    if (audioIndex >= 0) {
+        const AVCodecParameters *apar = format->streams[audioIndex]->codecpar;
+        if (const AVCodecDescriptor *desc = avcodec_descriptor_get(apar->codec_id)) info->audioCodec = QString::fromUtf8(desc->long_name);
+        info->sampleRate = apar->sample_rate;
+        char layout[128] = {};
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100)
+        if (av_channel_layout_describe(&apar->ch_layout, layout, sizeof(layout)) > 0) info->channelLayout = QString::fromUtf8(layout);
+#else
+        av_get_channel_layout_string(layout, sizeof(layout), apar->channels, apar->channel_layout);
+        info->channelLayout = QString::fromUtf8(layout);
+#endif
+    }
+}
+
+void LibavFrameSource::readMediaInfo(const Context &ctx)
+{
+    fillMediaInfo(ctx.format, ctx.videoStream, &m_mediaInfo, &m_nbFrames);
+}
+
+
+bool LibavFrameSource::openFilterGraph(Context &ctx)
+{
+    const AVStream *stream = ctx.format->streams[ctx.videoStream];
+    if (ctx.decoder->pix_fmt == AV_PIX_FMT_NONE || ctx.decoder->width <= 0 || ctx.decoder->height <= 0) {
+        fail("Không xác định được định dạng điểm ảnh hoặc kích thước của stream video.");
+        return false;
+    }
+
+    ctx.graph = avfilter_graph_alloc();
+    if (!ctx.graph) { fail("Không đủ bộ nhớ để tạo bộ lọc."); return false; }
+
+    const AVRational sar = ctx.decoder->sample_aspect_ratio;
+    const QByteArray sourceArgs = QString("video_size=%1x%2:pix_fmt=%3:time_base=%4/%5:pixel_aspect=%6/%7")
+                                      .arg(ctx.decoder->width).arg(ctx.decoder->height).arg(int(ctx.decoder->pix_fmt))
+                                      .arg(stream->time_base.num).arg(stream->time_base.den)
+                                      .arg(sar.num).arg(sar.den > 0 ? sar.den : 1).toLatin1();
+    int ret = avfilter_graph_create_filter(&ctx.bufferSource, avfilter_get_by_name("buffer"), "in", sourceArgs.constData(), nullptr, ctx.graph);
+    if (ret >= 0) ret = avfilter_graph_create_filter(&ctx.bufferSink, avfilter_get_by_name("buffersink"), "out", nullptr, nullptr, ctx.graph);
+    if (ret < 0) { failAv("Không tạo được bộ lọc", ret); return false; }
+
+    AVFilterInOut *outputs = avfilter_inout_alloc();
+    AVFilterInOut *inputs = avfilter_inout_alloc();
+    if (!outputs || !inputs) {
+        avfilter_inout_free(&outputs);
+        avfilter_inout_free(&inputs);
+        fail("Không đủ bộ nhớ để tạo bộ lọc.");
+        return false;
+    }
+    outputs->name = av_strdup("in");
+    outputs->filter_ctx = ctx.bufferSource;
+    outputs->pad_idx = 0;
+    outputs->next = nullptr;
+    inputs->name = av_strdup("out");
+    inputs->filter_ctx = ctx.bufferSink;
+    inputs->pad_idx = 0;
+    inputs->next = nullptr;
+
+    // YAVG/YDIF và viền đen tự tính bằng LumaStats khi đọc thẳng được mặt phẳng Y: signalstats còn tính cả U/V,
+    // độ bão hòa, sắc độ... mà ta không dùng; cropdetect cộng hết mọi hàng/cột kể cả khi frame không có viền
+    const int lumaDepth = m_nativeAllowed ? nativeLumaDepth(ctx.decoder->pix_fmt) : 0;
+    ctx.lumaBitDepth = m_signalStats ? lumaDepth : 0;
+    ctx.nativeBorders = m_cropDetect && lumaDepth > 0;
+    m_nativeLuma = ctx.lumaBitDepth > 0;
+    m_nativeBorders = ctx.nativeBorders;
+    const QByteArray description = filterDescription(m_signalStats && !m_nativeLuma, m_cropDetect && !m_nativeBorders, m_filterScale).toLatin1();
+    ret = avfilter_graph_parse_ptr(ctx.graph, description.constData(), &inputs, &outputs, nullptr);
+    if (ret >= 0) ret = avfilter_graph_config(ctx.graph, nullptr);
+    avfilter_inout_free(&inputs);
+    avfilter_inout_free(&outputs);
+    if (ret < 0) { failAv(QString("Không cấu hình được bộ lọc \"%1\"").arg(QString::fromLatin1(description)), ret); return false; }
+    return true;
+}
+
+bool LibavFrameSource::decodePacket(Context &ctx, const AVPacket *packet)
+{
+    int ret = avcodec_send_packet(ctx.decoder, packet);
+    if (ret == AVERROR_INVALIDDATA) {
+        // Gói hỏng: bỏ qua như qcli/ffmpeg, các frame sau vẫn được phân tích
+        ++m_corruptPackets;
+        return true;
+    }
+    if (ret < 0 && ret != AVERROR_EOF) { failAv("Lỗi giải mã video", ret); return false; }
+
+    while (!isCancelled()) {
+        ret = avcodec_receive_frame(ctx.decoder, ctx.decoded);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret == AVERROR_INVALIDDATA) { ++m_corruptPackets; continue; }
+        if (ret < 0) { failAv("Lỗi giải mã video", ret); return false; }
+
+        const int64_t ts = ctx.decoded->best_effort_timestamp;
+        if (ts != AV_NOPTS_VALUE && ts >= m_rangeEnd) {
+            // Frame đã ra theo thứ tự hiển thị nên các frame sau cũng thuộc đoạn kế tiếp. Frame này (frame đầu đoạn kế
+            // tiếp) đã giải mã xong: chỉ lọc thêm để đo YDIF so với frame cuối đoạn, xem endBoundaryYdif()
+            bool ok = true;
+            if (m_endBoundaryYdif < 0) {
+                ctx.decoded->pts = ts;
+                ok = filterFrame(ctx, ctx.decoded);
+            }
+            av_frame_unref(ctx.decoded);
+            ctx.reachedEnd = true;
+            return ok;
+        }
+        ctx.lastTs = ts;
+        if (m_sampleStep > 0 && ts != AV_NOPTS_VALUE && frameIndexOf(ctx, ts) < m_nextSample - 1) {
+            // Không phải mẫu và cũng không phải frame liền trước mẫu
+            av_frame_unref(ctx.decoded);
+            continue;
+        }
+        ctx.decoded->pts = ts;
+        if (ctx.durationTs > 0 && ts != AV_NOPTS_VALUE) {
+            m_progress.store(int(qBound<int64_t>(0, (ts - ctx.startTs) * 1000 / ctx.durationTs, 999)), std::memory_order_relaxed);
+        }
+        const bool ok = filterFrame(ctx, ctx.decoded);
+        av_frame_unref(ctx.decoded);
+        if (!ok) return false;
+    }
+    return false;
+}
+
+bool LibavFrameSource::filterFrame(Context &ctx, AVFrame *decoded)
+{
+    int ret = av_buffersrc_add_frame_flags(ctx.bufferSource, decoded, AV_BUFFERSRC_FLAG_KEEP_REF);
+    if (ret < 0) { failAv("Lỗi khi đưa frame vào bộ lọc", ret); return false; }
+
+    while (!isCancelled()) {
+        ret = av_buffersink_get_frame(ctx.bufferSink, ctx.filtered);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return true;
+        if (ret < 0) { failAv("Lỗi khi lấy frame từ bộ lọc", ret); return false; }
+        // Tính trước mọi lần bỏ frame: frame tham chiếu cũng là frame trước của YDIF
+        FrameData frame;
+        const bool lumaMeasured = ctx.lumaBitDepth > 0 && measureLuma(ctx, &frame);
+        LumaStats::Borders borders;
+        const bool bordersMeasured = ctx.nativeBorders && measureBorders(ctx, &borders);
+        if (ctx.filtered->pts != AV_NOPTS_VALUE && ctx.filtered->pts < m_rangeStart) {
+            // Frame trước đoạn, chỉ được giải mã để làm frame tham chiếu
+            av_frame_unref(ctx.filtered);
+            continue;
+        }
+        if (ctx.filtered->pts != AV_NOPTS_VALUE && ctx.filtered->pts >= m_rangeEnd) {
+            m_endBoundaryYdif = lumaMeasured ? frame.ydif : metadataValue(ctx.filtered->metadata, "lavfi.signalstats.YDIF", -1.0);
+            av_frame_unref(ctx.filtered);
+            continue;
+        }
+
+        // Cùng cách đọc các thẻ lavfi.* như ReportPipeline, chỉ khác là lấy thẳng từ frame
+        const AVDictionary *metadata = ctx.filtered->metadata;
+        if (m_sampleStep > 0) {
+            const int index = ctx.filtered->pts != AV_NOPTS_VALUE ? frameIndexOf(ctx, ctx.filtered->pts) : m_nextSample;
+            if (index < m_nextSample) {
+                // Frame liền trước mẫu, chỉ để tính YDIF
+                av_frame_unref(ctx.filtered);
+                continue;
+            }
+            frame.frameNum = index;
+            m_nextSample = (index / m_sampleStep + 1) * m_sampleStep;
+            ctx.seekPending = true;
+        } else {
+            // Mọi chế độ cùng một cách đánh số: theo timestamp hiển thị, như pkt_pts trong báo cáo qcli khi time_base là
+            // 1/fps, và như GopIndex. Frame không có timestamp hoặc trùng số (VFR) lấy số kế tiếp để frameNum luôn tăng.
+            const int index = ctx.filtered->pts != AV_NOPTS_VALUE ? frameIndexOf(ctx, ctx.filtered->pts) : m_lastFrameNum + 1;
+            frame.frameNum = qMax(index, m_lastFrameNum + 1);
+        }
+        m_lastFrameNum = frame.frameNum;
+        ++m_decodedFrames;
+        if (!lumaMeasured) {
+            frame.yavg = metadataValue(metadata, "lavfi.signalstats.YAVG", frame.yavg);
+            frame.ydif = metadataValue(metadata, "lavfi.signalstats.YDIF", frame.ydif);
+        }
+        int x1 = -1, y1 = -1, x2 = -1, y2 = -1;
+        if (bordersMeasured) {
+            x1 = borders.x1;
+            y1 = borders.y1;
+            x2 = borders.x2;
+            y2 = borders.y2;
+        } else if (!ctx.nativeBorders) {
+            x1 = int(metadataValue(metadata, "lavfi.cropdetect.x1", -1));
+            y1 = int(metadataValue(metadata, "lavfi.cropdetect.y1", -1));
+            x2 = int(metadataValue(metadata, "lavfi.cropdetect.x2", -1));
+            y2 = int(metadataValue(metadata, "lavfi.cropdetect.y2", -1));
+        }
+        // Như qcli: hai frame đầu video không có vùng ảnh, dù đoạn này có bộ lọc riêng bắt đầu từ đâu
+        if (frame.frameNum < CROPDETECT_SKIP) x1 = y1 = x2 = y2 = -1;
+        if (x1 != -1 && y1 != -1 && x2 != -1 && y2 != -1) {
+            // Frame đã thu nhỏ: đổi vùng ảnh [x1, x2] về tọa độ của độ phân giải gốc như báo cáo qcli
+            const int width = ctx.filtered->width, height = ctx.filtered->height;
+            const int fullWidth = m_mediaInfo.width, fullHeight = m_mediaInfo.height;
+            if (width > 0 && height > 0 && fullWidth > 0 && fullHeight > 0 && (width != fullWidth || height != fullHeight)) {
+                frame.crop_x = int(qint64(x1) * fullWidth / width);
+                frame.crop_y = int(qint64(y1) * fullHeight / height);
+                frame.crop_w = int(qint64(x2 + 1) * fullWidth / width) - frame.crop_x;
+                frame.crop_h = int(qint64(y2 + 1) * fullHeight / height) - frame.crop_y;
+            } else {
+                frame.crop_x = x1;
+                frame.crop_y = y1;
+                frame.crop_w = x2 - x1 + 1;
+                frame.crop_h = y2 - y1 + 1;
+            }
+        }
+        av_frame_unref(ctx.filtered);
+
+        ctx.batch.frames.append(frame);
+        if (ctx.batch.frames.size() >= BATCH_FRAMES && !pushBatch(ctx)) return false;
+    }
+    return false;
+}
+
+bool LibavFrameSource::pushBatch(Context &ctx)
+{
+    FrameBatch next;
+    next.videoWidth = ctx.batch.videoWidth;
+    next.videoHeight = ctx.batch.videoHeight;
+    next.frames.reserve(BATCH_FRAMES);
+    const bool pushed = m_batches.push(std::move(ctx.batch), [this]() { return isCancelled(); });
+    ctx.batch = std::move(next);
+    return pushed;
+}
+
+bool LibavFrameSource::planSegments(const QString &videoPath, int segments, QVector<qint64> *boundaries,
+                                    int *framesPerSegment, bool *keyframeAligned, QString *error)
+{
+    boundaries->clear();
+    *keyframeAligned = false;
+    AVFormatContext *format = nullptr;
+    const QByteArray path = videoPath.toUtf8();
+    int ret = avformat_open_input(&format, path.constData(), nullptr, nullptr);
+    if (ret >= 0) ret = avformat_find_stream_info(format, nullptr);
+    const int videoIndex = ret >= 0 ? av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0) : ret;
+    if (videoIndex < 0) {
+        *error = QString("Không đọc được stream video để chia đoạn: %1").arg(avErrorString(videoIndex));
+        avformat_close_input(&format);
+        return false;
+    }
+
+    AVStream *stream = format->streams[videoIndex];
+    const int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    int64_t duration = stream->duration > 0 ? stream->duration : 0;
+    if (duration <= 0 && format->duration > 0) duration = av_rescale_q(format->duration, AV_TIME_BASE_Q, stream->time_base);
+    const double seconds = duration * av_q2d(stream->time_base);
+    if (duration <= 0) {
+        *error = "Không xác định được thời lượng video để chia đoạn.";
+        avformat_close_input(&format);
+        return false;
+    }
+    // Đoạn quá ngắn thì chi phí mở file và tìm keyframe lớn hơn phần việc được chia
+    segments = qMax(1, qMin(segments, int(seconds / MIN_SEGMENT_SECONDS)));
+
+    // Không có chỉ mục keyframe thì chia đều theo thời gian
+    const QVector<qint64> keyframes = keyframeTimestamps(stream);
+    *keyframeAligned = !keyframes.isEmpty();
+
+    for (int k = 1; k < segments; ++k) {
+        qint64 target = start + duration * k / segments;
+        if (!keyframes.isEmpty()) {
+            auto it = std::lower_bound(keyframes.cbegin(), keyframes.cend(), target);
+            if (it == keyframes.cend() || (it != keyframes.cbegin() && target - *(it - 1) < *it - target)) --it;
+            target = *it;
+        }
+        if (target > start && (boundaries->isEmpty() || target > boundaries->last())) boundaries->append(target);
+    }
+
+    const double fps = av_q2d(stream->r_frame_rate);
+    *framesPerSegment = fps > 0 ? int(seconds * fps / (boundaries->size() + 1)) + 1 : 0;
+    avformat_close_input(&format);
+    return true;
+}
+
+double LibavFrameSource::probeFrameRate(const QString &videoPath)
+{
+    AVFormatContext *format = nullptr;
+    const QByteArray path = videoPath.toUtf8();
+    if (avformat_open_input(&format, path.constData(), nullptr, nullptr) < 0) return 0.0;
+    double fps = 0.0;
+    if (avformat_find_stream_info(format, nullptr) >= 0) {
+        const int videoIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+        if (videoIndex >= 0) {
+            const AVStream *stream = format->streams[videoIndex];
+            fps = av_q2d(stream->r_frame_rate.num > 0 ? stream->r_frame_rate : stream->avg_frame_rate);
+        }
+    }
+    avformat_close_input(&format);
+    return fps;
+}
+
+bool LibavFrameSource::probeMediaInfo(const QString &videoPath, MediaInfo *info, int *nbFrames)
+{
+    AVFormatContext *format = nullptr;
+    const QByteArray path = videoPath.toUtf8();
+    if (avformat_open_input(&format, path.constData(), nullptr, nullptr) < 0) return false;
+    int videoIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    // Header của phần lớn container đã có kích thước và tốc độ khung hình; thiếu thì mới phải đọc thử vài gói
+    const AVStream *video = videoIndex >= 0 ? format->streams[videoIndex] : nullptr;
+    if (!video || video->codecpar->width <= 0 || (video->avg_frame_rate.num <= 0 && video->r_frame_rate.num <= 0)) {
+        if (avformat_find_stream_info(format, nullptr) >= 0) videoIndex = av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    }
+    const bool ok = videoIndex >= 0;
+    if (ok) {
+        *info = MediaInfo();
+        *nbFrames = -1;
+        fillMediaInfo(format, videoIndex, info, nbFrames);
+    }
+    avformat_close_input(&format);
+    return ok && info->width > 0 && info->fps > 0;
+}
+
+bool LibavFrameSource::buildGopIndex(const QString &videoPath, GopIndex *index, const std::atomic<bool> &stopRequested,
+                                     const std::function<void(int)> &progress, QString *error)
+{
+    *index = GopIndex();
+    const QFileInfo fileInfo(videoPath);
+    AVFormatContext *format = nullptr;
+    const QByteArray path = videoPath.toUtf8();
+    int ret = avformat_open_input(&format, path.constData(), nullptr, nullptr);
+    if (ret >= 0) ret = avformat_find_stream_info(format, nullptr);
+    const int videoIndex = ret >= 0 ? av_find_best_stream(format, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0) : ret;
+    if (videoIndex < 0) {
+        *error = QString("Không đọc được stream video để lập chỉ mục GOP: %1").arg(avErrorString(videoIndex));
+        avformat_close_input(&format);
+        return false;
+    }
+
+    AVStream *stream = format->streams[videoIndex];
+    const AVRational frameRate = stream->r_frame_rate.num > 0 ? stream->r_frame_rate : stream->avg_frame_rate;
+    if (frameRate.num <= 0 || frameRate.den <= 0) {
+        *error = "Không xác định được tốc độ khung hình của video để lập chỉ mục GOP.";
+        avformat_close_input(&format);
+        return false;
+    }
+    // Chỉ cần gói của stream video: demuxer bỏ qua gói của các stream khác
+    for (unsigned i = 0; i < format->nb_streams; ++i) {
+        if (int(i) != videoIndex) format->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    index->frameRate = FrameRate{ frameRate.num, frameRate.den };
+    index->codec = QString::fromUtf8(avcodec_get_name(stream->codecpar->codec_id));
+    if (stream->codecpar->extradata_size > 0) {
+        index->extradataHash = QCryptographicHash::hash(QByteArray::fromRawData(reinterpret_cast<const char*>(stream->codecpar->extradata),
+                                                                                stream->codecpar->extradata_size),
+                                                        QCryptographicHash::Md5);
+    }
+    index->videoSize = fileInfo.size();
+    index->videoModified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    const int64_t startTs = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    const AVRational frameDuration{ frameRate.den, frameRate.num };
+    const int64_t fileSize = avio_size(format->pb);
+    AVPacket *packet = av_packet_alloc();
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    GopIndex::Gop gop;
+    bool gopOpen = false;
+    int packets = 0;
+    auto closeGop = [&]() {
+        if (!gopOpen) return;
+        gop.hash = hash.result();
+        index->gops.append(gop);
+        hash.reset();
+        gopOpen = false;
+    };
+
+    // GOP theo thứ tự gói: bắt đầu ở mỗi gói keyframe. Frame đầu của GOP là timestamp hiển thị nhỏ nhất trong GOP,
+    // nên các frame B đứng trước keyframe (GOP mở) vẫn thuộc về GOP của chúng.
+    while (packet && !stopRequested.load(std::memory_order_relaxed) && (ret = av_read_frame(format, packet)) >= 0) {
+        if (packet->stream_index == videoIndex) {
+            if ((packet->flags & AV_PKT_FLAG_KEY) || !gopOpen) {
+                closeGop();
+                gop = GopIndex::Gop();
+                gop.firstFrame = std::numeric_limits<int>::max();
+                gopOpen = true;
+            }
+            const int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            const int frame = ts != AV_NOPTS_VALUE
+                                  ? int(av_rescale_q_rnd(ts - startTs, stream->time_base, frameDuration, AV_ROUND_NEAR_INF))
+                                  : packets;
+            gop.firstFrame = qMin(gop.firstFrame, frame);
+            ++gop.frameCount;
+            hash.addData(QByteArray::fromRawData(reinterpret_cast<const char*>(packet->data), packet->size));
+            ++packets;
+            if (progress && fileSize > 0 && packet->pos >= 0 && (packets & 255) == 0) {
+                progress(int(qBound<int64_t>(0, packet->pos * 1000 / fileSize, 999)));
+            }
+        }
+        av_packet_unref(packet);
+    }
+    closeGop();
+    const bool allocated = packet != nullptr;
+    av_packet_free(&packet);
+    avformat_close_input(&format);
+
+    if (stopRequested.load()) return false;
+    if (!allocated) { *error = "Không đủ bộ nhớ để đọc gói video."; return false; }
+    if (ret != AVERROR_EOF) { *error = QString("Lỗi khi đọc gói video: %1").arg(avErrorString(ret)); return false; }
+    if (index->gops.isEmpty()) { *error = "File không có gói video nào."; return false; }
+    return true;
+}
+
+// =============================================================================
+// SegmentedLibavSource
+// =============================================================================
+
+SegmentedLibavSource::SegmentedLibavSource(const QString &videoPath, bool signalStats, bool cropDetect, int segments,
+                                           const std::atomic<bool> &stopRequested)
+    : m_videoPath(videoPath), m_signalStats(signalStats), m_cropDetect(cropDetect),
+      m_requestedSegments(qMax(1, segments)), m_stopRequested(stopRequested)
+{
+}
+
+SegmentedLibavSource::~SegmentedLibavSource()
+{
+    abortAll();
+    wait();
+}
+
+void SegmentedLibavSource::start()
+{
+    QVector<qint64> boundaries;
+    int framesPerSegment = 0;
+    if (!LibavFrameSource::planSegments(m_videoPath, m_requestedSegments, &boundaries, &framesPerSegment, &m_keyframeAligned, &m_error)) return;
+
+    const int count = int(boundaries.size()) + 1;
+    // Mỗi đoạn một phần số nhân CPU, tránh K bộ giải mã cùng tự mở đủ số luồng
+    m_decoderThreads = qMax(1, QThread::idealThreadCount() / count);
+    // Hàng đợi đủ chứa cả đoạn: các đoạn sau giải mã xong trước khi tới lượt mà không phải chờ
+    const int queueBatches = framesPerSegment / LibavFrameSource::BATCH_FRAMES + 2;
+    for (int i = 0; i < count; ++i) {
+        auto worker = std::make_unique<LibavFrameSource>(m_videoPath, m_signalStats, m_cropDetect, m_stopRequested, queueBatches);
+        worker->setRange(i == 0 ? LibavFrameSource::NO_LIMIT_START : boundaries[i - 1],
+                         i == count - 1 ? LibavFrameSource::NO_LIMIT_END : boundaries[i]);
+        worker->setDecoderThreads(m_decoderThreads);
+        worker->setDownscale(m_downscale);
+        worker->setStartsOnKeyframe(i > 0 && m_keyframeAligned);
+        worker->start();
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+bool SegmentedLibavSource::nextBatch(FrameBatch *batch)
+{
+    while (m_current < int(m_workers.size())) {
+        LibavFrameSource &worker = *m_workers[m_current];
+        if (worker.nextBatch(batch)) {
+            if (m_current > 0 && !m_currentStarted && worker.startedExactly() && !batch->frames.isEmpty()) {
+                // Frame đầu đoạn không có frame trước trong lượt giải mã của đoạn này: YDIF do đoạn trước đo
+                const double ydif = m_workers[m_current - 1]->endBoundaryYdif();
+                if (ydif >= 0) batch->frames.first().ydif = ydif;
+                else ++m_unstitchedBoundaries;
+            }
+            m_currentStarted = true;
+            return true;
+        }
+        worker.wait();
+        if (m_stopRequested.load() || !worker.errorString().isEmpty()) {
+            abortAll();
+            return false;
+        }
+        ++m_current;
+        m_currentStarted = false;
+    }
+    return false;
+}
+
+void SegmentedLibavSource::wait()
+{
+    for (auto &worker : m_workers) worker->wait();
+}
+
+void SegmentedLibavSource::abortAll()
+{
+    for (auto &worker : m_workers) worker->abort();
+}
+
+QString SegmentedLibavSource::errorString() const
+{
+    if (!m_error.isEmpty()) return m_error;
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        const QString error = m_workers[i]->errorString();
+        if (!error.isEmpty()) return QString("Đoạn %1/%2: %3").arg(i + 1).arg(m_workers.size()).arg(error);
+    }
+    return QString();
+}
+
+const MediaInfo &SegmentedLibavSource::mediaInfo() const
+{
+    return m_workers.empty() ? m_emptyInfo : m_workers.front()->mediaInfo();
+}
+
+int SegmentedLibavSource::nbFrames() const
+{
+    return m_workers.empty() ? -1 : m_workers.front()->nbFrames();
+}
+
+int SegmentedLibavSource::progressPermille() const
+{
+    if (m_workers.empty()) return -1;
+    int sum = 0;
+    for (const auto &worker : m_workers) sum += qMax(0, worker->progressPermille());
+    return sum / int(m_workers.size());
+}
+
+QString SegmentedLibavSource::stagesDescription() const
+{
+    return QString("chia tối đa %1 đoạn giải mã song song, tìm lỗi theo thứ tự frame").arg(m_requestedSegments);
+}
+
+QString SegmentedLibavSource::stageReport() const
+{
+    return QString("%1 đoạn %2%3, %4 luồng giải mã mỗi đoạn; đoạn đầu: %5")
+        .arg(m_workers.size())
+        .arg(m_keyframeAligned ? "cắt tại keyframe" : "chia đều theo thời gian (không có chỉ mục keyframe)")
+        .arg(m_unstitchedBoundaries > 0 ? QString(", %1 chỗ nối thiếu YDIF").arg(m_unstitchedBoundaries) : QString())
+        .arg(m_decoderThreads)
+        .arg(m_workers.empty() ? QString() : m_workers.front()->stageReport());
+}
@@ -0,0 +1,219 @@
+// src/qctools/LibavFrameSource.h
+#ifndef LIBAVFRAMESOURCE_H
+#define LIBAVFRAMESOURCE_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "core/SpscRingBuffer.h"
+#include "FrameSource.h"
+
+class QThread;
+struct GopIndex;
+struct AVFrame;
+struct AVPacket;
+
+// CẢI TIẾN: Bộ máy phân tích trong tiến trình (chỉ có khi build với VIDEOQC_WITH_LIBAV).
+// Giải mã video bằng libavformat/libavcodec, chạy cùng bộ lọc signalstats/cropdetect như qcli qua libavfilter
+// và đọc thẳng metadata lavfi.* của từng frame vào FrameData: không tạo tiến trình qcli, không ghi rồi đọc lại XML.
+// Với định dạng điểm ảnh có mặt phẳng Y đọc thẳng được (yuv4xxp, nv12, gray... 8-16 bit), YAVG/YDIF và viền đen do
+// LumaStats tính ngay trên frame thay cho signalstats/cropdetect, cùng định nghĩa nên kết quả như nhau.
+//   [giải mã + bộ lọc: một luồng, bộ giải mã tự chia luồng] --lô frame--> [tìm lỗi: luồng gọi nextBatch()]
+// Số frame tính từ timestamp hiển thị và tốc độ khung hình danh định ở mọi chế độ (cả file, đoạn, lấy mẫu, keyframe),
+// nên trùng với pkt_pts của báo cáo qcli khi time_base của stream là 1/fps (kiểm tra bằng VideoQC_EngineParity).
+class LibavFrameSource : public FrameSource
+{
+public:
+    static constexpr int BATCH_FRAMES = 4096;
+    static constexpr int BATCH_QUEUE = 8;
+    static constexpr qint64 NO_LIMIT_START = std::numeric_limits<qint64>::min();
+    static constexpr qint64 NO_LIMIT_END = std::numeric_limits<qint64>::max();
+
+    LibavFrameSource(const QString& videoPath, bool signalStats, bool cropDetect, const std::atomic<bool>& stopRequested,
+                     int queueBatches = BATCH_QUEUE);
+    ~LibavFrameSource() override;
+
+    // Gọi trước start(). Chỉ giao các frame có timestamp (theo time_base của stream video) trong [startTs, endTs).
+    // Giải mã bắt đầu từ keyframe trước startTs nên frame đầu đoạn vẫn có YDIF so với frame liền trước nó.
+    void setRange(qint64 startTs, qint64 endTs) { m_rangeStart = startTs; m_rangeEnd = endTs; }
+    // Như setRange() nhưng theo số frame [first, end) tính từ tốc độ khung hình danh định; frameNum giữ nguyên số frame
+    // trong file (không đánh lại từ 0). Đổi ra timestamp khi mở file.
+    void setFrameRange(int first, int end) { m_rangeFirstFrame = first; m_rangeEndFrame = end; m_lastFrameNum = qMax(0, first) - 1; }
+    // Gọi trước start(). Chỉ giao frame 0, N, 2N... (frameNum theo timestamp); frame liền trước mỗi mẫu cũng được
+    // lọc để YDIF của mẫu đúng. Tìm tới mẫu kế tiếp khi giữa hai mẫu có keyframe; codec chỉ có frame I thì bỏ qua
+    // luôn các gói không cần mà không giải mã.
+    void setSampling(int everyNthFrame) { m_sampleStep = qMax(0, everyNthFrame); }
+    // Gọi trước start(). Chỉ giải mã keyframe (bộ giải mã bỏ qua frame không phải keyframe, gói không phải keyframe
+    // bị bỏ trước khi giải mã); frameNum theo timestamp. YDIF so với keyframe trước nên không có ý nghĩa.
+    void setKeyframesOnly(bool enabled) { m_keyframesOnly = enabled; }
+    // Gọi trước start(). Phân tích frame đã giảm độ phân giải 1/factor (1, 2 hoặc 4): dùng chế độ lowres của bộ giải mã
+    // nếu codec hỗ trợ, phần còn lại thu nhỏ bằng bộ lọc scale kiểu area (trung bình khối). Vùng ảnh của cropdetect được
+    // đổi lại về tọa độ gốc. Hệ số được giảm dần để frame phân tích còn rộng ít nhất MIN_ANALYSIS_WIDTH.
+    void setDownscale(int factor) { m_downscale = qMax(1, factor); }
+    // Gọi trước start(). false: luôn dùng bộ lọc signalstats/cropdetect như qcli, kể cả khi LumaStats đọc thẳng được
+    // mặt phẳng Y (để so hai cách tính, hoặc để số liệu cùng nguồn với một báo cáo qcli)
+    void setNativeMetrics(bool enabled) { m_nativeAllowed = enabled; }
+    // LumaStats đã thay signalstats / cropdetect; đọc được sau khi nhận lô frame đầu tiên
+    bool nativeLuma() const { return m_nativeLuma; }
+    bool nativeBorders() const { return m_nativeBorders; }
+    // Gọi trước start() cùng setRange(): startTs là một keyframe (planSegments() có chỉ mục keyframe). Tìm thẳng tới
+    // keyframe đó thay vì tới keyframe trước frame liền trước đoạn, nên không phải giải mã thêm một GOP; frame đầu đoạn
+    // khi đó không có frame trước để tính YDIF, người gọi lấy từ endBoundaryYdif() của đoạn trước.
+    // Bỏ qua với codec có đảo thứ tự frame (frame B), khi đó vẫn giải mã từ keyframe trước như thường.
+    void setStartsOnKeyframe(bool enabled) { m_startsOnKeyframe = enabled; }
+    // setStartsOnKeyframe() đã được áp dụng; đọc được sau khi nhận lô frame đầu tiên
+    bool startedExactly() const { return m_exactStart; }
+    // YDIF của frame đầu tiên sau cuối đoạn (so với frame cuối đoạn), đo khi bộ giải mã trả frame đó ra để biết đã hết
+    // đoạn; âm nếu chưa đo (hết file trước, hoặc không có YDIF). Chỉ đọc sau wait().
+    double endBoundaryYdif() const { return m_endBoundaryYdif; }
+    // 0 = bộ giải mã tự chọn theo số nhân CPU
+    void setDecoderThreads(int threads) { m_decoderThreads = threads; }
+    // Dừng luồng giải mã (ví dụ khi một đoạn khác đã lỗi)
+    void abort() { m_abort.store(true); }
+    int deliveredFrames() const { return m_decodedFrames; }
+
+    void start() override;
+    bool nextBatch(FrameBatch* batch) override;
+    void wait() override;
+
+    QString errorString() const override;
+    const MediaInfo& mediaInfo() const override { return m_mediaInfo; }
+    int nbFrames() const override { return m_nbFrames; }
+    // Theo thời điểm của frame vừa giải mã so với thời lượng file
+    int progressPermille() const override { return m_progress.load(std::memory_order_relaxed); }
+    QString sourceName() const override { return QStringLiteral("video"); }
+    QString stagesDescription() const override { return QStringLiteral("giải mã, chạy bộ lọc và tìm lỗi song song, không qua qcli"); }
+    QString stageReport() const override;
+    // Có setFrameRange(): chỉ một đoạn của file, số frame không bắt đầu từ 0
+    bool contiguousFrames() const override { return m_rangeEndFrame < 0; }
+
+    // Chuỗi bộ lọc libavfilter tương ứng với các bộ lọc qcli được bật, thu nhỏ 1/scale trước đó nếu scale > 1
+    static QString filterDescription(bool signalStats, bool cropDetect, int scale = 1);
+
+    static constexpr int MIN_ANALYSIS_WIDTH = 960;
+
+    // Chia video thành tối đa `segments` đoạn (mỗi đoạn ít nhất MIN_SEGMENT_SECONDS giây). `boundaries` nhận timestamp
+    // bắt đầu của đoạn 2..K, đặt tại keyframe gần nhất khi container có chỉ mục keyframe (`keyframeAligned`).
+    static constexpr double MIN_SEGMENT_SECONDS = 30.0;
+    static bool planSegments(const QString& videoPath, int segments, QVector<qint64>* boundaries,
+                             int* framesPerSegment, bool* keyframeAligned, QString* error);
+    // Tốc độ khung hình danh định của stream video, chỉ đọc header; 0 nếu không đọc được
+    static double probeFrameRate(const QString& videoPath);
+    // MediaInfo và số frame (-1 nếu header không ghi) chỉ từ header của container, dùng khi MediaProbe không tự đọc được
+    static bool probeMediaInfo(const QString& videoPath, MediaInfo* info, int* nbFrames);
+    // Lập chỉ mục GOP (core/GopIndex.h) chỉ bằng cách đọc gói của stream video, không giải mã.
+    // `progress` (có thể rỗng) nhận tiến độ 0..1000 theo vị trí trong file.
+    static bool buildGopIndex(const QString& videoPath, GopIndex* index, const std::atomic<bool>& stopRequested,
+                              const std::function<void(int)>& progress, QString* error);
+
+    // Các đối tượng libav của một lần giải mã, chỉ định nghĩa trong .cpp
+    struct Context;
+
+private:
+    // Lấy mẫu: mẫu kế tiếp cách frame vừa giải mã không quá từng này frame thì giải mã tiếp thay vì tìm
+    static constexpr int MIN_SEEK_FRAMES = 8;
+
+    void run();
+    bool open(Context& ctx);
+    bool seekToNextSample(Context& ctx);
+    void readMediaInfo(const Context& ctx);
+    bool openFilterGraph(Context& ctx);
+    // packet = nullptr: xả các frame còn trong bộ giải mã
+    bool decodePacket(Context& ctx, const AVPacket* packet);
+    // Đưa một frame đã giải mã (hoặc nullptr để xả) qua bộ lọc và gom các frame đầu ra vào lô
+    bool filterFrame(Context& ctx, AVFrame* decoded);
+    bool pushBatch(Context& ctx);
+    bool isCancelled() const { return m_abort.load(std::memory_order_relaxed) || m_stopRequested.load(std::memory_order_relaxed); }
+    void fail(const QString& error);
+    void failAv(const QString& what, int errorCode);
+
+    const QString m_videoPath;
+    const bool m_signalStats;
+    const bool m_cropDetect;
+    const std::atomic<bool>& m_stopRequested;
+    std::atomic<bool> m_abort{false};
+    std::atomic<int> m_progress{-1};
+    qint64 m_rangeStart = NO_LIMIT_START;
+    qint64 m_rangeEnd = NO_LIMIT_END;
+    int m_decoderThreads = 0;
+    int m_downscale = 1;
+    int m_lowres = 0;           // Mức lowres đã đặt cho bộ giải mã (mỗi mức chia đôi mỗi chiều)
+    int m_filterScale = 1;      // Phần thu nhỏ còn lại do bộ lọc scale làm
+    bool m_nativeAllowed = true;
+    bool m_nativeLuma = false;  // YAVG/YDIF do LumaStats tính thay cho signalstats
+    bool m_nativeBorders = false;   // Viền đen do LumaStats tính thay cho cropdetect
+    int m_rangeFirstFrame = -1;
+    int m_rangeEndFrame = -1;
+    int m_sampleStep = 0;
+    int m_nextSample = 0;
+    bool m_keyframesOnly = false;
+    bool m_startsOnKeyframe = false;
+    bool m_exactStart = false;
+    double m_endBoundaryYdif = -1.0;
+
+    SpscRingBuffer<FrameBatch> m_batches;
+    std::unique_ptr<QThread> m_thread;
+
+    mutable QMutex m_errorMutex;
+    QString m_error;
+    // Chỉ luồng giải mã ghi, trước frame đầu tiên
+    MediaInfo m_mediaInfo;
+    int m_nbFrames = -1;
+    int m_decodedFrames = 0;
+    int m_lastFrameNum = -1;    // frameNum của frame vừa giao; trước frame đầu: frame đầu đoạn - 1
+    int m_corruptPackets = 0;
+};
+
+// CẢI TIẾN: Phân tích song song theo đoạn cho video dài: mỗi đoạn một LibavFrameSource giải mã trên luồng riêng,
+// các đoạn chạy cùng lúc và đổ frame vào hàng đợi riêng của mình. nextBatch() giao frame theo đúng thứ tự
+// (hết đoạn 1 mới tới đoạn 2); frameNum theo timestamp nên đã là số frame trong cả file, luồng tìm lỗi
+// nhận đúng chuỗi frame như khi giải mã một lượt: frame đen, viền đen và cảnh cắt nằm vắt qua ranh giới
+// hai đoạn được xử lý như mọi chỗ khác.
+class SegmentedLibavSource : public FrameSource
+{
+public:
+    SegmentedLibavSource(const QString& videoPath, bool signalStats, bool cropDetect, int segments,
+                         const std::atomic<bool>& stopRequested);
+    ~SegmentedLibavSource() override;
+
+    // Gọi trước start(), áp dụng cho mọi đoạn (xem LibavFrameSource::setDownscale())
+    void setDownscale(int factor) { m_downscale = factor; }
+
+    void start() override;
+    bool nextBatch(FrameBatch* batch) override;
+    void wait() override;
+
+    QString errorString() const override;
+    const MediaInfo& mediaInfo() const override;
+    int nbFrames() const override;
+    int progressPermille() const override;
+    QString sourceName() const override { return QStringLiteral("video"); }
+    QString stagesDescription() const override;
+    QString stageReport() const override;
+
+private:
+    void abortAll();
+
+    const QString m_videoPath;
+    const bool m_signalStats;
+    const bool m_cropDetect;
+    const int m_requestedSegments;
+    const std::atomic<bool>& m_stopRequested;
+
+    std::vector<std::unique_ptr<LibavFrameSource>> m_workers;
+    bool m_keyframeAligned = false;
+    int m_downscale = 1;
+    int m_decoderThreads = 1;
+    int m_current = 0;          // Đoạn đang giao frame
+    bool m_currentStarted = false;  // Đã giao lô đầu của đoạn đang giao
+    int m_unstitchedBoundaries = 0; // Chỗ nối mà đoạn trước không đo được YDIF của frame đầu đoạn sau
+    QString m_error;
+    MediaInfo m_emptyInfo;
+};
+
+#endif // LIBAVFRAMESOURCE_H
@@ -0,0 +1,479 @@
+// src/qctools/MediaProbe.cpp
+#include "MediaProbe.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QTimeZone>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#ifdef VIDEOQC_HAVE_LIBAV
+#include "LibavFrameSource.h"
+#endif
+
+namespace {
+
+// =============================================================================
+// MP4 / MOV (ISO base media file format, QuickTime)
+// =============================================================================
+
+constexpr quint32 fourcc(const char (&text)[5])
+{
+    return quint32(uchar(text[0])) << 24 | quint32(uchar(text[1])) << 16 | quint32(uchar(text[2])) << 8 | quint32(uchar(text[3]));
+}
+
+quint32 be32(const QByteArray &data, int offset)
+{
+    return offset + 4 <= data.size() ? qFromBigEndian<quint32>(data.constData() + offset) : 0;
+}
+
+quint64 be64(const QByteArray &data, int offset)
+{
+    return offset + 8 <= data.size() ? qFromBigEndian<quint64>(data.constData() + offset) : 0;
+}
+
+quint16 be16(const QByteArray &data, int offset)
+{
+    return offset + 2 <= data.size() ? qFromBigEndian<quint16>(data.constData() + offset) : 0;
+}
+
+struct Box {
+    quint32 type = 0;
+    qint64 payload = 0;     // Vị trí dữ liệu ngay sau header
+    qint64 end = 0;
+};
+
+// Header của box tại `pos`, không vượt quá `limit` (cuối box cha hoặc cuối file)
+bool readBox(QFile &file, qint64 pos, qint64 limit, Box *box)
+{
+    uchar header[16];
+    if (pos + 8 > limit || !file.seek(pos) || file.read(reinterpret_cast<char*>(header), 8) != 8) return false;
+    quint64 size = qFromBigEndian<quint32>(header);
+    box->type = qFromBigEndian<quint32>(header + 4);
+    qint64 headerSize = 8;
+    if (size == 1) {
+        if (file.read(reinterpret_cast<char*>(header + 8), 8) != 8) return false;
+        size = qFromBigEndian<quint64>(header + 8);
+        headerSize = 16;
+    } else if (size == 0) {
+        size = quint64(limit - pos);    // Box kéo tới hết phần chứa nó
+    }
+    if (size < quint64(headerSize) || size > quint64(limit - pos)) return false;
+    box->payload = pos + headerSize;
+    box->end = pos + qint64(size);
+    return true;
+}
+
+bool findChild(QFile &file, const Box &parent, quint32 type, Box *child)
+{
+    for (qint64 pos = parent.payload; pos < parent.end; pos = child->end) {
+        if (!readBox(file, pos, parent.end, child)) return false;
+        if (child->type == type) return true;
+    }
+    return false;
+}
+
+bool findPath(QFile &file, const Box &root, std::initializer_list<quint32> path, Box *found)
+{
+    Box current = root;
+    for (quint32 type : path) {
+        Box child;
+        if (!findChild(file, current, type, &child)) return false;
+        current = child;
+    }
+    *found = current;
+    return true;
+}
+
+// Chỉ đọc phần đầu của box lá cần dùng, không đọc cả bảng mẫu
+QByteArray readPayload(QFile &file, const Box &box, qint64 maxBytes)
+{
+    if (!file.seek(box.payload)) return QByteArray();
+    return file.read(qMin(box.end - box.payload, maxBytes));
+}
+
+struct IsoTrack {
+    quint32 handler = 0;
+    quint32 timescale = 0;
+    quint64 duration = 0;
+    quint32 codec = 0;
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    int sampleRate = 0;
+    quint32 sampleCount = 0;
+    quint32 sttsEntries = 0;
+    quint32 firstDelta = 0;
+};
+
+bool readTrack(QFile &file, const Box &trak, IsoTrack *track)
+{
+    Box mdia, box;
+    if (!findChild(file, trak, fourcc("mdia"), &mdia)) return false;
+
+    if (findChild(file, mdia, fourcc("mdhd"), &box)) {
+        const QByteArray d = readPayload(file, box, 32);
+        const bool v1 = !d.isEmpty() && d.at(0) == 1;
+        track->timescale = be32(d, v1 ? 20 : 12);
+        track->duration = v1 ? be64(d, 24) : be32(d, 16);
+    }
+    if (findChild(file, mdia, fourcc("hdlr"), &box)) track->handler = be32(readPayload(file, box, 12), 8);
+
+    Box stbl;
+    if (!findPath(file, mdia, { fourcc("minf"), fourcc("stbl") }, &stbl)) return true;
+    if (findChild(file, stbl, fourcc("stsd"), &box)) {
+        // version/flags, số mục, rồi mục đầu tiên: size, kiểu (fourcc codec), 6 byte dự trữ, data_reference_index
+        const QByteArray d = readPayload(file, box, 48);
+        const int entry = 8;
+        track->codec = be32(d, entry + 4);
+        if (track->handler == fourcc("vide")) {
+            track->width = be16(d, entry + 32);
+            track->height = be16(d, entry + 34);
+        } else if (track->handler == fourcc("soun")) {
+            track->channels = be16(d, entry + 24);
+            // 16.16; QuickTime sound v2 ghi 1.0 ở đây và tần số thật ở chỗ khác
+            const int rate = be16(d, entry + 32);
+            track->sampleRate = rate > 1 ? rate : 0;
+        }
+    }
+    if (findChild(file, stbl, fourcc("stts"), &box)) {
+        const QByteArray d = readPayload(file, box, 16);
+        track->sttsEntries = be32(d, 4);
+        track->firstDelta = be32(d, 12);
+    }
+    if (findChild(file, stbl, fourcc("stsz"), &box)) track->sampleCount = be32(readPayload(file, box, 12), 8);
+    return true;
+}
+
+QString isoCodecName(quint32 codec)
+{
+    switch (codec) {
+    case fourcc("avc1"): case fourcc("avc3"): return QStringLiteral("H.264 / AVC / MPEG-4 AVC / MPEG-4 part 10");
+    case fourcc("hvc1"): case fourcc("hev1"): return QStringLiteral("H.265 / HEVC (High Efficiency Video Coding)");
+    case fourcc("apch"): case fourcc("apcn"): case fourcc("apcs"): case fourcc("apco"):
+    case fourcc("ap4h"): case fourcc("ap4x"): return QStringLiteral("Apple ProRes (iCodec Pro)");
+    case fourcc("mp4v"): return QStringLiteral("MPEG-4 part 2");
+    case fourcc("av01"): return QStringLiteral("Alliance for Open Media AV1");
+    case fourcc("vp09"): return QStringLiteral("Google VP9");
+    case fourcc("mp4a"): return QStringLiteral("AAC (Advanced Audio Coding)");
+    case fourcc("ac-3"): return QStringLiteral("ATSC A/52A (AC-3)");
+    case fourcc("Opus"): return QStringLiteral("Opus (Opus Interactive Audio Codec)");
+    case fourcc("lpcm"): case fourcc("sowt"): case fourcc("twos"): case fourcc("in24"): return QStringLiteral("PCM");
+    default: break;
+    }
+    QByteArray text(4, '\0');
+    qToBigEndian<quint32>(codec, text.data());
+    return QString::fromLatin1(text).trimmed();
+}
+
+bool isIsoTopLevel(quint32 type)
+{
+    switch (type) {
+    case fourcc("ftyp"): case fourcc("moov"): case fourcc("mdat"): case fourcc("free"):
+    case fourcc("skip"): case fourcc("wide"): case fourcc("pnot"):
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString channelLayoutName(int channels)
+{
+    if (channels == 1) return QStringLiteral("mono");
+    if (channels == 2) return QStringLiteral("stereo");
+    return channels > 0 ? QString("%1 channels").arg(channels) : QString();
+}
+
+// =============================================================================
+// Matroska / WebM (EBML)
+// =============================================================================
+
+// Đủ cho header, Info và Tracks của mọi file thường gặp; Tracks nằm sau đó thì để libavformat đọc
+constexpr qint64 MATROSKA_HEAD_BYTES = 1024 * 1024;
+
+struct Element {
+    quint32 id = 0;
+    qint64 payload = 0;
+    qint64 end = 0;
+};
+
+// Số nguyên độ dài thay đổi của EBML; ID giữ bit đánh dấu độ dài, kích thước thì bỏ
+bool readVint(const QByteArray &data, qint64 *pos, bool keepMarker, quint64 *value, bool *unknown)
+{
+    if (*pos >= data.size()) return false;
+    const uchar first = uchar(data.at(*pos));
+    int length = 1;
+    uchar mask = 0x80;
+    while (length <= 8 && !(first & mask)) { mask >>= 1; ++length; }
+    if (length > 8 || *pos + length > data.size()) return false;
+    quint64 v = keepMarker ? first : (first & (mask - 1));
+    bool allOnes = (first & (mask - 1)) == (mask - 1);
+    for (int i = 1; i < length; ++i) {
+        const uchar byte = uchar(data.at(*pos + i));
+        v = (v << 8) | byte;
+        allOnes = allOnes && byte == 0xFF;
+    }
+    *pos += length;
+    *value = v;
+    if (unknown) *unknown = allOnes;
+    return true;
+}
+
+// Phần tử tại `pos` trong [.., limit); kích thước không biết hoặc vượt quá phần đã đọc được cắt tại limit
+bool readElement(const QByteArray &data, qint64 pos, qint64 limit, Element *element)
+{
+    quint64 id = 0, size = 0;
+    bool unknown = false;
+    if (!readVint(data, &pos, true, &id, nullptr) || !readVint(data, &pos, false, &size, &unknown)) return false;
+    if (pos > limit) return false;
+    element->id = quint32(id);
+    element->payload = pos;
+    element->end = (unknown || size > quint64(limit - pos)) ? limit : pos + qint64(size);
+    return true;
+}
+
+quint64 ebmlUInt(const QByteArray &data, const Element &e)
+{
+    quint64 value = 0;
+    for (qint64 i = e.payload; i < e.end && i < e.payload + 8; ++i) value = (value << 8) | uchar(data.at(i));
+    return value;
+}
+
+double ebmlFloat(const QByteArray &data, const Element &e)
+{
+    const qint64 size = e.end - e.payload;
+    if (size == 4) {
+        const quint32 bits = qFromBigEndian<quint32>(data.constData() + e.payload);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    if (size == 8) {
+        const quint64 bits = qFromBigEndian<quint64>(data.constData() + e.payload);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    return 0.0;
+}
+
+QString matroskaCodecName(const QByteArray &codecId)
+{
+    static const QList<QPair<const char*, const char*>> names = {
+        { "V_MPEG4/ISO/AVC", "H.264 / AVC / MPEG-4 AVC / MPEG-4 part 10" },
+        { "V_MPEGH/ISO/HEVC", "H.265 / HEVC (High Efficiency Video Coding)" },
+        { "V_PRORES", "Apple ProRes (iCodec Pro)" },
+        { "V_FFV1", "FFmpeg video codec #1" },
+        { "V_MPEG2", "MPEG-2 video" },
+        { "V_VP8", "On2 VP8" },
+        { "V_VP9", "Google VP9" },
+        { "V_AV1", "Alliance for Open Media AV1" },
+        { "A_AAC", "AAC (Advanced Audio Coding)" },
+        { "A_AC3", "ATSC A/52A (AC-3)" },
+        { "A_OPUS", "Opus (Opus Interactive Audio Codec)" },
+        { "A_FLAC", "FLAC (Free Lossless Audio Codec)" },
+        { "A_PCM", "PCM" },
+        { "A_MPEG/L3", "MP3 (MPEG audio layer 3)" },
+    };
+    for (const auto &name : names) {
+        if (codecId.startsWith(name.first)) return QString::fromLatin1(name.second);
+    }
+    return QString::fromLatin1(codecId);
+}
+
+// Phần chung của các cách đọc: thời lượng/bitrate từ kích thước file, ước lượng nb_frames khi header không ghi
+void finishResult(const QString &path, MediaProbe::Result *result)
+{
+    MediaInfo &info = result->info;
+    if (info.size <= 0) info.size = QFileInfo(path).size();
+    if (info.bitrate <= 0 && info.duration > 0) info.bitrate = qint64(info.size * 8 / info.duration);
+    if (result->nbFrames <= 0 && info.duration > 0 && info.fps > 0) {
+        result->nbFrames = int(std::lround(info.duration * info.fps));
+        result->nbFramesExact = false;
+    }
+}
+
+} // namespace
+
+bool MediaProbe::probe(const QString &path, Result *result)
+{
+    Result probed;
+    bool ok = probeIsoMedia(path, &probed) || probeMatroska(path, &probed);
+#ifdef VIDEOQC_HAVE_LIBAV
+    if (!ok) {
+        probed = Result();
+        ok = LibavFrameSource::probeMediaInfo(path, &probed.info, &probed.nbFrames);
+        probed.nbFramesExact = probed.nbFrames > 0;
+        probed.method = QStringLiteral("header, libavformat");
+    }
+#endif
+    if (!ok) return false;
+    finishResult(path, &probed);
+    *result = probed;
+    return true;
+}
+
+bool MediaProbe::probeIsoMedia(const QString &path, Result *result)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const qint64 fileSize = file.size();
+
+    // Các box cấp cao nhất: chỉ đọc header rồi nhảy qua (mdat có thể dài hàng chục GB), dừng ở moov
+    Box box, moov;
+    bool foundMoov = false;
+    for (qint64 pos = 0; pos < fileSize && !foundMoov; pos = box.end) {
+        if (!readBox(file, pos, fileSize, &box)) return false;
+        if (pos == 0 && !isIsoTopLevel(box.type)) return false;
+        if (box.type == fourcc("moov")) { moov = box; foundMoov = true; }
+    }
+    if (!foundMoov) return false;
+
+    MediaInfo &info = result->info;
+    info.formatName = QStringLiteral("QuickTime / MOV");
+    info.size = fileSize;
+    if (findChild(file, moov, fourcc("mvhd"), &box)) {
+        const QByteArray d = readPayload(file, box, 32);
+        const bool v1 = !d.isEmpty() && d.at(0) == 1;
+        const quint64 created = v1 ? be64(d, 4) : be32(d, 4);
+        const quint32 timescale = be32(d, v1 ? 20 : 12);
+        const quint64 duration = v1 ? be64(d, 24) : be32(d, 16);
+        if (timescale > 0) info.duration = double(duration) / timescale;
+        // Giây tính từ 1904-01-01 UTC
+        if (created > 0) info.creationTime = QDateTime(QDate(1904, 1, 1), QTime(0, 0), QTimeZone::utc()).addSecs(qint64(created));
+    }
+
+    bool foundVideo = false, foundAudio = false;
+    IsoTrack video;
+    for (qint64 pos = moov.payload; pos < moov.end; pos = box.end) {
+        if (!readBox(file, pos, moov.end, &box)) break;
+        if (box.type != fourcc("trak")) continue;
+        IsoTrack track;
+        if (!readTrack(file, box, &track)) continue;
+        if (!foundVideo && track.handler == fourcc("vide")) {
+            video = track;
+            foundVideo = true;
+        } else if (!foundAudio && track.handler == fourcc("soun")) {
+            info.audioCodec = isoCodecName(track.codec);
+            info.sampleRate = track.sampleRate;
+            info.channelLayout = channelLayoutName(track.channels);
+            foundAudio = true;
+        }
+    }
+    if (!foundVideo || video.width <= 0 || video.height <= 0 || video.timescale == 0) return false;
+
+    info.width = video.width;
+    info.height = video.height;
+    info.videoCodec = isoCodecName(video.codec);
+    if (video.sttsEntries == 1 && video.firstDelta > 0) {
+        // Mọi frame cùng thời lượng: tốc độ khung hình chính xác dạng phân số (30000/1001...)
+        const quint32 divisor = std::gcd(video.timescale, video.firstDelta);
+        info.frameRate.num = qint32(video.timescale / divisor);
+        info.frameRate.den = qint32(video.firstDelta / divisor);
+    } else if (video.sampleCount > 0 && video.duration > 0) {
+        info.frameRate = FrameRate::fromDouble(double(video.sampleCount) * video.timescale / double(video.duration));
+    }
+    info.fps = info.frameRate.toDouble();
+    if (info.fps <= 0) return false;     // MP4 phân mảnh: bảng mẫu nằm trong các moof, để libavformat đọc
+    if (video.duration > 0) info.duration = double(video.duration) / video.timescale;
+    if (video.sampleCount > 0) {
+        result->nbFrames = int(video.sampleCount);
+        result->nbFramesExact = true;
+    }
+    result->method = QStringLiteral("header MP4/MOV");
+    return true;
+}
+
+bool MediaProbe::probeMatroska(const QString &path, Result *result)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    const QByteArray data = file.read(MATROSKA_HEAD_BYTES);
+    const qint64 limit = data.size();
+
+    Element element;
+    if (!readElement(data, 0, limit, &element) || element.id != 0x1A45DFA3) return false;   // EBML header
+    qint64 pos = element.end;
+    if (!readElement(data, pos, limit, &element) || element.id != 0x18538067) return false; // Segment
+    const Element segment = element;
+
+    MediaInfo &info = result->info;
+    info.formatName = QStringLiteral("Matroska / WebM");
+    info.size = file.size();
+    quint64 timestampScale = 1000000;   // ns mỗi đơn vị thời gian của Segment
+    double durationUnits = 0.0;
+    quint64 defaultDuration = 0;        // ns mỗi frame của track video
+    bool foundTracks = false, foundVideo = false, foundAudio = false;
+
+    for (pos = segment.payload; pos < segment.end; pos = element.end) {
+        if (!readElement(data, pos, segment.end, &element)) break;
+        if (element.id == 0x1F43B675) break;    // Cluster: hết phần header
+        if (element.id == 0x1549A966) {         // Info
+            Element child;
+            for (qint64 p = element.payload; p < element.end; p = child.end) {
+                if (!readElement(data, p, element.end, &child)) break;
+                if (child.id == 0x2AD7B1) timestampScale = ebmlUInt(data, child);
+                else if (child.id == 0x4489) durationUnits = ebmlFloat(data, child);
+                else if (child.id == 0x4461) {
+                    // ns tính từ 2001-01-01 UTC
+                    const qint64 ns = qint64(ebmlUInt(data, child));
+                    info.creationTime = QDateTime(QDate(2001, 1, 1), QTime(0, 0), QTimeZone::utc()).addMSecs(ns / 1000000);
+                }
+            }
+        } else if (element.id == 0x1654AE6B) {  // Tracks
+            foundTracks = true;
+            Element entry;
+            for (qint64 p = element.payload; p < element.end; p = entry.end) {
+                if (!readElement(data, p, element.end, &entry)) break;
+                if (entry.id != 0xAE) continue;  // TrackEntry
+                quint64 type = 0, trackDuration = 0, width = 0, height = 0, channels = 0;
+                double sampleRate = 0.0;
+                QByteArray codecId;
+                Element field;
+                for (qint64 q = entry.payload; q < entry.end; q = field.end) {
+                    if (!readElement(data, q, entry.end, &field)) break;
+                    switch (field.id) {
+                    case 0x83: type = ebmlUInt(data, field); break;
+                    case 0x86: codecId = data.mid(field.payload, field.end - field.payload); break;
+                    case 0x23E383: trackDuration = ebmlUInt(data, field); break;
+                    case 0xE0:
+                    case 0xE1: {
+                        Element sub;
+                        for (qint64 r = field.payload; r < field.end; r = sub.end) {
+                            if (!readElement(data, r, field.end, &sub)) break;
+                            if (sub.id == 0xB0) width = ebmlUInt(data, sub);
+                            else if (sub.id == 0xBA) height = ebmlUInt(data, sub);
+                            else if (sub.id == 0xB5) sampleRate = ebmlFloat(data, sub);
+                            else if (sub.id == 0x9F) channels = ebmlUInt(data, sub);
+                        }
+                        break;
+                    }
+                    default: break;
+                    }
+                }
+                if (type == 1 && !foundVideo) {
+                    info.width = int(width);
+                    info.height = int(height);
+                    info.videoCodec = matroskaCodecName(codecId);
+                    defaultDuration = trackDuration;
+                    foundVideo = true;
+                } else if (type == 2 && !foundAudio) {
+                    info.audioCodec = matroskaCodecName(codecId);
+                    info.sampleRate = int(std::lround(sampleRate));
+                    info.channelLayout = channelLayoutName(int(channels));
+                    foundAudio = true;
+                }
+            }
+        }
+    }
+    if (!foundTracks || !foundVideo || info.width <= 0 || info.height <= 0 || defaultDuration == 0) return false;
+
+    info.frameRate = FrameRate::fromDouble(1e9 / double(defaultDuration));
+    info.fps = info.frameRate.toDouble();
+    info.duration = durationUnits * double(timestampScale) / 1e9;
+    result->method = QStringLiteral("header Matroska");
+    return info.fps > 0;
+}
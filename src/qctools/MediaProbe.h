@@ -0,0 +1,32 @@
+// src/qctools/MediaProbe.h
+#ifndef MEDIAPROBE_H
+#define MEDIAPROBE_H
+
+#include <QString>
+#include "core/media_info.h"
+
+// CẢI TIẾN: Đọc nhanh MediaInfo ngay khi chọn file, trước khi qcli giải mã xong cả file.
+// Chỉ đọc header của container (vài KB, không giải mã frame nào):
+//   - MP4/MOV: moov/mvhd, trak/mdia/mdhd, hdlr, stsd, stts, stsz (nb_frames = số mẫu của track video)
+//   - Matroska/WebM: Segment/Info và Tracks trước Cluster đầu tiên (nb_frames ước lượng từ thời lượng x fps)
+//   - Container khác (MXF, MPEG-TS, AVI...): đọc header bằng libavformat nếu bản build có bộ máy libav
+// Kết quả chỉ để hiển thị sớm và ước lượng (tiến độ, cấp trước bộ nhớ); MediaInfo từ báo cáo sau phân tích vẫn là chuẩn.
+class MediaProbe
+{
+public:
+    struct Result {
+        MediaInfo info;
+        int nbFrames = -1;          // -1: không biết
+        bool nbFramesExact = false; // false: ước lượng từ thời lượng x fps
+        QString method;             // Cách đã đọc, để ghi log
+    };
+
+    // false nếu không nhận ra container hoặc header không có kích thước/tốc độ khung hình của video
+    static bool probe(const QString& path, Result* result);
+
+private:
+    static bool probeIsoMedia(const QString& path, Result* result);
+    static bool probeMatroska(const QString& path, Result* result);
+};
+
+#endif // MEDIAPROBE_H
@@ -1,32 +1,41 @@
 // src/qctools/QCToolsManager.cpp (Cải tiến Bước 1)
 #include "QCToolsManager.h"
 #include "core/Constants.h"
+#include "core/ResultCache.h"
+#include "core/ReportComparator.h"
+#include "core/ResultFormat.h"
+#include "core/FrameStore.h"
+#include "ReportPipeline.h"
+#ifdef VIDEOQC_HAVE_LIBAV
+#include "LibavFrameSource.h"
+#include "CoarseScanSource.h"
+#include "SplicedFrameSource.h"
+#include "core/GopIndex.h"
+#endif
 #include <QProcess>
 #include <QTemporaryDir>
-#include <QXmlStreamReader>
 #include <QFile>
 #include <QDebug>
 #include <QRegularExpression>
 #include <QDateTime>
 #include <QTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <cmath>
 #include <algorithm>
-#include <QTemporaryFile>
 #include <zlib.h>
 #include <stdexcept>
 #include <optional>
 #include <QSet>
 #include <QMap>
 #include <memory>
+#include <vector>
+#include <limits>
 
 // =============================================================================
 // DATA STRUCTURES & INTERNAL UTILITY FUNCTIONS
 // =============================================================================
 
-struct FrameData {
-    int frameNum = 0; double yavg = 255.0; double ydif = 0.0;
-    int crop_x = -1, crop_y = -1, crop_w = -1, crop_h = -1;
-};
-
 struct CropValues {
     int top = 0, bottom = 0, left = 0, right = 0;
     bool isValid() const { return top >= 0; }
@@ -52,24 +61,287 @@ struct BorderGroup {
     CropValues maxCv;
 };
 
-static QString formatCropDetails(const CropValues& min_vals, const CropValues& max_vals, int w, int h) {
-    if (w <= 0 || h <= 0) return "Kích thước video không xác định";
-    QStringList parts;
-    auto formatSide = [&](const QString& name, int minVal, int maxVal, int total) {
-        if (maxVal < 0 || total <= 0) return;
-        if (maxVal == 0 && minVal == 0) return;
-        QString valStr = (minVal == maxVal) ? QString("%1px").arg(minVal) : QString("%1>%2px").arg(minVal).arg(maxVal);
-        double minP = (double)minVal / total * 100.0, maxP = (double)maxVal / total * 100.0;
-        QString pStr = (qAbs(minP - maxP) < 0.1) ? QString("(%1%)").arg(minP, 0, 'f', 1) : QString("(%1>%2%)").arg(minP, 0, 'f', 1).arg(maxP, 0, 'f', 1);
-        parts << QString("%1: %2 %3").arg(name, valStr, pStr);
-    };
-    formatSide("Trên", min_vals.top, max_vals.top, h);
-    formatSide("Dưới", min_vals.bottom, max_vals.bottom, h);
-    formatSide("Trái", min_vals.left, max_vals.left, w);
-    formatSide("Phải", min_vals.right, max_vals.right, w);
-    return parts.join(", ");
+// Bộ lọc qcli (-f) cho các loại lỗi được bật; cũng ghi vào chỉ mục GOP để biết báo cáo có những số liệu nào
+static QString qcliFilters(const QVariantMap& settings) {
+    QStringList filters;
+    if (settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool()) filters << "cropdetect";
+    if (settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool() || settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool()) {
+        filters << "signalstats";
+    }
+    return filters.join("+");
+}
+
+static CropEdges toCropEdges(const CropValues& cv) {
+    return { static_cast<qint16>(cv.top), static_cast<qint16>(cv.bottom), static_cast<qint16>(cv.left), static_cast<qint16>(cv.right) };
 }
 
+// Số kết quả tối đa trong một lô gửi lên giao diện
+constexpr int RESULT_BATCH_SIZE = 500;
+
+// CẢI TIẾN: Ước lượng thời gian còn lại từ tỉ lệ đã xong, nối vào dòng trạng thái.
+// Rỗng khi mới chạy (dưới 3 giây hoặc 1%) vì lúc đó tốc độ chưa ổn định.
+static QString remainingTimeText(qint64 elapsedMs, double fraction) {
+    if (fraction < 0.01 || fraction >= 1.0 || elapsedMs < 3000) return QString();
+    const qint64 remainingSec = qint64(elapsedMs * (1.0 - fraction) / fraction / 1000.0 + 0.5);
+    if (remainingSec < 60) return QString(" — còn khoảng %1 giây").arg(remainingSec);
+    if (remainingSec < 3600) return QString(" — còn khoảng %1 phút").arg((remainingSec + 30) / 60);
+    return QString(" — còn khoảng %1 giờ %2 phút").arg(remainingSec / 3600).arg((remainingSec % 3600) / 60);
+}
+
+// Gom các frame có viền liên tiếp thành một nhóm, giữ min/max của từng cạnh
+class BorderGrouper
+{
+public:
+    explicit BorderGrouper(QList<AnalysisResult>& out) : m_out(out) {}
+    void add(int frameNum, const CropValues& cv) {
+        if (!m_group.has_value()) {
+            m_group.emplace(BorderGroup{frameNum, frameNum, 1, cv, cv});
+            return;
+        }
+        BorderGroup& g = m_group.value();
+        g.endFrame = frameNum;
+        g.count++;
+        g.minCv.top = std::min(g.minCv.top, cv.top); g.maxCv.top = std::max(g.maxCv.top, cv.top);
+        g.minCv.bottom = std::min(g.minCv.bottom, cv.bottom); g.maxCv.bottom = std::max(g.maxCv.bottom, cv.bottom);
+        g.minCv.left = std::min(g.minCv.left, cv.left); g.maxCv.left = std::max(g.maxCv.left, cv.left);
+        g.minCv.right = std::min(g.minCv.right, cv.right); g.maxCv.right = std::max(g.maxCv.right, cv.right);
+    }
+    void close() {
+        if (!m_group.has_value()) return;
+        AnalysisResult res;
+        res.type = ErrorType::BlackBorder;
+        res.startFrame = m_group->startFrame;
+        res.endFrame = m_group->endFrame;
+        res.count = m_group->count;
+        res.minCrop = toCropEdges(m_group->minCv);
+        res.maxCrop = toCropEdges(m_group->maxCv);
+        m_out.append(res);
+        m_group.reset();
+    }
+private:
+    QList<AnalysisResult>& m_out;
+    std::optional<BorderGroup> m_group;
+};
+
+// Quét keyframe: gom các keyframe liên tiếp cùng bị đánh dấu thành một vùng ước lượng. Lỗi bắt đầu đâu đó sau
+// keyframe sạch trước đó và kết thúc trước keyframe sạch kế tiếp, nên vùng trải tới sát hai keyframe sạch này.
+class KeyframeRegionGrouper
+{
+public:
+    KeyframeRegionGrouper(ErrorType type, QList<AnalysisResult>& out) : m_type(type), m_out(out) {}
+    // `previousKeyframe`: keyframe ngay trước `frame`, -1 nếu `frame` là keyframe đầu tiên
+    void add(const FrameData& frame, bool flagged, int previousKeyframe, const CropValues& cv) {
+        if (!flagged) { close(frame.frameNum - 1); return; }
+        if (!m_open) {
+            m_open = true;
+            m_result = AnalysisResult{};
+            m_result.type = m_type;
+            m_result.startFrame = previousKeyframe + 1;
+            m_yavgSum = 0;
+            m_keyframes = 0;
+            m_minCv = m_maxCv = cv;
+        }
+        m_yavgSum += frame.yavg;
+        ++m_keyframes;
+        m_minCv.top = std::min(m_minCv.top, cv.top); m_maxCv.top = std::max(m_maxCv.top, cv.top);
+        m_minCv.bottom = std::min(m_minCv.bottom, cv.bottom); m_maxCv.bottom = std::max(m_maxCv.bottom, cv.bottom);
+        m_minCv.left = std::min(m_minCv.left, cv.left); m_maxCv.left = std::max(m_maxCv.left, cv.left);
+        m_minCv.right = std::min(m_minCv.right, cv.right); m_maxCv.right = std::max(m_maxCv.right, cv.right);
+    }
+    void close(int endFrame) {
+        if (!m_open) return;
+        m_result.endFrame = std::max(m_result.startFrame, endFrame);
+        m_result.count = m_result.endFrame - m_result.startFrame + 1;
+        m_result.meanYavg = static_cast<float>(m_yavgSum / m_keyframes);
+        if (m_type == ErrorType::BlackBorder) {
+            m_result.minCrop = toCropEdges(m_minCv);
+            m_result.maxCrop = toCropEdges(m_maxCv);
+        }
+        m_out.append(m_result);
+        m_open = false;
+    }
+private:
+    const ErrorType m_type;
+    QList<AnalysisResult>& m_out;
+    bool m_open = false;
+    AnalysisResult m_result;
+    double m_yavgSum = 0;
+    int m_keyframes = 0;
+    CropValues m_minCv, m_maxCv;
+};
+
+// CẢI TIẾN: Bộ phát hiện lỗi dạng luồng, dùng cho mọi chế độ (mở báo cáo, bộ máy libav, so sánh hai báo cáo):
+// nhận từng frame theo thứ tự, gắn thẻ và gom nhóm ngay, không cần mảng thẻ của cả file.
+// Trạng thái chỉ gồm frame đang xét (điểm cắt cảnh cần YDIF của frame trước và frame sau), nhóm đang mở,
+// và tối đa K_ORPHAN_THRESH frame đầu của cảnh hiện tại để đếm frame đen khi cảnh kết thúc.
+// Giả định frame đến theo thứ tự pkt_pts tăng dần, như qcli ghi ra.
+class StreamingDetector
+{
+public:
+    explicit StreamingDetector(const QVariantMap& settings)
+        : m_borders(borderResults)
+    {
+        m_detectBlack = settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool();
+        m_detectBorders = settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool();
+        m_detectOrphans = settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool();
+        m_hasTransitions = settings.value(AppConstants::K_HAS_TRANSITIONS, false).toBool();
+        m_blackThresh = settings.value(AppConstants::K_BLACK_FRAME_THRESH, 17.0).toDouble();
+        m_borderThresh = settings.value(AppConstants::K_BORDER_THRESH, 0.2).toDouble();
+        m_sceneThresh = settings.value(AppConstants::K_SCENE_THRESH, 30.0).toDouble();
+        m_orphanThresh = settings.value(AppConstants::K_ORPHAN_THRESH, 5).toInt();
+        if (m_orphanThresh <= 0) m_detectOrphans = false;
+    }
+
+    // Gọi một lần trước frame đầu tiên. Kích thước chưa biết (0): viền đen được tìm ở finish()
+    void begin(int width, int height) {
+        m_width = width;
+        m_height = height;
+        m_streamBorders = m_detectBorders && width > 0 && height > 0;
+    }
+
+    void push(const FrameData& frame) {
+        if (m_hasCurrent) process(true, frame.ydif);
+        m_current = frame;
+        m_hasCurrent = true;
+    }
+
+    // `frames` là toàn bộ frame đã push, dùng cho lượt tìm viền đen khi kích thước video chỉ có ở cuối báo cáo
+    void finish(const FrameStore& frames, int width, int height, int totalFrames) {
+        if (m_hasCurrent) process(false, 0.0);
+        m_hasCurrent = false;
+        if (m_blackGroup.count > 0) closeBlackGroup();
+        m_borders.close();
+
+        if (m_detectOrphans && totalFrames > 0 && m_lastCut != totalFrames) handleCut(totalFrames);
+
+        if (m_detectBorders && !m_streamBorders) {
+            FrameStore::Reader reader(frames);
+            for (int i = 0; i < frames.size(); ++i) {
+                const FrameData& frame = reader.at(i);
+                if (isBlack(frame)) { m_borders.close(); continue; }
+                const CropValues cv = CropValues::fromFrameData(frame, width, height);
+                if (cv.isValid() && cv.hasBorders(m_borderThresh, width, height)) m_borders.add(frame.frameNum, cv);
+                else m_borders.close();
+            }
+            m_borders.close();
+        }
+    }
+
+    // Frame kế tiếp không nối tiếp frame trước (quét nhanh: cửa sổ mới). Đóng các nhóm đang mở như ở cuối file;
+    // cảnh đầu cửa sổ được coi như cảnh đầu file nên không bị xét là cảnh mồ côi.
+    void breakSequence() {
+        if (m_hasCurrent) process(false, 0.0);
+        m_hasCurrent = false;
+        if (m_blackGroup.count > 0) closeBlackGroup();
+        m_borders.close();
+        m_index = 0;
+        m_prevYdif = 0.0;
+        m_lastCut = 0;
+        m_sceneHead.clear();
+    }
+
+    QList<AnalysisResult> blackResults;
+    QList<AnalysisResult> borderResults;
+    QList<AnalysisResult> orphanResults;
+
+private:
+    bool isBlack(const FrameData& frame) const { return m_detectBlack && frame.yavg < m_blackThresh; }
+
+    // Quyết định cho m_current khi đã biết frame sau nó (hoặc biết nó là frame cuối)
+    void process(bool hasNext, double nextYdif) {
+        const FrameData& frame = m_current;
+        const bool black = isBlack(frame);
+
+        if (black) {
+            if (m_blackGroup.count == 0) {
+                m_blackGroup = AnalysisResult{};
+                m_blackGroup.type = ErrorType::BlackFrame;
+                m_blackGroup.startFrame = frame.frameNum;
+                m_blackYavgSum = 0;
+            }
+            m_blackGroup.endFrame = frame.frameNum;
+            m_blackGroup.count++;
+            m_blackYavgSum += frame.yavg;
+        } else if (m_blackGroup.count > 0) {
+            closeBlackGroup();
+        }
+
+        if (m_streamBorders) {
+            const CropValues cv = CropValues::fromFrameData(frame, m_width, m_height);
+            if (!black && cv.isValid() && cv.hasBorders(m_borderThresh, m_width, m_height)) m_borders.add(frame.frameNum, cv);
+            else m_borders.close();
+        }
+
+        if (m_detectOrphans) {
+            bool isCut = false;
+            if (m_index > 0) {
+                if (m_hasTransitions) {
+                    isCut = hasNext && frame.ydif > m_sceneThresh && frame.ydif > m_prevYdif && frame.ydif > nextYdif;
+                } else {
+                    const bool isNormalCut = frame.ydif > m_sceneThresh && m_prevYdif < (m_sceneThresh / 2.0);
+                    const bool isTinySceneEnd = hasNext && frame.ydif > m_sceneThresh && m_prevYdif > m_sceneThresh && nextYdif < (m_sceneThresh / 2.0);
+                    isCut = isNormalCut || isTinySceneEnd;
+                }
+            }
+            if (isCut && frame.frameNum != m_lastCut) {
+                handleCut(frame.frameNum);
+                m_lastCut = frame.frameNum;
+                m_sceneHead.clear();
+            }
+            if (m_sceneHead.size() < m_orphanThresh) m_sceneHead.append({frame.frameNum, black});
+        }
+
+        m_prevYdif = frame.ydif;
+        ++m_index;
+    }
+
+    void closeBlackGroup() {
+        m_blackGroup.meanYavg = static_cast<float>(m_blackYavgSum / m_blackGroup.count);
+        blackResults.append(m_blackGroup);
+        m_blackGroup.count = 0;
+    }
+
+    // Cảnh [m_lastCut, endFrame) vừa kết thúc: là cảnh mồ côi nếu đủ ngắn và có frame không đen
+    void handleCut(int endFrame) {
+        const int startFrame = m_lastCut;
+        const int duration = endFrame - startFrame;
+        if (startFrame == 0 || duration <= 0 || duration > m_orphanThresh) return;
+
+        // Frame không có trong báo cáo cũng tính là không đen
+        int blackCount = 0;
+        for (int j = 0; j < m_sceneHead.size() && j < duration; ++j) {
+            if (m_sceneHead.at(j).first >= endFrame) break;
+            if (m_sceneHead.at(j).second) ++blackCount;
+        }
+        if (blackCount < duration) {
+            AnalysisResult res;
+            res.type = ErrorType::OrphanFrame;
+            res.startFrame = startFrame;
+            res.endFrame = endFrame - 1;
+            res.count = duration;
+            orphanResults.append(res);
+        }
+    }
+
+    bool m_detectBlack = true, m_detectBorders = true, m_detectOrphans = true, m_hasTransitions = false;
+    double m_blackThresh = 17.0, m_borderThresh = 0.2, m_sceneThresh = 30.0;
+    int m_orphanThresh = 5;
+    int m_width = 0, m_height = 0;
+    bool m_streamBorders = false;
+
+    FrameData m_current;
+    bool m_hasCurrent = false;
+    int m_index = 0;
+    double m_prevYdif = 0.0;
+
+    AnalysisResult m_blackGroup;
+    double m_blackYavgSum = 0;
+    BorderGrouper m_borders;
+
+    int m_lastCut = 0;
+    QVector<QPair<int, bool>> m_sceneHead;     // (frameNum, là frame đen) của các frame đầu cảnh hiện tại
+};
+
 // =============================================================================
 // CLASS IMPLEMENTATION: QCToolsManager
 // =============================================================================
@@ -118,6 +390,21 @@ QString QCToolsManager::getReportPath(ReportType type) const
 }
 
 
+bool QCToolsManager::inProcessEngineAvailable()
+{
+#ifdef VIDEOQC_HAVE_LIBAV
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool QCToolsManager::usesInProcessEngine(const QVariantMap &settings)
+{
+    return inProcessEngineAvailable()
+        && settings.value(AppConstants::K_ANALYSIS_ENGINE, AppConstants::ENGINE_QCLI).toString() == QLatin1String(AppConstants::ENGINE_LIBAV);
+}
+
 void QCToolsManager::cleanup() {
     if (m_mainProcess) { m_mainProcess->kill(); m_mainProcess->deleteLater(); m_mainProcess = nullptr; }
     if (m_backgroundProcess) { m_backgroundProcess->kill(); m_backgroundProcess->deleteLater(); m_backgroundProcess = nullptr; }
@@ -129,6 +416,7 @@ void QCToolsManager::resetState() {
     m_stopRequested = false;
     m_totalFramesFromLog = 0;
     m_totalFrames = 0;
+    m_probedFrames = -1;
     m_fps = 0;
     m_videoWidth = 0;
     m_videoHeight = 0;
@@ -137,7 +425,12 @@ void QCToolsManager::resetState() {
     m_currentStep = 0;
     m_totalSteps = 0;
     m_currentPhase.clear();
-    AnalysisResult::resetIdCounter();
+    m_emittedResultCount = 0;
+    m_nextResultId = 0;
+    m_cacheFingerprint.clear();
+    m_cacheProfile.clear();
+    m_cacheResults.clear();
+    m_resultSink = nullptr;
 }
 
 void QCToolsManager::requestStop() {
@@ -158,12 +451,34 @@ void QCToolsManager::doWork(const QString &filePath, const QVariantMap &settings
     m_qcliPath = settings.value(AppConstants::K_QCCLI_PATH).toString();
     m_reportDir = createReportDirectory();
 
-    m_totalSteps = m_totalStepsAnalyze;
+    const QString incrementalReport = m_settings.value(AppConstants::K_INCREMENTAL_REPORT).toString();
+    const bool incremental = !incrementalReport.isEmpty() && inProcessEngineAvailable();
+    const bool inProcess = incremental || usesInProcessEngine(m_settings);
+    m_totalSteps = incremental ? m_totalStepsIncremental : inProcess ? m_totalStepsInProcess : m_totalStepsAnalyze;
     m_currentStep = 1;
     m_currentPhase = "Chuẩn bị Phân tích";
     emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
     emit logMessage(QString("[%1] Bắt đầu Bước 1/%2: %3...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_totalSteps).arg(m_currentPhase));
+
+#ifdef VIDEOQC_HAVE_LIBAV
+    if (incremental) {
+        runIncrementalAnalysis(incrementalReport);
+        return;
+    }
+#endif
+    if (inProcess) {
+        runInProcessAnalysis();
+        return;
+    }
+    if (m_settings.value(AppConstants::K_ANALYSIS_ENGINE).toString() == QLatin1String(AppConstants::ENGINE_LIBAV)) {
+        emit logMessage("[WARNING] Bản build này không có bộ máy phân tích libav, chuyển sang dùng qcli.");
+    }
+    if (m_settings.value(AppConstants::K_FAST_SCAN, false).toBool()) {
+        emit logMessage("[WARNING] Quét nhanh cần bộ máy phân tích libav (qcli không lấy mẫu được), chạy phân tích đầy đủ.");
+    }
     emit logMessage(QString("   - Thư mục báo cáo: %1").arg(QDir::toNativeSeparators(m_reportDir)));
+    m_probedFrames = m_settings.value(AppConstants::K_PROBED_FRAME_COUNT, -1).toInt();
+    if (m_probedFrames > 0) emit logMessage(QString("   - Số frame đọc từ header: %1").arg(m_probedFrames));
 
     if (m_qcliPath.isEmpty() || !QFile::exists(m_qcliPath) || m_reportDir.isEmpty()) {
         emit errorOccurred("Không thể chuẩn bị môi trường phân tích. Vui lòng kiểm tra lại đường dẫn qcli.exe.");
@@ -176,19 +491,316 @@ void QCToolsManager::doWork(const QString &filePath, const QVariantMap &settings
     connect(m_mainProcess, &QProcess::readyRead, this, &QCToolsManager::readAnalysisOutput);
 
     QStringList args; args << "-i" << m_filePath << "-o" << getReportPath(ReportType::XML) << "-y" << "-s";
-    QStringList filters;
-    if (m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool()) filters << "cropdetect";
-    if (m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool() || m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool()) {
-        if (!filters.contains("signalstats")) filters << "signalstats";
-    }
-    if (!filters.isEmpty()) args << "-f" << filters.join("+");
+    const QString filters = qcliFilters(m_settings);
+    if (!filters.isEmpty()) args << "-f" << filters;
 
     m_currentPhase = "Phân tích Video (Tạo dữ liệu)";
     emit logMessage(QString("[%1]       -> Bắt đầu chạy qcli.exe để trích xuất dữ liệu frame...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
     emit logMessage(QString("   - Lệnh: %1 %2").arg(m_qcliPath).arg(args.join(" ")));
+    m_progressTimer.start();
     m_mainProcess->start(m_qcliPath, args);
 }
 
+void QCToolsManager::runInProcessAnalysis() {
+#ifdef VIDEOQC_HAVE_LIBAV
+    const bool signalStats = m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool() || m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool();
+    const bool cropDetect = m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool();
+    emit logMessage(QString("[%1]       -> Phân tích trong tiến trình bằng libav, bộ lọc: %2 (không tạo báo cáo XML).")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(LibavFrameSource::filterDescription(signalStats, cropDetect)));
+
+    // Video dài: chia thành nhiều đoạn giải mã song song, kết quả được ghép lại theo đúng thứ tự frame
+    int segments = m_settings.value(AppConstants::K_ANALYSIS_SEGMENTS, 0).toInt();
+    if (segments <= 0) segments = QThread::idealThreadCount();
+    const int downscale = m_settings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt();
+    if (downscale > 1) emit logMessage(QString("   - Giảm độ phân giải khi phân tích: tối đa 1/%1, frame phân tích rộng ít nhất %2 điểm ảnh.")
+                                          .arg(downscale).arg(LibavFrameSource::MIN_ANALYSIS_WIDTH));
+    std::unique_ptr<FrameSource> source;
+    const QVariantList windows = m_settings.value(AppConstants::K_ANALYSIS_WINDOWS).toList();
+    const QVariantList range = m_settings.value(AppConstants::K_ANALYSIS_RANGE).toList();
+    if (range.size() == 2) {
+        // Điểm vào/ra: tìm về keyframe trước điểm vào, bỏ các frame trước nó; frameNum vẫn là số frame trong cả file
+        const int first = qMax(0, range[0].toInt());
+        const int last = range[1].toInt();
+        emit logMessage(QString("   - Chỉ phân tích đoạn từ frame %1 tới %2 (điểm vào/ra), số frame giữ nguyên như trong cả file.")
+                            .arg(first).arg(last >= 0 ? QString::number(last) : QString("hết file")));
+        auto single = std::make_unique<LibavFrameSource>(m_filePath, signalStats, cropDetect, m_stopRequested);
+        single->setFrameRange(first, last >= 0 ? last + 1 : std::numeric_limits<int>::max());
+        single->setDownscale(downscale);
+        source = std::move(single);
+    } else if (!windows.isEmpty()) {
+        QVector<QPair<int, int>> frameWindows;
+        for (const QVariant& window : windows) {
+            const QVariantList bounds = window.toList();
+            if (bounds.size() == 2) frameWindows.append({ bounds[0].toInt(), bounds[1].toInt() });
+        }
+        emit logMessage(QString("   - Chỉ phân tích đầy đủ %1 vùng đã đánh dấu.").arg(frameWindows.size()));
+        auto coarse = std::make_unique<CoarseScanSource>(m_filePath, signalStats, cropDetect, 1, CoarseScanSource::Classifier(), m_stopRequested);
+        coarse->setWindows(frameWindows);
+        coarse->setDownscale(downscale);
+        source = std::move(coarse);
+    } else if (m_settings.value(AppConstants::K_FAST_SCAN, false).toBool()) {
+        source = createCoarseScanSource(signalStats, cropDetect);
+    } else if (segments > 1) {
+        auto segmented = std::make_unique<SegmentedLibavSource>(m_filePath, signalStats, cropDetect, segments, m_stopRequested);
+        segmented->setDownscale(downscale);
+        source = std::move(segmented);
+    } else {
+        auto single = std::make_unique<LibavFrameSource>(m_filePath, signalStats, cropDetect, m_stopRequested);
+        single->setDownscale(downscale);
+        source = std::move(single);
+    }
+    const bool ok = runFrameSource(*source, "Giải mã, Phân tích & Gắn thẻ Video");
+    if (!ok && !m_stopRequested) emit errorOccurred("Phân tích video trong tiến trình thất bại.");
+    emit analysisFinished(ok);
+#else
+    emit errorOccurred("Bản build này không có bộ máy phân tích libav.");
+    emit analysisFinished(false);
+#endif
+}
+
+#ifdef VIDEOQC_HAVE_LIBAV
+std::unique_ptr<FrameSource> QCToolsManager::createCoarseScanSource(bool signalStats, bool cropDetect) {
+    // Khoảng cách mẫu theo cài đặt, mặc định một frame mỗi giây (tốc độ khung hình đọc từ header)
+    int step = m_settings.value(AppConstants::K_FAST_SCAN_STEP, 0).toInt();
+    if (step <= 0) {
+        const double fps = LibavFrameSource::probeFrameRate(m_filePath);
+        step = fps > 0 ? qRound(fps) : 25;
+    }
+
+    // Mẫu đáng ngờ: cùng ngưỡng với bộ phát hiện, riêng cắt cảnh còn xét độ chênh YAVG so với mẫu trước
+    // (YDIF của một mẫu chỉ thấy cắt cảnh ngay tại mẫu đó)
+    const bool detectBlack = m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool();
+    const bool detectBorders = m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool();
+    const bool detectOrphans = m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool()
+                               && m_settings.value(AppConstants::K_ORPHAN_THRESH, 5).toInt() > 0;
+    const double blackThresh = m_settings.value(AppConstants::K_BLACK_FRAME_THRESH, 17.0).toDouble();
+    const double borderThresh = m_settings.value(AppConstants::K_BORDER_THRESH, 0.2).toDouble();
+    const double sceneThresh = m_settings.value(AppConstants::K_SCENE_THRESH, 30.0).toDouble();
+    auto classify = [=](const FrameData* previous, const FrameData& sample, int width, int height) {
+        if (detectBlack && sample.yavg < blackThresh) return CoarseScanSource::Candidate::Sample;
+        if (detectBorders && width > 0 && height > 0) {
+            const CropValues cv = CropValues::fromFrameData(sample, width, height);
+            if (cv.isValid() && cv.hasBorders(borderThresh, width, height)) return CoarseScanSource::Candidate::Sample;
+        }
+        if (detectOrphans) {
+            if (sample.ydif > sceneThresh) return CoarseScanSource::Candidate::Sample;
+            if (previous && std::abs(sample.yavg - previous->yavg) > sceneThresh / 4.0) return CoarseScanSource::Candidate::SinceLastSample;
+        }
+        return CoarseScanSource::Candidate::None;
+    };
+    emit logMessage(QString("   - Quét nhanh: lấy mẫu mỗi %1 frame. Lỗi ngắn hơn khoảng này và nằm lọt giữa hai mẫu có thể bị bỏ sót.").arg(step));
+    auto source = std::make_unique<CoarseScanSource>(m_filePath, signalStats, cropDetect, step, classify, m_stopRequested);
+    source->setDownscale(m_settings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt());
+    return source;
+}
+
+void QCToolsManager::runIncrementalAnalysis(const QString &previousReportPath) {
+    emit logMessage(QString("   - Báo cáo của bản trước: %1").arg(QDir::toNativeSeparators(previousReportPath)));
+
+    m_currentStep = 2;
+    m_currentPhase = "So khớp GOP với bản trước";
+    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit progressUpdated(0, 1000);
+
+    QElapsedTimer timer;
+    timer.start();
+    GopIndex previous, current;
+    QString reason;
+    QVector<QPair<int, int>> windows;
+    int changedGops = 0;
+    bool canSplice = false;
+    if (!GopIndex::load(GopIndex::pathForReport(previousReportPath), &previous)) {
+        reason = "không có chỉ mục GOP của bản trước";
+    } else if (!GopIndex::reportSpliceable(previous, AppConstants::ENGINE_QCLI, qcliFilters(m_settings), &reason)) {
+        // Số liệu của báo cáo cũ không ghép được theo số frame với frame phân tích lại: không cần lập chỉ mục bản mới
+    } else if (!LibavFrameSource::buildGopIndex(m_filePath, &current, m_stopRequested,
+                                                [this](int permille) { emit progressUpdated(permille, 1000); }, &reason)) {
+        if (m_stopRequested) { emit analysisFinished(false); return; }
+        reason = QString("không lập được chỉ mục GOP của bản mới (%1)").arg(reason);
+    } else {
+        canSplice = GopIndex::changedWindows(previous, current, &windows, &changedGops, &reason);
+    }
+    if (m_stopRequested) { emit analysisFinished(false); return; }
+
+    if (!canSplice) {
+        emit logMessage(QString("[WARNING] Không QC lại riêng phần đã đổi được: %1. Phân tích lại toàn bộ video.").arg(reason));
+        runInProcessAnalysis();
+        return;
+    }
+    int changedFrames = 0;
+    for (const auto &window : std::as_const(windows)) changedFrames += window.second - window.first + 1;
+    const int totalFrames = current.totalFrames();
+    emit logMessage(QString("[%1]       -> %2/%3 GOP đã đổi, phân tích lại %4/%5 frame (%6 vùng), so khớp mất %7 ms.")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(changedGops).arg(current.gops.size())
+                        .arg(changedFrames).arg(totalFrames).arg(windows.size()).arg(timer.elapsed()));
+
+    MediaInfo mediaInfo;
+    int probedFrames = -1;
+    LibavFrameSource::probeMediaInfo(m_filePath, &mediaInfo, &probedFrames);
+    const bool signalStats = m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool() || m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool();
+    const bool cropDetect = m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool();
+    SplicedFrameSource source(previousReportPath, m_filePath, windows, signalStats, cropDetect, mediaInfo, totalFrames, m_stopRequested);
+    source.setDownscale(m_settings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt());
+    const bool ok = runFrameSource(source, "Ghép Báo cáo cũ, Phân tích lại & Gắn thẻ");
+    if (!ok && !m_stopRequested) emit errorOccurred("QC lại phần đã đổi thất bại.");
+    emit analysisFinished(ok);
+}
+
+void QCToolsManager::writeGopIndex(const QString &reportPath) {
+    QElapsedTimer timer;
+    timer.start();
+    GopIndex index;
+    QString error;
+    if (!LibavFrameSource::buildGopIndex(m_filePath, &index, m_stopRequested, {}, &error)) {
+        if (!m_stopRequested) emit logMessage(QString("[WARNING] Không lập được chỉ mục GOP: %1").arg(error));
+        return;
+    }
+    index.reportEngine = AppConstants::ENGINE_QCLI;
+    index.reportFilters = qcliFilters(m_settings);
+    index.reportFrames = m_lastFrameCount;
+    index.reportNumberedFromZero = m_lastFramesNumberedFromZero;
+    if (!m_lastFramesNumberedFromZero || m_lastFrameCount != index.totalFrames()) {
+        emit logMessage(QString("[WARNING] pkt_pts của báo cáo không phải số thứ tự frame (%1 frame, chỉ mục GOP có %2): "
+                                "lần giao lại sau sẽ phải phân tích lại toàn bộ video.").arg(m_lastFrameCount).arg(index.totalFrames()));
+    }
+    const QString indexPath = GopIndex::pathForReport(reportPath);
+    if (!index.save(indexPath)) {
+        emit logMessage(QString("[WARNING] Không ghi được chỉ mục GOP: %1").arg(QDir::toNativeSeparators(indexPath)));
+        return;
+    }
+    emit logMessage(QString("[%1]       -> Đã lưu chỉ mục %2 GOP cho lần giao lại sau (%3 ms).")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(index.gops.size()).arg(timer.elapsed()));
+}
+#endif
+
+void QCToolsManager::triageKeyframes(const QString &filePath, const QVariantMap &settings) {
+    resetState();
+
+    emit analysisStarted();
+    emit logMessage(QString("[%1] Bắt đầu phiên làm việc mới (Quét keyframe).").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
+
+    m_filePath = filePath;
+    m_sourceReportPath.clear();
+    m_settings = settings;
+
+    m_totalSteps = m_totalStepsTriage;
+    m_currentStep = 1;
+    m_currentPhase = "Chuẩn bị Quét keyframe";
+    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước 1/%2: %3...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_totalSteps).arg(m_currentPhase));
+
+#ifdef VIDEOQC_HAVE_LIBAV
+    const bool ok = runKeyframeTriage();
+    if (!ok && !m_stopRequested) emit errorOccurred("Quét keyframe thất bại.");
+    emit analysisFinished(ok);
+#else
+    emit errorOccurred("Bản build này không có bộ máy phân tích libav, không quét keyframe được.");
+    emit analysisFinished(false);
+#endif
+}
+
+#ifdef VIDEOQC_HAVE_LIBAV
+bool QCToolsManager::runKeyframeTriage() {
+    const bool detectBlack = m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool();
+    const bool detectBorders = m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool();
+    const double blackThresh = m_settings.value(AppConstants::K_BLACK_FRAME_THRESH, 17.0).toDouble();
+    const double borderThresh = m_settings.value(AppConstants::K_BORDER_THRESH, 0.2).toDouble();
+    if (!detectBlack && !detectBorders) {
+        emit errorOccurred("Quét keyframe chỉ tìm Frame Đen và Viền Đen. Vui lòng bật ít nhất một trong hai loại lỗi này.");
+        return false;
+    }
+    if (m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool()) {
+        emit logMessage("   - Frame Dư cần YDIF của từng frame liên tiếp nên không được tìm khi quét keyframe.");
+    }
+
+    LibavFrameSource source(m_filePath, detectBlack, detectBorders, m_stopRequested);
+    source.setKeyframesOnly(true);
+    source.setDownscale(m_settings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt());
+
+    m_currentStep++;
+    m_currentPhase = "Giải mã Keyframe";
+    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit progressUpdated(0, 100);
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4 (bộ lọc: %5, bỏ qua mọi frame không phải keyframe)...")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase)
+                        .arg(LibavFrameSource::filterDescription(detectBlack, detectBorders)));
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<AnalysisResult> blackResults, borderResults;
+    KeyframeRegionGrouper blackRegions(ErrorType::BlackFrame, blackResults);
+    KeyframeRegionGrouper borderRegions(ErrorType::BlackBorder, borderResults);
+    int previousKeyframe = -1;
+    int keyframeCount = 0;
+
+    source.start();
+    FrameSource::FrameBatch batch;
+    while (source.nextBatch(&batch)) {
+        for (const FrameData& frame : std::as_const(batch.frames)) {
+            const bool black = detectBlack && frame.yavg < blackThresh;
+            CropValues cv;
+            bool bordered = false;
+            if (detectBorders && !black) {
+                cv = CropValues::fromFrameData(frame, batch.videoWidth, batch.videoHeight);
+                bordered = cv.isValid() && cv.hasBorders(borderThresh, batch.videoWidth, batch.videoHeight);
+            }
+            blackRegions.add(frame, black, previousKeyframe, cv);
+            borderRegions.add(frame, bordered, previousKeyframe, cv);
+            previousKeyframe = frame.frameNum;
+            ++keyframeCount;
+        }
+        const int permille = source.progressPermille();
+        if (permille >= 0) emit progressUpdated(permille, 1000);
+    }
+    source.wait();
+
+    if (m_stopRequested) { return false; }
+    if (!source.errorString().isEmpty()) {
+        emit errorOccurred(source.errorString());
+        return false;
+    }
+
+    const MediaInfo mediaInfo = source.mediaInfo();
+    emit progressUpdated(100, 100);
+    emit mediaInfoReady(mediaInfo);
+    m_fps = mediaInfo.fps;
+    m_videoWidth = mediaInfo.width;
+    m_videoHeight = mediaInfo.height;
+    m_totalFrames = source.nbFrames();
+    if (m_totalFrames <= 0 && mediaInfo.duration > 0 && m_fps > 0) m_totalFrames = int(mediaInfo.duration * m_fps + 0.5);
+    if (keyframeCount == 0) {
+        emit errorOccurred("Lỗi: Đã đọc xong video nhưng không giải mã được keyframe nào.");
+        return false;
+    }
+    emit logMessage(QString("[%1]     -> Đã giải mã %2 keyframe (%3 ms), trung bình một keyframe mỗi %4 frame.")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(keyframeCount).arg(timer.elapsed())
+                        .arg(m_totalFrames > 0 ? QString::number(double(m_totalFrames) / keyframeCount, 'f', 1) : QString("?")));
+
+    m_currentStep++;
+    m_currentPhase = "Gom vùng nghi lỗi";
+    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+
+    // Vùng còn mở kéo tới cuối file
+    const int lastFrame = std::max(previousKeyframe, m_totalFrames - 1);
+    blackRegions.close(lastFrame);
+    borderRegions.close(lastFrame);
+
+    QList<AnalysisResult> pending;
+    for (const QList<AnalysisResult>* list : { &blackResults, &borderResults }) {
+        for (const AnalysisResult& result : *list) appendResult(pending, result);
+        flushResults(pending);
+    }
+    if (m_stopRequested) { return false; }
+
+    emit logMessage(QString("[%1] Quét keyframe xong: %2 vùng nghi lỗi (ƯỚC LƯỢNG — ranh giới chính xác tới khoảng cách giữa hai keyframe, "
+                            "lỗi không chạm keyframe nào không được phát hiện).")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_emittedResultCount));
+    return true;
+}
+#endif
+
 void QCToolsManager::processReportFile(const QString &reportPath, const QVariantMap &settings) {
     resetState();
 
@@ -208,20 +820,14 @@ void QCToolsManager::processReportFile(const QString &reportPath, const QVariant
 
     if (m_stopRequested) { emit analysisFinished(false); return; }
 
+    if (prepareResultCache(reportPath) && loadFromResultCache()) return;
+
     if (fileName.endsWith(".xml") || fileName.endsWith(".qctools.xml")) {
-        QFile reportFile(reportPath);
-        if (reportFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            if (parseReport(&reportFile)) {
-                emit analysisFinished(true);
-            } else {
-                emit analysisFinished(false);
-            }
-        } else {
-             emit errorOccurred("Không thể mở file báo cáo XML.");
-             emit analysisFinished(false);
-        }
+        emit analysisFinished(runReportPipeline(reportPath));
     } else if (fileName.endsWith(".xml.gz") || fileName.endsWith(".qctools.xml.gz")) {
-        decompressGzFile(reportPath);
+        // Bước giải nén chạy song song với việc đọc XML trong pipeline
+        m_currentStep = 1;
+        emit analysisFinished(runReportPipeline(reportPath));
     } else if (fileName.endsWith(".mkv") || fileName.endsWith(".qctools.mkv")) {
         m_tempDir = std::make_unique<QTemporaryDir>();
         if (m_tempDir && m_tempDir->isValid()) {
@@ -234,6 +840,154 @@ void QCToolsManager::processReportFile(const QString &reportPath, const QVariant
 }
 
 
+void QCToolsManager::compareReports(const QString &referencePath, const QString &candidatePath, const QVariantMap &settings) {
+    resetState();
+
+    emit analysisStarted();
+    emit logMessage(QString("[%1] Bắt đầu phiên làm việc mới (So sánh báo cáo).").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
+    emit logMessage(QString("   - Bản gốc (tham chiếu): %1").arg(referencePath));
+    emit logMessage(QString("   - Bản cần kiểm tra: %1").arg(candidatePath));
+
+    m_filePath.clear();
+    m_sourceReportPath = candidatePath;
+    m_settings = settings;
+    m_totalSteps = m_totalStepsCompare;
+
+    MediaInfo referenceInfo, candidateInfo;
+    MetricPyramidPtr referenceMetrics, candidateMetrics;
+    QList<AnalysisResult> referenceResults, candidateResults;
+    if (!loadReportForComparison(referencePath, "bản gốc", &referenceInfo, &referenceMetrics, &referenceResults)
+        || !loadReportForComparison(candidatePath, "bản cần kiểm tra", &candidateInfo, &candidateMetrics, &candidateResults)) {
+        emit analysisFinished(false);
+        return;
+    }
+
+    if (referenceInfo.frameRate.isValid() && candidateInfo.frameRate.isValid() && referenceInfo.frameRate != candidateInfo.frameRate) {
+        emit logMessage(QString("[WARNING] Hai bản có tốc độ khung hình khác nhau (%1 và %2 fps); so sánh theo frame có thể không khớp.")
+                            .arg(referenceInfo.fps, 0, 'f', 3).arg(candidateInfo.fps, 0, 'f', 3));
+    }
+
+    m_currentStep++;
+    m_currentPhase = "So sánh hai báo cáo";
+    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+
+    QElapsedTimer timer;
+    timer.start();
+    const ReportComparison comparison = ReportComparator::compare(*referenceMetrics, referenceResults, *candidateMetrics, candidateResults);
+    if (m_stopRequested) { emit analysisFinished(false); return; }
+
+    emit logMessage(QString("[%1]     -> Căn chỉnh: bản cần kiểm tra lệch %2 frame so với bản gốc (tương quan YDIF %3), %4 frame được so sánh (%5 ms).")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(comparison.offset)
+                        .arg(comparison.correlation, 0, 'f', 3).arg(comparison.alignedFrames).arg(timer.elapsed()));
+    static const char* channelNames[MetricPyramid::ChannelCount] = { "YAVG", "YDIF", "Viền trên", "Viền dưới", "Viền trái", "Viền phải" };
+    for (int c = 0; c < MetricPyramid::ChannelCount; ++c) {
+        const ReportComparison::ChannelStats &stats = comparison.channels[c];
+        if (stats.comparedFrames == 0) continue;
+        emit logMessage(QString("       - %1: chênh lệch TB %2, lớn nhất %3 (frame %4), %5 frame vượt ngưỡng")
+                            .arg(channelNames[c]).arg(stats.meanAbsDiff, 0, 'f', 2).arg(stats.maxAbsDiff, 0, 'f', 2)
+                            .arg(stats.maxAtFrame).arg(stats.framesOverTolerance));
+    }
+
+    const int videoWidth = candidateInfo.width, videoHeight = candidateInfo.height;
+    for (const ReportComparison::ChangedError &changed : comparison.changedErrors) {
+        emit logMessage(QString("       - [THAY ĐỔI] %1 frame %2-%3 (gốc: %4-%5): %6 (gốc: %7)")
+                            .arg(ResultFormat::errorTypeName(changed.candidate.type))
+                            .arg(changed.candidate.startFrame).arg(changed.candidate.endFrame)
+                            .arg(changed.reference.startFrame).arg(changed.reference.endFrame)
+                            .arg(ResultFormat::details(changed.candidate, videoWidth, videoHeight))
+                            .arg(ResultFormat::details(changed.reference, referenceInfo.width, referenceInfo.height)));
+    }
+
+    // Bảng kết quả chỉ hiện lỗi mới và lỗi thay đổi của bản cần kiểm tra, theo thứ tự thời gian
+    QList<AnalysisResult> reported = comparison.newErrors;
+    for (const ReportComparison::ChangedError &changed : comparison.changedErrors) reported.append(changed.candidate);
+    std::sort(reported.begin(), reported.end(), [](const AnalysisResult &a, const AnalysisResult &b) {
+        return a.startFrame != b.startFrame ? a.startFrame < b.startFrame : a.type < b.type;
+    });
+    for (int i = 0; i < reported.size(); ++i) reported[i].id = i;
+
+    m_fps = candidateInfo.fps;
+    m_videoWidth = videoWidth;
+    m_videoHeight = videoHeight;
+    emit progressUpdated(100, 100);
+    emit mediaInfoReady(candidateInfo);
+    emit metricsReady(candidateMetrics);
+    for (qsizetype i = 0; i < reported.size(); i += RESULT_BATCH_SIZE) {
+        emit resultsBatchReady(reported.mid(i, RESULT_BATCH_SIZE));
+    }
+
+    emit logMessage(QString("[%1] So sánh xong: %2 lỗi mới, %3 lỗi thay đổi, %4 lỗi giống bản gốc.")
+                        .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(comparison.newErrors.size())
+                        .arg(comparison.changedErrors.size()).arg(comparison.unchangedErrors));
+    emit comparisonFinished(comparison.offset, int(comparison.newErrors.size()), int(comparison.changedErrors.size()));
+    emit analysisFinished(true);
+}
+
+void QCToolsManager::evaluateProfiles(const QString &reportPath, const QVariantList &profiles, const QVariantMap &settings) {
+    resetState();
+
+    emit analysisStarted();
+    emit logMessage(QString("[%1] Bắt đầu phiên làm việc mới (Đánh giá nhiều cấu hình).").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
+    emit logMessage(QString("   - File: %1").arg(reportPath));
+
+    m_filePath.clear();
+    m_sourceReportPath = reportPath;
+    m_settings = settings;
+    m_qcliPath = settings.value(AppConstants::K_QCCLI_PATH).toString();
+    m_totalSteps = m_totalStepsViewReport;
+
+    // Mỗi cấu hình chỉ ghi đè các ngưỡng; giới hạn bộ nhớ, cache... lấy từ thiết lập chung
+    ProfileList profileList;
+    for (const QVariant& item : profiles) {
+        const QVariantMap profile = item.toMap();
+        QVariantMap merged = settings;
+        const QVariantMap overrides = profile.value("settings").toMap();
+        for (auto it = overrides.constBegin(); it != overrides.constEnd(); ++it) merged[it.key()] = it.value();
+        profileList.append({ profile.value("name").toString(), merged });
+        emit logMessage(QString("   - Cấu hình: %1").arg(profileList.last().first));
+    }
+    if (profileList.isEmpty()) {
+        emit errorOccurred("Chưa chọn cấu hình nào để đánh giá.");
+        emit analysisFinished(false);
+        return;
+    }
+
+    const QString fileName = QFileInfo(reportPath).fileName().toLower();
+    if (!fileName.endsWith(".xml") && !fileName.endsWith(".xml.gz")) {
+        emit errorOccurred("Đánh giá nhiều cấu hình chỉ hỗ trợ báo cáo .xml và .xml.gz.");
+        emit analysisFinished(false);
+        return;
+    }
+    if (m_stopRequested) { emit analysisFinished(false); return; }
+
+    prepareResultCache(reportPath);
+    if (fileName.endsWith(".xml.gz")) m_currentStep = 1;
+    emit analysisFinished(runReportPipeline(reportPath, profileList));
+}
+
+bool QCToolsManager::loadReportForComparison(const QString &reportPath, const QString &label, MediaInfo *info,
+                                             MetricPyramidPtr *metrics, QList<AnalysisResult> *results) {
+    const QString fileName = QFileInfo(reportPath).fileName().toLower();
+    if (!fileName.endsWith(".xml") && !fileName.endsWith(".xml.gz")) {
+        emit errorOccurred("Chế độ so sánh chỉ hỗ trợ báo cáo .xml và .xml.gz.");
+        return false;
+    }
+
+    // Cùng đường đọc và cùng bộ phát hiện lỗi như khi mở một báo cáo, kết quả gom vào `results` thay vì gửi lên giao diện
+    m_totalFrames = 0;
+    ReportPipeline pipeline(reportPath, m_stopRequested);
+    FrameStorePtr frames;
+    m_resultSink = results;
+    const bool ok = runFrameSource(pipeline, QString("Đọc & Phân tích Báo cáo %1").arg(label), {}, &frames);
+    m_resultSink = nullptr;
+    if (!ok || m_stopRequested) return false;
+
+    *info = pipeline.mediaInfo();
+    *metrics = MetricPyramid::build(frames, info->width, info->height);
+    return true;
+}
+
 void QCToolsManager::onAnalysisStage1Finished(int exitCode, QProcess::ExitStatus exitStatus) {
     readAnalysisOutput();
     if (m_stopRequested) {
@@ -248,21 +1002,20 @@ void QCToolsManager::onAnalysisStage1Finished(int exitCode, QProcess::ExitStatus
 
     emit logMessage(QString("[%1] Hoàn tất Bước 1 & 2 (Phân tích và Tạo XML).").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
 
-    QFile reportFile(getReportPath(ReportType::XML));
-    if (!reportFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        emit errorOccurred("Không thể mở file báo cáo XML vừa tạo.");
-        emit analysisFinished(false);
-        return;
-    }
+    // Báo cáo vừa tạo vẫn nằm cạnh video, nên lưu kết quả để lần mở lại không phải đọc lại
+    prepareResultCache(getReportPath(ReportType::XML));
 
-    if (parseReport(&reportFile)) {
+    if (runReportPipeline(getReportPath(ReportType::XML))) {
+#ifdef VIDEOQC_HAVE_LIBAV
+        if (!m_filePath.isEmpty() && m_settings.value(AppConstants::K_WRITE_GOP_INDEX, false).toBool()) writeGopIndex(getReportPath(ReportType::GZ));
+#endif
         if (!m_filePath.isEmpty()) {
             startMkvGeneration();
         } else {
             emit analysisFinished(true);
         }
     } else {
-        // Nếu parseReport trả về false, nó có thể là do người dùng đã dừng,
+        // Nếu runReportPipeline trả về false, nó có thể là do người dùng đã dừng,
         // không cần phát tín hiệu lỗi nữa.
         if (!m_stopRequested) {
             emit errorOccurred("Phân tích file XML thất bại.");
@@ -297,18 +1050,7 @@ void QCToolsManager::onExtractionFinished(int exitCode, QProcess::ExitStatus exi
     }
     emit logMessage(QString("[%1] Trích xuất thành công.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
 
-    QFile reportFile(getReportPath(ReportType::XML));
-    if (!reportFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        emit errorOccurred("Không thể mở file báo cáo XML vừa trích xuất.");
-        emit analysisFinished(false);
-        return;
-    }
-
-    if (parseReport(&reportFile)) {
-        emit analysisFinished(true);
-    } else {
-        emit analysisFinished(false);
-    }
+    emit analysisFinished(runReportPipeline(getReportPath(ReportType::XML)));
 }
 
 void QCToolsManager::startMkvGeneration() {
@@ -390,8 +1132,12 @@ void QCToolsManager::readAnalysisOutput() {
             if (m_totalFramesFromLog == 0 && totalFrames > 0 && !m_isGeneratingReport) {
                 m_totalFramesFromLog = totalFrames;
             }
+            // qcli có thể báo tổng 0 khi container không ghi nb_frames: dùng số frame đã đọc nhanh từ header
+            if (totalFrames <= 0 && !m_isGeneratingReport) totalFrames = m_probedFrames;
             if (totalFrames > 0) {
-                emit statusUpdated(QString("Bước %1/%2 - %3").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+                const QString eta = m_isGeneratingReport ? QString()
+                                  : remainingTimeText(m_progressTimer.elapsed(), double(currentFrame) / totalFrames);
+                emit statusUpdated(QString("Bước %1/%2 - %3%4").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase).arg(eta));
                 emit progressUpdated(currentFrame, totalFrames);
             }
         }
@@ -399,518 +1145,307 @@ void QCToolsManager::readAnalysisOutput() {
 }
 
 // =============================================================================
-// DECOMPRESSION LOGIC (CẢI TIẾN)
+// REPORT PARSING LOGIC
 // =============================================================================
 
-#define CHUNK_SIZE 16384 // Sử dụng buffer 16KB
+bool QCToolsManager::runReportPipeline(const QString &reportPath, const ProfileList &profiles) {
+    ReportPipeline pipeline(reportPath, m_stopRequested);
+    return runFrameSource(pipeline, "Đọc, Phân tích & Gắn thẻ Báo cáo", profiles);
+}
 
-void QCToolsManager::decompressGzFile(const QString &gzPath) {
-    m_currentStep = 1;
-    m_currentPhase = "Giải nén báo cáo";
+bool QCToolsManager::runFrameSource(FrameSource &source, const QString &phase, const ProfileList &profiles, FrameStorePtr *frames) {
+    // Đọc dữ liệu frame và gắn thẻ chạy chồng lên nhau nên được tính chung thành hai bước
+    m_currentStep += 2;
+    m_currentPhase = phase;
     emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
     emit progressUpdated(0, 100);
-    emit logMessage(QString("[%1] Bắt đầu Bước 1/%2: %3 file nén...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4 (%5)...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase).arg(source.stagesDescription()));
 
-    QFile gzFile(gzPath);
-    if (!gzFile.open(QIODevice::ReadOnly)) {
-        emit errorOccurred("Không thể mở file nén .gz để đọc.");
-        emit analysisFinished(false);
-        return;
-    }
-
-    auto tempOutFile = std::make_unique<QTemporaryFile>();
-    if (!tempOutFile->open()) {
-        emit errorOccurred("Không thể tạo file tạm để ghi dữ liệu giải nén.");
-        emit analysisFinished(false);
-        return;
-    }
+    if (m_stopRequested) { return false; }
 
-    z_stream zStream;
-    zStream.zalloc = Z_NULL;
-    zStream.zfree = Z_NULL;
-    zStream.opaque = Z_NULL;
-    zStream.avail_in = 0;
-    zStream.next_in = Z_NULL;
-    if (inflateInit2(&zStream, 16 + MAX_WBITS) != Z_OK) {
-        emit errorOccurred("Khởi tạo zlib thất bại.");
-        emit analysisFinished(false);
-        return;
+    QElapsedTimer timer;
+    timer.start();
+    const qint64 budgetMB = m_settings.value(AppConstants::K_FRAME_MEMORY_MB, 512).toLongLong();
+    QSharedPointer<FrameStore> allFramesData(new FrameStore(budgetMB * 1024 * 1024));
+    // Nguồn đọc liên tục cả file: số frame từ header xấp xỉ số frame sẽ lưu, dành chỗ trước
+    if (source.contiguousFrames() && m_settings.value(AppConstants::K_ANALYSIS_WINDOWS).toList().isEmpty())
+        allFramesData->reserve(m_settings.value(AppConstants::K_PROBED_FRAME_COUNT, -1).toInt());
+    bool spillLogged = false;
+    qint64 lastStatusMs = 0;
+    // Không có danh sách cấu hình: một bộ phát hiện theo m_settings. Có: mỗi cấu hình một bộ, cùng ăn một luồng frame
+    std::vector<std::unique_ptr<StreamingDetector>> detectors;
+    if (profiles.isEmpty()) {
+        detectors.push_back(std::make_unique<StreamingDetector>(m_settings));
+    } else {
+        for (const auto& profile : profiles) detectors.push_back(std::make_unique<StreamingDetector>(profile.second));
     }
 
-    Bytef in[CHUNK_SIZE];
-    Bytef out[CHUNK_SIZE];
-    int ret;
-    qint64 bytesRead = 0;
-    qint64 totalSize = gzFile.size();
+    // Một cấu hình: các nhóm lỗi đã đóng được gửi lên giao diện ngay sau lô frame đóng chúng, không chờ hết file.
+    // Nhóm đã đóng không bao giờ đổi nữa nên gửi sớm cho cùng kết quả như gửi một lần ở cuối.
+    QList<AnalysisResult> pending;
+    qsizetype emittedBlack = 0, emittedBorder = 0, emittedOrphan = 0;
+    auto emitClosedResults = [&]() {
+        if (!profiles.isEmpty()) return;
+        const StreamingDetector& detector = *detectors.front();
+        QList<AnalysisResult> closed;
+        for (qsizetype i = emittedBlack; i < detector.blackResults.size(); ++i) closed.append(detector.blackResults.at(i));
+        for (qsizetype i = emittedBorder; i < detector.borderResults.size(); ++i) closed.append(detector.borderResults.at(i));
+        for (qsizetype i = emittedOrphan; i < detector.orphanResults.size(); ++i) closed.append(detector.orphanResults.at(i));
+        emittedBlack = detector.blackResults.size();
+        emittedBorder = detector.borderResults.size();
+        emittedOrphan = detector.orphanResults.size();
+        if (closed.isEmpty()) return;
+        std::stable_sort(closed.begin(), closed.end(), [](const AnalysisResult& a, const AnalysisResult& b) { return a.startFrame < b.startFrame; });
+        for (const AnalysisResult& result : std::as_const(closed)) appendResult(pending, result);
+        flushResults(pending);
+    };
 
-    do {
-        if (m_stopRequested) {
-            (void)inflateEnd(&zStream);
-            emit analysisFinished(false);
-            return;
+    // Luồng này là giai đoạn cuối của pipeline: lưu số liệu frame và tìm lỗi trên từng lô
+    source.start();
+    FrameSource::FrameBatch batch;
+    bool firstBatch = true;
+    m_lastFrameCount = 0;
+    m_lastFramesNumberedFromZero = true;
+    while (source.nextBatch(&batch)) {
+        if (firstBatch) {
+            for (auto& detector : detectors) detector->begin(batch.videoWidth, batch.videoHeight);
+            firstBatch = false;
         }
-
-        zStream.avail_in = gzFile.read(reinterpret_cast<char*>(in), CHUNK_SIZE);
-        bytesRead += zStream.avail_in;
-        if (gzFile.error() != QFile::NoError) {
-            emit errorOccurred("Lỗi khi đọc từ file .gz: " + gzFile.errorString());
-            (void)inflateEnd(&zStream);
-            emit analysisFinished(false);
-            return;
+        for (const FrameData& frame : std::as_const(batch.frames)) {
+            if (frame.frameNum != m_lastFrameCount) m_lastFramesNumberedFromZero = false;
+            ++m_lastFrameCount;
+            allFramesData->append(frame);
         }
-
-        if (zStream.avail_in == 0) break;
-        zStream.next_in = in;
-        
-        do {
-            zStream.avail_out = CHUNK_SIZE;
-            zStream.next_out = out;
-            ret = inflate(&zStream, Z_NO_FLUSH);
-
-            switch (ret) {
-                case Z_STREAM_ERROR: case Z_NEED_DICT: case Z_DATA_ERROR: case Z_MEM_ERROR:
-                    emit errorOccurred(QString("Lỗi giải nén zlib nghiêm trọng: mã lỗi %1").arg(ret));
-                    (void)inflateEnd(&zStream);
-                    emit analysisFinished(false);
-                    return;
-            }
-
-            unsigned int have = CHUNK_SIZE - zStream.avail_out;
-            if (tempOutFile->write(reinterpret_cast<const char*>(out), have) != have) {
-                emit errorOccurred("Lỗi khi ghi vào file tạm: " + tempOutFile->errorString());
-                (void)inflateEnd(&zStream);
-                emit analysisFinished(false);
-                return;
+        for (auto& detector : detectors) {
+            if (batch.newSequence) detector->breakSequence();
+            for (const FrameData& frame : std::as_const(batch.frames)) detector->push(frame);
+        }
+        emitClosedResults();
+        if (!spillLogged && allFramesData->isSpilled()) {
+            spillLogged = true;
+            emit logMessage(QString("[%1]     -> Số liệu frame vượt giới hạn %2 MB, chuyển sang chế độ ngoài bộ nhớ (file tạm).")
+                                .arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(budgetMB));
+        }
+        const int permille = source.progressPermille();
+        if (permille >= 0) {
+            emit progressUpdated(permille, 1000);
+            if (timer.elapsed() - lastStatusMs >= 1000) {
+                lastStatusMs = timer.elapsed();
+                emit statusUpdated(QString("Bước %1/%2 - %3...%4").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase)
+                                       .arg(remainingTimeText(lastStatusMs, permille / 1000.0)));
             }
-        } while (zStream.avail_out == 0);
-
-        if (totalSize > 0) {
-            emit progressUpdated(bytesRead, totalSize);
         }
-
-    } while (ret != Z_STREAM_END);
-
-    (void)inflateEnd(&zStream);
-    gzFile.close();
-    
-    if (m_stopRequested) {
-        emit analysisFinished(false);
-        return;
-    }
-
-    emit progressUpdated(100, 100);
-    emit logMessage(QString("[%1] Giải nén thành công.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
-
-    // CẢI TIẾN: Mở lại file tạm để đọc và phân tích
-    tempOutFile->seek(0);
-    if (parseReport(tempOutFile.get())) {
-         emit analysisFinished(true);
-    } else {
-         emit analysisFinished(false);
-    }
-}
-
-
-// =============================================================================
-// REPORT PARSING LOGIC
-// =============================================================================
-
-bool QCToolsManager::parseReport(QIODevice* device) {
-    if (!device) {
-        emit errorOccurred("Thiết bị đọc file báo cáo không hợp lệ.");
-        return false;
     }
-    m_currentStep++;
-    m_currentPhase = "Đọc & Phân tích Báo cáo";
-    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
-    emit progressUpdated(0, 100);
-    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
-
-    QXmlStreamReader xml(device);
-    
-    // CẢI TIẾN: Luôn kiểm tra yêu cầu dừng
-    if (m_stopRequested) { return false; }
-    
-    MediaInfo mediaInfo = parseMediaInfo(xml);
-    device->seek(0);
-    xml.setDevice(device);
+    source.wait();
 
     if (m_stopRequested) { return false; }
 
-    QList<FrameData> allFramesData = extractAllFrameData(xml);
-    
-    if (m_stopRequested) { return false; }
-
-    if (xml.hasError()) {
-        QString errorMsg = QString("Lỗi phân tích cú pháp XML: %1 (Dòng %2, Cột %3)").arg(xml.errorString()).arg(xml.lineNumber()).arg(xml.columnNumber());
-        emit errorOccurred(errorMsg);
+    const QString pipelineError = source.errorString();
+    if (!pipelineError.isEmpty()) {
+        emit errorOccurred(pipelineError);
         return false;
     }
-    
+    if (!allFramesData->spillError().isEmpty()) {
+        emit logMessage(QString("[WARNING] Không ghi được file tạm cho số liệu frame (%1), phần còn lại được giữ trong bộ nhớ.")
+                            .arg(allFramesData->spillError()));
+    }
+
+    // Trong báo cáo QCTools, <streams>/<format> có thể nằm sau các frame nên thông tin video chỉ chắc chắn có ở đây
+    const MediaInfo mediaInfo = source.mediaInfo();
     emit progressUpdated(100, 100);
-    emit mediaInfoReady(mediaInfo);
+    if (!m_resultSink) emit mediaInfoReady(mediaInfo);
 
     m_fps = mediaInfo.fps;
     m_videoWidth = mediaInfo.width;
     m_videoHeight = mediaInfo.height;
+    if (source.nbFrames() >= 0) m_totalFrames = source.nbFrames();
     if (m_totalFramesFromLog > 0) m_totalFrames = m_totalFramesFromLog;
 
     if (m_fps <= 0) {
-        emit errorOccurred("Lỗi nghiêm trọng: Không thể xác định FPS của video từ báo cáo. Dữ liệu timecode sẽ không chính xác.");
+        emit errorOccurred(QString("Lỗi nghiêm trọng: Không thể xác định FPS của video từ %1. Dữ liệu timecode sẽ không chính xác.").arg(source.sourceName()));
         return false;
     }
     if (m_videoWidth <= 0 || m_videoHeight <= 0) {
-        emit errorOccurred(QString("Lỗi: Đã đọc xong file XML nhưng không tìm thấy thông tin video stream hợp lệ (width/height=%1x%2).").arg(m_videoWidth).arg(m_videoHeight));
+        emit errorOccurred(QString("Lỗi: Đã đọc xong %1 nhưng không tìm thấy thông tin video stream hợp lệ (width/height=%2x%3).").arg(source.sourceName()).arg(m_videoWidth).arg(m_videoHeight));
         return false;
     }
-    if (allFramesData.isEmpty() && !m_stopRequested) {
-        emit errorOccurred("Lỗi: Đã đọc xong file XML nhưng không tìm thấy dữ liệu của bất kỳ frame nào.");
+    // Quét nhanh không thấy mẫu nào đáng ngờ thì không có frame nào được phân tích đầy đủ: không phải lỗi
+    if (allFramesData->isEmpty() && source.contiguousFrames()) {
+        emit errorOccurred(QString("Lỗi: Đã đọc xong %1 nhưng không tìm thấy dữ liệu của bất kỳ frame nào.").arg(source.sourceName()));
         return false;
     }
-    if (m_stopRequested) { return false; }
-
-    emit logMessage(QString("[%1]     -> Đã đọc xong. Tìm thấy %2 frame. Bắt đầu tổng hợp lỗi...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(allFramesData.count()));
-    if (m_totalFrames <= 0) m_totalFrames = allFramesData.size();
-
-    QList<AnalysisResult> finalResults = runErrorDetection(allFramesData);
-    if (m_stopRequested) { return false; }
-
-    if (!finalResults.isEmpty()) {
-        emit logMessage(QString("[%1] Tổng hợp xong. Tìm thấy %2 lỗi.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(finalResults.count()));
-        emit resultsReady(finalResults);
-    } else {
-        emit logMessage(QString("[%1] Tổng hợp xong. Không tìm thấy lỗi nào với cấu hình hiện tại.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
-        emit resultsReady({});
-    }
-    return true;
-}
 
-MediaInfo QCToolsManager::parseMediaInfo(QXmlStreamReader &xml) {
-    MediaInfo info;
-    bool inFormatSection = false;
-    bool foundVideoStream = false;
-    bool foundAudioStream = false;
-
-    while (!xml.atEnd()) {
-        if (m_stopRequested) return {};
-        xml.readNext();
-        if (xml.isStartElement()) {
-            if (xml.name() == QLatin1String("format")) {
-                inFormatSection = true;
-                const auto& attrs = xml.attributes();
-                info.formatName = attrs.value("format_long_name").toString();
-                info.duration = attrs.value("duration").toDouble();
-                info.size = attrs.value("size").toLongLong();
-                info.bitrate = attrs.value("bit_rate").toLongLong();
-            } else if (inFormatSection && xml.name() == QLatin1String("tag") && xml.attributes().value("key") == QLatin1String("creation_time")) {
-                info.creationTime = QDateTime::fromString(xml.attributes().value("value").toString(), Qt::ISODateWithMs);
-            } else if (xml.name() == QLatin1String("stream")) {
-                const auto& attrs = xml.attributes();
-                if (!foundVideoStream && attrs.value("codec_type") == QLatin1String("video")) {
-                    QStringList parts = attrs.value("r_frame_rate").toString().split('/');
-                    if (parts.size() == 2 && parts[1].toDouble() != 0) {
-                        info.fps = parts[0].toDouble() / parts[1].toDouble();
-                    }
-                    info.width = attrs.value("width").toInt();
-                    info.height = attrs.value("height").toInt();
-                    if (attrs.hasAttribute("nb_frames")) m_totalFrames = attrs.value("nb_frames").toInt();
-                    info.videoCodec = attrs.value("codec_long_name").toString();
-                    info.pixelFormat = attrs.value("pix_fmt").toString();
-                    info.colorSpace = attrs.value("color_space").toString();
-                    foundVideoStream = true;
-                } else if (!foundAudioStream && attrs.value("codec_type") == QLatin1String("audio")) {
-                    info.audioCodec = attrs.value("codec_long_name").toString();
-                    info.sampleRate = attrs.value("sample_rate").toInt();
-                    info.channelLayout = attrs.value("channel_layout").toString();
-                    foundAudioStream = true;
-                }
-            }
-        } else if (xml.isEndElement()) {
-            if (xml.name() == QLatin1String("format")) {
-                inFormatSection = false;
-            }
-            if (foundVideoStream && foundAudioStream) {
-                break;
-            }
-        }
+    emit logMessage(QString("[%1]     -> Đã đọc xong. Tìm thấy %2 frame (%3 ms).").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(allFramesData->size()).arg(timer.elapsed()));
+    emit logMessage(QString("   - Pipeline: %1.").arg(source.stageReport()));
+    if (m_totalFrames <= 0) m_totalFrames = allFramesData->size();
+    if (frames) *frames = allFramesData;
+
+    // Dữ liệu cho biểu đồ timeline (cần đủ các frame liên tiếp); kết quả gom vào m_resultSink thì người gọi tự dựng
+    MetricPyramidPtr metrics;
+    if (!source.contiguousFrames()) {
+        emit logMessage("   - Chỉ một phần các frame được phân tích: không dựng biểu đồ timeline, kết quả không lưu vào cache.");
+        m_cacheFingerprint.clear();
+    } else if (!m_resultSink) {
+        metrics = MetricPyramid::build(allFramesData, m_videoWidth, m_videoHeight);
+        emit metricsReady(metrics);
     }
-    return info;
-}
-
-
-QList<FrameData> QCToolsManager::extractAllFrameData(QXmlStreamReader &xml)
-{
-    QList<FrameData> allFramesData;
-    qint64 fileSize = xml.device() ? xml.device()->size() : 0;
-    int progressCounter = 0;
-
-    while (!xml.atEnd()) {
-        if (m_stopRequested) return {};
-        
-        // CẢI TIẾN: Báo cáo tiến trình đọc file XML
-        if (fileSize > 0 && ++progressCounter % 20 == 0) {
-             emit progressUpdated(xml.device()->pos(), fileSize);
-        }
-
-        xml.readNext();
-        if (xml.isStartElement() && xml.name() == QLatin1String("frame")) {
-            FrameData currentFrame;
-            currentFrame.frameNum = xml.attributes().value("pkt_pts").toInt();
-
-            int x1 = -1, y1 = -1, x2 = -1, y2 = -1;
-
-            while(xml.readNextStartElement()) {
-                if(xml.name() == QLatin1String("tag")) {
-                    const auto& attrs = xml.attributes();
-                    const auto& key = attrs.value("key").toString();
-                    const auto& value = attrs.value("value").toString();
-                    if (key == "lavfi.signalstats.YAVG") currentFrame.yavg = value.toDouble();
-                    else if (key == "lavfi.signalstats.YDIF") currentFrame.ydif = value.toDouble();
-                    else if (key == "lavfi.cropdetect.x1") x1 = static_cast<int>(value.toDouble());
-                    else if (key == "lavfi.cropdetect.y1") y1 = static_cast<int>(value.toDouble());
-                    else if (key == "lavfi.cropdetect.x2") x2 = static_cast<int>(value.toDouble());
-                    else if (key == "lavfi.cropdetect.y2") y2 = static_cast<int>(value.toDouble());
-                }
-                xml.skipCurrentElement();
-            }
-
-            if (x1 != -1 && y1 != -1 && x2 != -1 && y2 != -1) {
-                currentFrame.crop_x = x1;
-                currentFrame.crop_y = y1;
-                currentFrame.crop_w = x2 - x1 + 1;
-                currentFrame.crop_h = y2 - y1 + 1;
-            }
-            allFramesData.append(currentFrame);
-        }
-    }
-    return allFramesData;
-}
-
-
-QList<AnalysisResult> QCToolsManager::runErrorDetection(const QList<FrameData> &allFramesData)
-{
-    m_currentStep++;
-    m_currentPhase = "Gắn thẻ các frame";
-    emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
-    emit progressUpdated(0, 100);
-    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
-
-    if (m_stopRequested) return {};
-    QMap<int, QSet<QString>> frameTags = tagFramesForErrors(allFramesData);
-    
-    if (m_stopRequested) return {};
-
-    emit progressUpdated(100, 100);
-    emit logMessage(QString("[%1]       - Hoàn tất.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
 
     m_currentStep++;
     m_currentPhase = "Gom nhóm lỗi";
     emit statusUpdated(QString("Bước %1/%2 - %3...").arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
-    emit progressUpdated(0, 100);
-    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %3...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
+    emit logMessage(QString("[%1] Bắt đầu Bước %2/%3: %4...").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_currentStep).arg(m_totalSteps).arg(m_currentPhase));
 
-    if (m_stopRequested) return {};
-    QList<AnalysisResult> finalResults = groupErrorsFromTags(frameTags, allFramesData);
+    // Nhóm cuối cùng và cảnh cuối chỉ đóng được khi đã biết tổng số frame
+    for (auto& detector : detectors) detector->finish(*allFramesData, m_videoWidth, m_videoHeight, m_totalFrames);
+
+    if (!profiles.isEmpty()) {
+        // Mỗi cấu hình có danh sách kết quả riêng, xếp theo frame bắt đầu như luồng một cấu hình rồi mới đánh ID từ 0,
+        // và được lưu vào cache theo khóa của chính nó
+        // nên lần sau mở báo cáo với một trong các cấu hình này sẽ không phải đọc lại
+        emit logMessage("   - So sánh các cấu hình (Frame Đen / Viền Đen / Frame Dư / Tổng):");
+        for (int i = 0; i < profiles.size(); ++i) {
+            if (m_stopRequested) return false;
+            const StreamingDetector& detector = *detectors[i];
+            QList<AnalysisResult> results;
+            results.reserve(detector.blackResults.size() + detector.borderResults.size() + detector.orphanResults.size());
+            for (const QList<AnalysisResult>* list : { &detector.blackResults, &detector.borderResults, &detector.orphanResults })
+                results.append(*list);
+            std::stable_sort(results.begin(), results.end(), [](const AnalysisResult& a, const AnalysisResult& b) { return a.startFrame < b.startFrame; });
+            for (qsizetype r = 0; r < results.size(); ++r) results[r].id = int(r);
+            emit logMessage(QString("       %1: %2 / %3 / %4 / %5").arg(profiles[i].first).arg(detector.blackResults.size())
+                                .arg(detector.borderResults.size()).arg(detector.orphanResults.size()).arg(results.size()));
+            if (!m_cacheFingerprint.isEmpty()) {
+                ResultCache::Entry entry;
+                entry.mediaInfo = mediaInfo;
+                entry.totalFrames = m_totalFrames;
+                entry.results = results;
+                entry.metrics = metrics;
+                ResultCache::store(m_cacheFingerprint, ResultCache::profileHash(profiles[i].second), entry);
+            }
+            emit profileResultsReady(i, profiles[i].first, results);
+        }
+        m_cacheFingerprint.clear();
+        emit progressUpdated(100, 100);
+        emit logMessage(QString("[%1] Đánh giá xong %2 cấu hình trong một lượt đọc báo cáo.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(profiles.size()));
+        return true;
+    }
 
-    if (m_stopRequested) return {};
+    // Các nhóm chỉ đóng ở cuối file (nhóm cuối, cảnh cuối, viền đen khi kích thước chỉ có ở cuối báo cáo)
+    emitClosedResults();
+    if (m_stopRequested) { return false; }
 
     emit progressUpdated(100, 100);
     emit logMessage(QString("[%1]       - Hoàn tất.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
+    storeInResultCache(mediaInfo, metrics);
 
-    return finalResults;
+    const qsizetype resultCount = m_resultSink ? m_resultSink->size() : m_emittedResultCount;
+    if (resultCount > 0) {
+        emit logMessage(QString("[%1] Tổng hợp xong. Tìm thấy %2 lỗi.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(resultCount));
+    } else {
+        emit logMessage(QString("[%1] Tổng hợp xong. Không tìm thấy lỗi nào với cấu hình hiện tại.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
+    }
+    return true;
 }
 
-QMap<int, QSet<QString>> QCToolsManager::tagFramesForErrors(const QList<FrameData> &allFramesData)
+bool QCToolsManager::prepareResultCache(const QString &reportPath)
 {
-    QMap<int, QSet<QString>> frameTags;
-    const double blackFrameThresh = m_settings.value(AppConstants::K_BLACK_FRAME_THRESH, 17.0).toDouble();
-    const double borderThreshPercent = m_settings.value(AppConstants::K_BORDER_THRESH, 0.2).toDouble();
-    const double sceneThresh = m_settings.value(AppConstants::K_SCENE_THRESH, 30.0).toDouble();
-    const bool hasTransitions = m_settings.value(AppConstants::K_HAS_TRANSITIONS, false).toBool();
-    const int total = allFramesData.size();
-
-    for(int i = 0; i < total; ++i) {
-        if (m_stopRequested) return {};
-        if (i % 500 == 0) emit progressUpdated(i, total);
-
-        const auto& frame = allFramesData[i];
-        if (m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool() && frame.yavg < blackFrameThresh) {
-            frameTags[frame.frameNum].insert(AppConstants::TAG_IS_BLACK);
-        }
-        if (m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool()) {
-            bool isAlreadyBlack = frameTags.contains(frame.frameNum) && frameTags[frame.frameNum].contains(AppConstants::TAG_IS_BLACK);
-            if (!isAlreadyBlack) {
-                CropValues cv = CropValues::fromFrameData(frame, m_videoWidth, m_videoHeight);
-                if (cv.isValid() && cv.hasBorders(borderThreshPercent, m_videoWidth, m_videoHeight)) {
-                    frameTags[frame.frameNum].insert(AppConstants::TAG_HAS_BORDER);
-                }
-            }
-        }
-        if (m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool() && i > 0) {
-            if (hasTransitions) {
-                if (i < allFramesData.size() - 1) {
-                    const auto& prev = allFramesData[i-1];
-                    const auto& next = allFramesData[i+1];
-                    if (frame.ydif > sceneThresh && frame.ydif > prev.ydif && frame.ydif > next.ydif) {
-                        frameTags[frame.frameNum].insert(AppConstants::TAG_IS_SCENE_CUT);
-                    }
-                }
-            } else {
-                bool isNormalCut = (frame.ydif > sceneThresh && allFramesData[i-1].ydif < (sceneThresh / 2.0));
-                bool isTinySceneEnd = false;
-                if (i + 1 < allFramesData.size()) {
-                    isTinySceneEnd = (frame.ydif > sceneThresh && allFramesData[i-1].ydif > sceneThresh && allFramesData[i+1].ydif < (sceneThresh / 2.0));
-                }
-                if (isNormalCut || isTinySceneEnd) {
-                     frameTags[frame.frameNum].insert(AppConstants::TAG_IS_SCENE_CUT);
-                }
-            }
-        }
+    m_cacheFingerprint.clear();
+    m_cacheProfile.clear();
+    m_cacheResults.clear();
+    if (!m_settings.value(AppConstants::K_RESULT_CACHE, true).toBool()) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+    bool hashed = false;
+    const QByteArray fingerprint = ResultCache::reportFingerprint(reportPath, &hashed);
+    if (fingerprint.isEmpty()) return false;
+    if (hashed) {
+        emit logMessage(QString("[%1]     -> Đã tính mã băm báo cáo cho cache (%2 ms).").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(timer.elapsed()));
     }
-    return frameTags;
+    m_cacheFingerprint = fingerprint;
+    m_cacheProfile = ResultCache::profileHash(m_settings);
+    return true;
 }
 
-QList<AnalysisResult> QCToolsManager::groupErrorsFromTags(const QMap<int, QSet<QString>> &frameTags, const QList<FrameData> &allFramesData)
+bool QCToolsManager::loadFromResultCache()
 {
-    QList<AnalysisResult> finalResults;
-    if (m_settings.value(AppConstants::K_DETECT_BLACK_FRAMES, true).toBool()) {
-        if (m_stopRequested) return {};
-        groupBlackFrames(finalResults, frameTags, allFramesData);
+    QElapsedTimer timer;
+    timer.start();
+    ResultCache::Entry entry;
+    if (!ResultCache::load(m_cacheFingerprint, m_cacheProfile, &entry)) {
+        emit logMessage("[INFO] Cache kết quả: chưa có kết quả cho báo cáo và cấu hình này, sẽ phân tích báo cáo.");
+        return false;
     }
-    if (m_settings.value(AppConstants::K_DETECT_BLACK_BORDERS, true).toBool()) {
-        if (m_stopRequested) return {};
-        groupBorderedFrames(finalResults, frameTags, allFramesData);
+
+    // Đã có kết quả: không lưu lại lần nữa
+    m_cacheFingerprint.clear();
+    m_fps = entry.mediaInfo.fps;
+    m_videoWidth = entry.mediaInfo.width;
+    m_videoHeight = entry.mediaInfo.height;
+    m_totalFrames = entry.totalFrames;
+
+    emit logMessage(QString("[%1] [INFO] Cache kết quả: trùng khớp, bỏ qua giải nén và đọc báo cáo (%2 ms).").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(timer.elapsed()));
+    emit statusUpdated("Đã tải kết quả từ cache.");
+    emit progressUpdated(100, 100);
+    emit mediaInfoReady(entry.mediaInfo);
+    if (entry.metrics) emit metricsReady(entry.metrics);
+
+    for (qsizetype i = 0; i < entry.results.size() && !m_stopRequested; i += RESULT_BATCH_SIZE) {
+        emit resultsBatchReady(entry.results.mid(i, RESULT_BATCH_SIZE));
     }
-    if (m_settings.value(AppConstants::K_DETECT_ORPHAN_FRAMES, true).toBool()) {
-        if (m_stopRequested) return {};
-        findOrphanFrames(finalResults, frameTags, allFramesData);
+    m_emittedResultCount = int(entry.results.size());
+    m_nextResultId = m_emittedResultCount;
+
+    if (m_emittedResultCount > 0) {
+        emit logMessage(QString("[%1] Tổng hợp xong. Tìm thấy %2 lỗi.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")).arg(m_emittedResultCount));
+    } else {
+        emit logMessage(QString("[%1] Tổng hợp xong. Không tìm thấy lỗi nào với cấu hình hiện tại.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
     }
-    return finalResults;
+    emit analysisFinished(!m_stopRequested);
+    return true;
 }
 
-void QCToolsManager::groupBlackFrames(QList<AnalysisResult> &results, const QMap<int, QSet<QString>> &tags, const QList<FrameData> &frames)
+void QCToolsManager::storeInResultCache(const MediaInfo &mediaInfo, const MetricPyramidPtr &metrics)
 {
-    QList<FrameData> currentGroup;
-    for(const auto& frame : frames) {
-        if(m_stopRequested) return;
-        bool isBlack = tags.contains(frame.frameNum) && tags[frame.frameNum].contains(AppConstants::TAG_IS_BLACK);
-        if (isBlack) {
-            currentGroup.append(frame);
-        } else {
-            if (!currentGroup.isEmpty()) {
-                double yavgSum = 0;
-                for(const auto& f : currentGroup) yavgSum += f.yavg;
-                const int startFrame = currentGroup.first().frameNum;
-                const int endFrame = currentGroup.last().frameNum;
-                QString details = QString("Frame tối (YAVG TB: %1), từ frame %2 đến %3")
-                                      .arg(yavgSum / currentGroup.count(), 0, 'f', 2)
-                                      .arg(startFrame)
-                                      .arg(endFrame);
-                results.append({ QCToolsManager::frameToTimecodeHHMMSSFF(startFrame, m_fps), QString::number(currentGroup.count()), AppConstants::ERR_BLACK_FRAME, details, startFrame });
-                currentGroup.clear();
-            }
-        }
-    }
-    if (!currentGroup.isEmpty()) {
-         double yavgSum = 0;
-         for(const auto& f : currentGroup) yavgSum += f.yavg;
-         const int startFrame = currentGroup.first().frameNum;
-         const int endFrame = currentGroup.last().frameNum;
-         QString details = QString("Frame tối (YAVG TB: %1), từ frame %2 đến %3")
-                               .arg(yavgSum / currentGroup.count(), 0, 'f', 2)
-                               .arg(startFrame)
-                               .arg(endFrame);
-         results.append({ QCToolsManager::frameToTimecodeHHMMSSFF(startFrame, m_fps), QString::number(currentGroup.count()), AppConstants::ERR_BLACK_FRAME, details, startFrame });
+    if (m_cacheFingerprint.isEmpty() || m_stopRequested) return;
+
+    ResultCache::Entry entry;
+    entry.mediaInfo = mediaInfo;
+    entry.totalFrames = m_totalFrames;
+    entry.results = std::move(m_cacheResults);
+    entry.metrics = metrics;
+    if (ResultCache::store(m_cacheFingerprint, m_cacheProfile, entry)) {
+        emit logMessage(QString("[%1]     -> Đã lưu kết quả vào cache.").arg(QTime::currentTime().toString("hh:mm:ss.zzz")));
     }
+    m_cacheFingerprint.clear();
+    m_cacheResults.clear();
 }
 
-void QCToolsManager::groupBorderedFrames(QList<AnalysisResult> &results, const QMap<int, QSet<QString>> &tags, const QList<FrameData> &frames)
+void QCToolsManager::appendResult(QList<AnalysisResult> &pending, const AnalysisResult &result)
 {
-    std::optional<BorderGroup> currentGroupOpt;
-    for(const auto& frame : frames) {
-        if(m_stopRequested) return;
-        bool isBordered = tags.contains(frame.frameNum) && tags[frame.frameNum].contains(AppConstants::TAG_HAS_BORDER);
-         if (isBordered) {
-            CropValues cv = CropValues::fromFrameData(frame, m_videoWidth, m_videoHeight);
-            if (!currentGroupOpt.has_value()) {
-                currentGroupOpt.emplace(BorderGroup{frame.frameNum, frame.frameNum, 1, cv, cv});
-            } else {
-                BorderGroup& currentGroup = currentGroupOpt.value();
-                currentGroup.endFrame = frame.frameNum;
-                currentGroup.count++;
-                currentGroup.minCv.top = std::min(currentGroup.minCv.top, cv.top); currentGroup.maxCv.top = std::max(currentGroup.maxCv.top, cv.top);
-                currentGroup.minCv.bottom = std::min(currentGroup.minCv.bottom, cv.bottom); currentGroup.maxCv.bottom = std::max(currentGroup.maxCv.bottom, cv.bottom);
-                currentGroup.minCv.left = std::min(currentGroup.minCv.left, cv.left); currentGroup.maxCv.left = std::max(currentGroup.maxCv.left, cv.left);
-                currentGroup.minCv.right = std::min(currentGroup.minCv.right, cv.right); currentGroup.maxCv.right = std::max(currentGroup.maxCv.right, cv.right);
-            }
-        } else {
-            if (currentGroupOpt.has_value()) {
-                QString details = formatCropDetails(currentGroupOpt->minCv, currentGroupOpt->maxCv, m_videoWidth, m_videoHeight) +
-                                  QString(", từ frame %1 đến %2").arg(currentGroupOpt->startFrame).arg(currentGroupOpt->endFrame);
-                results.append({ QCToolsManager::frameToTimecodeHHMMSSFF(currentGroupOpt->startFrame, m_fps), QString::number(currentGroupOpt->count), AppConstants::ERR_BLACK_BORDER, details, currentGroupOpt->startFrame });
-                currentGroupOpt.reset();
-            }
-        }
-    }
-    if (currentGroupOpt.has_value()) {
-        QString details = formatCropDetails(currentGroupOpt->minCv, currentGroupOpt->maxCv, m_videoWidth, m_videoHeight) +
-                          QString(", từ frame %1 đến %2").arg(currentGroupOpt->startFrame).arg(currentGroupOpt->endFrame);
-        results.append({ QCToolsManager::frameToTimecodeHHMMSSFF(currentGroupOpt->startFrame, m_fps), QString::number(currentGroupOpt->count), AppConstants::ERR_BLACK_BORDER, details, currentGroupOpt->startFrame });
-    }
+    pending.append(result);
+    pending.last().id = m_nextResultId++;
+    if (pending.size() >= RESULT_BATCH_SIZE) flushResults(pending);
 }
 
-void QCToolsManager::findOrphanFrames(QList<AnalysisResult> &results, const QMap<int, QSet<QString>> &tags, const QList<FrameData> &frames)
+void QCToolsManager::flushResults(QList<AnalysisResult> &pending)
 {
-    const int orphanThresh = m_settings.value(AppConstants::K_ORPHAN_THRESH, 5).toInt();
-    if (orphanThresh <= 0) return;
-
-    QList<int> scene_cuts;
-    scene_cuts.append(0);
-    for(const auto& frame : frames) {
-        if(tags.value(frame.frameNum).contains(AppConstants::TAG_IS_SCENE_CUT)) {
-            scene_cuts.append(frame.frameNum);
-        }
-    }
-    if (m_totalFrames > 0 && (scene_cuts.isEmpty() || scene_cuts.last() != m_totalFrames)) {
-        scene_cuts.append(m_totalFrames);
-    }
-    
-    std::sort(scene_cuts.begin(), scene_cuts.end());
-    auto last = std::unique(scene_cuts.begin(), scene_cuts.end());
-    scene_cuts.erase(last, scene_cuts.end());
-
-    for (int i = 0; i < scene_cuts.size() - 1; ++i) {
-        if(m_stopRequested) return;
-        const int startFrame = scene_cuts[i];
-        
-        if (startFrame == 0) {
-            continue;
-        }
-
-        const int endFrame = scene_cuts[i+1];
-        const int duration = endFrame - startFrame;
-
-        if (duration <= 0 || duration > orphanThresh) {
-            continue;
-        }
-
-        bool sceneContainsNonBlackFrames = false;
-        for(int j = startFrame; j < endFrame; ++j) {
-            if (!tags.value(j).contains(AppConstants::TAG_IS_BLACK)) {
-                sceneContainsNonBlackFrames = true;
-                break;
-            }
-        }
-
-        if (sceneContainsNonBlackFrames) {
-            results.append({ QCToolsManager::frameToTimecodeHHMMSSFF(startFrame, m_fps), QString::number(duration), AppConstants::ERR_ORPHAN_FRAME, QString("Cảnh ngắn bất thường, từ frame %1 đến %2").arg(startFrame).arg(endFrame - 1), startFrame });
-        }
+    if (pending.isEmpty() || m_stopRequested) return;
+    if (m_resultSink) {
+        m_resultSink->append(pending);
+        pending.clear();
+        return;
     }
+    m_emittedResultCount += pending.size();
+    if (!m_cacheFingerprint.isEmpty()) m_cacheResults.append(pending);
+    emit resultsBatchReady(pending);
+    pending.clear();
 }
 
-
 QString QCToolsManager::createReportDirectory() {
     if (m_filePath.isEmpty()) return QString();
+    const QString reportDir = m_settings.value(AppConstants::K_REPORT_DIR).toString();
+    if (!reportDir.isEmpty()) return QDir().mkpath(reportDir) ? reportDir : QString();
     QFileInfo fileInfo(m_filePath);
     return fileInfo.absolutePath();
 }
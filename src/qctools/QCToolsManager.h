@@ -7,16 +7,18 @@
 #include <atomic>
 #include "core/types.h"
 #include "core/media_info.h"
+#include "core/frame_data.h"
+#include "core/FrameStore.h"
+#include "core/MetricPyramid.h"
 #include <QProcess>
 #include <memory>
 #include <QTime>
+#include <QElapsedTimer>
 #include <QFile>
 #include <zlib.h>
 
+class FrameSource;
 class QTemporaryDir;
-class QTemporaryFile;
-class QXmlStreamReader;
-struct FrameData;
 
 class QCToolsManager : public QObject
 {
@@ -29,54 +31,39 @@ public:
     enum class ReportType { GZ, MKV, XML };
     QString getReportPath(ReportType type) const;
 
-    // --- CÁC HÀM TIỆN ÍCH CHUYỂN ĐỔI THỜI GIAN ---
-    inline static QString frameToTimecodePrecise(int frame, double fps) {
-        if (fps <= 0 || frame < 0) return "00:00:00.000";
-        double totalSeconds = frame / fps;
-        int totalMilliseconds = static_cast<int>(totalSeconds * 1000.0);
-        return QTime(0,0,0,0).addMSecs(totalMilliseconds).toString("HH:mm:ss.zzz");
-    }
-
-    inline static QString frameToTimecodeHHMMSSFF(int frame, double fps) {
-        if (fps <= 0 || frame < 0) return "00:00:00:00";
-        double totalSeconds = frame / fps;
-        int hours = static_cast<int>(totalSeconds) / 3600;
-        int minutes = (static_cast<int>(totalSeconds) % 3600) / 60;
-        int seconds = static_cast<int>(totalSeconds) % 60;
-        int frameOfSecond = static_cast<int>(frame % static_cast<int>(round(fps)));
-        return QString("%1:%2:%3:%4")
-            .arg(hours, 2, 10, QChar('0'))
-            .arg(minutes, 2, 10, QChar('0'))
-            .arg(seconds, 2, 10, QChar('0'))
-            .arg(frameOfSecond, 2, 10, QChar('0'));
-    }
-    
-    // CẢI TIẾN: Thêm các hàm chuyển đổi mới theo yêu cầu
-    inline static QString frameToSecondsString(int frame, double fps) {
-        if (fps <= 0 || frame < 0) return "0.00";
-        return QString::number(frame / fps, 'f', 2);
-    }
-    
-    inline static QString frameToMinutesString(int frame, double fps) {
-        if (fps <= 0 || frame < 0) return "0.00";
-        return QString::number(frame / fps / 60.0, 'f', 2);
-    }
-
+    // Bản build có bộ máy phân tích libav trong tiến trình (VIDEOQC_WITH_LIBAV) hay không
+    static bool inProcessEngineAvailable();
+    // `settings` chọn bộ máy libav và bản build có nó: doWork() không cần qcli
+    static bool usesInProcessEngine(const QVariantMap& settings);
 
 signals:
     void analysisStarted();
     void progressUpdated(int value, int max);
     void statusUpdated(const QString &status);
-    void resultsReady(const QList<AnalysisResult> &results);
+    // Kết quả được gửi theo từng lô đã sắp xếp theo startFrame, ngay khi mỗi bộ phát hiện gom nhóm xong
+    void resultsBatchReady(const QList<AnalysisResult> &batch);
+    // Kim tự tháp min/max YAVG/YDIF/viền đen của toàn bộ file, cho biểu đồ timeline
+    void metricsReady(const MetricPyramidPtr &metrics);
     void analysisFinished(bool success);
     void errorOccurred(const QString &error);
     void logMessage(const QString& message);
     void backgroundTaskFinished(const QString& message);
     void mediaInfoReady(const MediaInfo& info);
+    // Chế độ so sánh: offset frame tìm được và số lỗi mới / thay đổi so với bản gốc
+    void comparisonFinished(int offset, int newErrors, int changedErrors);
+    // Đánh giá nhiều cấu hình: toàn bộ kết quả của cấu hình thứ `index`, gửi một lần khi xong
+    void profileResultsReady(int index, const QString& name, const QList<AnalysisResult>& results);
 
 public slots:
     void doWork(const QString &filePath, const QVariantMap &settings);
     void processReportFile(const QString &reportPath, const QVariantMap &settings);
+    void compareReports(const QString &referencePath, const QString &candidatePath, const QVariantMap &settings);
+    // Chạy nhiều bộ cấu hình phát hiện lỗi trên một lượt đọc báo cáo .xml/.xml.gz.
+    // `profiles`: danh sách map { "name": tên, "settings": các thiết lập ghi đè lên `settings` }
+    void evaluateProfiles(const QString &reportPath, const QVariantList &profiles, const QVariantMap &settings);
+    // Quét nhanh chỉ các keyframe (cần bộ máy libav): vùng nghi Frame Đen / Viền Đen là ước lượng, chính xác tới
+    // khoảng cách giữa hai keyframe. Phân tích đầy đủ các vùng này bằng doWork() với K_ANALYSIS_WINDOWS.
+    void triageKeyframes(const QString &filePath, const QVariantMap &settings);
     void requestStop();
 
 private slots:
@@ -87,7 +74,6 @@ private slots:
 
 private:
     // CẢI TIẾN: Các hàm giải nén giờ là hàm nội bộ, không phải slot
-    void decompressGzFile(const QString& gzPath);
     bool processDecompressionChunk(Bytef* in, Bytef* out);
 
     void startMkvGeneration();
@@ -96,16 +82,38 @@ private:
     void resetState();
     QString createReportDirectory();
     
-    bool parseReport(QIODevice* device); // CẢI TIẾN: Nhận QIODevice để xử lý file thường và file tạm
+    // (tên, thiết lập đầy đủ) của từng cấu hình
+    using ProfileList = QList<QPair<QString, QVariantMap>>;
+    // Đọc báo cáo .xml/.xml.gz qua ReportPipeline rồi chạy runFrameSource()
+    bool runReportPipeline(const QString& reportPath, const ProfileList& profiles = {});
+    // Tìm lỗi ngay trên từng lô frame của `source` và gửi kết quả.
+    // Có `profiles`: mỗi cấu hình một bộ phát hiện, kết quả gửi qua profileResultsReady()
+    // Có m_resultSink: kết quả gom vào đó, không gửi thông tin video/biểu đồ lên giao diện; `frames` (có thể rỗng)
+    // nhận số liệu frame đã đọc
+    bool runFrameSource(FrameSource& source, const QString& phase, const ProfileList& profiles = {}, FrameStorePtr* frames = nullptr);
+    // Phân tích video bằng LibavFrameSource thay cho qcli; không tạo báo cáo XML/MKV
+    void runInProcessAnalysis();
+#ifdef VIDEOQC_HAVE_LIBAV
+    // Chế độ quét nhanh (K_FAST_SCAN): lấy mẫu rồi phân tích đầy đủ quanh các mẫu đáng ngờ
+    std::unique_ptr<FrameSource> createCoarseScanSource(bool signalStats, bool cropDetect);
+    bool runKeyframeTriage();
+    // Video được giao lại (K_INCREMENTAL_REPORT): so chỉ mục GOP với bản cũ, chỉ phân tích lại các vùng đã đổi và
+    // ghép với số liệu của báo cáo cũ; không ghép được thì phân tích lại cả file
+    void runIncrementalAnalysis(const QString& previousReportPath);
+    // Lưu chỉ mục GOP của m_filePath cạnh báo cáo vừa tạo (khi bật K_WRITE_GOP_INDEX), để lần giao lại sau chỉ phải
+    // QC phần đã đổi; ghi kèm cách đánh số của báo cáo theo lượt runFrameSource() vừa đọc nó
+    void writeGopIndex(const QString& reportPath);
+#endif
     
-    MediaInfo parseMediaInfo(QXmlStreamReader& xml);
-    QList<FrameData> extractAllFrameData(QXmlStreamReader& xml);
-    QList<AnalysisResult> runErrorDetection(const QList<FrameData>& allFramesData);
-    QMap<int, QSet<QString>> tagFramesForErrors(const QList<FrameData>& allFramesData);
-    QList<AnalysisResult> groupErrorsFromTags(const QMap<int, QSet<QString>>& frameTags, const QList<FrameData>& allFramesData);
-    void groupBlackFrames(QList<AnalysisResult>& results, const QMap<int, QSet<QString>>& tags, const QList<FrameData>& frames);
-    void groupBorderedFrames(QList<AnalysisResult>& results, const QMap<int, QSet<QString>>& tags, const QList<FrameData>& frames);
-    void findOrphanFrames(QList<AnalysisResult>& results, const QMap<int, QSet<QString>>& tags, const QList<FrameData>& frames);
+    // Chế độ so sánh: đọc một báo cáo (.xml hoặc .xml.gz) qua ReportPipeline + runFrameSource(), dựng các cột số liệu
+    bool loadReportForComparison(const QString& reportPath, const QString& label, MediaInfo* info,
+                                 MetricPyramidPtr* metrics, QList<AnalysisResult>* results);
+    // Cache kết quả: tính khóa cho báo cáo sắp đọc, thử tải, và lưu lại sau khi phân tích xong
+    bool prepareResultCache(const QString& reportPath);
+    bool loadFromResultCache();
+    void storeInResultCache(const MediaInfo& mediaInfo, const MetricPyramidPtr& metrics);
+    void appendResult(QList<AnalysisResult>& pending, const AnalysisResult& result);
+    void flushResults(QList<AnalysisResult>& pending);
 
 
     QProcess *m_mainProcess = nullptr;
@@ -124,6 +132,22 @@ private:
     int m_videoHeight = 0;
     int m_totalFrames = 0;
     int m_totalFramesFromLog = 0;
+    // Số frame đọc nhanh từ header khi chọn file (K_PROBED_FRAME_COUNT, -1: không có), chỉ dùng để tính tiến độ
+    int m_probedFrames = -1;
+    QElapsedTimer m_progressTimer;
+    // Lượt runFrameSource() gần nhất: số frame đã đọc và frameNum có chạy 0, 1, 2... không
+    int m_lastFrameCount = 0;
+    bool m_lastFramesNumberedFromZero = false;
+
+    int m_emittedResultCount = 0;
+    int m_nextResultId = 0;     // ID kết quả, đánh lại từ 0 ở mỗi phiên
+
+    // Khóa cache của báo cáo đang đọc (rỗng: không lưu) và các kết quả đã phát trong phiên
+    QByteArray m_cacheFingerprint;
+    QByteArray m_cacheProfile;
+    QList<AnalysisResult> m_cacheResults;
+    // Khác null: flushResults gom kết quả vào đây thay vì gửi lên giao diện
+    QList<AnalysisResult>* m_resultSink = nullptr;
 
     std::atomic<bool> m_stopRequested{false};
     QString m_processBuffer;
@@ -133,6 +157,10 @@ private:
     int m_currentStep = 0;
     const int m_totalStepsAnalyze = 6;
     const int m_totalStepsViewReport = 5;
+    const int m_totalStepsCompare = 7;
+    const int m_totalStepsInProcess = 4;
+    const int m_totalStepsTriage = 3;
+    const int m_totalStepsIncremental = 5;
     int m_totalSteps = 0;
 };
 
@@ -0,0 +1,283 @@
+// src/qctools/ReportPipeline.cpp
+#include "ReportPipeline.h"
+#include <QDateTime>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QXmlStreamReader>
+#include <zlib.h>
+
+// =============================================================================
+// MediaInfoReader
+// =============================================================================
+
+void MediaInfoReader::startElement(const QXmlStreamReader &xml)
+{
+    if (xml.name() == QLatin1String("format")) {
+        m_inFormat = true;
+        const auto& attrs = xml.attributes();
+        m_info.formatName = attrs.value("format_long_name").toString();
+        m_info.duration = attrs.value("duration").toDouble();
+        m_info.size = attrs.value("size").toLongLong();
+        m_info.bitrate = attrs.value("bit_rate").toLongLong();
+    } else if (m_inFormat && xml.name() == QLatin1String("tag") && xml.attributes().value("key") == QLatin1String("creation_time")) {
+        m_info.creationTime = QDateTime::fromString(xml.attributes().value("value").toString(), Qt::ISODateWithMs);
+    } else if (xml.name() == QLatin1String("stream")) {
+        const auto& attrs = xml.attributes();
+        if (!m_foundVideo && attrs.value("codec_type") == QLatin1String("video")) {
+            m_info.frameRate = FrameRate::fromString(attrs.value("r_frame_rate"));
+            m_info.fps = m_info.frameRate.toDouble();
+            m_info.width = attrs.value("width").toInt();
+            m_info.height = attrs.value("height").toInt();
+            if (attrs.hasAttribute("nb_frames")) m_nbFrames = attrs.value("nb_frames").toInt();
+            m_info.videoCodec = attrs.value("codec_long_name").toString();
+            m_info.pixelFormat = attrs.value("pix_fmt").toString();
+            m_info.colorSpace = attrs.value("color_space").toString();
+            m_foundVideo = true;
+        } else if (!m_foundAudio && attrs.value("codec_type") == QLatin1String("audio")) {
+            m_info.audioCodec = attrs.value("codec_long_name").toString();
+            m_info.sampleRate = attrs.value("sample_rate").toInt();
+            m_info.channelLayout = attrs.value("channel_layout").toString();
+            m_foundAudio = true;
+        }
+    }
+}
+
+void MediaInfoReader::endElement(const QXmlStreamReader &xml)
+{
+    if (xml.name() == QLatin1String("format")) m_inFormat = false;
+}
+
+// =============================================================================
+// ReportPipeline
+// =============================================================================
+
+ReportPipeline::ReportPipeline(const QString &reportPath, const std::atomic<bool> &stopRequested)
+    : m_reportPath(reportPath), m_stopRequested(stopRequested)
+{
+}
+
+ReportPipeline::~ReportPipeline()
+{
+    // Luồng tìm lỗi dừng giữa chừng: hai luồng kia đang chờ hàng đợi sẽ thấy cờ này và thoát
+    m_abort.store(true);
+    wait();
+}
+
+void ReportPipeline::start()
+{
+    m_sourceThread.reset(QThread::create([this]() { runSource(); }));
+    m_parserThread.reset(QThread::create([this]() { runParser(); }));
+    m_sourceThread->start();
+    m_parserThread->start();
+}
+
+bool ReportPipeline::nextBatch(FrameBatch *batch)
+{
+    return m_batches.pop(*batch, [this]() { return isCancelled(); });
+}
+
+void ReportPipeline::wait()
+{
+    if (m_sourceThread) m_sourceThread->wait();
+    if (m_parserThread) m_parserThread->wait();
+}
+
+QString ReportPipeline::errorString() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_error;
+}
+
+int ReportPipeline::progressPermille() const
+{
+    const qint64 total = m_totalBytes.load(std::memory_order_relaxed);
+    if (total <= 0) return -1;
+    return int(m_bytesRead.load(std::memory_order_relaxed) * 1000 / total);
+}
+
+QString ReportPipeline::stageReport() const
+{
+    return QString("giải nén/đọc file chờ %1 lần (hàng đợi đầy), phân tích XML chờ dữ liệu %2 lần và chờ tìm lỗi %3 lần, "
+                   "tìm lỗi chờ dữ liệu %4 lần")
+        .arg(m_blocks.fullWaits()).arg(m_blocks.emptyWaits()).arg(m_batches.fullWaits()).arg(m_batches.emptyWaits());
+}
+
+void ReportPipeline::fail(const QString &error)
+{
+    {
+        QMutexLocker locker(&m_errorMutex);
+        if (m_error.isEmpty()) m_error = error;
+    }
+    m_abort.store(true);
+}
+
+bool ReportPipeline::pushBlock(QByteArray &block)
+{
+    return m_blocks.push(std::move(block), [this]() { return isCancelled(); });
+}
+
+// --- Giai đoạn 1: đọc file và giải nén ---
+
+void ReportPipeline::runSource()
+{
+    QFile file(m_reportPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fail(QString("Không thể mở file báo cáo: %1").arg(file.errorString()));
+    } else {
+        m_totalBytes.store(file.size());
+        if (m_reportPath.endsWith(".gz", Qt::CaseInsensitive)) readGzip(file);
+        else readPlain(file);
+    }
+    m_blocks.close();
+}
+
+bool ReportPipeline::readPlain(QFile &file)
+{
+    while (!isCancelled()) {
+        QByteArray block = file.read(BLOCK_BYTES);
+        if (file.error() != QFile::NoError) {
+            fail("Lỗi khi đọc file báo cáo: " + file.errorString());
+            return false;
+        }
+        if (block.isEmpty()) return true;
+        m_bytesRead.fetch_add(block.size(), std::memory_order_relaxed);
+        if (!pushBlock(block)) return false;
+    }
+    return false;
+}
+
+bool ReportPipeline::readGzip(QFile &file)
+{
+    z_stream zStream = {};
+    if (inflateInit2(&zStream, 16 + MAX_WBITS) != Z_OK) {
+        fail("Khởi tạo zlib thất bại.");
+        return false;
+    }
+
+    // Giải nén thẳng vào khối sẽ gửi đi, không chép lại
+    QByteArray in(64 * 1024, Qt::Uninitialized);
+    QByteArray block(BLOCK_BYTES, Qt::Uninitialized);
+    int filled = 0;
+    int ret = Z_OK;
+    bool ok = true;
+
+    while (ok && ret != Z_STREAM_END && !isCancelled()) {
+        const qint64 n = file.read(in.data(), in.size());
+        if (n < 0 || file.error() != QFile::NoError) {
+            fail("Lỗi khi đọc từ file .gz: " + file.errorString());
+            ok = false;
+            break;
+        }
+        if (n == 0) break;
+        m_bytesRead.fetch_add(n, std::memory_order_relaxed);
+        zStream.next_in = reinterpret_cast<Bytef*>(in.data());
+        zStream.avail_in = uInt(n);
+
+        while (zStream.avail_in > 0 && ret != Z_STREAM_END) {
+            zStream.next_out = reinterpret_cast<Bytef*>(block.data() + filled);
+            zStream.avail_out = uInt(BLOCK_BYTES - filled);
+            ret = inflate(&zStream, Z_NO_FLUSH);
+            if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
+                fail(QString("Lỗi giải nén zlib nghiêm trọng: mã lỗi %1").arg(ret));
+                ok = false;
+                break;
+            }
+            filled = BLOCK_BYTES - int(zStream.avail_out);
+            if (filled == BLOCK_BYTES) {
+                if (!pushBlock(block)) { ok = false; break; }
+                block = QByteArray(BLOCK_BYTES, Qt::Uninitialized);
+                filled = 0;
+            }
+        }
+    }
+
+    if (ok && filled > 0 && !isCancelled()) {
+        block.truncate(filled);
+        ok = pushBlock(block);
+    }
+    (void)inflateEnd(&zStream);
+    return ok && !isCancelled();
+}
+
+// --- Giai đoạn 2: phân tích XML thành các lô frame ---
+
+void ReportPipeline::runParser()
+{
+    QXmlStreamReader xml;
+    FrameBatch batch;
+    batch.frames.reserve(BATCH_FRAMES);
+
+    // Phân tích từng token: không dùng readNextStartElement()/skipCurrentElement() vì một frame
+    // có thể bị cắt ngang ở ranh giới hai khối dữ liệu
+    bool inFrame = false;
+    FrameData current;
+    int x1 = -1, y1 = -1, x2 = -1, y2 = -1;
+
+    auto pushBatch = [&]() -> bool {
+        if (m_mediaInfo.hasVideoGeometry()) {
+            batch.videoWidth = m_mediaInfo.info().width;
+            batch.videoHeight = m_mediaInfo.info().height;
+        }
+        const bool pushed = m_batches.push(std::move(batch), [this]() { return isCancelled(); });
+        batch = FrameBatch();
+        batch.frames.reserve(BATCH_FRAMES);
+        return pushed;
+    };
+
+    while (!isCancelled()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::Invalid) {
+            if (xml.error() == QXmlStreamReader::PrematureEndOfDocumentError) {
+                QByteArray block;
+                if (m_blocks.pop(block, [this]() { return isCancelled(); })) {
+                    xml.addData(block);
+                    continue;
+                }
+                if (isCancelled()) break;
+            }
+            // Hết dữ liệu khi tài liệu chưa đóng, hoặc XML sai cú pháp
+            fail(QString("Lỗi phân tích cú pháp XML: %1 (Dòng %2, Cột %3)").arg(xml.errorString()).arg(xml.lineNumber()).arg(xml.columnNumber()));
+            break;
+        }
+        if (token == QXmlStreamReader::EndDocument) break;
+
+        if (token == QXmlStreamReader::StartElement) {
+            if (xml.name() == QLatin1String("frame")) {
+                inFrame = true;
+                current = FrameData();
+                current.frameNum = xml.attributes().value("pkt_pts").toInt();
+                x1 = y1 = x2 = y2 = -1;
+            } else if (inFrame && xml.name() == QLatin1String("tag")) {
+                const auto& attrs = xml.attributes();
+                const QStringView key = attrs.value("key");
+                const QStringView value = attrs.value("value");
+                if (key == QLatin1String("lavfi.signalstats.YAVG")) current.yavg = value.toDouble();
+                else if (key == QLatin1String("lavfi.signalstats.YDIF")) current.ydif = value.toDouble();
+                else if (key == QLatin1String("lavfi.cropdetect.x1")) x1 = static_cast<int>(value.toDouble());
+                else if (key == QLatin1String("lavfi.cropdetect.y1")) y1 = static_cast<int>(value.toDouble());
+                else if (key == QLatin1String("lavfi.cropdetect.x2")) x2 = static_cast<int>(value.toDouble());
+                else if (key == QLatin1String("lavfi.cropdetect.y2")) y2 = static_cast<int>(value.toDouble());
+            } else if (!inFrame) {
+                m_mediaInfo.startElement(xml);
+            }
+        } else if (token == QXmlStreamReader::EndElement) {
+            if (inFrame && xml.name() == QLatin1String("frame")) {
+                inFrame = false;
+                if (x1 != -1 && y1 != -1 && x2 != -1 && y2 != -1) {
+                    current.crop_x = x1;
+                    current.crop_y = y1;
+                    current.crop_w = x2 - x1 + 1;
+                    current.crop_h = y2 - y1 + 1;
+                }
+                batch.frames.append(current);
+                if (batch.frames.size() >= BATCH_FRAMES && !pushBatch()) break;
+            } else if (!inFrame) {
+                m_mediaInfo.endElement(xml);
+            }
+        }
+    }
+
+    if (!batch.frames.isEmpty() && !isCancelled()) pushBatch();
+    m_batches.close();
+}
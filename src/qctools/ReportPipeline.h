@@ -0,0 +1,101 @@
+// src/qctools/ReportPipeline.h
+#ifndef REPORTPIPELINE_H
+#define REPORTPIPELINE_H
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "core/frame_data.h"
+#include "core/media_info.h"
+#include "core/SpscRingBuffer.h"
+#include "FrameSource.h"
+
+class QFile;
+class QThread;
+class QXmlStreamReader;
+
+// Gom MediaInfo từ các phần tử <format>, <tag>, <stream> của báo cáo QCTools.
+// Dùng chung cho cách đọc cũ (một vòng riêng) và cho pipeline (mỗi phần tử được đưa vào khi gặp).
+class MediaInfoReader
+{
+public:
+    void startElement(const QXmlStreamReader& xml);
+    void endElement(const QXmlStreamReader& xml);
+
+    bool complete() const { return m_foundVideo && m_foundAudio; }
+    bool hasVideoGeometry() const { return m_info.width > 0 && m_info.height > 0; }
+    const MediaInfo& info() const { return m_info; }
+    // Giá trị nb_frames của stream video, -1 nếu báo cáo không có
+    int nbFrames() const { return m_nbFrames; }
+
+private:
+    MediaInfo m_info;
+    int m_nbFrames = -1;
+    bool m_inFormat = false;
+    bool m_foundVideo = false;
+    bool m_foundAudio = false;
+};
+
+// CẢI TIẾN: Đọc báo cáo (.xml hoặc .xml.gz) theo pipeline ba giai đoạn, mỗi giai đoạn một luồng:
+//   [nguồn: đọc file + giải nén] --khối byte--> [phân tích XML] --lô frame--> [tìm lỗi: luồng gọi nextBatch()]
+// Các giai đoạn nối với nhau bằng SpscRingBuffer có giới hạn, nên thời gian tổng tiến gần tới giai đoạn chậm nhất
+// thay vì tổng của cả ba, báo cáo chỉ được đọc một lượt và không cần giải nén ra file tạm.
+// QXmlStreamReader được nạp dữ liệu dần bằng addData(); phần tử nào bị cắt ngang giữa hai khối thì đợi khối sau.
+class ReportPipeline : public FrameSource
+{
+public:
+    static constexpr int BLOCK_BYTES = 256 * 1024;
+    static constexpr int BLOCK_QUEUE = 16;          // ~4 MB XML đang chờ phân tích
+    static constexpr int BATCH_FRAMES = 4096;
+    static constexpr int BATCH_QUEUE = 8;
+
+    ReportPipeline(const QString& reportPath, const std::atomic<bool>& stopRequested);
+    ~ReportPipeline() override;
+
+    void start() override;
+    bool nextBatch(FrameBatch* batch) override;
+    // Chờ hai luồng kia kết thúc
+    void wait() override;
+    // Dừng hai luồng kia khi luồng tìm lỗi thôi đọc giữa chừng (ví dụ nguồn ghép với báo cáo đã lỗi)
+    void abort() { m_abort.store(true); }
+
+    QString errorString() const override;
+    // Kích thước video trong các lô chỉ có khi <stream> xuất hiện trước các frame đó
+    const MediaInfo& mediaInfo() const override { return m_mediaInfo.info(); }
+    int nbFrames() const override { return m_mediaInfo.nbFrames(); }
+    // Theo số byte của file nguồn đã đọc
+    int progressPermille() const override;
+    QString sourceName() const override { return QStringLiteral("báo cáo"); }
+    QString stagesDescription() const override { return QStringLiteral("giải nén, đọc XML và tìm lỗi chạy song song"); }
+    QString stageReport() const override;
+
+private:
+    void runSource();
+    void runParser();
+    bool readPlain(QFile& file);
+    bool readGzip(QFile& file);
+    bool pushBlock(QByteArray& block);
+    bool isCancelled() const { return m_abort.load(std::memory_order_relaxed) || m_stopRequested.load(std::memory_order_relaxed); }
+    void fail(const QString& error);
+
+    const QString m_reportPath;
+    const std::atomic<bool>& m_stopRequested;
+    std::atomic<bool> m_abort{false};
+    std::atomic<qint64> m_bytesRead{0};
+    std::atomic<qint64> m_totalBytes{0};
+
+    SpscRingBuffer<QByteArray> m_blocks{BLOCK_QUEUE};
+    SpscRingBuffer<FrameBatch> m_batches{BATCH_QUEUE};
+
+    std::unique_ptr<QThread> m_sourceThread;
+    std::unique_ptr<QThread> m_parserThread;
+
+    mutable QMutex m_errorMutex;
+    QString m_error;
+    MediaInfoReader m_mediaInfo;    // Chỉ luồng phân tích ghi
+};
+
+#endif // REPORTPIPELINE_H
@@ -0,0 +1,170 @@
+// src/qctools/SplicedFrameSource.cpp
+#include "SplicedFrameSource.h"
+#include "ReportPipeline.h"
+#include "CoarseScanSource.h"
+
+SplicedFrameSource::SplicedFrameSource(const QString &reportPath, const QString &videoPath, const QVector<QPair<int, int>> &windows,
+                                       bool signalStats, bool cropDetect, const MediaInfo &mediaInfo, int nbFrames,
+                                       const std::atomic<bool> &stopRequested)
+    : m_windows(windows), m_mediaInfo(mediaInfo), m_nbFrames(nbFrames), m_stopRequested(stopRequested),
+      m_report(std::make_unique<ReportPipeline>(reportPath, stopRequested)),
+      m_patch(std::make_unique<CoarseScanSource>(videoPath, signalStats, cropDetect, 1, CoarseScanSource::Classifier(), stopRequested))
+{
+    m_patch->setWindows(windows);
+    m_patch->setNativeMetrics(false);
+}
+
+SplicedFrameSource::~SplicedFrameSource()
+{
+    abortAll();
+    wait();
+}
+
+void SplicedFrameSource::setDownscale(int factor)
+{
+    m_patch->setDownscale(factor);
+}
+
+void SplicedFrameSource::start()
+{
+    m_report->start();
+    m_patch->start();
+}
+
+void SplicedFrameSource::abortAll()
+{
+    m_report->abort();
+    m_patch->abort();
+}
+
+void SplicedFrameSource::wait()
+{
+    m_report->wait();
+    m_patch->wait();
+}
+
+bool SplicedFrameSource::peekReport()
+{
+    while (!m_reportDone) {
+        while (m_reportPos < m_reportBatch.frames.size()) {
+            const int frameNum = m_reportBatch.frames[m_reportPos].frameNum;
+            while (m_reportWindow < m_windows.size() && m_windows[m_reportWindow].second < frameNum) ++m_reportWindow;
+            // Frame nằm trong vùng đã đổi: bản mới có số liệu phân tích lại
+            if (m_reportWindow < m_windows.size() && frameNum >= m_windows[m_reportWindow].first) {
+                ++m_reportPos;
+                ++m_replacedFrames;
+                continue;
+            }
+            return true;
+        }
+        m_reportPos = 0;
+        if (!m_report->nextBatch(&m_reportBatch)) {
+            m_reportBatch.frames.clear();
+            m_reportDone = true;
+            m_report->wait();
+            if (m_stopRequested.load() || !m_report->errorString().isEmpty()) {
+                m_failed = true;
+            } else if (m_nbFrames > 0 && m_nextReportFrame != m_nbFrames) {
+                m_spliceError = QString("Báo cáo cũ có %1 frame, bản mới có %2 frame: không ghép được theo số frame.")
+                                    .arg(m_nextReportFrame).arg(m_nbFrames);
+                m_failed = true;
+            }
+            break;
+        }
+        for (const FrameData &frame : std::as_const(m_reportBatch.frames)) {
+            if (frame.frameNum != m_nextReportFrame) {
+                m_spliceError = QString("frameNum của báo cáo cũ không liên tục (frame %1 đứng ở vị trí %2): không ghép được theo số frame.")
+                                    .arg(frame.frameNum).arg(m_nextReportFrame);
+                m_reportBatch.frames.clear();
+                m_reportDone = true;
+                m_failed = true;
+                break;
+            }
+            ++m_nextReportFrame;
+        }
+    }
+    return false;
+}
+
+bool SplicedFrameSource::peekPatch()
+{
+    while (!m_patchDone) {
+        if (m_patchPos < m_patchBatch.frames.size()) {
+            const int frameNum = m_patchBatch.frames[m_patchPos].frameNum;
+            while (m_patchWindow < m_windows.size() && m_windows[m_patchWindow].second < frameNum) ++m_patchWindow;
+            return true;
+        }
+        m_patchPos = 0;
+        if (!m_patch->nextBatch(&m_patchBatch)) {
+            m_patchBatch.frames.clear();
+            m_patchDone = true;
+            m_patchWindow = int(m_windows.size());
+            if (m_stopRequested.load() || !m_patch->errorString().isEmpty()) m_failed = true;
+        }
+    }
+    return false;
+}
+
+bool SplicedFrameSource::nextBatch(FrameBatch *batch)
+{
+    batch->frames.clear();
+    batch->frames.reserve(BATCH_FRAMES);
+    batch->videoWidth = m_mediaInfo.width;
+    batch->videoHeight = m_mediaInfo.height;
+    batch->newSequence = false;
+
+    while (batch->frames.size() < BATCH_FRAMES) {
+        const bool hasReport = peekReport();
+        if (m_failed) break;
+        // Mọi frame phân tích lại còn lại đều thuộc vùng m_patchWindow trở đi: frame báo cáo đứng trước vùng đó
+        // được giao luôn mà không phải chờ bộ giải mã
+        if (hasReport && (m_patchWindow >= m_windows.size()
+                          || m_reportBatch.frames[m_reportPos].frameNum < m_windows[m_patchWindow].first)) {
+            batch->frames.append(m_reportBatch.frames[m_reportPos++]);
+            ++m_reportFrames;
+            continue;
+        }
+        const bool hasPatch = peekPatch();
+        if (m_failed) break;
+        if (!hasReport && !hasPatch) break;
+        if (hasPatch && (!hasReport || m_patchBatch.frames[m_patchPos].frameNum < m_reportBatch.frames[m_reportPos].frameNum)) {
+            batch->frames.append(m_patchBatch.frames[m_patchPos++]);
+            ++m_patchFrames;
+        } else {
+            batch->frames.append(m_reportBatch.frames[m_reportPos++]);
+            ++m_reportFrames;
+        }
+    }
+
+    if (m_failed) {
+        abortAll();
+        return false;
+    }
+    return !batch->frames.isEmpty();
+}
+
+QString SplicedFrameSource::errorString() const
+{
+    if (!m_spliceError.isEmpty()) return m_spliceError;
+    const QString reportError = m_report->errorString();
+    if (!reportError.isEmpty()) return QString("Báo cáo cũ: %1").arg(reportError);
+    const QString patchError = m_patch->errorString();
+    if (!patchError.isEmpty()) return QString("Phân tích lại vùng đã đổi: %1").arg(patchError);
+    return QString();
+}
+
+int SplicedFrameSource::progressPermille() const
+{
+    return m_report->progressPermille();
+}
+
+QString SplicedFrameSource::stagesDescription() const
+{
+    return QString("đọc báo cáo cũ, giải mã lại %1 vùng đã đổi và ghép theo số frame").arg(m_windows.size());
+}
+
+QString SplicedFrameSource::stageReport() const
+{
+    return QString("%1 frame lấy từ báo cáo cũ, %2 frame phân tích lại thay cho %3 frame cũ; báo cáo: %4; giải mã: %5")
+        .arg(m_reportFrames).arg(m_patchFrames).arg(m_replacedFrames).arg(m_report->stageReport(), m_patch->stageReport());
+}
@@ -0,0 +1,83 @@
+// src/qctools/SplicedFrameSource.h
+#ifndef SPLICEDFRAMESOURCE_H
+#define SPLICEDFRAMESOURCE_H
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "FrameSource.h"
+
+class ReportPipeline;
+class CoarseScanSource;
+
+// CẢI TIẾN: QC lại bản giao lại của một video chỉ khác bản cũ ở vài GOP (chỉ có khi build với VIDEOQC_WITH_LIBAV).
+// Số liệu frame của bản cũ đọc từ báo cáo QCTools của nó (ReportPipeline); các vùng đã đổi (theo GopIndex) được giải
+// mã và phân tích lại bằng CoarseScanSource với các cửa sổ cho sẵn. Hai luồng frame được trộn theo frameNum: frame của
+// báo cáo nằm trong vùng đổi bị bỏ và thay bằng frame vừa phân tích. Luồng tìm lỗi nhận đủ mọi frame của bản mới theo
+// thứ tự như khi đọc một báo cáo đầy đủ, nên biểu đồ timeline và các bộ phát hiện chạy như thường.
+// Frame của báo cáo đứng trước vùng đổi kế tiếp được giao ngay, không chờ bộ giải mã.
+// Chỉ đúng khi frameNum (pkt_pts) của báo cáo là số thứ tự frame như của bộ giải mã: người gọi kiểm tra trước bằng
+// GopIndex::reportSpliceable(), và nguồn này dừng với lỗi nếu báo cáo không chạy 0, 1, 2... đủ `nbFrames` frame.
+// Vùng đổi được phân tích bằng chính bộ lọc signalstats/cropdetect như qcli (không dùng LumaStats) để số liệu hai
+// bên cùng một cách tính.
+class SplicedFrameSource : public FrameSource
+{
+public:
+    static constexpr int BATCH_FRAMES = 4096;
+
+    // `windows`: [frame đầu, frame cuối] đã sắp xếp và không chồng nhau. `mediaInfo`, `nbFrames`: của bản mới, đọc từ
+    // header, vì MediaInfo trong báo cáo mô tả file cũ
+    SplicedFrameSource(const QString& reportPath, const QString& videoPath, const QVector<QPair<int, int>>& windows,
+                       bool signalStats, bool cropDetect, const MediaInfo& mediaInfo, int nbFrames,
+                       const std::atomic<bool>& stopRequested);
+    ~SplicedFrameSource() override;
+
+    // Gọi trước start() (xem LibavFrameSource::setDownscale())
+    void setDownscale(int factor);
+
+    void start() override;
+    bool nextBatch(FrameBatch* batch) override;
+    void wait() override;
+
+    QString errorString() const override;
+    const MediaInfo& mediaInfo() const override { return m_mediaInfo; }
+    int nbFrames() const override { return m_nbFrames; }
+    // Theo phần báo cáo cũ đã đọc: phần việc chính, các vùng đổi được giải mã khi việc đọc tới gần chúng
+    int progressPermille() const override;
+    QString sourceName() const override { return QStringLiteral("báo cáo cũ + vùng đã đổi"); }
+    QString stagesDescription() const override;
+    QString stageReport() const override;
+
+private:
+    // Đảm bảo có frame kế tiếp của từng nguồn trong bộ đệm; false khi nguồn đó đã hết hoặc lỗi (xem m_failed)
+    bool peekReport();
+    bool peekPatch();
+    void abortAll();
+
+    const QVector<QPair<int, int>> m_windows;
+    const MediaInfo m_mediaInfo;
+    const int m_nbFrames;
+    const std::atomic<bool>& m_stopRequested;
+    std::unique_ptr<ReportPipeline> m_report;
+    std::unique_ptr<CoarseScanSource> m_patch;
+
+    FrameBatch m_reportBatch;
+    int m_reportPos = 0;
+    bool m_reportDone = false;
+    int m_reportWindow = 0;     // Vùng đổi đầu tiên chưa nằm hẳn trước frame báo cáo đang xét
+    FrameBatch m_patchBatch;
+    int m_patchPos = 0;
+    bool m_patchDone = false;
+    int m_patchWindow = 0;      // Các vùng trước vùng này đã giao hết frame phân tích lại
+    bool m_failed = false;
+    int m_nextReportFrame = 0;  // frameNum mà frame kế tiếp của báo cáo phải có
+    QString m_spliceError;
+
+    qint64 m_reportFrames = 0;
+    qint64 m_patchFrames = 0;
+    qint64 m_replacedFrames = 0;
+};
+
+#endif // SPLICEDFRAMESOURCE_H
@@ -0,0 +1,328 @@
+// src/qctools/WatchFolderService.cpp
+#include "WatchFolderService.h"
+#include "QCToolsManager.h"
+#include "core/Constants.h"
+#include "core/ResultExporter.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSettings>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+constexpr int DEBOUNCE_MS = 1000;
+constexpr int STABILITY_CHECK_MS = 2000;
+
+QString timestamp()
+{
+    return QTime::currentTime().toString("hh:mm:ss.zzz");
+}
+
+} // namespace
+
+WatchFolderService::WatchFolderService(QObject *parent)
+    : QObject(parent)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(DEBOUNCE_MS);
+    m_stabilityTimer.setInterval(STABILITY_CHECK_MS);
+
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &WatchFolderService::scheduleScan);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &WatchFolderService::scan);
+    connect(&m_scanTimer, &QTimer::timeout, this, &WatchFolderService::scan);
+    connect(&m_stabilityTimer, &QTimer::timeout, this, [this]() {
+        checkPending();
+        dispatch();
+    });
+}
+
+WatchFolderService::~WatchFolderService()
+{
+    stop();
+}
+
+bool WatchFolderService::start(const Config &config, QString *errorMessage)
+{
+    stop();
+
+    const QFileInfo watchInfo(config.watchDir);
+    if (config.watchDir.isEmpty() || !watchInfo.isDir()) {
+        if (errorMessage) *errorMessage = "Thư mục theo dõi không tồn tại.";
+        return false;
+    }
+    if (config.outputDir.isEmpty() || !QDir().mkpath(config.outputDir)) {
+        if (errorMessage) *errorMessage = "Không thể tạo thư mục đầu ra.";
+        return false;
+    }
+
+    m_config = config;
+    m_config.watchDir = watchInfo.absoluteFilePath();
+    m_config.outputDir = QFileInfo(config.outputDir).absoluteFilePath();
+    m_config.maxJobs = qMax(1, config.maxJobs);
+    m_running = true;
+
+    loadLedger();
+    m_watcher.addPath(m_config.watchDir);
+    m_scanTimer.start(qMax(1, m_config.scanIntervalSeconds) * 1000);
+
+    emit logMessage(QString("[%1] [WATCH] Bắt đầu theo dõi '%2' (tối đa %3 file cùng lúc, đầu ra: '%4', %5 file đã xử lý trước đó).")
+                        .arg(timestamp(), QDir::toNativeSeparators(m_config.watchDir)).arg(m_config.maxJobs)
+                        .arg(QDir::toNativeSeparators(m_config.outputDir)).arg(m_doneKeys.size()));
+    scan();
+    return true;
+}
+
+void WatchFolderService::stop()
+{
+    if (!m_running) return;
+    m_running = false;
+
+    m_scanTimer.stop();
+    m_debounceTimer.stop();
+    m_stabilityTimer.stop();
+    if (!m_watcher.directories().isEmpty()) m_watcher.removePaths(m_watcher.directories());
+
+    for (Worker *worker : std::as_const(m_workers)) {
+        delete worker->context;
+        worker->manager->requestStop();
+        worker->thread->quit();
+        worker->thread->wait();
+        delete worker;
+    }
+    m_workers.clear();
+    m_queue.clear();
+    m_activeKeys.clear();
+    m_pending.clear();
+
+    emit logMessage(QString("[%1] [WATCH] Đã dừng theo dõi thư mục.").arg(timestamp()));
+    emit statusChanged(0, 0);
+}
+
+void WatchFolderService::scheduleScan()
+{
+    if (m_running) m_debounceTimer.start();
+}
+
+bool WatchFolderService::isVideoFile(const QString &fileName)
+{
+    static const QStringList suffixes = { "mp4", "mov", "avi", "mkv", "ts", "m2ts", "mxf" };
+    const QString lower = fileName.toLower();
+    if (lower.contains(".qctools.")) return false;   // Báo cáo QCTools (.qctools.mkv)
+    return suffixes.contains(QFileInfo(lower).suffix());
+}
+
+void WatchFolderService::scan()
+{
+    if (!m_running) return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QSet<QString> seen;
+    const QFileInfoList entries = QDir(m_config.watchDir).entryInfoList(QDir::Files | QDir::Readable);
+    for (const QFileInfo &info : entries) {
+        if (!isVideoFile(info.fileName())) continue;
+        const FileKey key{ info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch() };
+        const QString keyText = key.toString();
+        if (m_doneKeys.contains(keyText) || m_activeKeys.contains(keyText)) continue;
+
+        seen.insert(key.path);
+        PendingFile &pending = m_pending[key.path];
+        if (pending.size != key.size || pending.mtime != key.mtime) {
+            pending = { key.size, key.mtime, now };
+        }
+    }
+
+    // File đã bị xóa hoặc đổi tên trước khi chép xong
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (!seen.contains(it.key())) it = m_pending.erase(it);
+        else ++it;
+    }
+
+    checkPending();
+    dispatch();
+}
+
+void WatchFolderService::checkPending()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 stableMs = qint64(qMax(0, m_config.stableSeconds)) * 1000;
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        const QFileInfo info(it.key());
+        if (!info.exists()) { it = m_pending.erase(it); continue; }
+
+        const qint64 size = info.size();
+        const qint64 mtime = info.lastModified().toMSecsSinceEpoch();
+        if (size != it->size || mtime != it->mtime) {
+            *it = { size, mtime, now };     // Vẫn đang được chép
+            ++it;
+            continue;
+        }
+        if (now - it->unchangedSince < stableMs) { ++it; continue; }
+
+        // Trên Windows, file đang được chép thường bị khóa ghi: chưa mở được thì đợi tiếp
+        QFile probe(it.key());
+        if (!probe.open(QIODevice::ReadOnly)) { ++it; continue; }
+        probe.close();
+
+        const FileKey key{ it.key(), size, mtime };
+        it = m_pending.erase(it);
+        if (m_doneKeys.contains(key.toString()) || m_activeKeys.contains(key.toString())) continue;
+        m_activeKeys.insert(key.toString());
+        m_queue.enqueue(key);
+        emit logMessage(QString("[%1] [WATCH] Đưa vào hàng đợi: %2").arg(timestamp(), QFileInfo(key.path).fileName()));
+    }
+
+    if (m_pending.isEmpty()) m_stabilityTimer.stop();
+    else if (!m_stabilityTimer.isActive()) m_stabilityTimer.start();
+}
+
+void WatchFolderService::dispatch()
+{
+    while (m_running && !m_queue.isEmpty() && m_workers.size() < m_config.maxJobs) {
+        startWorker(m_queue.dequeue());
+    }
+    emit statusChanged(runningCount(), queuedCount());
+}
+
+void WatchFolderService::startWorker(const FileKey &key)
+{
+    auto *worker = new Worker;
+    worker->key = key;
+    worker->thread = new QThread(this);
+    worker->manager = new QCToolsManager();
+    worker->manager->moveToThread(worker->thread);
+    connect(worker->thread, &QThread::finished, worker->manager, &QObject::deleteLater);
+    connect(worker->thread, &QThread::finished, worker->thread, &QObject::deleteLater);
+    worker->context = new QObject(this);
+
+    const QString fileName = QFileInfo(key.path).fileName();
+    connect(worker->manager, &QCToolsManager::resultsBatchReady, worker->context, [worker](const QList<AnalysisResult> &batch) {
+        worker->results.append(batch);
+    }, Qt::QueuedConnection);
+    connect(worker->manager, &QCToolsManager::mediaInfoReady, worker->context, [worker](const MediaInfo &info) {
+        worker->mediaInfo = info;
+    }, Qt::QueuedConnection);
+    connect(worker->manager, &QCToolsManager::errorOccurred, worker->context, [this, fileName](const QString &error) {
+        emit logMessage(QString("[%1] [WATCH] %2: %3").arg(timestamp(), fileName, error));
+    }, Qt::QueuedConnection);
+    connect(worker->manager, &QCToolsManager::analysisFinished, worker->context, [this, worker](bool success) {
+        finishWorker(worker, success);
+    }, Qt::QueuedConnection);
+
+    m_workers.append(worker);
+    worker->thread->start();
+
+    QVariantMap settings = m_config.analysisSettings;
+    settings[AppConstants::K_REPORT_DIR] = m_config.outputDir;
+    QMetaObject::invokeMethod(worker->manager, "doWork", Qt::QueuedConnection,
+                              Q_ARG(QString, key.path), Q_ARG(QVariantMap, settings));
+    emit logMessage(QString("[%1] [WATCH] Bắt đầu phân tích: %2").arg(timestamp(), fileName));
+}
+
+void WatchFolderService::finishWorker(Worker *worker, bool success)
+{
+    if (!m_workers.removeOne(worker)) return;
+
+    // Đang ở trong slot của context: chỉ xóa nó sau khi slot kết thúc
+    worker->context->deleteLater();
+    worker->thread->quit();
+
+    const QString fileName = QFileInfo(worker->key.path).fileName();
+    QString error;
+    if (success && !writeResults(*worker, &error)) {
+        emit logMessage(QString("[%1] [WATCH] %2: không ghi được file kết quả: %3").arg(timestamp(), fileName, error));
+        success = false;
+    }
+    emit logMessage(QString("[%1] [WATCH] %2 %3 (%4 lỗi).")
+                        .arg(timestamp(), fileName, success ? "đã phân tích xong" : "phân tích thất bại")
+                        .arg(worker->results.size()));
+
+    // Cả file lỗi cũng được ghi sổ để không thử lại liên tục; file được chép đè sẽ có khóa mới
+    m_activeKeys.remove(worker->key.toString());
+    appendToLedger(worker->key, success, int(worker->results.size()));
+    emit fileFinished(worker->key.path, success, int(worker->results.size()));
+    delete worker;
+
+    dispatch();
+}
+
+bool WatchFolderService::writeResults(const Worker &worker, QString *errorMessage) const
+{
+    const QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    ExportJob job;
+    job.format = ExportFormat::Json;
+    job.sourceFile = worker.key.path;
+    job.mediaInfo = worker.mediaInfo;
+    job.timecode = Timecode(worker.mediaInfo.frameRate, qsettings.value(AppConstants::K_DROP_FRAME_TIMECODE, true).toBool());
+    job.results = worker.results;
+    std::sort(job.results.begin(), job.results.end(), [](const AnalysisResult &a, const AnalysisResult &b) {
+        return a.startFrame < b.startFrame;
+    });
+
+    QSaveFile file(QString("%1/%2.results.json").arg(m_config.outputDir, QFileInfo(worker.key.path).fileName()));
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    ResultExporter exporter;
+    if (!exporter.write(&file, job, errorMessage)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        if (errorMessage) *errorMessage = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString WatchFolderService::ledgerPath() const
+{
+    return m_config.outputDir + "/" + ledgerFileName();
+}
+
+void WatchFolderService::loadLedger()
+{
+    m_ledger = QJsonArray();
+    m_doneKeys.clear();
+
+    QFile file(ledgerPath());
+    if (!file.open(QIODevice::ReadOnly)) return;
+    m_ledger = QJsonDocument::fromJson(file.readAll()).object().value("files").toArray();
+    for (const QJsonValue &value : std::as_const(m_ledger)) {
+        const QJsonObject entry = value.toObject();
+        const FileKey key{ entry.value("path").toString(), qint64(entry.value("size").toDouble()),
+                           qint64(entry.value("mtime").toDouble()) };
+        m_doneKeys.insert(key.toString());
+    }
+}
+
+void WatchFolderService::appendToLedger(const FileKey &key, bool success, int resultCount)
+{
+    m_doneKeys.insert(key.toString());
+
+    QJsonObject entry;
+    entry["path"] = key.path;
+    entry["size"] = double(key.size);
+    entry["mtime"] = double(key.mtime);
+    entry["success"] = success;
+    entry["results"] = resultCount;
+    entry["finished"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    m_ledger.append(entry);
+
+    // Ghi lại cả sổ qua QSaveFile: mất điện giữa chừng không làm hỏng sổ cũ
+    QSaveFile file(ledgerPath());
+    if (!file.open(QIODevice::WriteOnly)) return;
+    QJsonObject root;
+    root["files"] = m_ledger;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        emit logMessage(QString("[%1] [WATCH] Không ghi được sổ theo dõi: %2").arg(timestamp(), file.errorString()));
+    }
+}
@@ -0,0 +1,114 @@
+// src/qctools/WatchFolderService.h
+#ifndef WATCHFOLDERSERVICE_H
+#define WATCHFOLDERSERVICE_H
+
+#include <QObject>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QJsonArray>
+#include <QList>
+#include <QQueue>
+#include <QSet>
+#include <QTimer>
+#include <QVariantMap>
+#include "core/types.h"
+#include "core/media_info.h"
+
+class QThread;
+class QCToolsManager;
+
+// CẢI TIẾN: Chế độ theo dõi thư mục (hot folder) cho máy chủ ingest.
+// - QFileSystemWatcher báo thay đổi ngay; thêm một lần quét định kỳ vì watcher có thể bỏ sót sự kiện
+//   (ổ mạng, thư mục có quá nhiều thay đổi cùng lúc).
+// - Một file chỉ được đưa vào hàng đợi khi dung lượng và thời gian sửa không đổi trong stableSeconds
+//   và mở được để đọc, tức là đã chép xong.
+// - Khử trùng lặp theo (đường dẫn, dung lượng, thời gian sửa): cùng một khóa không bao giờ chạy hai lần.
+//   Các khóa đã xong được ghi vào sổ (ledger) JSON trong thư mục đầu ra nên khởi động lại không phân tích lại.
+// - Tối đa maxJobs file được phân tích cùng lúc, mỗi file một QCToolsManager trên luồng riêng.
+//   Báo cáo QCTools và kết quả (JSON) được ghi vào thư mục đầu ra.
+class WatchFolderService : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Config {
+        QString watchDir;
+        QString outputDir;
+        int maxJobs = 1;
+        int scanIntervalSeconds = 30;
+        int stableSeconds = 10;
+        QVariantMap analysisSettings;   // Như map gửi cho QCToolsManager::doWork
+    };
+
+    explicit WatchFolderService(QObject *parent = nullptr);
+    ~WatchFolderService();
+
+    bool start(const Config& config, QString* errorMessage = nullptr);
+    // Dừng theo dõi và hủy các file đang phân tích (chúng sẽ được phân tích lại lần sau)
+    void stop();
+
+    bool isRunning() const { return m_running; }
+    int runningCount() const { return int(m_workers.size()); }
+    int queuedCount() const { return int(m_queue.size()); }
+
+    static QString ledgerFileName() { return QStringLiteral(".videoqc_watch.json"); }
+
+signals:
+    void logMessage(const QString& message);
+    void statusChanged(int running, int queued);
+    void fileFinished(const QString& path, bool success, int resultCount);
+
+private:
+    struct FileKey {
+        QString path;
+        qint64 size = 0;
+        qint64 mtime = 0;
+        QString toString() const { return QString("%1|%2|%3").arg(path).arg(size).arg(mtime); }
+    };
+
+    struct PendingFile {
+        qint64 size = -1;
+        qint64 mtime = 0;
+        qint64 unchangedSince = 0;  // ms since epoch
+    };
+
+    struct Worker {
+        FileKey key;
+        QThread* thread = nullptr;
+        QCToolsManager* manager = nullptr;
+        QObject* context = nullptr;     // Nhận tín hiệu của manager; xóa nó sẽ hủy các tín hiệu còn xếp hàng
+        QList<AnalysisResult> results;
+        MediaInfo mediaInfo;
+    };
+
+    void scheduleScan();
+    void scan();
+    void checkPending();
+    void dispatch();
+    void startWorker(const FileKey& key);
+    void finishWorker(Worker* worker, bool success);
+    bool writeResults(const Worker& worker, QString* errorMessage) const;
+
+    void loadLedger();
+    void appendToLedger(const FileKey& key, bool success, int resultCount);
+    QString ledgerPath() const;
+
+    static bool isVideoFile(const QString& fileName);
+
+    Config m_config;
+    bool m_running = false;
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_scanTimer;         // Quét định kỳ
+    QTimer m_debounceTimer;     // Gộp nhiều sự kiện của watcher thành một lần quét
+    QTimer m_stabilityTimer;    // Kiểm tra lại các file đang chờ chép xong
+
+    QHash<QString, PendingFile> m_pending;  // Theo đường dẫn
+    QJsonArray m_ledger;
+    QSet<QString> m_doneKeys;               // Đã xong (kể cả lỗi), đọc từ ledger
+    QSet<QString> m_activeKeys;             // Đang chờ hoặc đang chạy
+    QQueue<FileKey> m_queue;
+    QList<Worker*> m_workers;
+};
+
+#endif // WATCHFOLDERSERVICE_H
@@ -0,0 +1,187 @@
+// src/tools/ApiLoadTest.cpp
+// CẢI TIẾN: Công cụ dòng lệnh đo độ trễ của dịch vụ job HTTP (JobApiServer) khi nhiều client gọi cùng lúc.
+// Mỗi client có QNetworkAccessManager riêng (mỗi manager chỉ mở tối đa 6 kết nối tới một host),
+// gửi request kế tiếp ngay khi nhận được phản hồi, nên số request đang chờ luôn bằng số client.
+//
+// Ví dụ:
+//   VideoQC_ApiLoadTest --clients 32 --requests 5000                 (GET /health)
+//   VideoQC_ApiLoadTest --endpoint /jobs --clients 8 --requests 2000 (GET /jobs)
+//   VideoQC_ApiLoadTest --submit D:/clips/a.mxf --requests 4         (POST /jobs rồi theo dõi đến khi xong)
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTextStream>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Options {
+    QUrl baseUrl;
+    QString endpoint;
+    QByteArray submitBody;      // Khác rỗng: chế độ gửi job
+    int clients = 1;
+    int requests = 0;
+    int pollMs = 500;
+};
+
+class LoadTest
+{
+public:
+    explicit LoadTest(const Options &options) : m_options(options) {}
+
+    void start()
+    {
+        m_total.start();
+        const int clients = qMin(m_options.clients, m_options.requests);
+        for (int i = 0; i < clients; ++i) {
+            m_managers.push_back(std::make_unique<QNetworkAccessManager>());
+            sendNext(m_managers.back().get());
+        }
+    }
+
+private:
+    void sendNext(QNetworkAccessManager *manager)
+    {
+        if (m_sent >= m_options.requests) return;
+        ++m_sent;
+
+        QNetworkRequest request(m_options.baseUrl.resolved(QUrl(m_options.submitBody.isEmpty() ? m_options.endpoint : "/jobs")));
+        QElapsedTimer timer;
+        timer.start();
+        QNetworkReply *reply;
+        if (m_options.submitBody.isEmpty()) {
+            reply = manager->get(request);
+        } else {
+            request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+            reply = manager->post(request, m_options.submitBody);
+        }
+        QObject::connect(reply, &QNetworkReply::finished, [this, manager, reply, timer]() {
+            m_latenciesUs.push_back(timer.nsecsElapsed() / 1000);
+            const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+            if (reply->error() != QNetworkReply::NoError || status >= 400) {
+                ++m_errors;
+                if (m_errors <= 5) QTextStream(stderr) << "Lỗi: HTTP " << status << " " << reply->errorString() << "\n";
+            } else if (!m_options.submitBody.isEmpty()) {
+                const int id = QJsonDocument::fromJson(reply->readAll()).object().value("id").toInt();
+                ++m_pendingJobs;
+                pollJob(manager, id);
+            }
+            reply->deleteLater();
+            sendNext(manager);
+            finishIfDone();
+        });
+    }
+
+    // Chế độ gửi job: hỏi trạng thái định kỳ để đo cả thời gian từ lúc gửi đến lúc có kết quả
+    void pollJob(QNetworkAccessManager *manager, int id)
+    {
+        QTimer::singleShot(m_options.pollMs, [this, manager, id]() {
+            QNetworkReply *reply = manager->get(QNetworkRequest(m_options.baseUrl.resolved(QUrl(QString("/jobs/%1").arg(id)))));
+            QObject::connect(reply, &QNetworkReply::finished, [this, manager, reply, id]() {
+                const QString status = QJsonDocument::fromJson(reply->readAll()).object().value("status").toString();
+                reply->deleteLater();
+                if (reply->error() == QNetworkReply::NoError && (status == "queued" || status == "running")) {
+                    pollJob(manager, id);
+                    return;
+                }
+                QTextStream(stdout) << "Job #" << id << ": " << (status.isEmpty() ? reply->errorString() : status)
+                                    << " sau " << m_total.elapsed() << " ms\n";
+                --m_pendingJobs;
+                finishIfDone();
+            });
+        });
+    }
+
+    void finishIfDone()
+    {
+        if (int(m_latenciesUs.size()) < m_options.requests || m_pendingJobs > 0) return;
+        report();
+        QCoreApplication::exit(m_errors > 0 ? 1 : 0);
+    }
+
+    void report()
+    {
+        std::sort(m_latenciesUs.begin(), m_latenciesUs.end());
+        const auto percentile = [this](double p) {
+            const size_t index = size_t(p * double(m_latenciesUs.size() - 1) + 0.5);
+            return double(m_latenciesUs[index]) / 1000.0;
+        };
+        double sum = 0.0;
+        for (qint64 v : m_latenciesUs) sum += double(v);
+        const double seconds = qMax<qint64>(1, m_total.elapsed()) / 1000.0;
+
+        QTextStream out(stdout);
+        out << "Request: " << m_latenciesUs.size() << ", lỗi: " << m_errors
+            << ", client: " << m_managers.size() << "\n";
+        out << "Thông lượng: " << QString::number(m_latenciesUs.size() / seconds, 'f', 1) << " request/s\n";
+        out << "Độ trễ (ms): min " << QString::number(m_latenciesUs.front() / 1000.0, 'f', 2)
+            << "  tb " << QString::number(sum / m_latenciesUs.size() / 1000.0, 'f', 2)
+            << "  p50 " << QString::number(percentile(0.50), 'f', 2)
+            << "  p95 " << QString::number(percentile(0.95), 'f', 2)
+            << "  p99 " << QString::number(percentile(0.99), 'f', 2)
+            << "  max " << QString::number(m_latenciesUs.back() / 1000.0, 'f', 2) << "\n";
+    }
+
+    Options m_options;
+    std::vector<std::unique_ptr<QNetworkAccessManager>> m_managers;
+    std::vector<qint64> m_latenciesUs;
+    QElapsedTimer m_total;
+    int m_sent = 0;
+    int m_errors = 0;
+    int m_pendingJobs = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Đo độ trễ của dịch vụ job HTTP cục bộ.");
+    parser.addHelpOption();
+    const QCommandLineOption hostOption("host", "Địa chỉ dịch vụ.", "host", "127.0.0.1");
+    const QCommandLineOption portOption("port", "Cổng dịch vụ.", "port", "8765");
+    const QCommandLineOption clientsOption("clients", "Số client gửi đồng thời.", "n", "8");
+    const QCommandLineOption requestsOption("requests", "Tổng số request.", "n", "1000");
+    const QCommandLineOption endpointOption("endpoint", "Đường dẫn GET được đo.", "path", "/health");
+    const QCommandLineOption submitOption("submit", "Gửi job phân tích file này thay vì GET.", "file");
+    const QCommandLineOption presetOption("preset", "File preset JSON gửi kèm job.", "file");
+    const QCommandLineOption pollOption("poll-ms", "Chu kỳ hỏi trạng thái job.", "ms", "500");
+    parser.addOptions({ hostOption, portOption, clientsOption, requestsOption, endpointOption, submitOption, presetOption, pollOption });
+    parser.process(app);
+
+    Options options;
+    options.baseUrl = QUrl(QString("http://%1:%2").arg(parser.value(hostOption), parser.value(portOption)));
+    options.endpoint = parser.value(endpointOption);
+    options.clients = qMax(1, parser.value(clientsOption).toInt());
+    options.requests = qMax(1, parser.value(requestsOption).toInt());
+    options.pollMs = qMax(10, parser.value(pollOption).toInt());
+
+    if (parser.isSet(submitOption)) {
+        QJsonObject body{ {"path", parser.value(submitOption)} };
+        if (parser.isSet(presetOption)) {
+            QFile presetFile(parser.value(presetOption));
+            if (!presetFile.open(QIODevice::ReadOnly)) {
+                QTextStream(stderr) << "Không mở được preset: " << presetFile.errorString() << "\n";
+                return 2;
+            }
+            body["preset"] = QJsonDocument::fromJson(presetFile.readAll()).object();
+        }
+        options.submitBody = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    }
+
+    LoadTest test(options);
+    test.start();
+    return app.exec();
+}
@@ -0,0 +1,512 @@
+// src/tools/EngineParity.cpp
+// CẢI TIẾN: Công cụ dòng lệnh so bộ máy libav với qcli trên tập video mẫu (chỉ có khi build với VIDEOQC_WITH_LIBAV).
+// Đọc báo cáo qcli của video bằng ReportPipeline, phân tích lại video bằng LibavFrameSource, rồi so từng frame theo frameNum:
+// - đánh số: frameNum của báo cáo (pkt_pts) có chạy liên tục từ 0 không, hai bên có cùng tập frame không;
+// - YAVG/YDIF chênh nhau bao nhiêu và bao nhiêu frame vượt ngưỡng;
+// - vùng cropdetect lệch quá bao nhiêu điểm ảnh.
+// --segments: đo thời gian phân tích song song theo đoạn (SegmentedLibavSource) với từng số đoạn, so với một lượt giải
+// mã, và kiểm tra số liệu ghép từ các đoạn trùng với một lượt (cả YDIF ở chỗ nối); không cần báo cáo.
+// --downscale: đo cái giá của phân tích trên frame thu nhỏ (cài đặt "Độ phân giải khi phân tích") so với độ phân giải
+// đầy đủ: thời gian, độ lệch số liệu, và với từng loại lỗi (Frame Đen, Viền Đen, cắt cảnh theo YDIF) số frame bị
+// đánh dấu ở bản đầy đủ mà bản thu nhỏ bỏ sót (tỉ lệ bỏ sót) hoặc đánh dấu thừa. Ngưỡng mặc định như cấu hình mặc định
+// của ứng dụng; chạy trên kho video mẫu để có bảng tốc độ / tỉ lệ bỏ sót cho từng hệ số trước khi bật cài đặt này.
+// --native-vs-filter: phân tích video hai lần, một lần với LumaStats (YAVG/YDIF, viền đen tính ngay trên frame) và
+// một lần bắt buộc qua bộ lọc signalstats/cropdetect như qcli, rồi so từng frame; không cần báo cáo.
+// --splice-windows: ghép báo cáo qcli của video với các cửa sổ phân tích lại (SplicedFrameSource, như QC lại phần đã
+// đổi) và so các frame trong cửa sổ với một lượt giải mã cả file qua cùng bộ lọc: số liệu, vùng ảnh (kể cả frame đầu
+// mỗi cửa sổ), cờ Viền Đen và số chuỗi Viền Đen, để thấy chuỗi viền có bị cắt ở chỗ nối không.
+// Mã thoát: 0 khi khớp trong ngưỡng, 1 khi không khớp, 2 khi không đọc được video hoặc báo cáo.
+//
+// Ví dụ:
+//   VideoQC_EngineParity D:/corpus/a.mxf D:/corpus/a.mxf.qctools.xml.gz
+//   VideoQC_EngineParity --tolerance 0.25 --crop-tolerance 0 a.mov a.mov.qctools.xml
+//   VideoQC_EngineParity --segments 2,4,8 D:/corpus/master.mov
+//   VideoQC_EngineParity --downscale 2,4 --scene-threshold 25 D:/corpus/uhd.mov
+//   VideoQC_EngineParity --native-vs-filter --tolerance 0.01 D:/corpus/10bit.mxf
+//   VideoQC_EngineParity --splice-windows 240-479,1200-1319 D:/corpus/intra.mxf D:/corpus/intra.mxf.qctools.xml.gz
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include "qctools/LibavFrameSource.h"
+#include "qctools/ReportPipeline.h"
+#include "qctools/SplicedFrameSource.h"
+
+namespace {
+
+struct Options {
+    double tolerance = 0.5;     // Chênh lệch YAVG/YDIF cho phép
+    int cropTolerance = 2;      // Chênh lệch mỗi cạnh vùng cropdetect cho phép (điểm ảnh)
+    int maxMismatches = 0;      // Số frame được phép vượt ngưỡng
+    // --downscale: ngưỡng đánh dấu frame, mặc định như ConfigWidget
+    double blackThreshold = 17.0;
+    double borderThresholdPercent = 0.2;
+    double sceneThreshold = 30.0;
+};
+
+struct Comparison {
+    int common = 0;
+    int onlyFirst = 0;          // Frame chỉ có ở nguồn thứ nhất
+    int onlySecond = 0;
+    int firstMissing = -1;      // frameNum đầu tiên chỉ có ở một bên
+    double yavgMax = 0.0, yavgSum = 0.0;
+    double ydifMax = 0.0, ydifSum = 0.0;
+    int yavgOver = 0, ydifOver = 0, cropOver = 0, cropCompared = 0;
+    int cropOneSided = 0;       // Frame chỉ một bên có vùng ảnh, tính là lệch
+    int framesOver = 0;         // Frame có ít nhất một số liệu vượt ngưỡng
+    int firstOver = -1;         // frameNum đầu tiên vượt ngưỡng
+};
+
+// Đọc hết frame của `source`; thời gian tính cả khởi động và chờ các luồng kết thúc
+bool readAll(FrameSource &source, QVector<FrameData> *frames, qint64 *elapsedMs, QString *error)
+{
+    QElapsedTimer timer;
+    timer.start();
+    source.start();
+    FrameSource::FrameBatch batch;
+    while (source.nextBatch(&batch)) frames->append(batch.frames);
+    source.wait();
+    *elapsedMs = timer.elapsed();
+    *error = source.errorString();
+    std::stable_sort(frames->begin(), frames->end(), [](const FrameData &a, const FrameData &b) { return a.frameNum < b.frameNum; });
+    return error->isEmpty();
+}
+
+// frameNum chạy 0, 1, 2... không hở, không trùng
+bool numberedFromZero(const QVector<FrameData> &frames)
+{
+    for (int i = 0; i < frames.size(); ++i) {
+        if (frames[i].frameNum != i) return false;
+    }
+    return true;
+}
+
+bool hasCrop(const FrameData &frame) { return frame.crop_w >= 0 && frame.crop_h >= 0; }
+
+Comparison compare(const QVector<FrameData> &first, const QVector<FrameData> &second, const Options &options)
+{
+    Comparison result;
+    int i = 0, j = 0;
+    while (i < first.size() || j < second.size()) {
+        if (j >= second.size() || (i < first.size() && first[i].frameNum < second[j].frameNum)) {
+            if (result.firstMissing < 0) result.firstMissing = first[i].frameNum;
+            ++result.onlyFirst;
+            ++i;
+            continue;
+        }
+        if (i >= first.size() || second[j].frameNum < first[i].frameNum) {
+            if (result.firstMissing < 0) result.firstMissing = second[j].frameNum;
+            ++result.onlySecond;
+            ++j;
+            continue;
+        }
+        const FrameData &a = first[i++];
+        const FrameData &b = second[j++];
+        ++result.common;
+        bool over = false;
+        const double yavg = std::abs(a.yavg - b.yavg);
+        const double ydif = std::abs(a.ydif - b.ydif);
+        result.yavgMax = std::max(result.yavgMax, yavg);
+        result.ydifMax = std::max(result.ydifMax, ydif);
+        result.yavgSum += yavg;
+        result.ydifSum += ydif;
+        if (yavg > options.tolerance) { ++result.yavgOver; over = true; }
+        if (ydif > options.tolerance) { ++result.ydifOver; over = true; }
+        if (hasCrop(a) && hasCrop(b)) {
+            ++result.cropCompared;
+            const int cropDiff = std::max({ std::abs(a.crop_x - b.crop_x), std::abs(a.crop_y - b.crop_y),
+                                            std::abs(a.crop_w - b.crop_w), std::abs(a.crop_h - b.crop_h) });
+            if (cropDiff > options.cropTolerance) { ++result.cropOver; over = true; }
+        } else if (hasCrop(a) != hasCrop(b)) {
+            ++result.cropOneSided;
+            over = true;
+        }
+        if (over) {
+            ++result.framesOver;
+            if (result.firstOver < 0) result.firstOver = a.frameNum;
+        }
+    }
+    return result;
+}
+
+void printComparison(QTextStream &out, const QString &first, const QString &second, const Comparison &c, const Options &options)
+{
+    out << first << " / " << second << ": " << c.common << " frame chung, " << c.onlyFirst << " frame chỉ có ở " << first
+        << ", " << c.onlySecond << " frame chỉ có ở " << second;
+    if (c.firstMissing >= 0) out << " (đầu tiên: frame " << c.firstMissing << ")";
+    out << "\n";
+    if (c.common == 0) return;
+    out << "  YAVG: lệch tối đa " << QString::number(c.yavgMax, 'f', 3) << ", trung bình " << QString::number(c.yavgSum / c.common, 'f', 4)
+        << ", " << c.yavgOver << " frame vượt " << options.tolerance << "\n";
+    out << "  YDIF: lệch tối đa " << QString::number(c.ydifMax, 'f', 3) << ", trung bình " << QString::number(c.ydifSum / c.common, 'f', 4)
+        << ", " << c.ydifOver << " frame vượt " << options.tolerance << "\n";
+    out << "  Crop: " << c.cropCompared << " frame so được, " << c.cropOver << " frame lệch quá " << options.cropTolerance << " điểm ảnh, "
+        << c.cropOneSided << " frame chỉ một bên có vùng ảnh\n";
+    if (c.firstOver >= 0) out << "  " << c.framesOver << " frame vượt ngưỡng, đầu tiên: frame " << c.firstOver << "\n";
+}
+
+enum FrameFlag { FLAG_BLACK, FLAG_BORDER, FLAG_SCENE, FLAG_COUNT };
+const char *const FLAG_NAMES[FLAG_COUNT] = { "Frame Đen", "Viền Đen", "Cắt cảnh (YDIF)" };
+
+// Đánh dấu theo từng frame như bước gắn cờ của QCToolsManager (Viền Đen chỉ xét frame không đen); cắt cảnh chỉ so YDIF
+// với ngưỡng, không xét frame lân cận, để thấy thẳng ảnh hưởng của việc thu nhỏ lên YDIF
+bool isFlagged(const FrameData &frame, FrameFlag flag, int width, int height, const Options &options)
+{
+    const bool black = frame.yavg < options.blackThreshold;
+    switch (flag) {
+    case FLAG_BLACK:
+        return black;
+    case FLAG_BORDER: {
+        if (black || !hasCrop(frame) || width <= 0 || height <= 0) return false;
+        const double ratio = options.borderThresholdPercent / 100.0;
+        const int edges[4] = { frame.crop_y, height - (frame.crop_y + frame.crop_h), frame.crop_x, width - (frame.crop_x + frame.crop_w) };
+        for (int i = 0; i < 4; ++i) {
+            const int size = i < 2 ? height : width;
+            if (ratio <= 0 ? edges[i] > 0 : double(edges[i]) / size > ratio) return true;
+        }
+        return false;
+    }
+    case FLAG_SCENE:
+        return frame.ydif > options.sceneThreshold;
+    default:
+        return false;
+    }
+}
+
+struct FlagAgreement {
+    int reference[FLAG_COUNT] = {};     // Frame được đánh dấu ở bản đầy đủ
+    int missed[FLAG_COUNT] = {};        // ... mà bản thu nhỏ không đánh dấu
+    int extra[FLAG_COUNT] = {};         // Frame chỉ bản thu nhỏ đánh dấu
+};
+
+FlagAgreement compareFlags(const QVector<FrameData> &reference, const QVector<FrameData> &scaled, int width, int height, const Options &options)
+{
+    FlagAgreement result;
+    int j = 0;
+    for (const FrameData &a : reference) {
+        while (j < scaled.size() && scaled[j].frameNum < a.frameNum) ++j;
+        if (j >= scaled.size() || scaled[j].frameNum != a.frameNum) continue;
+        const FrameData &b = scaled[j];
+        for (int f = 0; f < FLAG_COUNT; ++f) {
+            const bool inReference = isFlagged(a, FrameFlag(f), width, height, options);
+            const bool inScaled = isFlagged(b, FrameFlag(f), width, height, options);
+            if (inReference) ++result.reference[f];
+            if (inReference && !inScaled) ++result.missed[f];
+            if (!inReference && inScaled) ++result.extra[f];
+        }
+    }
+    return result;
+}
+
+// Thời gian, độ lệch số liệu và tỉ lệ bỏ sót của phân tích trên frame thu nhỏ so với độ phân giải đầy đủ
+int runDownscaleBenchmark(const QString &videoPath, const QList<int> &factors, const Options &options, QTextStream &out, QTextStream &err)
+{
+    const std::atomic<bool> stop{false};
+    QString error;
+    QVector<FrameData> reference;
+    qint64 referenceMs = 0;
+    LibavFrameSource full(videoPath, true, true, stop);
+    if (!readAll(full, &reference, &referenceMs, &error)) {
+        err << "Không phân tích được video: " << error << "\n";
+        return 2;
+    }
+    const int width = full.mediaInfo().width;
+    const int height = full.mediaInfo().height;
+    out << "Đầy đủ (" << width << "x" << height << "): " << reference.size() << " frame, " << referenceMs << " ms\n";
+
+    bool ok = true;
+    for (int factor : factors) {
+        QVector<FrameData> frames;
+        qint64 elapsedMs = 0;
+        LibavFrameSource scaled(videoPath, true, true, stop);
+        scaled.setDownscale(factor);
+        if (!readAll(scaled, &frames, &elapsedMs, &error)) {
+            err << "1/" << factor << ": " << error << "\n";
+            return 2;
+        }
+        out << "1/" << factor << ": " << elapsedMs << " ms, tăng tốc x" << QString::number(double(referenceMs) / qMax<qint64>(1, elapsedMs), 'f', 2)
+            << " (" << scaled.stageReport() << ")\n";
+        const Comparison comparison = compare(reference, frames, options);
+        printComparison(out, "đầy đủ", QString("1/%1").arg(factor), comparison, options);
+        const FlagAgreement flags = compareFlags(reference, frames, width, height, options);
+        int missed = 0;
+        for (int f = 0; f < FLAG_COUNT; ++f) {
+            const double missRate = flags.reference[f] > 0 ? 100.0 * flags.missed[f] / flags.reference[f] : 0.0;
+            out << "  " << FLAG_NAMES[f] << ": " << flags.reference[f] << " frame ở bản đầy đủ, bỏ sót " << flags.missed[f]
+                << " (" << QString::number(missRate, 'f', 2) << "%), đánh dấu thừa " << flags.extra[f] << "\n";
+            missed += flags.missed[f];
+        }
+        ok = ok && comparison.onlyFirst == 0 && comparison.onlySecond == 0 && missed <= options.maxMismatches;
+    }
+    out << (ok ? "KHỚP" : "KHÔNG KHỚP") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Số liệu LumaStats so với metadata lavfi.signalstats/cropdetect trên cùng các frame đã giải mã
+int runNativeVsFilter(const QString &videoPath, const Options &options, QTextStream &out, QTextStream &err)
+{
+    const std::atomic<bool> stop{false};
+    QString error;
+    QVector<FrameData> nativeFrames;
+    qint64 nativeMs = 0;
+    LibavFrameSource native(videoPath, true, true, stop);
+    if (!readAll(native, &nativeFrames, &nativeMs, &error)) {
+        err << "Không phân tích được video: " << error << "\n";
+        return 2;
+    }
+    if (!native.nativeLuma() && !native.nativeBorders()) {
+        err << "LumaStats không đọc được định dạng điểm ảnh của video này, mọi số liệu đều do bộ lọc tính: không có gì để so.\n";
+        return 2;
+    }
+    QVector<FrameData> filterFrames;
+    qint64 filterMs = 0;
+    LibavFrameSource filtered(videoPath, true, true, stop);
+    filtered.setNativeMetrics(false);
+    if (!readAll(filtered, &filterFrames, &filterMs, &error)) {
+        err << "Không phân tích được video qua bộ lọc: " << error << "\n";
+        return 2;
+    }
+
+    out << "LumaStats: " << nativeFrames.size() << " frame, " << nativeMs << " ms (" << native.stageReport() << ")\n";
+    out << "signalstats/cropdetect: " << filterFrames.size() << " frame, " << filterMs << " ms\n";
+    if (!native.nativeLuma()) out << "YAVG/YDIF của cả hai lượt đều do signalstats tính, chỉ so viền đen.\n";
+    if (!native.nativeBorders()) out << "Viền đen của cả hai lượt đều do cropdetect tính, chỉ so YAVG/YDIF.\n";
+    const Comparison comparison = compare(filterFrames, nativeFrames, options);
+    printComparison(out, "signalstats", "LumaStats", comparison, options);
+
+    const bool ok = comparison.onlyFirst == 0 && comparison.onlySecond == 0 && comparison.framesOver <= options.maxMismatches;
+    out << (ok ? "KHỚP" : "KHÔNG KHỚP") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Thời gian và độ khớp của phân tích theo đoạn so với một lượt giải mã
+int runSegmentScaling(const QString &videoPath, const QList<int> &segmentCounts, const Options &options, QTextStream &out, QTextStream &err)
+{
+    const std::atomic<bool> stop{false};
+    QString error;
+    QVector<FrameData> reference;
+    qint64 referenceMs = 0;
+    LibavFrameSource single(videoPath, true, true, stop);
+    if (!readAll(single, &reference, &referenceMs, &error)) {
+        err << "Không phân tích được video: " << error << "\n";
+        return 2;
+    }
+    out << "1 lượt: " << reference.size() << " frame, " << referenceMs << " ms\n";
+
+    bool ok = true;
+    for (int segments : segmentCounts) {
+        QVector<FrameData> frames;
+        qint64 elapsedMs = 0;
+        SegmentedLibavSource segmented(videoPath, true, true, segments, stop);
+        if (!readAll(segmented, &frames, &elapsedMs, &error)) {
+            err << segments << " đoạn: " << error << "\n";
+            return 2;
+        }
+        out << segments << " đoạn: " << elapsedMs << " ms, tăng tốc x" << QString::number(double(referenceMs) / qMax<qint64>(1, elapsedMs), 'f', 2)
+            << " (" << segmented.stageReport() << ")\n";
+        const Comparison comparison = compare(reference, frames, options);
+        printComparison(out, "1 lượt", QString("%1 đoạn").arg(segments), comparison, options);
+        ok = ok && comparison.onlyFirst == 0 && comparison.onlySecond == 0 && comparison.framesOver <= options.maxMismatches;
+    }
+    out << (ok ? "KHỚP" : "KHÔNG KHỚP") << "\n";
+    return ok ? 0 : 1;
+}
+
+// Frame của `frames` nằm trong một trong các cửa sổ [đầu, cuối]
+QVector<FrameData> framesInWindows(const QVector<FrameData> &frames, const QVector<QPair<int, int>> &windows)
+{
+    QVector<FrameData> inside;
+    int w = 0;
+    for (const FrameData &frame : frames) {
+        while (w < windows.size() && windows[w].second < frame.frameNum) ++w;
+        if (w >= windows.size()) break;
+        if (frame.frameNum >= windows[w].first) inside.append(frame);
+    }
+    return inside;
+}
+
+// Số chuỗi frame Viền Đen liền nhau; frameNum hở cũng cắt chuỗi
+int borderRuns(const QVector<FrameData> &frames, int width, int height, const Options &options)
+{
+    int runs = 0;
+    int previous = -2;
+    for (const FrameData &frame : frames) {
+        if (!isFlagged(frame, FLAG_BORDER, width, height, options)) continue;
+        if (frame.frameNum != previous + 1) ++runs;
+        previous = frame.frameNum;
+    }
+    return runs;
+}
+
+// Báo cáo qcli ghép với các cửa sổ phân tích lại so với một lượt phân tích cả file qua cùng bộ lọc, trong các cửa sổ
+int runSpliceVsFullPass(const QString &videoPath, const QString &reportPath, const QVector<QPair<int, int>> &windows,
+                        const Options &options, QTextStream &out, QTextStream &err)
+{
+    const std::atomic<bool> stop{false};
+    QString error;
+    QVector<FrameData> fullFrames;
+    qint64 fullMs = 0;
+    // Vùng ghép luôn dùng bộ lọc như qcli (SplicedFrameSource tắt LumaStats), lượt đầy đủ cũng vậy
+    LibavFrameSource full(videoPath, true, true, stop);
+    full.setNativeMetrics(false);
+    if (!readAll(full, &fullFrames, &fullMs, &error)) {
+        err << "Không phân tích được video: " << error << "\n";
+        return 2;
+    }
+    const MediaInfo mediaInfo = full.mediaInfo();
+    QVector<FrameData> splicedFrames;
+    qint64 splicedMs = 0;
+    SplicedFrameSource spliced(reportPath, videoPath, windows, true, true, mediaInfo, int(fullFrames.size()), stop);
+    if (!readAll(spliced, &splicedFrames, &splicedMs, &error)) {
+        err << "Không ghép được báo cáo với các cửa sổ: " << error << "\n";
+        return 2;
+    }
+
+    out << "1 lượt: " << fullFrames.size() << " frame, " << fullMs << " ms\n";
+    out << "Ghép: " << splicedFrames.size() << " frame, " << splicedMs << " ms (" << spliced.stageReport() << ")\n";
+    const QVector<FrameData> fullInside = framesInWindows(fullFrames, windows);
+    const QVector<FrameData> splicedInside = framesInWindows(splicedFrames, windows);
+    const Comparison comparison = compare(fullInside, splicedInside, options);
+    printComparison(out, "1 lượt", "ghép (trong cửa sổ)", comparison, options);
+
+    // Frame đầu mỗi cửa sổ: chỗ bộ lọc của vùng ghép bắt đầu, nơi vùng ảnh từng bị mất
+    int startsMissingCrop = 0;
+    for (const auto &window : windows) {
+        const auto byFrame = [&](const QVector<FrameData> &frames) -> const FrameData * {
+            const auto it = std::lower_bound(frames.begin(), frames.end(), window.first,
+                                             [](const FrameData &f, int frameNum) { return f.frameNum < frameNum; });
+            return it != frames.end() && it->frameNum == window.first ? &*it : nullptr;
+        };
+        const FrameData *a = byFrame(fullInside);
+        const FrameData *b = byFrame(splicedInside);
+        if (a && b && hasCrop(*a) && !hasCrop(*b)) {
+            ++startsMissingCrop;
+            out << "  Frame " << window.first << " (đầu cửa sổ): lượt đầy đủ có vùng ảnh, bản ghép không có\n";
+        }
+    }
+
+    const int width = mediaInfo.width, height = mediaInfo.height;
+    const FlagAgreement flags = compareFlags(fullInside, splicedInside, width, height, options);
+    const int fullRuns = borderRuns(fullInside, width, height, options);
+    const int splicedRuns = borderRuns(splicedInside, width, height, options);
+    out << "  " << FLAG_NAMES[FLAG_BORDER] << ": " << flags.reference[FLAG_BORDER] << " frame ở lượt đầy đủ, bản ghép bỏ sót "
+        << flags.missed[FLAG_BORDER] << ", đánh dấu thừa " << flags.extra[FLAG_BORDER] << "; " << fullRuns << " / " << splicedRuns << " chuỗi\n";
+
+    const bool ok = comparison.onlyFirst == 0 && comparison.onlySecond == 0 && comparison.framesOver <= options.maxMismatches
+                    && startsMissingCrop == 0 && flags.missed[FLAG_BORDER] == 0 && flags.extra[FLAG_BORDER] == 0 && fullRuns == splicedRuns;
+    out << (ok ? "KHỚP" : "KHÔNG KHỚP") << "\n";
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    parser.setApplicationDescription("So số liệu frame của bộ máy libav với báo cáo qcli của cùng video.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("video", "File video.");
+    parser.addPositionalArgument("report", "Báo cáo qcli của video (.qctools.xml hoặc .qctools.xml.gz); không cần với --segments, --downscale, --native-vs-filter.");
+    const QCommandLineOption toleranceOption("tolerance", "Chênh lệch YAVG/YDIF cho phép.", "value", "0.5");
+    const QCommandLineOption cropToleranceOption("crop-tolerance", "Chênh lệch mỗi cạnh vùng cropdetect cho phép (điểm ảnh).", "px", "2");
+    const QCommandLineOption maxMismatchOption("max-mismatches", "Số frame được phép vượt ngưỡng.", "n", "0");
+    const QCommandLineOption segmentsOption("segments", "Đo phân tích song song với các số đoạn này (ví dụ 2,4,8).", "list");
+    const QCommandLineOption downscaleOption("downscale", "Đo phân tích trên frame thu nhỏ với các hệ số này (2, 4).", "list");
+    const QCommandLineOption blackOption("black-threshold", "--downscale: ngưỡng YAVG của Frame Đen.", "value", "17");
+    const QCommandLineOption borderOption("border-threshold", "--downscale: ngưỡng viền đen (% cạnh khung hình).", "percent", "0.2");
+    const QCommandLineOption sceneOption("scene-threshold", "--downscale: ngưỡng YDIF của cắt cảnh.", "value", "30");
+    const QCommandLineOption nativeOption("native-vs-filter", "So số liệu LumaStats với bộ lọc signalstats/cropdetect trên cùng video.");
+    const QCommandLineOption spliceOption("splice-windows", "So báo cáo ghép với các cửa sổ phân tích lại này (đầu-cuối, ví dụ 240-479,1200-1319; "
+                                          "nên là đầu/cuối GOP) với một lượt giải mã cả file.", "list");
+    parser.addOptions({ toleranceOption, cropToleranceOption, maxMismatchOption, segmentsOption,
+                        downscaleOption, blackOption, borderOption, sceneOption, nativeOption, spliceOption });
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    const bool scaling = parser.isSet(segmentsOption);
+    const bool downscaling = parser.isSet(downscaleOption);
+    const bool nativeCheck = parser.isSet(nativeOption);
+    const bool spliceCheck = parser.isSet(spliceOption);
+    if (int(scaling) + int(downscaling) + int(nativeCheck) + int(spliceCheck) > 1) parser.showHelp(2);
+    if (args.size() != (scaling || downscaling || nativeCheck ? 1 : 2)) parser.showHelp(2);
+    Options options;
+    options.tolerance = parser.value(toleranceOption).toDouble();
+    options.cropTolerance = qMax(0, parser.value(cropToleranceOption).toInt());
+    options.maxMismatches = qMax(0, parser.value(maxMismatchOption).toInt());
+    options.blackThreshold = parser.value(blackOption).toDouble();
+    options.borderThresholdPercent = parser.value(borderOption).toDouble();
+    options.sceneThreshold = parser.value(sceneOption).toDouble();
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    if (scaling) {
+        QList<int> segmentCounts;
+        for (const QString &value : parser.value(segmentsOption).split(',', Qt::SkipEmptyParts)) {
+            if (value.trimmed().toInt() > 1) segmentCounts.append(value.trimmed().toInt());
+        }
+        return runSegmentScaling(args[0], segmentCounts, options, out, err);
+    }
+    if (downscaling) {
+        QList<int> factors;
+        for (const QString &value : parser.value(downscaleOption).split(',', Qt::SkipEmptyParts)) {
+            const int factor = value.trimmed().toInt();
+            if (factor == 2 || factor == 4) factors.append(factor);
+        }
+        return runDownscaleBenchmark(args[0], factors, options, out, err);
+    }
+    if (nativeCheck) return runNativeVsFilter(args[0], options, out, err);
+    if (spliceCheck) {
+        // Như GopIndex::changedWindows(): đã sắp xếp, không chồng nhau
+        QVector<QPair<int, int>> windows;
+        for (const QString &value : parser.value(spliceOption).split(',', Qt::SkipEmptyParts)) {
+            const QStringList bounds = value.trimmed().split('-');
+            bool firstOk = false, lastOk = false;
+            const int first = bounds.value(0).toInt(&firstOk);
+            const int last = bounds.value(1).toInt(&lastOk);
+            if (bounds.size() != 2 || !firstOk || !lastOk || first < 0 || last < first || (!windows.isEmpty() && first <= windows.last().second)) {
+                err << "Cửa sổ không hợp lệ: " << value << "\n";
+                return 2;
+            }
+            windows.append({ first, last });
+        }
+        if (windows.isEmpty()) parser.showHelp(2);
+        return runSpliceVsFullPass(args[0], args[1], windows, options, out, err);
+    }
+    const std::atomic<bool> stop{false};
+    QString error;
+
+    QVector<FrameData> reportFrames;
+    qint64 reportMs = 0;
+    ReportPipeline report(args[1], stop);
+    if (!readAll(report, &reportFrames, &reportMs, &error)) {
+        err << "Không đọc được báo cáo: " << error << "\n";
+        return 2;
+    }
+    QVector<FrameData> libavFrames;
+    qint64 libavMs = 0;
+    LibavFrameSource libav(args[0], true, true, stop);
+    if (!readAll(libav, &libavFrames, &libavMs, &error)) {
+        err << "Không phân tích được video: " << error << "\n";
+        return 2;
+    }
+
+    out << "Báo cáo qcli: " << reportFrames.size() << " frame (" << reportMs << " ms đọc)\n";
+    out << "libav: " << libavFrames.size() << " frame (" << libavMs << " ms giải mã + phân tích; " << libav.stageReport() << ")\n";
+    const bool reportContiguous = numberedFromZero(reportFrames);
+    if (!reportContiguous) {
+        out << "pkt_pts của báo cáo không chạy liên tục từ 0 (time_base của stream khác 1/fps?): frameNum của báo cáo "
+               "không phải số frame, hai bộ máy không đánh số như nhau.\n";
+    }
+    const Comparison comparison = compare(reportFrames, libavFrames, options);
+    printComparison(out, "qcli", "libav", comparison, options);
+
+    const bool numberingMatches = reportContiguous && comparison.onlyFirst == 0 && comparison.onlySecond == 0;
+    const bool ok = numberingMatches && comparison.framesOver <= options.maxMismatches;
+    out << (ok ? "KHỚP" : "KHÔNG KHỚP") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+// src/tools/LumaStatsCheck.cpp
+// CẢI TIẾN: Công cụ dòng lệnh tự kiểm tra các bản cài đặt của LumaStats (không cần libav, không cần video mẫu).
+// Sinh ngẫu nhiên mặt phẳng Y 8/10/12 bit với chiều rộng lẻ, stride có phần đệm (chứa giá trị rác để lộ việc đọc quá
+// mép hàng) và stride âm, có viền đen ngẫu nhiên quanh ảnh, rồi chạy computeWith()/findBordersWith() với mọi Isa có
+// trên máy này và so từng trường với bản vô hướng: YAVG/YDIF phải bằng nhau tuyệt đối, không có ngưỡng sai số.
+// Chạy sau mỗi lần sửa LumaStats*.cpp và trên mỗi loại CPU trước khi tin số liệu của bộ máy libav.
+// Mã thoát: 0 khi mọi bản cài đặt khớp, 1 khi có chỗ lệch, 2 khi sai tham số.
+//
+// Ví dụ:
+//   VideoQC_LumaStatsCheck
+//   VideoQC_LumaStatsCheck --iterations 20000 --seed 7
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "core/LumaStats.h"
+
+namespace {
+
+using LumaStats::Isa;
+
+// Một mặt phẳng Y trong bộ đệm riêng; hàng đầu ở cuối bộ đệm khi stride âm
+struct TestPlane {
+    std::vector<unsigned char> buffer;
+    LumaStats::Plane plane;
+};
+
+struct Case {
+    int width = 0;
+    int height = 0;
+    int bitDepth = 8;
+    int padding = 0;            // Số điểm ảnh đệm sau mỗi hàng
+    bool negativeStride = false;
+    int border[4] = {};         // Viền đen trên, dưới, trái, phải (số hàng/cột)
+};
+
+int pickBitDepth(std::mt19937 &rng)
+{
+    static const int depths[] = { 8, 10, 12 };
+    return depths[rng() % 3];
+}
+
+Case randomCase(std::mt19937 &rng)
+{
+    Case c;
+    // Chiều rộng lẻ, đủ nhỏ để có phần lẻ sau khối SIMD và đủ lớn để đi qua nhiều khối 8/16/32 cột
+    c.width = int(rng() % 160) * 2 + 1;
+    c.height = 1 + int(rng() % 48);
+    c.bitDepth = pickBitDepth(rng);
+    c.padding = int(rng() % 40);
+    c.negativeStride = rng() % 4 == 0;
+    if (rng() % 3 != 0) {
+        c.border[0] = int(rng() % (c.height / 2 + 1));
+        c.border[1] = int(rng() % (c.height / 2 + 1));
+        c.border[2] = int(rng() % (c.width / 2 + 1));
+        c.border[3] = int(rng() % (c.width / 2 + 1));
+    }
+    return c;
+}
+
+// Điểm ảnh viền có giá trị thấp quanh ngưỡng đen, phần ảnh có giá trị bất kỳ; phần đệm là giá trị lớn nhất của
+// kiểu lưu trữ (ngoài thang của độ sâu bit) để mọi lần đọc quá mép hàng làm kết quả lệch
+void fill(TestPlane *target, const Case &c, std::mt19937 &rng)
+{
+    const int bytesPerPixel = c.bitDepth <= 8 ? 1 : 2;
+    const std::ptrdiff_t rowBytes = std::ptrdiff_t(c.width + c.padding) * bytesPerPixel;
+    target->buffer.assign(size_t(rowBytes * c.height), 0xFF);
+    const int maxValue = (1 << c.bitDepth) - 1;
+    const int darkMax = (maxValue * 32) / 255;
+    for (int y = 0; y < c.height; ++y) {
+        unsigned char *row = target->buffer.data() + (c.negativeStride ? c.height - 1 - y : y) * rowBytes;
+        for (int x = 0; x < c.width; ++x) {
+            const bool inBorder = y < c.border[0] || y >= c.height - c.border[1] || x < c.border[2] || x >= c.width - c.border[3];
+            const int value = int(rng() % unsigned((inBorder ? darkMax : maxValue) + 1));
+            if (bytesPerPixel == 1) {
+                row[x] = static_cast<unsigned char>(value);
+            } else {
+                row[2 * x] = static_cast<unsigned char>(value & 0xFF);
+                row[2 * x + 1] = static_cast<unsigned char>(value >> 8);
+            }
+        }
+    }
+    LumaStats::Plane &plane = target->plane;
+    plane.width = c.width;
+    plane.height = c.height;
+    plane.bitDepth = c.bitDepth;
+    plane.stride = c.negativeStride ? -rowBytes : rowBytes;
+    plane.data = target->buffer.data() + (c.negativeStride ? (c.height - 1) * rowBytes : 0);
+}
+
+void printCase(const Case &c, int iteration)
+{
+    std::printf("  lần %d: %dx%d, %d bit, đệm %d điểm ảnh, stride %s, viền %d/%d/%d/%d\n", iteration, c.width, c.height, c.bitDepth,
+                c.padding, c.negativeStride ? "âm" : "dương", c.border[0], c.border[1], c.border[2], c.border[3]);
+}
+
+bool sameResult(const LumaStats::Result &a, const LumaStats::Result &b)
+{
+    return a.yavg == b.yavg && a.ydif == b.ydif && a.ymin == b.ymin && a.ymax == b.ymax;
+}
+
+bool sameBorders(const LumaStats::Borders &a, const LumaStats::Borders &b)
+{
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    long iterations = 5000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = std::strtol(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr, "Cách dùng: %s [--iterations N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (iterations <= 0) {
+        std::fprintf(stderr, "--iterations phải lớn hơn 0\n");
+        return 2;
+    }
+
+    // Bản cao hơn activeIsa() không có trên máy này và sẽ lùi về bản thấp hơn, không cần chạy lại
+    std::vector<Isa> isas;
+    for (Isa isa : { Isa::Sse2, Isa::Avx2 }) {
+        if (int(isa) <= int(LumaStats::activeIsa())) isas.push_back(isa);
+    }
+    std::printf("Bản cài đặt so với %s:", LumaStats::isaName(Isa::Scalar));
+    for (Isa isa : isas) std::printf(" %s", LumaStats::isaName(isa));
+    if (isas.empty()) std::printf(" (không có, máy này chỉ dùng bản vô hướng)");
+    std::printf("\n");
+
+    std::mt19937 rng(seed);
+    long computeMismatches = 0, borderMismatches = 0;
+    const int maxReported = 10;
+    int reported = 0;
+    for (long iteration = 0; iteration < iterations; ++iteration) {
+        const Case c = randomCase(rng);
+        TestPlane current, previous;
+        fill(&current, c, rng);
+        fill(&previous, c, rng);
+        const LumaStats::Plane *previousPlane = rng() % 5 == 0 ? nullptr : &previous.plane;
+        // Ngưỡng đen quanh giá trị của viền (mặc định của cropdetect là 24/255), cả giá trị không nguyên
+        const double limit = (1 << c.bitDepth) * (double(rng() % 64) / 1024.0) + (rng() % 2 ? 0.5 : 0.0);
+
+        const LumaStats::Result scalar = LumaStats::computeWith(Isa::Scalar, current.plane, previousPlane);
+        const LumaStats::Borders scalarBorders = LumaStats::findBordersWith(Isa::Scalar, current.plane, limit);
+        for (Isa isa : isas) {
+            const LumaStats::Result result = LumaStats::computeWith(isa, current.plane, previousPlane);
+            if (!sameResult(scalar, result)) {
+                ++computeMismatches;
+                if (reported++ < maxReported) {
+                    std::printf("[LỆCH] compute %s: YAVG %.17g/%.17g, YDIF %.17g/%.17g, YMIN %d/%d, YMAX %d/%d\n", LumaStats::isaName(isa),
+                                result.yavg, scalar.yavg, result.ydif, scalar.ydif, result.ymin, scalar.ymin, result.ymax, scalar.ymax);
+                    printCase(c, int(iteration));
+                }
+            }
+            const LumaStats::Borders borders = LumaStats::findBordersWith(isa, current.plane, limit);
+            if (!sameBorders(scalarBorders, borders)) {
+                ++borderMismatches;
+                if (reported++ < maxReported) {
+                    std::printf("[LỆCH] findBorders %s (ngưỡng %.2f): %d,%d-%d,%d / %d,%d-%d,%d\n", LumaStats::isaName(isa), limit, borders.x1,
+                                borders.y1, borders.x2, borders.y2, scalarBorders.x1, scalarBorders.y1, scalarBorders.x2, scalarBorders.y2);
+                    printCase(c, int(iteration));
+                }
+            }
+        }
+    }
+
+    std::printf("%ld mặt phẳng (seed %u): %ld lần compute lệch, %ld lần findBorders lệch\n", iterations, seed, computeMismatches,
+                borderMismatches);
+    const bool ok = computeMismatches == 0 && borderMismatches == 0;
+    std::printf("%s\n", ok ? "KHỚP" : "KHÔNG KHỚP");
+    return ok ? 0 : 1;
+}
@@ -18,6 +18,8 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMessageBox>
+#include <QFileInfo>
+#include <QRegularExpressionValidator>
 
 ConfigWidget::ConfigWidget(QWidget *parent)
     : QWidget(parent)
@@ -28,7 +30,13 @@ ConfigWidget::ConfigWidget(QWidget *parent)
 
 void ConfigWidget::setInputPath(const QString &path)
 {
-    m_videoPathEdit->setText(QDir::toNativeSeparators(path));
+    const QString nativePath = QDir::toNativeSeparators(path);
+    // Điểm vào/ra thuộc về file cũ
+    if (m_videoPathEdit->text() != nativePath) {
+        m_inPointEdit->clear();
+        m_outPointEdit->clear();
+    }
+    m_videoPathEdit->setText(nativePath);
 }
 
 void ConfigWidget::reloadSettings()
@@ -43,7 +51,8 @@ void ConfigWidget::setupUI()
 
     // --- Input Group ---
     QGroupBox *fileBox = new QGroupBox("Đầu vào");
-    QHBoxLayout *fileLayout = new QHBoxLayout(fileBox);
+    QVBoxLayout *fileBoxLayout = new QVBoxLayout(fileBox);
+    QHBoxLayout *fileLayout = new QHBoxLayout();
     m_videoPathEdit = new QLineEdit;
     m_videoPathEdit->setPlaceholderText("Chưa chọn file (hỗ trợ kéo-thả vào cửa sổ)");
     m_videoPathEdit->setReadOnly(true);
@@ -55,6 +64,39 @@ void ConfigWidget::setupUI()
     fileLayout->addWidget(selectFileButton);
     fileLayout->addWidget(selectReportButton);
 
+    // CẢI TIẾN: Điểm vào/ra để chỉ QC lại một đoạn (ví dụ đoạn được giao lại), không phải giải mã cả file
+    QHBoxLayout *rangeLayout = new QHBoxLayout();
+    const QString rangeToolTip =
+        "Chỉ giải mã và phân tích đoạn từ điểm vào tới điểm ra (tính cả hai frame này).\n"
+        "Nhập timecode HH:MM:SS:FF (HH:MM:SS;FF với drop-frame) hoặc số frame tính từ 0.\n"
+        "Để trống: từ đầu / tới cuối file. Số frame và timecode của kết quả vẫn tính theo cả file.\n"
+        "Cần bộ máy phân tích libav; không có biểu đồ timeline và kết quả không lưu vào cache.";
+    // Số frame, hoặc timecode 4 trường (trường FF có thể 3 chữ số với fps > 99)
+    const QRegularExpression rangePattern("\\d{1,9}|\\d{1,3}[:;]\\d{1,2}[:;]\\d{1,2}[:;]\\d{1,3}");
+    m_inPointEdit = new QLineEdit;
+    m_inPointEdit->setPlaceholderText("Đầu file");
+    m_outPointEdit = new QLineEdit;
+    m_outPointEdit->setPlaceholderText("Cuối file");
+    for (QLineEdit *edit : { m_inPointEdit, m_outPointEdit }) {
+        edit->setValidator(new QRegularExpressionValidator(rangePattern, edit));
+        edit->setClearButtonEnabled(true);
+        edit->setFixedWidth(140);
+        edit->setToolTip(rangeToolTip);
+    }
+    QLabel *inLabel = new QLabel("Điểm vào:");
+    QLabel *outLabel = new QLabel("Điểm ra:");
+    inLabel->setToolTip(rangeToolTip);
+    outLabel->setToolTip(rangeToolTip);
+    rangeLayout->addWidget(inLabel);
+    rangeLayout->addWidget(m_inPointEdit);
+    rangeLayout->addSpacing(12);
+    rangeLayout->addWidget(outLabel);
+    rangeLayout->addWidget(m_outPointEdit);
+    rangeLayout->addStretch();
+
+    fileBoxLayout->addLayout(fileLayout);
+    fileBoxLayout->addLayout(rangeLayout);
+
     // --- Configuration Section ---
 
     // CẢI TIẾN: Tạo một layout riêng cho tiêu đề và các nút preset
@@ -62,13 +104,24 @@ void ConfigWidget::setupUI()
     QLabel *configTitleLabel = new QLabel("<b>Cấu hình Phát hiện Lỗi</b>");
     m_loadPresetButton = new QPushButton("Tải Cấu hình");
     m_savePresetButton = new QPushButton("Lưu Cấu hình");
+    m_compareProfilesButton = new QPushButton("So sánh Cấu hình...");
+    m_compareProfilesButton->setToolTip("Chọn một hoặc nhiều file cấu hình (.json) để chạy cùng cấu hình hiện tại\n"
+                                        "trên một lượt đọc báo cáo, rồi so sánh số lỗi của từng cấu hình.");
+    // CẢI TIẾN: Quét nhanh để phân loại file (chỉ với bộ máy libav)
+    m_fastScanCheck = new QCheckBox("Quét nhanh");
+    m_fastScanCheck->setToolTip("Lấy mẫu thưa (mặc định 1 frame/giây) để tìm vùng đáng ngờ, rồi chỉ phân tích đầy đủ từng frame\n"
+                                "quanh các vùng đó. Nhanh hơn nhiều với file dài ít lỗi, nhưng lỗi ngắn hơn khoảng lấy mẫu\n"
+                                "có thể bị bỏ sót và không có biểu đồ timeline. Chỉ dùng được với bộ máy phân tích libav.");
     connect(m_loadPresetButton, &QPushButton::clicked, this, &ConfigWidget::onLoadPresetClicked);
     connect(m_savePresetButton, &QPushButton::clicked, this, &ConfigWidget::onSavePresetClicked);
+    connect(m_compareProfilesButton, &QPushButton::clicked, this, &ConfigWidget::onCompareProfilesClicked);
 
     configHeaderLayout->addWidget(configTitleLabel);
     configHeaderLayout->addStretch();
+    configHeaderLayout->addWidget(m_fastScanCheck);
     configHeaderLayout->addWidget(m_loadPresetButton);
     configHeaderLayout->addWidget(m_savePresetButton);
+    configHeaderLayout->addWidget(m_compareProfilesButton);
 
 
     // CẢI TIẾN: GroupBox bây giờ không có tiêu đề, chỉ dùng để tạo khung
@@ -243,6 +296,21 @@ void ConfigWidget::saveSettings()
     }
 }
 
+bool ConfigWidget::fastScanEnabled() const
+{
+    return m_fastScanCheck->isChecked();
+}
+
+QString ConfigWidget::inPointText() const
+{
+    return m_inPointEdit->text().trimmed();
+}
+
+QString ConfigWidget::outPointText() const
+{
+    return m_outPointEdit->text().trimmed();
+}
+
 QVariantMap ConfigWidget::getSettings() const
 {
     QVariantMap settings;
@@ -322,3 +390,28 @@ void ConfigWidget::onLoadPresetClicked()
     QMessageBox::information(this, "Thành công", "Đã tải và áp dụng cấu hình thành công.");
 }
 
+void ConfigWidget::onCompareProfilesClicked()
+{
+    const QStringList filePaths = QFileDialog::getOpenFileNames(this, "Chọn các Cấu hình để So sánh", "", "JSON Files (*.json)");
+    if (filePaths.isEmpty()) return;
+
+    QVariantList profiles;
+    profiles.append(QVariantMap{ {"name", "Cấu hình hiện tại"}, {"settings", getSettings()} });
+
+    QStringList invalidFiles;
+    for (const QString& filePath : filePaths) {
+        QFile loadFile(filePath);
+        const QJsonDocument doc = loadFile.open(QIODevice::ReadOnly) ? QJsonDocument::fromJson(loadFile.readAll()) : QJsonDocument();
+        if (doc.isNull() || !doc.isObject()) {
+            invalidFiles << QFileInfo(filePath).fileName();
+            continue;
+        }
+        profiles.append(QVariantMap{ {"name", QFileInfo(filePath).completeBaseName()}, {"settings", doc.object().toVariantMap()} });
+    }
+
+    if (!invalidFiles.isEmpty()) {
+        QMessageBox::warning(this, "Lỗi", QString("Bỏ qua các file cấu hình không hợp lệ:\n%1").arg(invalidFiles.join("\n")));
+    }
+    if (profiles.size() < 2) return;
+    emit profilesSelected(profiles);
+}
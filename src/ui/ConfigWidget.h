@@ -21,6 +21,12 @@ public:
     QVariantMap getSettings() const;
     void setInputPath(const QString& path);
     void setSettings(const QVariantMap& settings); // Hàm mới để áp dụng cài đặt từ bên ngoài
+    // Chế độ quét nhanh cho lần phân tích kế tiếp; không thuộc cấu hình phát hiện lỗi nên không nằm trong getSettings()
+    bool fastScanEnabled() const;
+    // Điểm vào/ra do người dùng nhập (timecode HH:MM:SS:FF hoặc số frame), rỗng: đầu/cuối file.
+    // Như quét nhanh, chỉ áp dụng cho lần phân tích kế tiếp nên không nằm trong getSettings()
+    QString inPointText() const;
+    QString outPointText() const;
 
 public slots:
     void reloadSettings();
@@ -28,6 +34,8 @@ public slots:
 signals:
     void filePathSelected(const QString &path);
     void reportPathSelected(const QString &path);
+    // Danh sách map { "name", "settings" }: cấu hình hiện tại trước, sau đó các preset đã chọn
+    void profilesSelected(const QVariantList &profiles);
 
 private slots:
     void onSelectFileClicked();
@@ -35,6 +43,7 @@ private slots:
     // Slots mới cho tính năng preset
     void onSavePresetClicked();
     void onLoadPresetClicked();
+    void onCompareProfilesClicked();
 
 private:
     void setupUI();
@@ -43,6 +52,8 @@ private:
 
     // Input
     QLineEdit *m_videoPathEdit;
+    QLineEdit *m_inPointEdit;
+    QLineEdit *m_outPointEdit;
 
     // --- Error Groups ---
     QGroupBox* m_blackFrameBox;
@@ -52,6 +63,7 @@ private:
     // --- Preset Buttons (Mới) ---
     QPushButton* m_savePresetButton;
     QPushButton* m_loadPresetButton;
+    QPushButton* m_compareProfilesButton;
     
     // --- Thresholds ---
     // Black Frames
@@ -64,6 +76,7 @@ private:
     QSpinBox* m_orphanFrameThreshSpinBox;
     QDoubleSpinBox* m_sceneDetectThreshSpinBox;
     QCheckBox* m_hasTransitionsCheck;
+    QCheckBox* m_fastScanCheck;
 };
 
 #endif // CONFIGWIDGET_H
@@ -1,20 +1,27 @@
 // src/ui/resultswidget.cpp (Đã cải tiến theo Yêu cầu #3)
 #include "resultswidget.h"
 #include "clickableheaderview.h" 
+#include "resultstablemodel.h"
+#include "metrictimelinewidget.h"
+#include "thumbnaildelegate.h"
+#include "core/ThumbnailProvider.h"
 #include "core/Constants.h"
-#include "qctools/QCToolsManager.h" 
+#include "core/ResultExporter.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QTreeView>
-#include <QStandardItemModel>
 #include <QPushButton>
 #include <QHeaderView>
 #include <QCheckBox>
 #include <QLabel>
 #include <QMenu>      
 #include <QAction>    
-#include <algorithm>
+#include <QSettings>
+#include <QSplitter>
+#include <QScrollBar>
+#include <QTimer>
+#include <QComboBox>
 
 ResultsWidget::ResultsWidget(QWidget *parent)
     : QWidget(parent)
@@ -46,40 +53,102 @@ void ResultsWidget::setupUI()
     m_filterBlackBordersCheck->setChecked(true);
     m_filterOrphanFramesCheck->setChecked(true);
 
+    m_profileLabel = new QLabel("Cấu hình:");
+    m_profileCombo = new QComboBox();
+    m_profileCombo->setToolTip("Xem kết quả của từng cấu hình đã đánh giá trên cùng báo cáo");
+    m_profileCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    m_profileLabel->setVisible(false);
+    m_profileCombo->setVisible(false);
+    connect(m_profileCombo, &QComboBox::activated, this, &ResultsWidget::profileSelected);
+
     titleLayout->addWidget(titleLabel);
+    titleLayout->addSpacing(12);
+    titleLayout->addWidget(m_profileLabel);
+    titleLayout->addWidget(m_profileCombo);
     titleLayout->addStretch();
     titleLayout->addWidget(new QLabel("Lọc:"));
     titleLayout->addWidget(m_filterBlackFramesCheck);
     titleLayout->addWidget(m_filterBlackBordersCheck);
     titleLayout->addWidget(m_filterOrphanFramesCheck);
 
+    m_showThumbnailsCheck = new QCheckBox("Ảnh xem trước");
+    m_showThumbnailsCheck->setToolTip("Hiện ảnh frame đầu, giữa và cuối của mỗi đoạn lỗi (cần ffmpeg và file video gốc)");
+    titleLayout->addSpacing(12);
+    titleLayout->addWidget(m_showThumbnailsCheck);
+
     connect(m_filterBlackFramesCheck, &QCheckBox::stateChanged, this, &ResultsWidget::onDisplayOptionsChanged);
     connect(m_filterBlackBordersCheck, &QCheckBox::stateChanged, this, &ResultsWidget::onDisplayOptionsChanged);
     connect(m_filterOrphanFramesCheck, &QCheckBox::stateChanged, this, &ResultsWidget::onDisplayOptionsChanged);
 
     resultsLayout->addWidget(titleWidget);
 
+    // --- Ghi chú về kết quả (ví dụ: chỉ là ước lượng của lượt quét keyframe) ---
+    m_noticeWidget = new QWidget();
+    m_noticeWidget->setStyleSheet("background-color: #fcf8e3; border: 1px solid #faebcc; border-radius: 3px;");
+    QHBoxLayout *noticeLayout = new QHBoxLayout(m_noticeWidget);
+    noticeLayout->setContentsMargins(6, 4, 6, 4);
+    m_noticeLabel = new QLabel();
+    m_noticeLabel->setWordWrap(true);
+    m_noticeLabel->setStyleSheet("color: #8a6d3b; border: none;");
+    m_noticeButton = new QPushButton();
+    connect(m_noticeButton, &QPushButton::clicked, this, &ResultsWidget::noticeActionClicked);
+    noticeLayout->addWidget(m_noticeLabel, 1);
+    noticeLayout->addWidget(m_noticeButton);
+    m_noticeWidget->setVisible(false);
+    resultsLayout->addWidget(m_noticeWidget);
+
     // --- Bảng kết quả ---
     m_resultsTreeView = new QTreeView;
     m_headerView = new ClickableHeaderView(Qt::Horizontal, m_resultsTreeView);
     m_resultsTreeView->setHeader(m_headerView);
     connect(m_headerView, &ClickableHeaderView::sectionClickedWithPos, this, &ResultsWidget::onHeaderClicked);
 
-    m_resultsModel = new QStandardItemModel(0, 5, this);
-    m_resultsModel->setHorizontalHeaderLabels({"Timecode", "Số lượng", "Loại lỗi", "Chi tiết", "ID"});
+    m_resultsModel = new ResultsTableModel(this);
     m_resultsTreeView->setModel(m_resultsModel);
     m_resultsTreeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_headerView->setSectionResizeMode(0, QHeaderView::Interactive);
-    m_headerView->setSectionResizeMode(1, QHeaderView::Interactive);
-    m_headerView->setSectionResizeMode(2, QHeaderView::Interactive);
-    m_headerView->setSectionResizeMode(3, QHeaderView::Stretch);
-    m_resultsTreeView->setColumnWidth(0, 140); 
-    m_resultsTreeView->setColumnWidth(1, 120);
-    m_resultsTreeView->setColumnWidth(2, 100);
-    m_resultsTreeView->setColumnHidden(4, true); 
+    // CẢI TIẾN: Các dòng có cùng chiều cao và không có cây con, view không phải đo từng dòng
+    m_resultsTreeView->setUniformRowHeights(true);
+    m_resultsTreeView->setRootIsDecorated(false);
+    m_headerView->setSectionResizeMode(ResultsTableModel::ColTime, QHeaderView::Interactive);
+    m_headerView->setSectionResizeMode(ResultsTableModel::ColCount, QHeaderView::Interactive);
+    m_headerView->setSectionResizeMode(ResultsTableModel::ColType, QHeaderView::Interactive);
+    m_headerView->setSectionResizeMode(ResultsTableModel::ColDetails, QHeaderView::Stretch);
+    m_resultsTreeView->setColumnWidth(ResultsTableModel::ColTime, 140); 
+    m_resultsTreeView->setColumnWidth(ResultsTableModel::ColCount, 120);
+    m_resultsTreeView->setColumnWidth(ResultsTableModel::ColType, 100);
     connect(m_resultsTreeView, &QTreeView::doubleClicked, this, &ResultsWidget::onTreeViewDoubleClicked);
 
-    resultsLayout->addWidget(m_resultsTreeView);
+    // --- Ảnh xem trước: giải mã nền, chỉ cho các dòng đang nhìn thấy ---
+    m_thumbnailProvider = new ThumbnailProvider(this);
+    m_thumbnailDelegate = new ThumbnailDelegate(m_resultsModel, m_thumbnailProvider, this);
+    m_resultsTreeView->setItemDelegateForColumn(ResultsTableModel::ColThumbs, m_thumbnailDelegate);
+    m_headerView->setSectionResizeMode(ResultsTableModel::ColThumbs, QHeaderView::Interactive);
+    m_resultsTreeView->setColumnWidth(ResultsTableModel::ColThumbs, ThumbnailDelegate::THUMB_COUNT * (ThumbnailProvider::THUMB_WIDTH + 4));
+    connect(m_thumbnailProvider, &ThumbnailProvider::thumbnailReady, m_resultsTreeView->viewport(), qOverload<>(&QWidget::update));
+
+    // Sau khi cuộn, hủy các yêu cầu của những dòng đã ra khỏi màn hình
+    m_thumbnailTimer = new QTimer(this);
+    m_thumbnailTimer->setSingleShot(true);
+    m_thumbnailTimer->setInterval(60);
+    connect(m_thumbnailTimer, &QTimer::timeout, this, &ResultsWidget::updateVisibleThumbnails);
+    connect(m_resultsTreeView->verticalScrollBar(), &QScrollBar::valueChanged, m_thumbnailTimer, qOverload<>(&QTimer::start));
+
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    m_showThumbnailsCheck->setChecked(settings.value(AppConstants::K_SHOW_THUMBNAILS, false).toBool());
+    onShowThumbnailsToggled(m_showThumbnailsCheck->isChecked());
+    connect(m_showThumbnailsCheck, &QCheckBox::toggled, this, &ResultsWidget::onShowThumbnailsToggled);
+
+    // --- Biểu đồ chỉ số của toàn bộ file, nằm dưới bảng và có thể kéo giãn ---
+    m_timelineWidget = new MetricTimelineWidget;
+    connect(m_timelineWidget, &MetricTimelineWidget::frameDoubleClicked, this, &ResultsWidget::errorDoubleClicked);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_resultsTreeView);
+    splitter->addWidget(m_timelineWidget);
+    splitter->setStretchFactor(0, 3);
+    splitter->setStretchFactor(1, 1);
+    splitter->setChildrenCollapsible(false);
+    resultsLayout->addWidget(splitter);
 
     // --- Các nút chức năng dưới bảng ---
     QHBoxLayout *bottomButtonsLayout = new QHBoxLayout;
@@ -87,14 +156,26 @@ void ResultsWidget::setupUI()
     m_settingsButton->setToolTip("Mở cài đặt (đường dẫn, ngưỡng lỗi...)");
     connect(m_settingsButton, &QPushButton::clicked, this, &ResultsWidget::settingsClicked);
 
-    m_exportTxtButton = new QPushButton("Xuất TXT");
+    m_exportButton = new QPushButton("Xuất báo cáo");
+    m_exportButton->setToolTip("Xuất kết quả ra file TXT, CSV, JSON hoặc EDL (marker cho phần mềm dựng)");
+    QMenu* exportMenu = new QMenu(m_exportButton);
+    const QList<QPair<QString, ExportFormat>> exportFormats = {
+        {"Văn bản (TXT)", ExportFormat::Txt},
+        {"Bảng tính (CSV)", ExportFormat::Csv},
+        {"JSON", ExportFormat::Json},
+        {"EDL CMX3600 / Marker", ExportFormat::Edl}
+    };
+    for (const auto& entry : exportFormats) {
+        const int format = static_cast<int>(entry.second);
+        connect(exportMenu->addAction(entry.first), &QAction::triggered, this, [this, format]() { emit exportRequested(format); });
+    }
+    m_exportButton->setMenu(exportMenu);
     m_copyButton = new QPushButton("Sao chép vào Clipboard");
-    connect(m_exportTxtButton, &QPushButton::clicked, this, &ResultsWidget::exportTxtClicked);
     connect(m_copyButton, &QPushButton::clicked, this, &ResultsWidget::copyToClipboardClicked);
 
     bottomButtonsLayout->addWidget(m_settingsButton);
     bottomButtonsLayout->addStretch();
-    bottomButtonsLayout->addWidget(m_exportTxtButton);
+    bottomButtonsLayout->addWidget(m_exportButton);
     bottomButtonsLayout->addWidget(m_copyButton);
 
     resultsLayout->addLayout(bottomButtonsLayout);
@@ -128,113 +209,146 @@ void ResultsWidget::onHeaderClicked(int logicalIndex, const QPoint &pos)
 
 void ResultsWidget::onTimecodeFormatSelected(QAction *action)
 {
+    // Chỉ cột thời gian cần vẽ lại, không dựng lại toàn bộ bảng
     m_currentTimecodeFormat = action->data().toInt();
-    onDisplayOptionsChanged();
+    m_resultsModel->setTimeFormat(m_currentTimecodeFormat, action->text());
 }
 
-void ResultsWidget::setCurrentFps(double fps)
+void ResultsWidget::setMediaInfo(const MediaInfo& info)
 {
-    m_currentFps = fps;
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    const bool dropFrame = settings.value(AppConstants::K_DROP_FRAME_TIMECODE, true).toBool();
+    m_resultsModel->setVideoInfo(Timecode(info.frameRate, dropFrame), info.width, info.height);
 }
 
-void ResultsWidget::onDisplayOptionsChanged()
+void ResultsWidget::setMetrics(const MetricPyramidPtr& metrics)
 {
-    updateResultsView();
+    m_timelineWidget->setMetrics(metrics);
 }
 
-void ResultsWidget::updateButtonStates()
+void ResultsWidget::setVideoSource(const QString& videoPath, const FrameRate& frameRate)
 {
-    bool hasResults = !m_currentResults.isEmpty();
-    m_exportTxtButton->setEnabled(hasResults);
-    m_copyButton->setEnabled(hasResults);
+    m_thumbnailProvider->setSource(videoPath, frameRate);
+    m_resultsTreeView->viewport()->update();
 }
 
-QString ResultsWidget::getFormattedTime(const AnalysisResult& res) const
+void ResultsWidget::setThumbnailSettings(const QString& ffmpegPath, bool diskCache)
 {
-    switch (m_currentTimecodeFormat) {
-        case 0: return QCToolsManager::frameToTimecodeHHMMSSFF(res.startFrame, m_currentFps);
-        case 1: return QCToolsManager::frameToTimecodePrecise(res.startFrame, m_currentFps);
-        case 2: return QString::number(res.startFrame);
-        case 3: return QCToolsManager::frameToSecondsString(res.startFrame, m_currentFps);
-        case 4: return QCToolsManager::frameToMinutesString(res.startFrame, m_currentFps);
-        default: return res.timecode;
-    }
+    m_thumbnailProvider->setFfmpegPath(ffmpegPath);
+    m_thumbnailProvider->setDiskCacheEnabled(diskCache);
+    m_resultsTreeView->viewport()->update();
 }
 
-void ResultsWidget::updateResultsView()
+void ResultsWidget::onShowThumbnailsToggled(bool checked)
 {
-    m_resultsModel->removeRows(0, m_resultsModel->rowCount());
-
-    bool showBlackFrames = m_filterBlackFramesCheck->isChecked();
-    bool showBlackBorders = m_filterBlackBordersCheck->isChecked();
-    bool showOrphanFrames = m_filterOrphanFramesCheck->isChecked();
-
-    QString currentFormatText = m_timecodeFormatMenu->actions().at(m_currentTimecodeFormat)->text();
-    m_resultsModel->setHorizontalHeaderItem(0, new QStandardItem(currentFormatText));
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    settings.setValue(AppConstants::K_SHOW_THUMBNAILS, checked);
+
+    m_thumbnailDelegate->setEnabled(checked);
+    m_resultsTreeView->setColumnHidden(ResultsTableModel::ColThumbs, !checked);
+    if (!checked) m_thumbnailProvider->retainOnly({});
+    // Chiều cao dòng (đồng nhất) phụ thuộc vào việc có hiện ảnh hay không
+    m_resultsTreeView->doItemsLayout();
+}
 
-    for (const auto &res : m_currentResults) {
-        bool shouldShow = false;
-        if (res.errorType == AppConstants::ERR_BLACK_FRAME && showBlackFrames) shouldShow = true;
-        else if (res.errorType == AppConstants::ERR_BLACK_BORDER && showBlackBorders) shouldShow = true;
-        else if (res.errorType == AppConstants::ERR_ORPHAN_FRAME && showOrphanFrames) shouldShow = true;
+void ResultsWidget::updateVisibleThumbnails()
+{
+    if (!m_showThumbnailsCheck->isChecked()) return;
+
+    const int rows = m_resultsModel->rowCount();
+    QSet<int> frames;
+    if (rows > 0) {
+        const QRect viewport = m_resultsTreeView->viewport()->rect();
+        const QModelIndex top = m_resultsTreeView->indexAt(viewport.topLeft());
+        const QModelIndex bottom = m_resultsTreeView->indexAt(viewport.bottomLeft());
+        const int first = top.isValid() ? top.row() : 0;
+        const int last = bottom.isValid() ? bottom.row() : rows - 1;
+        for (int row = first; row <= last; ++row) {
+            if (const AnalysisResult* res = m_resultsModel->resultAt(row)) {
+                for (int frame : ThumbnailDelegate::framesFor(*res)) frames.insert(frame);
+            }
+        }
+    }
+    m_thumbnailProvider->retainOnly(frames);
+}
 
-        if (shouldShow) {
-            // CẢI TIẾN: Căn giữa cho 2 cột đầu tiên
-            QStandardItem *timecodeItem = new QStandardItem(getFormattedTime(res));
-            timecodeItem->setTextAlignment(Qt::AlignCenter);
+void ResultsWidget::onDisplayOptionsChanged()
+{
+    updateResultsView();
+}
 
-            QStandardItem *durationItem = new QStandardItem(res.duration);
-            durationItem->setTextAlignment(Qt::AlignCenter);
+void ResultsWidget::updateButtonStates()
+{
+    bool hasResults = m_resultsModel->resultCount() > 0;
+    m_exportButton->setEnabled(hasResults);
+    m_copyButton->setEnabled(hasResults);
+}
 
-            QList<QStandardItem *> rowItems;
-            rowItems.append(timecodeItem);
-            rowItems.append(durationItem);
-            rowItems.append(new QStandardItem(res.errorType));
-            rowItems.append(new QStandardItem(res.details));
-            rowItems.append(new QStandardItem(QString::number(res.id)));
-            m_resultsModel->appendRow(rowItems);
-        }
-    }
+void ResultsWidget::updateResultsView()
+{
+    quint8 mask = ResultsTableModel::BitNone;
+    if (m_filterBlackFramesCheck->isChecked()) mask |= ResultsTableModel::BitBlackFrame;
+    if (m_filterBlackBordersCheck->isChecked()) mask |= ResultsTableModel::BitBlackBorder;
+    if (m_filterOrphanFramesCheck->isChecked()) mask |= ResultsTableModel::BitOrphanFrame;
+    m_resultsModel->setTypeFilter(mask);
+    m_timelineWidget->setTypeFilter(mask);
+    m_thumbnailTimer->start();
 }
 
 void ResultsWidget::onTreeViewDoubleClicked(const QModelIndex &index)
 {
     if (!index.isValid()) return;
 
-    QModelIndex idIndex = m_resultsModel->index(index.row(), 4);
-    bool ok;
-    int resultId = m_resultsModel->data(idIndex).toInt(&ok);
-    if (!ok) return;
-
-    for(const auto& res : m_currentResults) {
-        if (res.id == resultId) {
-            emit errorDoubleClicked(res.startFrame);
-            return;
-        }
+    if (const AnalysisResult* res = m_resultsModel->resultAt(index.row())) {
+        emit errorDoubleClicked(res->startFrame);
     }
 }
 
 void ResultsWidget::handleResults(const QList<AnalysisResult> &newResults)
 {
-    m_currentResults.clear();
-    m_currentResults.append(newResults);
-    std::sort(m_currentResults.begin(), m_currentResults.end(), [](const auto& a, const auto& b){
-        return a.startFrame < b.startFrame;
-    });
+    m_resultsModel->setResults(newResults);
+    m_timelineWidget->setResults(newResults);
+    updateButtonStates();
+}
 
-    updateResultsView();
+void ResultsWidget::appendResults(const QList<AnalysisResult> &batch)
+{
+    m_resultsModel->appendResults(batch);
+    m_timelineWidget->appendResults(batch);
     updateButtonStates();
 }
 
 void ResultsWidget::clearResults()
 {
-    m_currentResults.clear();
-    updateResultsView();
+    m_resultsModel->clear();
+    m_timelineWidget->clear();
+    setProfiles({});
+    setNotice(QString());
     updateButtonStates();
 }
 
-const QList<AnalysisResult>& ResultsWidget::getCurrentResults() const
+void ResultsWidget::setNotice(const QString &text, const QString &actionText)
+{
+    m_noticeLabel->setText(text);
+    m_noticeButton->setText(actionText);
+    m_noticeButton->setVisible(!actionText.isEmpty());
+    m_noticeWidget->setVisible(!text.isEmpty());
+}
+
+void ResultsWidget::setProfiles(const QStringList &names)
 {
-    return m_currentResults;
+    m_profileCombo->clear();
+    m_profileCombo->addItems(names);
+    m_profileLabel->setVisible(!names.isEmpty());
+    m_profileCombo->setVisible(!names.isEmpty());
 }
 
+QList<AnalysisResult> ResultsWidget::getCurrentResults() const
+{
+    return m_resultsModel->sortedResults();
+}
+
+int ResultsWidget::resultCount() const
+{
+    return m_resultsModel->resultCount();
+}
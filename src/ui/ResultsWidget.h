@@ -5,15 +5,23 @@
 #include <QWidget>
 #include <QList>
 #include "core/types.h"
+#include "core/media_info.h"
+#include "core/MetricPyramid.h"
 
 // Forward declarations
 class QTreeView;
-class QStandardItemModel;
+class ResultsTableModel;
 class QPushButton;
 class QCheckBox;
 class QMenu;
 class QAction;
 class ClickableHeaderView; // Thêm lớp header tùy chỉnh
+class MetricTimelineWidget;
+class ThumbnailProvider;
+class ThumbnailDelegate;
+class QTimer;
+class QComboBox;
+class QLabel;
 
 class ResultsWidget : public QWidget
 {
@@ -22,17 +30,31 @@ class ResultsWidget : public QWidget
 public:
     explicit ResultsWidget(QWidget *parent = nullptr);
     void handleResults(const QList<AnalysisResult> &newResults);
+    void appendResults(const QList<AnalysisResult> &batch);
     void clearResults();
-    const QList<AnalysisResult>& getCurrentResults() const;
+    QList<AnalysisResult> getCurrentResults() const;
+    int resultCount() const;
+    // Đánh giá nhiều cấu hình: hiện ô chọn cấu hình, mỗi mục là tên kèm số lỗi. Danh sách rỗng: ẩn đi.
+    void setProfiles(const QStringList& names);
+    // Dòng ghi chú phía trên bảng (ví dụ kết quả chỉ là ước lượng), kèm nút hành động nếu `actionText` khác rỗng.
+    // `text` rỗng: ẩn đi. clearResults() cũng ẩn ghi chú.
+    void setNotice(const QString& text, const QString& actionText = QString());
 
 public slots:
-    void setCurrentFps(double fps);
+    void setMediaInfo(const MediaInfo& info);
+    void setMetrics(const MetricPyramidPtr& metrics);
+    // Video dùng để tạo ảnh xem trước (rỗng khi chỉ mở báo cáo)
+    void setVideoSource(const QString& videoPath, const FrameRate& frameRate);
+    void setThumbnailSettings(const QString& ffmpegPath, bool diskCache);
 
 signals:
-    void exportTxtClicked();
+    // format: giá trị của ExportFormat
+    void exportRequested(int format);
     void copyToClipboardClicked();
     void settingsClicked();
     void errorDoubleClicked(int frameNum);
+    void profileSelected(int index);
+    void noticeActionClicked();
 
 private slots:
     void onTreeViewDoubleClicked(const QModelIndex &index);
@@ -41,6 +63,8 @@ private slots:
     void onHeaderClicked(int logicalIndex, const QPoint& pos);
     // Slot mới để xử lý khi một định dạng được chọn từ menu
     void onTimecodeFormatSelected(QAction* action);
+    void onShowThumbnailsToggled(bool checked);
+    void updateVisibleThumbnails();
 
 
 private:
@@ -48,14 +72,17 @@ private:
     void setupTimecodeMenu(); // Hàm mới để khởi tạo menu
     void updateResultsView(); 
     void updateButtonStates();
-    QString getFormattedTime(const AnalysisResult& res) const;
 
     // UI Elements
     QTreeView *m_resultsTreeView;
     ClickableHeaderView *m_headerView; // Sử dụng header tùy chỉnh
-    QStandardItemModel *m_resultsModel;
+    ResultsTableModel *m_resultsModel;
+    MetricTimelineWidget *m_timelineWidget;
+    ThumbnailProvider *m_thumbnailProvider;
+    ThumbnailDelegate *m_thumbnailDelegate;
+    QTimer *m_thumbnailTimer;
     QPushButton *m_settingsButton;
-    QPushButton *m_exportTxtButton;
+    QPushButton *m_exportButton;
     QPushButton *m_copyButton;
 
     // Loại bỏ QComboBox, thay bằng QMenu
@@ -63,10 +90,14 @@ private:
     QCheckBox *m_filterBlackFramesCheck;
     QCheckBox *m_filterBlackBordersCheck;
     QCheckBox *m_filterOrphanFramesCheck;
+    QCheckBox *m_showThumbnailsCheck;
+    QLabel *m_profileLabel;
+    QComboBox *m_profileCombo;
+    QWidget *m_noticeWidget;
+    QLabel *m_noticeLabel;
+    QPushButton *m_noticeButton;
 
-    // State
-    QList<AnalysisResult> m_currentResults; // Dữ liệu gốc
-    double m_currentFps = 0.0;
+    // State (dữ liệu gốc nằm trong m_resultsModel)
     int m_currentTimecodeFormat = 0; // Lưu trạng thái định dạng hiện tại
 };
 
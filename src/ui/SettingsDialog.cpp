@@ -1,6 +1,7 @@
 // src/ui/settingsdialog.cpp
 #include "settingsdialog.h"
 #include "core/Constants.h"
+#include "qctools/QCToolsManager.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QFormLayout>
@@ -11,6 +12,7 @@
 #include <QSpinBox>
 #include <QCheckBox>
 #include <QComboBox>
+#include <QStandardItemModel>
 #include <QLineEdit>
 #include <QFileDialog>
 #include <QSettings>
@@ -66,7 +68,77 @@ void SettingsDialog::setupUI()
     qcliLayout->addWidget(browseQCCliButton);
     pathsLayout->addRow("Đường dẫn qcli.exe:", qcliLayout);
 
+    m_ffmpegPathEdit = new QLineEdit(this);
+    m_ffmpegPathEdit->setPlaceholderText("Tự tìm trong PATH hoặc thư mục QCTools");
+    m_ffmpegPathEdit->setToolTip("Dùng để tạo ảnh xem trước của các đoạn lỗi trong bảng kết quả");
+    QPushButton *browseFfmpegButton = new QPushButton("Duyệt...");
+    QHBoxLayout *ffmpegLayout = new QHBoxLayout();
+    ffmpegLayout->addWidget(m_ffmpegPathEdit);
+    ffmpegLayout->addWidget(browseFfmpegButton);
+    pathsLayout->addRow("Đường dẫn ffmpeg.exe:", ffmpegLayout);
+
+    m_engineCombo = new QComboBox(this);
+    m_engineCombo->addItem("qcli (tạo báo cáo QCTools)", AppConstants::ENGINE_QCLI);
+    m_engineCombo->addItem("libav trong ứng dụng (không qua XML)", AppConstants::ENGINE_LIBAV);
+    m_engineCombo->setToolTip("qcli: chạy qcli.exe, ghi báo cáo .xml.gz/.mkv cạnh video rồi đọc lại báo cáo.\n"
+                              "libav: giải mã và chạy signalstats/cropdetect ngay trong ứng dụng, nhanh hơn\n"
+                              "nhưng không tạo file báo cáo để mở lại bằng QCTools.");
+    if (!QCToolsManager::inProcessEngineAvailable()) {
+        // Bản build không có libav: vẫn hiện lựa chọn nhưng không cho chọn
+        if (auto *model = qobject_cast<QStandardItemModel*>(m_engineCombo->model())) {
+            QStandardItem *item = model->item(1);
+            item->setEnabled(false);
+            item->setToolTip("Bản build này không có libav (VIDEOQC_WITH_LIBAV=OFF).");
+        }
+    }
+    pathsLayout->addRow("Bộ máy phân tích:", m_engineCombo);
+
+    m_segmentsSpinBox = new QSpinBox(this);
+    m_segmentsSpinBox->setRange(0, 256);
+    m_segmentsSpinBox->setSpecialValueText("Tự động");
+    m_segmentsSpinBox->setFixedWidth(120);
+    m_segmentsSpinBox->setToolTip("Chỉ dùng với bộ máy libav: video dài được chia thành từng ấy đoạn tại keyframe,\n"
+                                  "các đoạn được giải mã song song rồi ghép lại. Tự động = theo số nhân CPU, 1 = không chia.\n"
+                                  "Mỗi đoạn dài ít nhất 30 giây.");
+    pathsLayout->addRow("Số đoạn phân tích song song:", m_segmentsSpinBox);
+
+    m_fastScanStepSpinBox = new QSpinBox(this);
+    m_fastScanStepSpinBox->setRange(0, 100000);
+    m_fastScanStepSpinBox->setSpecialValueText("1 frame/giây");
+    m_fastScanStepSpinBox->setSuffix(" frame");
+    m_fastScanStepSpinBox->setFixedWidth(120);
+    m_fastScanStepSpinBox->setToolTip("Chế độ \"Quét nhanh\" lấy mẫu mỗi từng ấy frame để tìm vùng đáng ngờ.\n"
+                                      "Khoảng càng lớn càng nhanh, nhưng lỗi ngắn hơn khoảng này có thể bị bỏ sót.");
+    pathsLayout->addRow("Quét nhanh: lấy mẫu mỗi:", m_fastScanStepSpinBox);
+
+    m_downscaleCombo = new QComboBox(this);
+    m_downscaleCombo->addItem("Đầy đủ", 1);
+    m_downscaleCombo->addItem("1/2 (nhanh hơn)", 2);
+    m_downscaleCombo->addItem("1/4 (nhanh nhất)", 4);
+    m_downscaleCombo->setToolTip("Chỉ dùng với bộ máy libav: phân tích frame đã thu nhỏ, chủ yếu cho video UHD.\n"
+                                 "Bộ giải mã tự giảm độ phân giải nếu codec hỗ trợ (lowres), nếu không thì thu nhỏ bằng trung bình khối.\n"
+                                 "YAVG (Frame Đen) gần như không đổi. Mép viền đen chỉ chính xác tới 2 hoặc 4 điểm ảnh của bản gốc,\n"
+                                 "và YDIF (Frame Dư) thấp hơn một chút vì nhiễu bị làm mịn: nên kiểm tra lại ngưỡng cắt cảnh.\n"
+                                 "Frame phân tích luôn rộng ít nhất 960 điểm ảnh nên video SD/HD gần như không bị thu nhỏ.\n"
+                                 "Tốc độ và tỉ lệ frame lỗi bị bỏ sót so với phân tích đầy đủ: đo trên video mẫu bằng\n"
+                                 "VideoQC_EngineParity --downscale 2,4 <video>.");
+    pathsLayout->addRow("Độ phân giải khi phân tích:", m_downscaleCombo);
+
+    m_gopIndexCheck = new QCheckBox("Lưu chỉ mục GOP sau mỗi lần chạy qcli", this);
+    m_gopIndexCheck->setToolTip("Đọc lại toàn bộ file video sau khi qcli xong (trước khi tạo MKV) để lưu chỉ mục GOP cạnh báo cáo.\n"
+                                "Khi video được giao lại, chỉ các GOP đã đổi phải QC lại, phần còn lại lấy từ báo cáo cũ.\n"
+                                "Chỉ nên bật cho các video hay được giao lại: với file lớn trên ổ mạng, lượt đọc thêm này đáng kể.");
+    m_gopIndexCheck->setEnabled(QCToolsManager::inProcessEngineAvailable());
+    pathsLayout->addRow(m_gopIndexCheck);
+    connect(m_engineCombo, &QComboBox::currentIndexChanged, this, [this]() {
+        const bool libav = m_engineCombo->currentData().toString() == QLatin1String(AppConstants::ENGINE_LIBAV);
+        m_segmentsSpinBox->setEnabled(libav);
+        m_fastScanStepSpinBox->setEnabled(libav);
+        m_downscaleCombo->setEnabled(libav);
+    });
+
     connect(browseQCToolsButton, &QPushButton::clicked, this, &SettingsDialog::onBrowseQCTools);
+    connect(browseFfmpegButton, &QPushButton::clicked, this, &SettingsDialog::onBrowseFfmpeg);
     connect(browseQCCliButton, &QPushButton::clicked, this, &SettingsDialog::onBrowseQCCli);
 
     // --- About Tab ---
@@ -93,6 +165,120 @@ void SettingsDialog::setupUI()
     m_rewindFramesSpinBox->setFixedWidth(80);
     interactionLayout->addRow("Lùi lại khi double-click (frames):", m_rewindFramesSpinBox);
 
+    m_dropFrameCheck = new QCheckBox("Dùng timecode drop-frame cho video 29.97/59.94 fps", this);
+    m_dropFrameCheck->setToolTip("Bật: timecode hiển thị và xuất ra theo chuẩn drop-frame (HH:MM:SS;FF), khớp với thời gian thực.\n"
+                                 "Tắt: đếm frame liên tục (non-drop), timecode sẽ chậm dần so với thời gian thực.");
+    interactionLayout->addRow(m_dropFrameCheck);
+
+    m_thumbDiskCacheCheck = new QCheckBox("Lưu ảnh xem trước xuống đĩa", this);
+    m_thumbDiskCacheCheck->setToolTip("Ảnh xem trước đã tạo được giữ lại trong thư mục cache của ứng dụng,\n"
+                                      "mở lại cùng file video sẽ không phải giải mã lại.");
+    interactionLayout->addRow(m_thumbDiskCacheCheck);
+
+    m_resultCacheCheck = new QCheckBox("Lưu kết quả phân tích vào cache", this);
+    m_resultCacheCheck->setToolTip("Kết quả của mỗi file báo cáo được lưu theo nội dung báo cáo và cấu hình phát hiện lỗi.\n"
+                                   "Mở lại cùng báo cáo với cùng cấu hình sẽ hiện kết quả ngay, không phải giải nén và đọc lại.");
+    interactionLayout->addRow(m_resultCacheCheck);
+
+    m_frameMemorySpinBox = new QSpinBox(this);
+    m_frameMemorySpinBox->setRange(0, 65536);
+    m_frameMemorySpinBox->setSingleStep(64);
+    m_frameMemorySpinBox->setSuffix(" MB");
+    m_frameMemorySpinBox->setSpecialValueText("Không giới hạn");
+    m_frameMemorySpinBox->setFixedWidth(120);
+    m_frameMemorySpinBox->setToolTip("Khi số liệu theo frame của một báo cáo vượt quá mức này (bản ghi rất dài),\n"
+                                     "chúng được chuyển ra file tạm và chỉ nạp lại từng phần khi cần.");
+    interactionLayout->addRow("Bộ nhớ cho số liệu frame:", m_frameMemorySpinBox);
+
+    m_logToFileCheck = new QCheckBox("Ghi nhật ký ra file", this);
+    m_logToFileCheck->setToolTip("Ghi nhật ký hoạt động vào thư mục dữ liệu của ứng dụng (logs/VideoQC.log) trên một luồng nền.\n"
+                                 "Khi file vượt quá dung lượng tối đa, file cũ được đổi tên và giữ lại tối đa 3 bản.");
+    m_logMaxSizeSpinBox = new QSpinBox(this);
+    m_logMaxSizeSpinBox->setRange(1, 1024);
+    m_logMaxSizeSpinBox->setSuffix(" MB");
+    m_logMaxSizeSpinBox->setFixedWidth(80);
+    interactionLayout->addRow(m_logToFileCheck);
+    interactionLayout->addRow("Dung lượng tối đa mỗi file log:", m_logMaxSizeSpinBox);
+    connect(m_logToFileCheck, &QCheckBox::toggled, m_logMaxSizeSpinBox, &QSpinBox::setEnabled);
+
+    // --- Watch Folder Tab ---
+    QWidget *watchTab = new QWidget();
+    QFormLayout *watchLayout = new QFormLayout(watchTab);
+    QLabel *watchNote = new QLabel("Video mới trong thư mục theo dõi được tự động phân tích với cấu hình phát hiện lỗi hiện tại.\n"
+                                   "Báo cáo QCTools và file kết quả (.results.json) được ghi vào thư mục đầu ra.");
+    watchNote->setWordWrap(true);
+    watchLayout->addRow(watchNote);
+
+    m_watchDirEdit = new QLineEdit(this);
+    m_watchDirEdit->setPlaceholderText("Chưa đặt thư mục");
+    QPushButton *browseWatchDirButton = new QPushButton("Duyệt...");
+    QHBoxLayout *watchDirLayout = new QHBoxLayout();
+    watchDirLayout->addWidget(m_watchDirEdit);
+    watchDirLayout->addWidget(browseWatchDirButton);
+    watchLayout->addRow("Thư mục theo dõi:", watchDirLayout);
+
+    m_watchOutputDirEdit = new QLineEdit(this);
+    m_watchOutputDirEdit->setPlaceholderText("Chưa đặt thư mục");
+    QPushButton *browseWatchOutputButton = new QPushButton("Duyệt...");
+    QHBoxLayout *watchOutputLayout = new QHBoxLayout();
+    watchOutputLayout->addWidget(m_watchOutputDirEdit);
+    watchOutputLayout->addWidget(browseWatchOutputButton);
+    watchLayout->addRow("Thư mục đầu ra:", watchOutputLayout);
+
+    m_watchMaxJobsSpinBox = new QSpinBox(this);
+    m_watchMaxJobsSpinBox->setRange(1, 8);
+    m_watchMaxJobsSpinBox->setFixedWidth(80);
+    m_watchMaxJobsSpinBox->setToolTip("Số video được phân tích cùng lúc. Mỗi video chạy một tiến trình qcli riêng.");
+    watchLayout->addRow("Số file phân tích cùng lúc:", m_watchMaxJobsSpinBox);
+
+    m_watchStableSpinBox = new QSpinBox(this);
+    m_watchStableSpinBox->setRange(2, 600);
+    m_watchStableSpinBox->setSuffix(" giây");
+    m_watchStableSpinBox->setFixedWidth(80);
+    m_watchStableSpinBox->setToolTip("Một file chỉ được phân tích khi dung lượng không đổi trong khoảng thời gian này (đã chép xong).");
+    watchLayout->addRow("Chờ file ổn định:", m_watchStableSpinBox);
+
+    m_watchScanSpinBox = new QSpinBox(this);
+    m_watchScanSpinBox->setRange(5, 3600);
+    m_watchScanSpinBox->setSuffix(" giây");
+    m_watchScanSpinBox->setFixedWidth(80);
+    m_watchScanSpinBox->setToolTip("Quét lại thư mục định kỳ, phòng khi hệ điều hành không báo thay đổi (ví dụ ổ mạng).");
+    watchLayout->addRow("Chu kỳ quét lại:", m_watchScanSpinBox);
+
+    connect(browseWatchDirButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, "Chọn thư mục theo dõi", m_watchDirEdit->text());
+        if (!dir.isEmpty()) m_watchDirEdit->setText(QDir::toNativeSeparators(dir));
+    });
+    connect(browseWatchOutputButton, &QPushButton::clicked, this, [this]() {
+        const QString dir = QFileDialog::getExistingDirectory(this, "Chọn thư mục đầu ra", m_watchOutputDirEdit->text());
+        if (!dir.isEmpty()) m_watchOutputDirEdit->setText(QDir::toNativeSeparators(dir));
+    });
+
+    // --- API Tab ---
+    QWidget *apiTab = new QWidget();
+    QFormLayout *apiLayout = new QFormLayout(apiTab);
+    QLabel *apiNote = new QLabel("Cho phép các công cụ khác gửi job phân tích qua HTTP/JSON tại http://127.0.0.1:<cổng>/jobs.\n"
+                                 "Chỉ nhận kết nối từ chính máy này. Job dùng cấu hình phát hiện lỗi hiện tại nếu không gửi kèm preset.");
+    apiNote->setWordWrap(true);
+    apiLayout->addRow(apiNote);
+
+    m_apiEnabledCheck = new QCheckBox("Bật dịch vụ job HTTP", this);
+    apiLayout->addRow(m_apiEnabledCheck);
+
+    m_apiPortSpinBox = new QSpinBox(this);
+    m_apiPortSpinBox->setRange(1024, 65535);
+    m_apiPortSpinBox->setFixedWidth(80);
+    apiLayout->addRow("Cổng:", m_apiPortSpinBox);
+
+    m_apiMaxJobsSpinBox = new QSpinBox(this);
+    m_apiMaxJobsSpinBox->setRange(1, 8);
+    m_apiMaxJobsSpinBox->setFixedWidth(80);
+    m_apiMaxJobsSpinBox->setToolTip("Số job được phân tích cùng lúc; các job còn lại chờ trong hàng đợi.");
+    apiLayout->addRow("Số job chạy cùng lúc:", m_apiMaxJobsSpinBox);
+
+    connect(m_apiEnabledCheck, &QCheckBox::toggled, m_apiPortSpinBox, &QSpinBox::setEnabled);
+    connect(m_apiEnabledCheck, &QCheckBox::toggled, m_apiMaxJobsSpinBox, &QSpinBox::setEnabled);
+
     // --- Hardware Tab ---
     QWidget *hwTab = new QWidget();
     QFormLayout *hwLayout = new QFormLayout(hwTab);
@@ -118,6 +304,8 @@ void SettingsDialog::setupUI()
     m_tabWidget->addTab(pathsTab, "Đường dẫn");
     m_tabWidget->addTab(hwTab, "Tăng tốc P.cứng");
     m_tabWidget->addTab(interactionTab, "Tương tác");
+    m_tabWidget->addTab(watchTab, "Thư mục theo dõi");
+    m_tabWidget->addTab(apiTab, "Dịch vụ API");
     m_tabWidget->addTab(aboutTab, "Giới thiệu");
 
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
@@ -137,12 +325,42 @@ void SettingsDialog::loadSettings()
     QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
     m_qctoolsPathEdit->setText(settings.value(AppConstants::K_QCTOOLS_PATH, "").toString());
     m_qcliPathEdit->setText(settings.value(AppConstants::K_QCCLI_PATH, "").toString());
+    m_ffmpegPathEdit->setText(settings.value(AppConstants::K_FFMPEG_PATH, "").toString());
+    const int engineIndex = m_engineCombo->findData(settings.value(AppConstants::K_ANALYSIS_ENGINE, AppConstants::ENGINE_QCLI).toString());
+    m_engineCombo->setCurrentIndex(engineIndex >= 0 && QCToolsManager::inProcessEngineAvailable() ? engineIndex : 0);
+    m_segmentsSpinBox->setValue(settings.value(AppConstants::K_ANALYSIS_SEGMENTS, 0).toInt());
+    m_fastScanStepSpinBox->setValue(settings.value(AppConstants::K_FAST_SCAN_STEP, 0).toInt());
+    m_segmentsSpinBox->setEnabled(m_engineCombo->currentData().toString() == QLatin1String(AppConstants::ENGINE_LIBAV));
+    m_fastScanStepSpinBox->setEnabled(m_segmentsSpinBox->isEnabled());
+    const int downscaleIndex = m_downscaleCombo->findData(settings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt());
+    m_downscaleCombo->setCurrentIndex(downscaleIndex >= 0 ? downscaleIndex : 0);
+    m_downscaleCombo->setEnabled(m_segmentsSpinBox->isEnabled());
+    m_gopIndexCheck->setChecked(settings.value(AppConstants::K_WRITE_GOP_INDEX, false).toBool());
 
     m_hwAccelCheck->setChecked(settings.value(AppConstants::K_USE_HW_ACCEL, false).toBool());
     m_hwAccelTypeCombo->setCurrentText(settings.value(AppConstants::K_HW_ACCEL_TYPE, "auto").toString());
     m_hwAccelTypeCombo->setEnabled(m_hwAccelCheck->isChecked());
 
     m_rewindFramesSpinBox->setValue(settings.value(AppConstants::K_REWIND_FRAMES, 5).toInt());
+    m_dropFrameCheck->setChecked(settings.value(AppConstants::K_DROP_FRAME_TIMECODE, true).toBool());
+    m_thumbDiskCacheCheck->setChecked(settings.value(AppConstants::K_THUMB_DISK_CACHE, true).toBool());
+    m_resultCacheCheck->setChecked(settings.value(AppConstants::K_RESULT_CACHE, true).toBool());
+    m_frameMemorySpinBox->setValue(settings.value(AppConstants::K_FRAME_MEMORY_MB, 512).toInt());
+    m_logToFileCheck->setChecked(settings.value(AppConstants::K_LOG_TO_FILE, false).toBool());
+    m_logMaxSizeSpinBox->setValue(settings.value(AppConstants::K_LOG_MAX_FILE_MB, 10).toInt());
+    m_logMaxSizeSpinBox->setEnabled(m_logToFileCheck->isChecked());
+
+    m_watchDirEdit->setText(settings.value(AppConstants::K_WATCH_DIR, "").toString());
+    m_watchOutputDirEdit->setText(settings.value(AppConstants::K_WATCH_OUTPUT_DIR, "").toString());
+    m_watchMaxJobsSpinBox->setValue(settings.value(AppConstants::K_WATCH_MAX_JOBS, 1).toInt());
+    m_watchStableSpinBox->setValue(settings.value(AppConstants::K_WATCH_STABLE_SEC, 10).toInt());
+    m_watchScanSpinBox->setValue(settings.value(AppConstants::K_WATCH_SCAN_SEC, 30).toInt());
+
+    m_apiEnabledCheck->setChecked(settings.value(AppConstants::K_API_ENABLED, false).toBool());
+    m_apiPortSpinBox->setValue(settings.value(AppConstants::K_API_PORT, 8765).toInt());
+    m_apiMaxJobsSpinBox->setValue(settings.value(AppConstants::K_API_MAX_JOBS, 2).toInt());
+    m_apiPortSpinBox->setEnabled(m_apiEnabledCheck->isChecked());
+    m_apiMaxJobsSpinBox->setEnabled(m_apiEnabledCheck->isChecked());
 }
 
 void SettingsDialog::saveSettings()
@@ -150,10 +368,30 @@ void SettingsDialog::saveSettings()
     QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
     settings.setValue(AppConstants::K_QCTOOLS_PATH, m_qctoolsPathEdit->text());
     settings.setValue(AppConstants::K_QCCLI_PATH, m_qcliPathEdit->text());
+    settings.setValue(AppConstants::K_FFMPEG_PATH, m_ffmpegPathEdit->text());
+    settings.setValue(AppConstants::K_ANALYSIS_ENGINE, m_engineCombo->currentData().toString());
+    settings.setValue(AppConstants::K_ANALYSIS_SEGMENTS, m_segmentsSpinBox->value());
+    settings.setValue(AppConstants::K_FAST_SCAN_STEP, m_fastScanStepSpinBox->value());
+    settings.setValue(AppConstants::K_ANALYSIS_DOWNSCALE, m_downscaleCombo->currentData().toInt());
+    settings.setValue(AppConstants::K_WRITE_GOP_INDEX, m_gopIndexCheck->isChecked());
 
     settings.setValue(AppConstants::K_USE_HW_ACCEL, m_hwAccelCheck->isChecked());
     settings.setValue(AppConstants::K_HW_ACCEL_TYPE, m_hwAccelTypeCombo->currentText());
     settings.setValue(AppConstants::K_REWIND_FRAMES, m_rewindFramesSpinBox->value());
+    settings.setValue(AppConstants::K_DROP_FRAME_TIMECODE, m_dropFrameCheck->isChecked());
+    settings.setValue(AppConstants::K_THUMB_DISK_CACHE, m_thumbDiskCacheCheck->isChecked());
+    settings.setValue(AppConstants::K_RESULT_CACHE, m_resultCacheCheck->isChecked());
+    settings.setValue(AppConstants::K_FRAME_MEMORY_MB, m_frameMemorySpinBox->value());
+    settings.setValue(AppConstants::K_LOG_TO_FILE, m_logToFileCheck->isChecked());
+    settings.setValue(AppConstants::K_LOG_MAX_FILE_MB, m_logMaxSizeSpinBox->value());
+    settings.setValue(AppConstants::K_WATCH_DIR, m_watchDirEdit->text());
+    settings.setValue(AppConstants::K_WATCH_OUTPUT_DIR, m_watchOutputDirEdit->text());
+    settings.setValue(AppConstants::K_WATCH_MAX_JOBS, m_watchMaxJobsSpinBox->value());
+    settings.setValue(AppConstants::K_WATCH_STABLE_SEC, m_watchStableSpinBox->value());
+    settings.setValue(AppConstants::K_WATCH_SCAN_SEC, m_watchScanSpinBox->value());
+    settings.setValue(AppConstants::K_API_ENABLED, m_apiEnabledCheck->isChecked());
+    settings.setValue(AppConstants::K_API_PORT, m_apiPortSpinBox->value());
+    settings.setValue(AppConstants::K_API_MAX_JOBS, m_apiMaxJobsSpinBox->value());
 }
 
 QVariantMap SettingsDialog::getSettings() const
@@ -194,6 +432,14 @@ void SettingsDialog::onBrowseQCCli()
     }
 }
 
+void SettingsDialog::onBrowseFfmpeg()
+{
+    QString filePath = QFileDialog::getOpenFileName(this, "Chọn file ffmpeg.exe", "C:/Program Files/", "Executable (*.exe)");
+    if(!filePath.isEmpty()) {
+        m_ffmpegPathEdit->setText(QDir::toNativeSeparators(filePath));
+    }
+}
+
 void SettingsDialog::onResetToDefaultsClicked()
 {
     // Hộp thoại 1: Xác nhận
@@ -29,6 +29,7 @@ signals:
 private slots:
     void onBrowseQCTools();
     void onBrowseQCCli();
+    void onBrowseFfmpeg();
     void onResetToDefaultsClicked();
 
 private:
@@ -42,9 +43,33 @@ private:
     // Paths Tab
     QLineEdit* m_qctoolsPathEdit;
     QLineEdit* m_qcliPathEdit;
+    QLineEdit* m_ffmpegPathEdit;
+    QComboBox* m_engineCombo;
+    QSpinBox* m_segmentsSpinBox;
+    QSpinBox* m_fastScanStepSpinBox;
+    QComboBox* m_downscaleCombo;
+    QCheckBox* m_gopIndexCheck;
 
     // Interaction Tab
     QSpinBox* m_rewindFramesSpinBox;
+    QCheckBox* m_dropFrameCheck;
+    QCheckBox* m_thumbDiskCacheCheck;
+    QCheckBox* m_resultCacheCheck;
+    QSpinBox* m_frameMemorySpinBox;
+    QCheckBox* m_logToFileCheck;
+    QSpinBox* m_logMaxSizeSpinBox;
+
+    // Watch Folder Tab
+    QLineEdit* m_watchDirEdit;
+    QLineEdit* m_watchOutputDirEdit;
+    QSpinBox* m_watchMaxJobsSpinBox;
+    QSpinBox* m_watchStableSpinBox;
+    QSpinBox* m_watchScanSpinBox;
+
+    // API Tab
+    QCheckBox* m_apiEnabledCheck;
+    QSpinBox* m_apiPortSpinBox;
+    QSpinBox* m_apiMaxJobsSpinBox;
     
     // Hardware Tab
     QCheckBox* m_hwAccelCheck;
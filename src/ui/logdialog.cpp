@@ -11,14 +11,17 @@
 #include <QTextStream>
 #include <QMessageBox>
 #include <QScrollBar>
+#include <QComboBox>
+#include <QLabel>
 
-LogDialog::LogDialog(const QStringList& history, QWidget *parent)
-    : QDialog(parent)
+LogDialog::LogDialog(LogSink* sink, QWidget *parent)
+    : QDialog(parent), m_sink(sink)
 {
     setupUI();
     setWindowTitle("Nhật ký Hoạt động");
     setMinimumSize(700, 500);
-    m_logEdit->appendPlainText(history.join("\n"));
+    reloadFromSink();
+    connect(m_sink, &LogSink::entriesAppended, this, &LogDialog::appendEntries);
 }
 
 void LogDialog::setupUI()
@@ -28,6 +31,16 @@ void LogDialog::setupUI()
     m_logEdit = new QPlainTextEdit(this);
     m_logEdit->setReadOnly(true);
     m_logEdit->setFont(QFont("Courier New", 9));
+    // CẢI TIẾN: Ô hiển thị cũng bị giới hạn như bộ đệm của LogSink
+    m_logEdit->setMaximumBlockCount(m_sink->capacity());
+    m_logEdit->setUndoRedoEnabled(false);
+
+    m_levelCombo = new QComboBox(this);
+    m_levelCombo->addItem("Tất cả", int(LogLevel::Debug));
+    m_levelCombo->addItem("Thông tin trở lên", int(LogLevel::Info));
+    m_levelCombo->addItem("Cảnh báo trở lên", int(LogLevel::Warning));
+    m_levelCombo->addItem("Chỉ lỗi", int(LogLevel::Error));
+    m_levelCombo->setCurrentIndex(0);
 
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     m_copyButton = new QPushButton("Sao chép vào Clipboard");
@@ -36,6 +49,8 @@ void LogDialog::setupUI()
     
     // CẢI TIẾN: Sắp xếp lại vị trí các nút theo yêu cầu
     buttonLayout->addWidget(m_clearButton);     // Ngoài cùng bên trái
+    buttonLayout->addWidget(new QLabel("Mức:"));
+    buttonLayout->addWidget(m_levelCombo);
     buttonLayout->addStretch();                 // Thêm khoảng trống co giãn
     buttonLayout->addWidget(m_exportButton);    // Bên phải
     buttonLayout->addWidget(m_copyButton);      // Ngoài cùng bên phải
@@ -47,14 +62,44 @@ void LogDialog::setupUI()
     connect(m_copyButton, &QPushButton::clicked, this, &LogDialog::onCopyClicked);
     connect(m_exportButton, &QPushButton::clicked, this, &LogDialog::onExportClicked);
     connect(m_clearButton, &QPushButton::clicked, this, &LogDialog::onClearClicked);
+    connect(m_levelCombo, &QComboBox::currentIndexChanged, this, &LogDialog::onLevelFilterChanged);
+}
+
+LogLevel LogDialog::minimumLevel() const
+{
+    return static_cast<LogLevel>(m_levelCombo->currentData().toInt());
 }
 
-void LogDialog::appendLog(const QString &message)
+void LogDialog::reloadFromSink()
 {
-    m_logEdit->appendPlainText(message);
+    QStringList lines;
+    for (const auto& e : m_sink->snapshot(minimumLevel())) lines.append(e.text);
+    m_logEdit->setPlainText(lines.join("\n"));
     m_logEdit->verticalScrollBar()->setValue(m_logEdit->verticalScrollBar()->maximum());
 }
 
+void LogDialog::appendEntries(const QList<LogEntry> &entries)
+{
+    // Mỗi lô chỉ chèn văn bản và cuộn thanh cuộn một lần
+    const LogLevel minLevel = minimumLevel();
+    QStringList lines;
+    lines.reserve(entries.size());
+    for (const auto& e : entries) {
+        if (e.level >= minLevel) lines.append(e.text);
+    }
+    if (lines.isEmpty()) return;
+
+    QScrollBar* bar = m_logEdit->verticalScrollBar();
+    const bool atBottom = bar->value() >= bar->maximum() - 2;
+    m_logEdit->appendPlainText(lines.join("\n"));
+    if (atBottom) bar->setValue(bar->maximum());
+}
+
+void LogDialog::onLevelFilterChanged()
+{
+    reloadFromSink();
+}
+
 void LogDialog::setDefaultSavePath(const QString &path)
 {
     m_defaultSaveDir = path;
@@ -99,6 +144,7 @@ void LogDialog::onClearClicked()
     reply = QMessageBox::question(this, "Xác nhận Xóa", "Bạn có chắc chắn muốn xóa toàn bộ nội dung nhật ký không?",
                                   QMessageBox::Yes|QMessageBox::No);
     if (reply == QMessageBox::Yes) {
+        m_sink->clear();
         m_logEdit->clear();
     }
 }
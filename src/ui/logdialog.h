@@ -3,18 +3,21 @@
 #define LOGDIALOG_H
 
 #include <QDialog>
-#include <QStringList>
+#include <QList>
+#include "core/LogSink.h"
 
 class QPlainTextEdit;
 class QPushButton;
+class QComboBox;
 
 class LogDialog : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit LogDialog(const QStringList& history, QWidget *parent = nullptr);
-    void appendLog(const QString& message);
+    // Hộp thoại đọc lịch sử từ LogSink và nhận các dòng mới theo lô
+    explicit LogDialog(LogSink* sink, QWidget *parent = nullptr);
+    void appendEntries(const QList<LogEntry>& entries);
     void setDefaultSavePath(const QString& path);
     void setVideoFileName(const QString& name);
 
@@ -22,14 +25,19 @@ private slots:
     void onCopyClicked();
     void onExportClicked();
     void onClearClicked();
+    void onLevelFilterChanged();
 
 private:
     void setupUI();
+    void reloadFromSink();
+    LogLevel minimumLevel() const;
 
     QPlainTextEdit* m_logEdit;
     QPushButton* m_copyButton;
     QPushButton* m_exportButton;
     QPushButton* m_clearButton;
+    QComboBox* m_levelCombo;
+    LogSink* m_sink;
     QString m_defaultSaveDir;
     QString m_videoFileName;
 };
@@ -0,0 +1,341 @@
+// src/ui/metrictimelinewidget.cpp
+#include "metrictimelinewidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QtMath>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+constexpr int LABEL_WIDTH = 44;
+constexpr double MIN_FRAMES_PER_PIXEL = 1.0 / 16.0;   // Phóng to tối đa: 16 pixel cho một frame
+constexpr double ZOOM_STEP = 0.8;
+constexpr int ERROR_TYPE_COUNT = 3;
+
+QColor spanColor(ErrorType type)
+{
+    switch (type) {
+        case ErrorType::BlackFrame: return QColor(220, 53, 69, 80);
+        case ErrorType::BlackBorder: return QColor(255, 159, 64, 80);
+        case ErrorType::OrphanFrame: return QColor(54, 162, 235, 80);
+    }
+    return QColor(128, 128, 128, 80);
+}
+
+} // namespace
+
+MetricTimelineWidget::MetricTimelineWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMouseTracking(true);
+    setFocusPolicy(Qt::ClickFocus);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setToolTip("Lăn chuột để phóng to/thu nhỏ, kéo để di chuyển, double-click để sao chép timecode.\n"
+               "Double-click chuột phải hoặc phím Home để xem toàn bộ file.");
+}
+
+void MetricTimelineWidget::setMetrics(const MetricPyramidPtr &metrics)
+{
+    m_metrics = metrics;
+    resetZoom();
+}
+
+void MetricTimelineWidget::appendResults(const QList<AnalysisResult> &batch)
+{
+    m_spans.reserve(m_spans.size() + batch.size());
+    for (const auto &res : batch) m_spans.append({res.startFrame, res.endFrame, res.type});
+    update();
+}
+
+void MetricTimelineWidget::setResults(const QList<AnalysisResult> &results)
+{
+    m_spans.clear();
+    appendResults(results);
+}
+
+void MetricTimelineWidget::clear()
+{
+    m_metrics.reset();
+    m_spans.clear();
+    m_hoverX = -1;
+    resetZoom();
+}
+
+void MetricTimelineWidget::setTypeFilter(quint8 mask)
+{
+    m_typeMask = mask;
+    update();
+}
+
+void MetricTimelineWidget::resetZoom()
+{
+    const int frames = m_metrics ? m_metrics->frameCount() : 0;
+    m_viewStart = 0.0;
+    m_framesPerPixel = qMax(MIN_FRAMES_PER_PIXEL, double(frames) / qMax(1, plotRect().width()));
+    update();
+}
+
+QRect MetricTimelineWidget::plotRect() const
+{
+    return rect().adjusted(LABEL_WIDTH, 2, -4, -2);
+}
+
+double MetricTimelineWidget::positionAtX(double x) const
+{
+    return m_viewStart + (x - plotRect().left()) * m_framesPerPixel;
+}
+
+void MetricTimelineWidget::clampView()
+{
+    const int frames = m_metrics ? m_metrics->frameCount() : 0;
+    const int width = qMax(1, plotRect().width());
+    const double maxFpp = qMax(MIN_FRAMES_PER_PIXEL, double(frames) / width);
+    m_framesPerPixel = qBound(MIN_FRAMES_PER_PIXEL, m_framesPerPixel, maxFpp);
+    const double maxStart = qMax(0.0, frames - m_framesPerPixel * width);
+    m_viewStart = qBound(0.0, m_viewStart, maxStart);
+}
+
+void MetricTimelineWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+
+    const QRect plot = plotRect();
+    if (!m_metrics || m_metrics->frameCount() == 0 || plot.width() <= 0) {
+        painter.setPen(palette().color(QPalette::PlaceholderText));
+        painter.drawText(rect(), Qt::AlignCenter, "Chưa có dữ liệu biểu đồ");
+        return;
+    }
+
+    drawSpans(painter, plot);
+
+    // Ba làn: YAVG 40%, YDIF 30%, viền đen 30%
+    const int yavgHeight = plot.height() * 4 / 10;
+    const int ydifHeight = plot.height() * 3 / 10;
+    const QRect yavgLane(plot.left(), plot.top(), plot.width(), yavgHeight);
+    const QRect ydifLane(plot.left(), yavgLane.bottom() + 1, plot.width(), ydifHeight);
+    const QRect cropLane(plot.left(), ydifLane.bottom() + 1, plot.width(), plot.bottom() - ydifLane.bottom());
+
+    // YAVG theo thang 8-bit, tự mở rộng nếu báo cáo là 10-bit
+    const float yavgMax = qMax(255.0f, m_metrics->channelRange(MetricPyramid::Yavg).max);
+    const float ydifMax = qMax(1.0f, m_metrics->channelRange(MetricPyramid::Ydif).max);
+    float cropMax = 1.0f;
+    for (int c = MetricPyramid::CropTop; c <= MetricPyramid::CropRight; ++c) {
+        const auto range = m_metrics->channelRange(static_cast<MetricPyramid::Channel>(c));
+        if (range.isValid()) cropMax = qMax(cropMax, range.max);
+    }
+
+    drawLane(painter, yavgLane, MetricPyramid::Yavg, QColor(66, 139, 202), yavgMax);
+    drawLane(painter, ydifLane, MetricPyramid::Ydif, QColor(92, 184, 92), ydifMax);
+    drawLane(painter, cropLane, MetricPyramid::CropTop, QColor(240, 173, 78), cropMax);
+    drawLane(painter, cropLane, MetricPyramid::CropBottom, QColor(217, 83, 79), cropMax);
+    drawLane(painter, cropLane, MetricPyramid::CropLeft, QColor(153, 102, 255), cropMax);
+    drawLane(painter, cropLane, MetricPyramid::CropRight, QColor(91, 192, 222), cropMax);
+
+    // Nhãn và đường phân cách giữa các làn
+    const QColor textColor = palette().color(QPalette::Text);
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawLine(plot.left(), ydifLane.top(), plot.right(), ydifLane.top());
+    painter.drawLine(plot.left(), cropLane.top(), plot.right(), cropLane.top());
+    painter.drawLine(plot.left() - 1, plot.top(), plot.left() - 1, plot.bottom());
+    painter.setPen(textColor);
+    const int labelWidth = LABEL_WIDTH - 4;
+    painter.drawText(QRect(2, yavgLane.top(), labelWidth, yavgLane.height()), Qt::AlignLeft | Qt::AlignVCenter, "YAVG");
+    painter.drawText(QRect(2, ydifLane.top(), labelWidth, ydifLane.height()), Qt::AlignLeft | Qt::AlignVCenter, "YDIF");
+    painter.drawText(QRect(2, cropLane.top(), labelWidth, cropLane.height()), Qt::AlignLeft | Qt::AlignVCenter, "Viền");
+
+    drawHoverInfo(painter, plot);
+}
+
+void MetricTimelineWidget::drawSpans(QPainter &painter, const QRect &plot)
+{
+    // Mảng hiệu theo pixel: mỗi đoạn lỗi chỉ tốn O(1), tổng chi phí O(số đoạn + chiều rộng)
+    const int width = plot.width();
+    const int offset = m_metrics->firstFrameNumber();
+    QVector<int> diff[ERROR_TYPE_COUNT];
+    for (auto &d : diff) d.fill(0, width + 1);
+
+    for (const Span &span : m_spans) {
+        if (!(m_typeMask & (1u << int(span.type)))) continue;
+        const double x0 = (span.start - offset - m_viewStart) / m_framesPerPixel;
+        const double x1 = (span.end + 1 - offset - m_viewStart) / m_framesPerPixel;
+        if (x1 < 0 || x0 >= width) continue;
+        const int first = qMax(0, int(std::floor(x0)));
+        const int last = qMin(width - 1, qMax(first, int(std::ceil(x1)) - 1));
+        diff[int(span.type)][first] += 1;
+        diff[int(span.type)][last + 1] -= 1;
+    }
+
+    for (int t = 0; t < ERROR_TYPE_COUNT; ++t) {
+        const QColor color = spanColor(static_cast<ErrorType>(t));
+        int running = 0, runStart = -1;
+        for (int x = 0; x <= width; ++x) {
+            running += (x < width) ? diff[t][x] : 0;
+            const bool covered = x < width && running > 0;
+            if (covered && runStart < 0) runStart = x;
+            if (!covered && runStart >= 0) {
+                painter.fillRect(QRect(plot.left() + runStart, plot.top(), x - runStart, plot.height()), color);
+                runStart = -1;
+            }
+        }
+    }
+}
+
+void MetricTimelineWidget::drawLane(QPainter &painter, const QRect &lane, MetricPyramid::Channel channel, const QColor &color, float maxValue)
+{
+    const int width = lane.width();
+    if (width <= 0 || lane.height() <= 2) return;
+    m_rangeBuffer.resize(width);
+    m_metrics->query(channel, m_viewStart, m_framesPerPixel, width, m_rangeBuffer.data());
+
+    const double scale = (lane.height() - 2) / double(maxValue);
+    const double bottom = lane.bottom() - 1;
+    auto toY = [&](float v) { return bottom - qBound(0.0f, v, maxValue) * scale; };
+
+    // Mỗi pixel là một đoạn thẳng đứng từ min tới max, nối với pixel trước để đường không bị đứt
+    QVector<QLineF> lines;
+    lines.reserve(width);
+    const MetricPyramid::Range *prev = nullptr;
+    for (int x = 0; x < width; ++x) {
+        const MetricPyramid::Range &r = m_rangeBuffer[x];
+        if (!r.isValid()) { prev = nullptr; continue; }
+        float lo = r.min, hi = r.max;
+        if (prev) {
+            lo = qMin(lo, prev->max);
+            hi = qMax(hi, prev->min);
+        }
+        const double px = lane.left() + x + 0.5;
+        double yTop = toY(hi), yBottom = toY(lo);
+        if (yBottom - yTop < 1.0) yBottom = yTop + 1.0;
+        lines.append(QLineF(px, yTop, px, yBottom));
+        prev = &r;
+    }
+    painter.setPen(QPen(color, 1));
+    painter.drawLines(lines);
+}
+
+void MetricTimelineWidget::drawHoverInfo(QPainter &painter, const QRect &plot)
+{
+    if (m_hoverX < plot.left() || m_hoverX > plot.right()) return;
+
+    painter.setPen(QPen(palette().color(QPalette::Highlight), 1, Qt::DashLine));
+    painter.drawLine(m_hoverX, plot.top(), m_hoverX, plot.bottom());
+
+    const int position = int(std::floor(positionAtX(m_hoverX)));
+    if (position < 0 || position >= m_metrics->frameCount()) return;
+
+    auto valueText = [&](MetricPyramid::Channel c) {
+        const float v = m_metrics->valueAt(c, position);
+        return std::isnan(v) ? QString("-") : QString::number(v, 'f', 1);
+    };
+    QString text = QString("Frame %1   YAVG %2   YDIF %3")
+                       .arg(position + m_metrics->firstFrameNumber())
+                       .arg(valueText(MetricPyramid::Yavg), valueText(MetricPyramid::Ydif));
+    if (!std::isnan(m_metrics->valueAt(MetricPyramid::CropTop, position))) {
+        text += QString("   Viền T/D/T/P %1/%2/%3/%4").arg(valueText(MetricPyramid::CropTop), valueText(MetricPyramid::CropBottom),
+                                                        valueText(MetricPyramid::CropLeft), valueText(MetricPyramid::CropRight));
+    }
+
+    const QRect textRect = painter.fontMetrics().boundingRect(text).adjusted(-4, -2, 4, 2);
+    QRect box(plot.right() - textRect.width(), plot.top(), textRect.width(), textRect.height());
+    QColor background = palette().color(QPalette::ToolTipBase);
+    background.setAlpha(220);
+    painter.fillRect(box, background);
+    painter.setPen(palette().color(QPalette::ToolTipText));
+    painter.drawText(box, Qt::AlignCenter, text);
+}
+
+void MetricTimelineWidget::resizeEvent(QResizeEvent *event)
+{
+    // Đang xem toàn bộ file thì tiếp tục vừa khung sau khi đổi kích thước
+    const int frames = m_metrics ? m_metrics->frameCount() : 0;
+    const int oldWidth = event->oldSize().width() - LABEL_WIDTH - 4;
+    const bool wasFitted = m_viewStart <= 0.0 && (oldWidth <= 0 || m_framesPerPixel * oldWidth >= frames);
+    if (wasFitted) {
+        resetZoom();
+    } else {
+        clampView();
+    }
+    QWidget::resizeEvent(event);
+}
+
+void MetricTimelineWidget::wheelEvent(QWheelEvent *event)
+{
+    if (!m_metrics) return;
+    const double steps = event->angleDelta().y() / 120.0;
+    if (steps == 0) return;
+
+    const double x = event->position().x();
+    const double anchor = positionAtX(x);
+    m_framesPerPixel *= std::pow(ZOOM_STEP, steps);
+    clampView();
+    m_viewStart = anchor - (x - plotRect().left()) * m_framesPerPixel;
+    clampView();
+    update();
+    event->accept();
+}
+
+void MetricTimelineWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = true;
+        m_dragStartX = event->position().x();
+        m_dragStartView = m_viewStart;
+        setCursor(Qt::ClosedHandCursor);
+    }
+    QWidget::mousePressEvent(event);
+}
+
+void MetricTimelineWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    m_hoverX = int(event->position().x());
+    if (m_dragging) {
+        m_viewStart = m_dragStartView - (event->position().x() - m_dragStartX) * m_framesPerPixel;
+        clampView();
+    }
+    update();
+}
+
+void MetricTimelineWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && m_dragging) {
+        m_dragging = false;
+        unsetCursor();
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void MetricTimelineWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::RightButton) {
+        resetZoom();
+        return;
+    }
+    if (event->button() == Qt::LeftButton && m_metrics) {
+        const int position = int(std::floor(positionAtX(event->position().x())));
+        if (position >= 0 && position < m_metrics->frameCount()) {
+            emit frameDoubleClicked(position + m_metrics->firstFrameNumber());
+        }
+    }
+}
+
+void MetricTimelineWidget::leaveEvent(QEvent *event)
+{
+    m_hoverX = -1;
+    update();
+    QWidget::leaveEvent(event);
+}
+
+void MetricTimelineWidget::keyPressEvent(QKeyEvent *event)
+{
+    if (event->key() == Qt::Key_Home) {
+        resetZoom();
+        return;
+    }
+    QWidget::keyPressEvent(event);
+}
@@ -0,0 +1,81 @@
+// src/ui/metrictimelinewidget.h
+#ifndef METRICTIMELINEWIDGET_H
+#define METRICTIMELINEWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include <QList>
+#include "core/types.h"
+#include "core/MetricPyramid.h"
+
+// Biểu đồ YAVG, YDIF và độ dày viền đen của toàn bộ file, tô màu các đoạn lỗi.
+// - Lăn chuột: phóng to/thu nhỏ quanh vị trí con trỏ
+// - Kéo chuột trái: di chuyển
+// - Double-click: phát frameDoubleClicked (giống double-click một dòng kết quả)
+// - Phím Home hoặc double-click chuột phải: xem toàn bộ file
+class MetricTimelineWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MetricTimelineWidget(QWidget *parent = nullptr);
+
+    void setMetrics(const MetricPyramidPtr &metrics);
+    void appendResults(const QList<AnalysisResult> &batch);
+    void setResults(const QList<AnalysisResult> &results);
+    void clear();
+    // Cùng mặt nạ bit với ResultsTableModel::TypeBit
+    void setTypeFilter(quint8 mask);
+
+    QSize sizeHint() const override { return QSize(600, 150); }
+    QSize minimumSizeHint() const override { return QSize(200, 90); }
+
+public slots:
+    void resetZoom();
+
+signals:
+    void frameDoubleClicked(int frameNum);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    struct Span {
+        int start;      // Vị trí trong pyramid (đã trừ firstFrameNumber)
+        int end;        // Tính cả frame này
+        ErrorType type;
+    };
+
+    QRect plotRect() const;
+    double positionAtX(double x) const;
+    void clampView();
+    void drawSpans(QPainter &painter, const QRect &plot);
+    void drawLane(QPainter &painter, const QRect &lane, MetricPyramid::Channel channel, const QColor &color, float maxValue);
+    void drawHoverInfo(QPainter &painter, const QRect &plot);
+
+    MetricPyramidPtr m_metrics;
+    QVector<Span> m_spans;
+    quint8 m_typeMask = 0xFF;
+
+    // Khung nhìn: vị trí frame ở mép trái và số frame trên một pixel
+    double m_viewStart = 0.0;
+    double m_framesPerPixel = 1.0;
+
+    bool m_dragging = false;
+    double m_dragStartX = 0.0;
+    double m_dragStartView = 0.0;
+    int m_hoverX = -1;
+
+    // Bộ đệm cho từng lần vẽ, giữ lại để không cấp phát mỗi lần
+    QVector<MetricPyramid::Range> m_rangeBuffer;
+};
+
+#endif // METRICTIMELINEWIDGET_H
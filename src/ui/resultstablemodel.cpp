@@ -0,0 +1,195 @@
+// src/ui/resultstablemodel.cpp
+#include "resultstablemodel.h"
+#include "core/ResultFormat.h"
+#include <algorithm>
+#include <iterator>
+
+ResultsTableModel::ResultsTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ResultsTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_visibleRows.size();
+}
+
+int ResultsTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ResultsTableModel::data(const QModelIndex &index, int role) const
+{
+    const AnalysisResult *res = index.isValid() ? resultAt(index.row()) : nullptr;
+    if (!res) return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case ColTime: return formattedTime(*res);
+            case ColCount: return res->count;
+            case ColType: return ResultFormat::errorTypeName(res->type);
+            case ColDetails: return ResultFormat::details(*res, m_videoWidth, m_videoHeight);
+        }
+    } else if (role == Qt::TextAlignmentRole) {
+        // Căn giữa cho 2 cột đầu tiên
+        if (index.column() == ColTime || index.column() == ColCount) {
+            return int(Qt::AlignCenter);
+        }
+    }
+    return QVariant();
+}
+
+QVariant ResultsTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+        case ColTime: return m_timeHeader;
+        case ColCount: return QStringLiteral("Số lượng");
+        case ColType: return QStringLiteral("Loại lỗi");
+        case ColThumbs: return QStringLiteral("Ảnh (đầu / giữa / cuối)");
+        case ColDetails: return QStringLiteral("Chi tiết");
+    }
+    return QVariant();
+}
+
+void ResultsTableModel::setResults(const QList<AnalysisResult> &results)
+{
+    clear();
+    appendResults(results);
+}
+
+void ResultsTableModel::appendResults(const QList<AnalysisResult> &batch)
+{
+    if (batch.isEmpty()) return;
+
+    const int firstNew = m_results.size();
+    m_results.append(batch);
+    QVector<int> newRows;
+    newRows.reserve(batch.size());
+    for (int i = firstNew; i < m_results.size(); ++i) newRows.append(i);
+    std::stable_sort(newRows.begin(), newRows.end(), [this](int a, int b){ return lessByStart(a, b); });
+
+    // Trộn vào thứ tự tổng (không ảnh hưởng đến view)
+    QVector<int> merged;
+    merged.reserve(m_sortedRows.size() + newRows.size());
+    std::merge(m_sortedRows.cbegin(), m_sortedRows.cend(), newRows.cbegin(), newRows.cend(),
+               std::back_inserter(merged), [this](int a, int b){ return lessByStart(a, b); });
+    m_sortedRows.swap(merged);
+
+    // Gom các dòng mới hiển thị thành từng khối theo vị trí chèn trong m_visibleRows hiện tại
+    struct InsertBlock { int row; QVector<int> indices; };
+    QVector<InsertBlock> blocks;
+    for (int idx : newRows) {
+        if (!(typeBitFor(m_results[idx].type) & m_filterMask)) continue;
+        auto it = std::upper_bound(m_visibleRows.cbegin(), m_visibleRows.cend(), idx,
+                                   [this](int a, int b){ return lessByStart(a, b); });
+        const int row = int(it - m_visibleRows.cbegin());
+        if (blocks.isEmpty() || blocks.last().row != row) blocks.append({row, {}});
+        blocks.last().indices.append(idx);
+    }
+    if (blocks.isEmpty()) return;
+
+    // Lô xen kẽ quá nhiều vị trí: reset một lần rẻ hơn hàng trăm tín hiệu chèn
+    constexpr int MAX_INSERT_BLOCKS = 256;
+    if (blocks.size() > MAX_INSERT_BLOCKS) {
+        beginResetModel();
+        rebuildVisibleRows();
+        endResetModel();
+        return;
+    }
+
+    // Chèn từ cuối lên đầu để vị trí của các khối phía trước không bị dịch
+    for (auto it = blocks.crbegin(); it != blocks.crend(); ++it) {
+        beginInsertRows(QModelIndex(), it->row, it->row + it->indices.size() - 1);
+        m_visibleRows.insert(it->row, it->indices.size(), 0);
+        std::copy(it->indices.cbegin(), it->indices.cend(), m_visibleRows.begin() + it->row);
+        endInsertRows();
+    }
+}
+
+void ResultsTableModel::clear()
+{
+    beginResetModel();
+    m_results.clear();
+    m_sortedRows.clear();
+    m_visibleRows.clear();
+    endResetModel();
+}
+
+QList<AnalysisResult> ResultsTableModel::sortedResults() const
+{
+    QList<AnalysisResult> sorted;
+    sorted.reserve(m_sortedRows.size());
+    for (int idx : m_sortedRows) sorted.append(m_results[idx]);
+    return sorted;
+}
+
+const AnalysisResult* ResultsTableModel::resultAt(int row) const
+{
+    if (row < 0 || row >= m_visibleRows.size()) return nullptr;
+    return &m_results[m_visibleRows[row]];
+}
+
+void ResultsTableModel::setTypeFilter(quint8 mask)
+{
+    if (mask == m_filterMask) return;
+    beginResetModel();
+    m_filterMask = mask;
+    rebuildVisibleRows();
+    endResetModel();
+}
+
+void ResultsTableModel::setTimeFormat(int format, const QString &headerText)
+{
+    m_timeFormat = format;
+    m_timeHeader = headerText;
+    emit headerDataChanged(Qt::Horizontal, ColTime, ColTime);
+    if (!m_visibleRows.isEmpty()) {
+        emit dataChanged(index(0, ColTime), index(m_visibleRows.size() - 1, ColTime), {Qt::DisplayRole});
+    }
+}
+
+void ResultsTableModel::setVideoInfo(const Timecode &timecode, int width, int height)
+{
+    m_timecode = timecode;
+    m_videoWidth = width;
+    m_videoHeight = height;
+    if (!m_visibleRows.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_visibleRows.size() - 1, ColumnCount - 1), {Qt::DisplayRole});
+    }
+}
+
+void ResultsTableModel::rebuildVisibleRows()
+{
+    m_visibleRows.clear();
+    m_visibleRows.reserve(m_sortedRows.size());
+    for (int idx : m_sortedRows) {
+        if (typeBitFor(m_results[idx].type) & m_filterMask) m_visibleRows.append(idx);
+    }
+}
+
+bool ResultsTableModel::lessByStart(int a, int b) const
+{
+    // Cùng startFrame thì giữ thứ tự đến
+    const int sa = m_results[a].startFrame, sb = m_results[b].startFrame;
+    return sa != sb ? sa < sb : a < b;
+}
+
+QString ResultsTableModel::formattedTime(const AnalysisResult &res) const
+{
+    if (m_timeFormat == FmtFrame) return QString::number(res.startFrame);
+
+    Timecode::Style style = Timecode::Style::Smpte;
+    switch (m_timeFormat) {
+        case FmtPrecise: style = Timecode::Style::Milliseconds; break;
+        case FmtSeconds: style = Timecode::Style::Seconds; break;
+        case FmtMinutes: style = Timecode::Style::Minutes; break;
+        default: break;
+    }
+    char buffer[Timecode::BUFFER_SIZE];
+    const int length = m_timecode.format(res.startFrame, style, buffer);
+    return QString::fromLatin1(buffer, length);
+}
@@ -0,0 +1,77 @@
+// src/ui/resultstablemodel.h
+#ifndef RESULTSTABLEMODEL_H
+#define RESULTSTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QList>
+#include <QVector>
+#include "core/types.h"
+#include "core/Timecode.h"
+
+// Model bảng kết quả đọc trực tiếp từ vector kết quả.
+// Không tạo QStandardItem cho từng ô: bộ lọc chỉ dựng lại mảng chỉ số các dòng hiển thị,
+// còn văn bản của từng ô chỉ được định dạng khi view yêu cầu trong data().
+// Kết quả được lưu theo thứ tự đến (chỉ thêm vào cuối) nên chỉ số của một kết quả không bao giờ đổi;
+// thứ tự hiển thị theo startFrame nằm trong các mảng chỉ số.
+class ResultsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { ColTime = 0, ColCount, ColType, ColThumbs, ColDetails, ColumnCount };
+
+    // Mỗi loại lỗi ứng với một bit để lọc nhanh (bit = giá trị của ErrorType)
+    enum TypeBit : quint8 {
+        BitNone = 0,
+        BitBlackFrame = 1 << int(ErrorType::BlackFrame),
+        BitBlackBorder = 1 << int(ErrorType::BlackBorder),
+        BitOrphanFrame = 1 << int(ErrorType::OrphanFrame),
+        BitAll = BitBlackFrame | BitBlackBorder | BitOrphanFrame
+    };
+
+    // Giữ nguyên thứ tự định dạng của menu Timecode trong ResultsWidget
+    enum TimeFormat { FmtTimecode = 0, FmtPrecise, FmtFrame, FmtSeconds, FmtMinutes };
+
+    explicit ResultsTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setResults(const QList<AnalysisResult> &results);
+    // Thêm một lô kết quả (đã sắp xếp hoặc chưa), phát tín hiệu chèn dòng đúng vị trí
+    void appendResults(const QList<AnalysisResult> &batch);
+    void clear();
+    int resultCount() const { return m_results.size(); }
+    // Toàn bộ kết quả (không lọc) theo thứ tự startFrame
+    QList<AnalysisResult> sortedResults() const;
+
+    // Trả về kết quả tương ứng với một dòng đang hiển thị, O(1)
+    const AnalysisResult* resultAt(int row) const;
+
+    void setTypeFilter(quint8 mask);
+    quint8 typeFilter() const { return m_filterMask; }
+    void setTimeFormat(int format, const QString &headerText);
+    // Timecode dùng cho cột thời gian, kích thước video dùng cho phần chi tiết viền đen
+    void setVideoInfo(const Timecode &timecode, int width, int height);
+
+private:
+    static quint8 typeBitFor(ErrorType type) { return quint8(1u << int(type)); }
+    void rebuildVisibleRows();
+    bool lessByStart(int a, int b) const;
+    QString formattedTime(const AnalysisResult &res) const;
+
+    QList<AnalysisResult> m_results;   // Dữ liệu gốc, theo thứ tự đến
+    QVector<int> m_sortedRows;         // Chỉ số trong m_results, sắp xếp theo startFrame
+    QVector<int> m_visibleRows;        // Dòng hiển thị -> chỉ số trong m_results
+
+    quint8 m_filterMask = BitAll;
+    int m_timeFormat = FmtTimecode;
+    QString m_timeHeader = QStringLiteral("Timecode");
+    Timecode m_timecode;
+    int m_videoWidth = 0;
+    int m_videoHeight = 0;
+};
+
+#endif // RESULTSTABLEMODEL_H
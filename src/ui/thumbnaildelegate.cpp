@@ -0,0 +1,65 @@
+// src/ui/thumbnaildelegate.cpp
+#include "thumbnaildelegate.h"
+#include "resultstablemodel.h"
+#include "core/ThumbnailProvider.h"
+#include <QPainter>
+#include <QApplication>
+
+namespace {
+constexpr int THUMB_SPACING = 2;
+}
+
+ThumbnailDelegate::ThumbnailDelegate(ResultsTableModel *model, ThumbnailProvider *provider, QObject *parent)
+    : QStyledItemDelegate(parent), m_model(model), m_provider(provider)
+{
+}
+
+std::array<int, ThumbnailDelegate::THUMB_COUNT> ThumbnailDelegate::framesFor(const AnalysisResult &res)
+{
+    return { res.startFrame, res.startFrame + (res.endFrame - res.startFrame) / 2, res.endFrame };
+}
+
+QSize ThumbnailDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    QSize size = QStyledItemDelegate::sizeHint(option, index);
+    if (m_enabled) size.setHeight(qMax(size.height(), THUMB_HEIGHT + 4));
+    return size;
+}
+
+void ThumbnailDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    // Nền (chọn / hover) vẽ như một ô trống bình thường
+    QStyleOptionViewItem opt = option;
+    initStyleOption(&opt, index);
+    const QWidget *widget = opt.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    const AnalysisResult *res = m_model->resultAt(index.row());
+    if (!m_enabled || !res) return;
+
+    const QRect area = option.rect.adjusted(2, 2, -2, -2);
+    const int slotWidth = (area.width() - THUMB_SPACING * (THUMB_COUNT - 1)) / THUMB_COUNT;
+    if (slotWidth <= 4) return;
+
+    painter->save();
+    const auto frames = framesFor(*res);
+    for (int i = 0; i < THUMB_COUNT; ++i) {
+        const QRect slot(area.left() + i * (slotWidth + THUMB_SPACING), area.top(), slotWidth, area.height());
+        // Đoạn chỉ có 1-2 frame: không lặp lại cùng một ảnh
+        if (i > 0 && frames[i] == frames[i - 1]) continue;
+
+        const QImage image = m_provider->isAvailable() ? m_provider->thumbnail(frames[i]) : QImage();
+        if (image.isNull()) {
+            painter->setPen(option.palette.color(QPalette::Mid));
+            painter->drawRect(slot.adjusted(0, 0, -1, -1));
+            continue;
+        }
+        const QSize scaled = image.size().scaled(slot.size(), Qt::KeepAspectRatio);
+        const QRect target(slot.left() + (slot.width() - scaled.width()) / 2,
+                           slot.top() + (slot.height() - scaled.height()) / 2,
+                           scaled.width(), scaled.height());
+        painter->drawImage(target, image);
+    }
+    painter->restore();
+}
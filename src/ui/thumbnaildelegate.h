@@ -0,0 +1,37 @@
+// src/ui/thumbnaildelegate.h
+#ifndef THUMBNAILDELEGATE_H
+#define THUMBNAILDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include <array>
+#include "core/types.h"
+
+class ResultsTableModel;
+class ThumbnailProvider;
+
+// Vẽ ảnh frame đầu / giữa / cuối của đoạn lỗi trong cột ảnh của bảng kết quả.
+// Ảnh chưa có thì vẽ khung trống; việc gọi ThumbnailProvider::thumbnail() khi vẽ
+// chính là yêu cầu giải mã, nên chỉ các dòng đang hiển thị mới được xếp hàng.
+class ThumbnailDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    static constexpr int THUMB_COUNT = 3;
+    static constexpr int THUMB_HEIGHT = 54;
+
+    ThumbnailDelegate(ResultsTableModel *model, ThumbnailProvider *provider, QObject *parent = nullptr);
+
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    static std::array<int, THUMB_COUNT> framesFor(const AnalysisResult &res);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    ResultsTableModel *m_model;
+    ThumbnailProvider *m_provider;
+    bool m_enabled = false;
+};
+
+#endif // THUMBNAILDELEGATE_H
@@ -6,8 +6,14 @@
 #include "logdialog.h"
 #include "qctools/QCToolsManager.h"
 #include "qctools/QCToolsController.h"
+#include "qctools/WatchFolderService.h"
+#include "qctools/JobApiServer.h"
+#include "qctools/MediaProbe.h"
 #include "core/Constants.h" 
 #include "core/media_info.h"
+#include "core/LogSink.h"
+#include "core/ResultCache.h"
+#include "core/GopIndex.h"
 
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -16,7 +22,6 @@
 #include <QLabel>
 #include <QMessageBox>
 #include <QFileDialog>
-#include <QTextStream>
 #include <QApplication>
 #include <QClipboard>
 #include <QFileInfo>
@@ -25,6 +30,10 @@
 #include <QCryptographicHash>
 #include <QTimer>
 #include <QSettings> 
+#include <QProgressDialog>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
 
 VideoWidget::VideoWidget(QWidget *parent)
     : QWidget(parent)
@@ -32,8 +41,13 @@ VideoWidget::VideoWidget(QWidget *parent)
     qRegisterMetaType<AnalysisResult>("AnalysisResult");
     qRegisterMetaType<QList<AnalysisResult>>("QList<AnalysisResult>");
     qRegisterMetaType<MediaInfo>("MediaInfo");
+    qRegisterMetaType<MetricPyramidPtr>("MetricPyramidPtr");
+
+    m_logSink = new LogSink(LogSink::DEFAULT_CAPACITY, this);
+    applyLogSettings();
 
     setupUI();
+    applyThumbnailSettings();
     
     m_statusResetTimer = new QTimer(this);
     m_statusResetTimer->setSingleShot(true);
@@ -44,18 +58,33 @@ VideoWidget::VideoWidget(QWidget *parent)
     m_qctoolsManager->moveToThread(m_analysisThread);
     m_qctoolsController = new QCToolsController(this);
 
+    // CẢI TIẾN: Xuất báo cáo chạy trên luồng riêng để giao diện không bị treo với danh sách lỗi lớn
+    m_exportThread = new QThread(this);
+    m_exporter = new ResultExporter();
+    m_exporter->moveToThread(m_exportThread);
+
+    m_watchService = new WatchFolderService(this);
+
     setupConnections();
     m_analysisThread->start();
+    m_exportThread->start();
     
     handleLogMessage(QString("[%1] Chương trình đã khởi động.").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")));
     
     initializePaths();
+
+    // Chế độ theo dõi thư mục được bật lại sau khi khởi động lại, các file đã xong không bị phân tích lại
+    QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    if (qsettings.value(AppConstants::K_WATCH_ENABLED, false).toBool()) m_watchButton->setChecked(true);
+    applyApiSettings();
     
     handleLogMessage("------------------------------------------------------------------");
 }
 
 VideoWidget::~VideoWidget()
 {
+    m_watchService->stop();
+    stopApiServer();
     if(m_analysisThread->isRunning()) {
         m_analysisThread->quit();
         if (!m_analysisThread->wait(3000)) {
@@ -64,6 +93,11 @@ VideoWidget::~VideoWidget()
         }
     }
     delete m_qctoolsManager;
+
+    m_exporter->requestCancel();
+    m_exportThread->quit();
+    m_exportThread->wait();
+    delete m_exporter;
 }
 
 void VideoWidget::setupUI()
@@ -88,8 +122,32 @@ void VideoWidget::setupUI()
     m_analysisButtonStack->addWidget(m_analyzeButton);
     m_analysisButtonStack->addWidget(m_stopButton);
     
+    m_compareButton = new QPushButton("So sánh báo cáo...");
+    m_compareButton->setToolTip("So sánh báo cáo của một bản (ví dụ bản transcode) với báo cáo của bản gốc,\n"
+                                "chỉ hiện các lỗi mới hoặc đã thay đổi so với bản gốc.");
+    m_compareButton->setStyleSheet("padding: 5px;");
+
     // Nút Log sẽ được chuyển xuống dưới
     controlButtonsLayout->addWidget(m_analysisButtonStack, 1);
+    controlButtonsLayout->addWidget(m_compareButton);
+
+    m_triageButton = new QPushButton("Quét keyframe");
+    m_triageButton->setStyleSheet("padding: 5px;");
+    if (QCToolsManager::inProcessEngineAvailable()) {
+        m_triageButton->setToolTip("Chỉ giải mã các keyframe để có bản đồ lỗi sơ bộ (Frame Đen, Viền Đen) trong vài giây.\n"
+                                   "Kết quả là ước lượng: ranh giới chỉ chính xác tới khoảng cách giữa hai keyframe và lỗi\n"
+                                   "không chạm keyframe nào sẽ không được phát hiện. Sau đó có thể phân tích đầy đủ các vùng đã đánh dấu.");
+    } else {
+        m_triageButton->setEnabled(false);
+        m_triageButton->setToolTip("Cần bản build có bộ máy phân tích libav (VIDEOQC_WITH_LIBAV).");
+    }
+    controlButtonsLayout->addWidget(m_triageButton);
+
+    m_watchButton = new QPushButton("Theo dõi thư mục");
+    m_watchButton->setCheckable(true);
+    m_watchButton->setToolTip("Tự động phân tích các video mới được chép vào thư mục theo dõi (cấu hình trong Cài đặt).");
+    m_watchButton->setStyleSheet("padding: 5px;");
+    controlButtonsLayout->addWidget(m_watchButton);
 
     // --- Status & Log Layout (Layout dưới cùng MỚI) ---
     QHBoxLayout* bottomLayout = new QHBoxLayout();
@@ -115,10 +173,16 @@ void VideoWidget::setupConnections()
 {
     connect(m_configWidget, &ConfigWidget::filePathSelected, this, &VideoWidget::onFileSelected);
     connect(m_configWidget, &ConfigWidget::reportPathSelected, this, &VideoWidget::onReportSelected);
+    connect(m_configWidget, &ConfigWidget::profilesSelected, this, &VideoWidget::onProfilesSelected);
+    connect(m_resultsWidget, &ResultsWidget::profileSelected, this, &VideoWidget::onProfileSelected);
     connect(m_analyzeButton, &QPushButton::clicked, this, &VideoWidget::onAnalyzeClicked);
     connect(m_stopButton, &QPushButton::clicked, this, &VideoWidget::onStopClicked);
+    connect(m_compareButton, &QPushButton::clicked, this, &VideoWidget::onCompareClicked);
+    connect(m_triageButton, &QPushButton::clicked, this, &VideoWidget::onTriageClicked);
+    connect(m_resultsWidget, &ResultsWidget::noticeActionClicked, this, &VideoWidget::onAnalyzeFlaggedRegions);
+    connect(m_watchButton, &QPushButton::toggled, this, &VideoWidget::onWatchToggled);
     connect(m_resultsWidget, &ResultsWidget::settingsClicked, this, &VideoWidget::onSettingsClicked);
-    connect(m_resultsWidget, &ResultsWidget::exportTxtClicked, this, &VideoWidget::onExportTxt);
+    connect(m_resultsWidget, &ResultsWidget::exportRequested, this, &VideoWidget::onExportRequested);
     connect(m_resultsWidget, &ResultsWidget::copyToClipboardClicked, this, &VideoWidget::onCopyToClipboard);
     connect(m_logButton, &QPushButton::clicked, this, &VideoWidget::onShowLogClicked);
     
@@ -128,12 +192,21 @@ void VideoWidget::setupConnections()
     connect(m_qctoolsManager, &QCToolsManager::analysisStarted, this, [this](){ setAnalysisInProgress(true); });
     connect(m_qctoolsManager, &QCToolsManager::statusUpdated, this, &VideoWidget::updateStatus, Qt::QueuedConnection);
     connect(m_qctoolsManager, &QCToolsManager::progressUpdated, this, &VideoWidget::updateProgress, Qt::QueuedConnection);
-    connect(m_qctoolsManager, &QCToolsManager::resultsReady, this, &VideoWidget::handleResults, Qt::QueuedConnection);
+    connect(m_qctoolsManager, &QCToolsManager::resultsBatchReady, this, &VideoWidget::handleResultsBatch, Qt::QueuedConnection);
+    connect(m_qctoolsManager, &QCToolsManager::metricsReady, m_resultsWidget, &ResultsWidget::setMetrics, Qt::QueuedConnection);
     connect(m_qctoolsManager, &QCToolsManager::analysisFinished, this, &VideoWidget::handleAnalysisFinished, Qt::QueuedConnection);
     connect(m_qctoolsManager, &QCToolsManager::errorOccurred, this, &VideoWidget::handleError, Qt::QueuedConnection);
-    connect(m_qctoolsManager, &QCToolsManager::logMessage, this, &VideoWidget::handleLogMessage, Qt::QueuedConnection);
+    // CẢI TIẾN: LogSink an toàn đa luồng nên luồng phân tích ghi thẳng vào bộ đệm,
+    // giao diện chỉ được cập nhật theo lô bởi timer của LogSink.
+    connect(m_qctoolsManager, &QCToolsManager::logMessage, m_logSink, &LogSink::appendMessage, Qt::DirectConnection);
     connect(m_qctoolsManager, &QCToolsManager::backgroundTaskFinished, this, &VideoWidget::handleBackgroundTaskFinished, Qt::QueuedConnection);
     connect(m_qctoolsManager, &QCToolsManager::mediaInfoReady, this, &VideoWidget::handleMediaInfo, Qt::QueuedConnection);
+    connect(m_qctoolsManager, &QCToolsManager::comparisonFinished, this, &VideoWidget::handleComparisonFinished, Qt::QueuedConnection);
+    connect(m_qctoolsManager, &QCToolsManager::profileResultsReady, this, &VideoWidget::handleProfileResults, Qt::QueuedConnection);
+    connect(m_watchService, &WatchFolderService::logMessage, m_logSink, &LogSink::appendMessage);
+    connect(m_watchService, &WatchFolderService::statusChanged, this, &VideoWidget::onWatchStatusChanged);
+    connect(m_exporter, &ResultExporter::progressUpdated, this, &VideoWidget::onExportProgress, Qt::QueuedConnection);
+    connect(m_exporter, &ResultExporter::exportFinished, this, &VideoWidget::onExportFinished, Qt::QueuedConnection);
 }
 
 void VideoWidget::initializePaths()
@@ -263,11 +336,13 @@ void VideoWidget::onFileSelected(const QString &path)
     handleLogMessage(QString("[%1] Đã chọn file mới: %2").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")).arg(path));
     m_currentVideoPath = path;
     m_currentReportPath.clear();
+    m_incrementalReportPath.clear();
     m_resultsWidget->clearResults();
     m_currentMediaInfo = MediaInfo();
     emit videoFileChanged(QFileInfo(path).fileName());
     m_configWidget->setInputPath(path);
     m_analyzeButton->setText("BẮT ĐẦU PHÂN TÍCH");
+    probeSelectedFile(path);
     
     QString existingXml = findExistingReport(path, QCToolsManager::ReportType::XML);
     if(existingXml.isEmpty()) existingXml = findExistingReport(path, QCToolsManager::ReportType::GZ);
@@ -276,19 +351,42 @@ void VideoWidget::onFileSelected(const QString &path)
 
     if (!existingXml.isEmpty()) {
         handleLogMessage(QString("[INFO] Đã phát hiện file báo cáo có sẵn: %1").arg(existingXml));
-        
+
+        // Chỉ mục GOP lưu cùng báo cáo không còn khớp với file: video đã được giao lại sau lần QC trước.
+        // Báo cáo (và kết quả trong cache) mô tả bản cũ, nên không mở tự động; đề nghị chỉ QC lại phần đã đổi.
+        GopIndex previousIndex;
+        const bool redelivered = QCToolsManager::inProcessEngineAvailable()
+                                 && GopIndex::load(GopIndex::pathForReport(existingXml), &previousIndex)
+                                 && !previousIndex.matchesFile(path);
+        if (redelivered) handleLogMessage("[INFO] Video đã thay đổi sau lần tạo báo cáo, có thể chỉ QC lại các GOP đã đổi.");
+
+        // Báo cáo chưa đổi và đã có kết quả cho cấu hình hiện tại: mở ngay, không cần hỏi.
+        // Chỉ tra chỉ mục cache, không đọc file báo cáo trên luồng giao diện.
+        QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+        if (!redelivered && qsettings.value(AppConstants::K_RESULT_CACHE, true).toBool()
+            && ResultCache::contains(ResultCache::indexedFingerprint(existingXml), ResultCache::profileHash(m_configWidget->getSettings()))) {
+            handleLogMessage("[INFO] Cache kết quả: báo cáo có sẵn đã được phân tích với cấu hình hiện tại, tải kết quả từ cache.");
+            onReportSelected(existingXml);
+            return;
+        }
+
         QMessageBox msgBox(this);
         msgBox.setWindowTitle("Phát hiện dữ liệu có sẵn");
         msgBox.setText(QString("Đã tìm thấy một file báo cáo có sẵn cho video này.\n'%1'").arg(QFileInfo(existingXml).fileName()));
-        msgBox.setInformativeText("Bạn muốn làm gì?");
+        msgBox.setInformativeText(redelivered ? "Video đã thay đổi sau khi tạo báo cáo này. Bạn muốn làm gì?" : "Bạn muốn làm gì?");
+        QPushButton* incrementalButton = redelivered ? msgBox.addButton("QC lại phần thay đổi", QMessageBox::ActionRole) : nullptr;
         QPushButton* reanalyzeButton = msgBox.addButton("Phân tích lại (Ghi đè)", QMessageBox::ActionRole);
         QPushButton* viewReportButton = msgBox.addButton("Xem báo cáo có sẵn", QMessageBox::ActionRole);
         QPushButton* cancelButton = msgBox.addButton("Hủy", QMessageBox::RejectRole);
-        msgBox.setDefaultButton(viewReportButton);
+        msgBox.setDefaultButton(incrementalButton ? incrementalButton : viewReportButton);
         msgBox.setEscapeButton(cancelButton);
         msgBox.exec();
 
-        if (msgBox.clickedButton() == viewReportButton) {
+        if (incrementalButton && msgBox.clickedButton() == incrementalButton) {
+            m_currentMode = AnalysisMode::ANALYZE_VIDEO;
+            m_incrementalReportPath = existingXml;
+            onAnalyzeClicked();
+        } else if (msgBox.clickedButton() == viewReportButton) {
             onReportSelected(existingXml);
         } else if (msgBox.clickedButton() == reanalyzeButton) {
              m_currentMode = AnalysisMode::ANALYZE_VIDEO;
@@ -321,6 +419,92 @@ void VideoWidget::onFileSelected(const QString &path)
     }
 }
 
+namespace {
+struct ProbeOutcome {
+    bool ok = false;
+    MediaProbe::Result probe;
+    qint64 elapsedMs = 0;
+};
+}
+
+// CẢI TIẾN: Đọc header trên luồng của QThreadPool: file trên ổ mạng có thể mất vài giây mới mở được, giao diện không
+// phải chờ. Kết quả về sau khi người dùng đã chọn file khác thì bị bỏ.
+void VideoWidget::probeSelectedFile(const QString &videoPath)
+{
+    m_probedVideoPath.clear();
+    m_probedMediaInfo = MediaInfo();
+    m_probedFrameCount = -1;
+
+    auto *watcher = new QFutureWatcher<ProbeOutcome>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, videoPath]() {
+        watcher->deleteLater();
+        if (videoPath != m_currentVideoPath) return;
+        const ProbeOutcome outcome = watcher->result();
+        if (!outcome.ok) {
+            handleLogMessage("[INFO] Không đọc nhanh được header của file, thông tin video sẽ có sau khi phân tích.");
+            return;
+        }
+        const MediaProbe::Result &probe = outcome.probe;
+        m_probedVideoPath = videoPath;
+        m_probedMediaInfo = probe.info;
+        m_probedFrameCount = probe.nbFrames;
+        handleLogMessage(QString("[INFO] Đọc nhanh header (%1, %2 ms): %3")
+                             .arg(probe.method).arg(outcome.elapsedMs)
+                             .arg(probe.nbFrames > 0 ? QString("%1 frame (%2)").arg(probe.nbFrames).arg(probe.nbFramesExact ? "chính xác" : "ước lượng")
+                                                     : QString("không rõ số frame")));
+        // Phân tích đã bắt đầu thì thông tin video do lượt phân tích cập nhật
+        if (!m_isAnalysisInProgress) handleMediaInfo(probe.info);
+    });
+    watcher->setFuture(QtConcurrent::run([videoPath]() {
+        ProbeOutcome outcome;
+        QElapsedTimer timer;
+        timer.start();
+        outcome.ok = MediaProbe::probe(videoPath, &outcome.probe);
+        outcome.elapsedMs = timer.elapsed();
+        return outcome;
+    }));
+}
+
+bool VideoWidget::analysisRange(QVariantList *range, QString *error) const
+{
+    range->clear();
+    const QString inText = m_configWidget->inPointText();
+    const QString outText = m_configWidget->outPointText();
+    if (inText.isEmpty() && outText.isEmpty()) return true;
+
+    // Số frame dùng thẳng; timecode đổi theo tốc độ khung hình đã đọc nhanh từ header
+    const Timecode timecode = currentTimecode();
+    auto toFrame = [&](const QString& text, const QString& name, qint64* frame) {
+        bool isNumber = false;
+        *frame = text.toLongLong(&isNumber);
+        if (isNumber) return true;
+        if (!timecode.isValid()) {
+            *error = QString("Chưa biết tốc độ khung hình của video nên không đổi được timecode %1 của %2.\nHãy nhập số frame.")
+                         .arg(text).arg(name.toLower());
+            return false;
+        }
+        *frame = timecode.parseSmpte(text);
+        if (*frame >= 0) return true;
+        *error = QString("%1 '%2' không phải timecode hợp lệ với %3 fps (%4).").arg(name).arg(text)
+                     .arg(timecode.rate().toDouble(), 0, 'f', 3).arg(timecode.isDropFrame() ? "HH:MM:SS;FF, drop-frame" : "HH:MM:SS:FF");
+        return false;
+    };
+    qint64 first = 0;
+    qint64 last = -1;
+    if (!inText.isEmpty() && !toFrame(inText, "Điểm vào", &first)) return false;
+    if (!outText.isEmpty() && !toFrame(outText, "Điểm ra", &last)) return false;
+    if (last >= 0 && last < first) {
+        *error = QString("Điểm ra (frame %1) nằm trước điểm vào (frame %2).").arg(last).arg(first);
+        return false;
+    }
+    if (m_probedVideoPath == m_currentVideoPath && m_probedFrameCount > 0 && first >= m_probedFrameCount) {
+        *error = QString("Điểm vào (frame %1) nằm sau cuối file (%2 frame).").arg(first).arg(m_probedFrameCount);
+        return false;
+    }
+    *range = QVariantList{ int(first), int(last) };
+    return true;
+}
+
 void VideoWidget::onReportSelected(const QString &path)
 {
     handleLogMessage(QString("[%1] Đã nhập file báo cáo: %2").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss")).arg(path));
@@ -332,19 +516,9 @@ void VideoWidget::onReportSelected(const QString &path)
     m_currentVideoPath.clear();
     m_analyzeButton->setText("XEM BÁO CÁO");
 
-    QFileInfo reportInfo(path);
-    QString reportName = reportInfo.fileName();
-    QString baseName = reportName;
-
-    if (reportName.endsWith(".qctools.xml.gz")) baseName = reportName.left(reportName.length() - 16);
-    else if (reportName.endsWith(".qctools.mkv")) baseName = reportName.left(reportName.length() - 12);
-    else if (reportName.endsWith(".qctools.xml")) baseName = reportName.left(reportName.length() - 12);
-    else if (reportName.endsWith(".xml.gz")) baseName = reportName.left(reportName.length() - 7);
-    else if (reportName.endsWith(".xml")) baseName = reportName.left(reportName.length() - 4);
-    
-    QString potentialVideoPath = reportInfo.absolutePath() + "/" + baseName;
-    if(QFile::exists(potentialVideoPath)){
-        m_currentVideoPath = potentialVideoPath;
+    const QString reportName = QFileInfo(path).fileName();
+    m_currentVideoPath = findVideoForReport(path);
+    if (!m_currentVideoPath.isEmpty()) {
         handleLogMessage(QString("[INFO] Đã tìm thấy file video tương ứng: %1").arg(m_currentVideoPath));
     }
 
@@ -385,6 +559,225 @@ void VideoWidget::onReportSelected(const QString &path)
 }
 
 
+QVariantMap VideoWidget::currentAnalysisSettings() const
+{
+    QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    QVariantMap settings = m_configWidget->getSettings();
+    settings[AppConstants::K_QCCLI_PATH] = qsettings.value(AppConstants::K_QCCLI_PATH).toString();
+    settings[AppConstants::K_ANALYSIS_ENGINE] = qsettings.value(AppConstants::K_ANALYSIS_ENGINE, AppConstants::ENGINE_QCLI).toString();
+    settings[AppConstants::K_ANALYSIS_SEGMENTS] = qsettings.value(AppConstants::K_ANALYSIS_SEGMENTS, 0).toInt();
+    settings[AppConstants::K_FAST_SCAN] = m_configWidget->fastScanEnabled();
+    settings[AppConstants::K_FAST_SCAN_STEP] = qsettings.value(AppConstants::K_FAST_SCAN_STEP, 0).toInt();
+    settings[AppConstants::K_ANALYSIS_DOWNSCALE] = qsettings.value(AppConstants::K_ANALYSIS_DOWNSCALE, 1).toInt();
+    settings[AppConstants::K_WRITE_GOP_INDEX] = qsettings.value(AppConstants::K_WRITE_GOP_INDEX, false).toBool();
+    settings[AppConstants::K_RESULT_CACHE] = qsettings.value(AppConstants::K_RESULT_CACHE, true).toBool();
+    settings[AppConstants::K_FRAME_MEMORY_MB] = qsettings.value(AppConstants::K_FRAME_MEMORY_MB, 512).toInt();
+    return settings;
+}
+
+void VideoWidget::onWatchToggled(bool enabled)
+{
+    QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    if (!enabled) {
+        m_watchService->stop();
+        m_watchButton->setText("Theo dõi thư mục");
+        qsettings.setValue(AppConstants::K_WATCH_ENABLED, false);
+        return;
+    }
+
+    WatchFolderService::Config config;
+    config.watchDir = qsettings.value(AppConstants::K_WATCH_DIR).toString();
+    config.outputDir = qsettings.value(AppConstants::K_WATCH_OUTPUT_DIR).toString();
+    config.maxJobs = qsettings.value(AppConstants::K_WATCH_MAX_JOBS, 1).toInt();
+    config.scanIntervalSeconds = qsettings.value(AppConstants::K_WATCH_SCAN_SEC, 30).toInt();
+    config.stableSeconds = qsettings.value(AppConstants::K_WATCH_STABLE_SEC, 10).toInt();
+    config.analysisSettings = currentAnalysisSettings();
+
+    const QString qcliPath = config.analysisSettings.value(AppConstants::K_QCCLI_PATH).toString();
+    QString error;
+    const bool needsQcli = !QCToolsManager::usesInProcessEngine(config.analysisSettings);
+    if (needsQcli && (qcliPath.isEmpty() || !QFile::exists(qcliPath))) error = "Đường dẫn đến qcli.exe không hợp lệ.";
+    else m_watchService->start(config, &error);
+
+    if (!error.isEmpty()) {
+        QMessageBox::warning(this, "Không thể bắt đầu theo dõi",
+                             error + "\nVui lòng kiểm tra thư mục theo dõi và thư mục đầu ra trong Cài đặt (thẻ Thư mục theo dõi).");
+        const QSignalBlocker blocker(m_watchButton);
+        m_watchButton->setChecked(false);
+        qsettings.setValue(AppConstants::K_WATCH_ENABLED, false);
+        return;
+    }
+    qsettings.setValue(AppConstants::K_WATCH_ENABLED, true);
+}
+
+void VideoWidget::applyApiSettings()
+{
+    QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    const bool enabled = qsettings.value(AppConstants::K_API_ENABLED, false).toBool();
+    const quint16 port = quint16(qsettings.value(AppConstants::K_API_PORT, 8765).toUInt());
+    const int maxJobs = qsettings.value(AppConstants::K_API_MAX_JOBS, 2).toInt();
+
+    if (!enabled) {
+        stopApiServer();
+        return;
+    }
+    // Cùng cổng và số job: chỉ cập nhật cấu hình mặc định, không hủy các job đang chạy
+    if (m_apiServer && port == m_apiPort && maxJobs == m_apiMaxJobs) {
+        QMetaObject::invokeMethod(m_apiServer, "setBaseSettings", Qt::QueuedConnection,
+                                  Q_ARG(QVariantMap, currentAnalysisSettings()));
+        return;
+    }
+    stopApiServer();
+
+    // Server chạy trên luồng riêng để các request không phải chờ vòng lặp sự kiện của giao diện
+    m_apiThread = new QThread(this);
+    m_apiServer = new JobApiServer();
+    m_apiServer->moveToThread(m_apiThread);
+    m_apiPort = port;
+    m_apiMaxJobs = maxJobs;
+    connect(m_apiServer, &JobApiServer::logMessage, m_logSink, &LogSink::appendMessage, Qt::DirectConnection);
+    connect(m_apiServer, &JobApiServer::startFailed, this, [this](const QString &error) {
+        handleLogMessage(QString("[ERROR] Không thể mở dịch vụ job HTTP tại cổng %1: %2").arg(m_apiPort).arg(error));
+    }, Qt::QueuedConnection);
+    m_apiThread->start();
+    QMetaObject::invokeMethod(m_apiServer, "start", Qt::QueuedConnection, Q_ARG(int, port), Q_ARG(int, maxJobs),
+                              Q_ARG(QVariantMap, currentAnalysisSettings()));
+}
+
+void VideoWidget::stopApiServer()
+{
+    if (!m_apiServer) return;
+    // Socket và luồng job thuộc về luồng của server nên phải dừng chúng trên luồng đó
+    QMetaObject::invokeMethod(m_apiServer, "stop", Qt::BlockingQueuedConnection);
+    m_apiThread->quit();
+    m_apiThread->wait();
+    delete m_apiServer;
+    delete m_apiThread;
+    m_apiServer = nullptr;
+    m_apiThread = nullptr;
+}
+
+void VideoWidget::onWatchStatusChanged(int running, int queued)
+{
+    if (!m_watchService->isRunning()) {
+        m_watchButton->setText("Theo dõi thư mục");
+        return;
+    }
+    m_watchButton->setText(QString("Đang theo dõi (%1 chạy, %2 chờ)").arg(running).arg(queued));
+}
+
+QString VideoWidget::findVideoForReport(const QString &reportPath) const
+{
+    QFileInfo reportInfo(reportPath);
+    QString reportName = reportInfo.fileName();
+    QString baseName = reportName;
+
+    if (reportName.endsWith(".qctools.xml.gz")) baseName = reportName.left(reportName.length() - 16);
+    else if (reportName.endsWith(".qctools.mkv")) baseName = reportName.left(reportName.length() - 12);
+    else if (reportName.endsWith(".qctools.xml")) baseName = reportName.left(reportName.length() - 12);
+    else if (reportName.endsWith(".xml.gz")) baseName = reportName.left(reportName.length() - 7);
+    else if (reportName.endsWith(".xml")) baseName = reportName.left(reportName.length() - 4);
+
+    QString potentialVideoPath = reportInfo.absolutePath() + "/" + baseName;
+    return QFile::exists(potentialVideoPath) ? potentialVideoPath : QString();
+}
+
+void VideoWidget::onCompareClicked()
+{
+    if (m_isAnalysisInProgress) {
+        QMessageBox::warning(this, "Đang xử lý", "Một quá trình khác đang chạy. Vui lòng đợi.");
+        return;
+    }
+
+    const QString reportFilter = "QCTools Reports (*.xml *.xml.gz);;All Files (*)";
+    const QString referencePath = QFileDialog::getOpenFileName(this, "Chọn báo cáo của bản gốc (tham chiếu)",
+                                                               QFileInfo(m_currentReportPath).absolutePath(), reportFilter);
+    if (referencePath.isEmpty()) return;
+    const QString candidatePath = QFileDialog::getOpenFileName(this, "Chọn báo cáo của bản cần kiểm tra",
+                                                               QFileInfo(referencePath).absolutePath(), reportFilter);
+    if (candidatePath.isEmpty()) return;
+
+    m_referenceReportPath = referencePath;
+    m_currentReportPath = candidatePath;
+    m_currentVideoPath = findVideoForReport(candidatePath);
+    m_currentMode = AnalysisMode::COMPARE_REPORTS;
+    emit videoFileChanged(QFileInfo(candidatePath).fileName());
+    m_configWidget->setInputPath(candidatePath);
+    m_analyzeButton->setText("SO SÁNH BÁO CÁO");
+    onAnalyzeClicked();
+}
+
+void VideoWidget::onTriageClicked()
+{
+    if (m_isAnalysisInProgress) {
+        QMessageBox::warning(this, "Đang xử lý", "Một quá trình khác đang chạy. Vui lòng đợi.");
+        return;
+    }
+    if (m_currentVideoPath.isEmpty()) {
+        QMessageBox::warning(this, "Chưa chọn file", "Vui lòng chọn một file video.");
+        return;
+    }
+    m_currentMode = AnalysisMode::TRIAGE_KEYFRAMES;
+    onAnalyzeClicked();
+}
+
+void VideoWidget::onAnalyzeFlaggedRegions()
+{
+    if (m_isAnalysisInProgress) {
+        QMessageBox::warning(this, "Đang xử lý", "Một quá trình khác đang chạy. Vui lòng đợi.");
+        return;
+    }
+    m_flaggedWindows.clear();
+    for (const AnalysisResult& result : m_resultsWidget->getCurrentResults()) {
+        m_flaggedWindows.append(QVariant(QVariantList{ result.startFrame, result.endFrame }));
+    }
+    if (m_flaggedWindows.isEmpty() || m_currentVideoPath.isEmpty()) return;
+    m_currentMode = AnalysisMode::ANALYZE_REGIONS;
+    onAnalyzeClicked();
+}
+
+void VideoWidget::onProfilesSelected(const QVariantList &profiles)
+{
+    if (m_isAnalysisInProgress) {
+        QMessageBox::warning(this, "Đang xử lý", "Một quá trình khác đang chạy. Vui lòng đợi.");
+        return;
+    }
+
+    // Các cấu hình được chạy trên số liệu frame của một báo cáo có sẵn, không phân tích lại video
+    QString reportPath = m_currentReportPath;
+    if (reportPath.isEmpty() && !m_currentVideoPath.isEmpty()) {
+        reportPath = findExistingReport(m_currentVideoPath, QCToolsManager::ReportType::XML);
+        if (reportPath.isEmpty()) reportPath = findExistingReport(m_currentVideoPath, QCToolsManager::ReportType::GZ);
+    }
+    const QString reportName = QFileInfo(reportPath).fileName().toLower();
+    if (reportPath.isEmpty() || !(reportName.endsWith(".xml") || reportName.endsWith(".xml.gz"))) {
+        QMessageBox::warning(this, "Chưa có báo cáo",
+                             "Cần một báo cáo .xml hoặc .xml.gz để so sánh các cấu hình.\n"
+                             "Vui lòng phân tích video hoặc nhập báo cáo trước.");
+        return;
+    }
+
+    m_evaluatedProfiles = profiles;
+    m_currentReportPath = reportPath;
+    m_currentMode = AnalysisMode::EVALUATE_PROFILES;
+    m_analyzeButton->setText("ĐÁNH GIÁ CẤU HÌNH");
+    onAnalyzeClicked();
+}
+
+void VideoWidget::onProfileSelected(int index)
+{
+    if (index < 0 || index >= m_profileResults.size()) return;
+    m_resultsWidget->handleResults(m_profileResults.at(index).second);
+}
+
+void VideoWidget::handleProfileResults(int index, const QString &name, const QList<AnalysisResult> &results)
+{
+    if (m_currentMode != AnalysisMode::EVALUATE_PROFILES) return;
+    m_profileResults.append({ name, results });
+    // Bảng hiện cấu hình đầu tiên (cấu hình hiện tại), các cấu hình khác chọn ở ô "Cấu hình"
+    if (index == 0) m_resultsWidget->handleResults(results);
+}
+
 void VideoWidget::onAnalyzeClicked()
 {
     if (m_isAnalysisInProgress) {
@@ -395,18 +788,58 @@ void VideoWidget::onAnalyzeClicked()
     m_resultsWidget->clearResults();
     m_currentMediaInfo = MediaInfo();
     
-    QSettings qsettings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
-    QVariantMap settings = m_configWidget->getSettings();
-    settings[AppConstants::K_QCCLI_PATH] = qsettings.value(AppConstants::K_QCCLI_PATH).toString();
+    QVariantMap settings = currentAnalysisSettings();
+    const QString incrementalReport = m_incrementalReportPath;
+    m_incrementalReportPath.clear();
+
+    // Phân tích trực tiếp video đã đọc nhanh header: giữ thông tin video trên màn hình và gửi kèm số frame
+    // (tính tiến độ, cấp trước bộ nhớ). MediaInfo đầy đủ sẽ thay thế khi phân tích xong.
+    const bool analyzesVideo = m_currentMode == AnalysisMode::ANALYZE_VIDEO || m_currentMode == AnalysisMode::TRIAGE_KEYFRAMES
+                               || m_currentMode == AnalysisMode::ANALYZE_REGIONS;
+    if (analyzesVideo && !m_probedVideoPath.isEmpty() && m_probedVideoPath == m_currentVideoPath) {
+        m_resultsWidget->setMediaInfo(m_probedMediaInfo);
+        m_resultsWidget->setVideoSource(m_currentVideoPath, m_probedMediaInfo.frameRate);
+        m_currentMediaInfo = m_probedMediaInfo;
+        settings[AppConstants::K_PROBED_FRAME_COUNT] = m_probedFrameCount;
+    }
+
+    if (m_currentMode == AnalysisMode::ANALYZE_VIDEO) {
+        QVariantList range;
+        QString rangeError;
+        if (!analysisRange(&range, &rangeError)) {
+            QMessageBox::warning(this, "Điểm vào/ra không hợp lệ", rangeError);
+            return;
+        }
+        if (!range.isEmpty()) {
+            // qcli luôn đọc cả file: chỉ bộ máy libav tìm tới điểm vào và dừng ở điểm ra được
+            if (!QCToolsManager::inProcessEngineAvailable()) {
+                QMessageBox::warning(this, "Không hỗ trợ", "Phân tích theo điểm vào/ra cần bộ máy phân tích libav, bản build này không có.\n"
+                                                           "Hãy xóa điểm vào/ra để phân tích cả file bằng qcli.");
+                return;
+            }
+            settings[AppConstants::K_ANALYSIS_ENGINE] = AppConstants::ENGINE_LIBAV;
+            settings[AppConstants::K_FAST_SCAN] = false;
+            settings[AppConstants::K_ANALYSIS_RANGE] = range;
+        } else if (!incrementalReport.isEmpty()) {
+            settings[AppConstants::K_INCREMENTAL_REPORT] = incrementalReport;
+        }
+    }
     
-    if (settings[AppConstants::K_QCCLI_PATH].toString().isEmpty() || !QFile::exists(settings[AppConstants::K_QCCLI_PATH].toString())) {
+    // Bộ máy libav phân tích video trong tiến trình, không cần qcli; các chế độ còn lại vẫn dùng qcli
+    const bool needsQcli = !(m_currentMode == AnalysisMode::ANALYZE_VIDEO
+                             && (QCToolsManager::usesInProcessEngine(settings) || settings.contains(AppConstants::K_INCREMENTAL_REPORT)))
+                           && m_currentMode != AnalysisMode::TRIAGE_KEYFRAMES && m_currentMode != AnalysisMode::ANALYZE_REGIONS;
+    if (needsQcli && (settings[AppConstants::K_QCCLI_PATH].toString().isEmpty() || !QFile::exists(settings[AppConstants::K_QCCLI_PATH].toString()))) {
         QMessageBox::critical(this, "Lỗi đường dẫn", "Đường dẫn đến qcli.exe không hợp lệ. Vui lòng kiểm tra lại trong Cài đặt.");
         promptForPaths();
         return;
     }
 
     if (m_currentMode == AnalysisMode::ANALYZE_VIDEO) {
-        deleteAssociatedReports(m_currentVideoPath);
+        // Phân tích một đoạn không tạo báo cáo mới, giữ lại báo cáo của cả file; QC lại phần đã đổi cần đọc báo cáo cũ
+        if (!settings.contains(AppConstants::K_ANALYSIS_RANGE) && !settings.contains(AppConstants::K_INCREMENTAL_REPORT)) {
+            deleteAssociatedReports(m_currentVideoPath);
+        }
         m_analyzeButton->setText("BẮT ĐẦU PHÂN TÍCH");
 
         if (m_currentVideoPath.isEmpty()) {
@@ -425,9 +858,39 @@ void VideoWidget::onAnalyzeClicked()
         QMetaObject::invokeMethod(m_qctoolsManager, "processReportFile", Qt::QueuedConnection,
                                   Q_ARG(QString, m_currentReportPath),
                                   Q_ARG(QVariantMap, settings));
+    } else if (m_currentMode == AnalysisMode::COMPARE_REPORTS) {
+        m_comparisonSummary.clear();
+        QMetaObject::invokeMethod(m_qctoolsManager, "compareReports", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_referenceReportPath),
+                                  Q_ARG(QString, m_currentReportPath),
+                                  Q_ARG(QVariantMap, settings));
+    } else if (m_currentMode == AnalysisMode::EVALUATE_PROFILES) {
+        m_profileResults.clear();
+        QMetaObject::invokeMethod(m_qctoolsManager, "evaluateProfiles", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_currentReportPath),
+                                  Q_ARG(QVariantList, m_evaluatedProfiles),
+                                  Q_ARG(QVariantMap, settings));
+    } else if (m_currentMode == AnalysisMode::TRIAGE_KEYFRAMES) {
+        QMetaObject::invokeMethod(m_qctoolsManager, "triageKeyframes", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_currentVideoPath),
+                                  Q_ARG(QVariantMap, settings));
+    } else if (m_currentMode == AnalysisMode::ANALYZE_REGIONS) {
+        // Vùng đánh dấu chỉ phân tích được bằng bộ máy libav (có sẵn vì lượt quét keyframe cũng cần nó)
+        settings[AppConstants::K_ANALYSIS_ENGINE] = AppConstants::ENGINE_LIBAV;
+        settings[AppConstants::K_FAST_SCAN] = false;
+        settings[AppConstants::K_ANALYSIS_WINDOWS] = m_flaggedWindows;
+        QMetaObject::invokeMethod(m_qctoolsManager, "doWork", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_currentVideoPath),
+                                  Q_ARG(QVariantMap, settings));
     }
 }
 
+void VideoWidget::handleComparisonFinished(int offset, int newErrors, int changedErrors)
+{
+    m_comparisonSummary = QString("So sánh với bản gốc hoàn tất (lệch %1 frame).\nTìm thấy %2 lỗi mới và %3 lỗi thay đổi.")
+                              .arg(offset).arg(newErrors).arg(changedErrors);
+}
+
 void VideoWidget::onStopClicked()
 {
     if (m_isAnalysisInProgress) {
@@ -443,6 +906,8 @@ void VideoWidget::setAnalysisInProgress(bool inProgress)
     m_configWidget->setEnabled(!inProgress);
     m_analysisButtonStack->setCurrentWidget(inProgress ? m_stopButton : m_analyzeButton);
     m_stopButton->setEnabled(inProgress);
+    m_compareButton->setEnabled(!inProgress);
+    m_triageButton->setEnabled(!inProgress && QCToolsManager::inProcessEngineAvailable());
 
     if (inProgress) {
         updateStatus("Bắt đầu xử lý...");
@@ -465,6 +930,10 @@ void VideoWidget::onSettingsClicked()
         QString qccliPath = settings.value(AppConstants::K_QCCLI_PATH).toString();
         m_qctoolsController->updatePaths(qctoolsPath, qccliPath);
         m_configWidget->reloadSettings();
+        applyLogSettings();
+        applyThumbnailSettings();
+        applyApiSettings();
+        m_resultsWidget->setMediaInfo(m_currentMediaInfo);
         handleLogMessage("[INFO] Cài đặt đã được cập nhật.");
     }
 }
@@ -472,6 +941,10 @@ void VideoWidget::onSettingsClicked()
 void VideoWidget::onSettingsReset()
 {
     m_configWidget->reloadSettings();
+    applyLogSettings();
+    applyThumbnailSettings();
+    applyApiSettings();
+    m_resultsWidget->setMediaInfo(m_currentMediaInfo);
     handleLogMessage("[INFO] Cài đặt đã được người dùng reset.");
     initializePaths();
 }
@@ -480,7 +953,7 @@ void VideoWidget::onSettingsReset()
 void VideoWidget::onShowLogClicked()
 {
     if (!m_logDialog) {
-        m_logDialog = new LogDialog(m_logHistory, this);
+        m_logDialog = new LogDialog(m_logSink, this);
     }
     m_logDialog->setDefaultSavePath(getCurrentDefaultSaveDir());
     
@@ -494,89 +967,116 @@ void VideoWidget::onShowLogClicked()
 
 void VideoWidget::onResultDoubleClicked(int frameNum)
 {
-    if (m_currentFps > 0) {
+    const Timecode timecode = currentTimecode();
+    if (timecode.isValid()) {
         QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
         int rewindFrames = settings.value(AppConstants::K_REWIND_FRAMES, 5).toInt();
         
         int newFrame = frameNum - rewindFrames;
         if (newFrame < 0) newFrame = 0;
 
-        QString timecode = QCToolsManager::frameToTimecodePrecise(newFrame, m_currentFps);
-        QApplication::clipboard()->setText(timecode);
+        const QString timeText = timecode.toString(newFrame, Timecode::Style::Milliseconds);
+        QApplication::clipboard()->setText(timeText);
 
         if(m_statusResetTimer->isActive()) m_statusResetTimer->stop();
-        m_statusLabel->setText(QString("Đã sao chép timecode '%1' (đã lùi %2 frames) vào clipboard!").arg(timecode).arg(rewindFrames));
+        m_statusLabel->setText(QString("Đã sao chép timecode '%1' (đã lùi %2 frames) vào clipboard!").arg(timeText).arg(rewindFrames));
         m_statusResetTimer->start(3500);
     }
 }
 
-void VideoWidget::onExportTxt()
+void VideoWidget::onExportRequested(int format)
 {
-    const auto& results = m_resultsWidget->getCurrentResults();
-    if (results.isEmpty()){ 
-        QMessageBox::warning(this, "Không có dữ liệu", "Không có dữ liệu để xuất."); 
-        return; 
+    if (m_resultsWidget->resultCount() == 0) {
+        QMessageBox::warning(this, "Không có dữ liệu", "Không có dữ liệu để xuất.");
+        return;
     }
-    
+    if (m_exportProgress) return; // Đang có một lần xuất khác
+
+    const ExportFormat exportFormat = static_cast<ExportFormat>(format);
     QString defaultDir = getCurrentDefaultSaveDir();
     QString sourceFile = !m_currentVideoPath.isEmpty() ? m_currentVideoPath : m_currentReportPath;
-    QFileInfo fileInfo(sourceFile);
-    QString suggestedName = defaultDir + "/" + fileInfo.completeBaseName() + "_QC_Report.txt";
-    
-    QString p = QFileDialog::getSaveFileName(this, "Lưu file Text", suggestedName, "Text Files (*.txt)");
+    QString suggestedName = defaultDir + "/" + QFileInfo(sourceFile).completeBaseName() + "_QC_Report." + ResultExporter::fileSuffix(exportFormat);
 
+    QString p = QFileDialog::getSaveFileName(this, QString("Lưu file %1").arg(ResultExporter::formatName(exportFormat)),
+                                             suggestedName, ResultExporter::fileFilter(exportFormat));
     if (p.isEmpty()) return;
-    QFile f(p);
-    if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&f);
-        out.setEncoding(QStringConverter::Utf8);
-        out << "File: " << QDir::toNativeSeparators(sourceFile) << "\n\n";
-        out << QString("%1\t%2\t%3\t%4\n").arg("Timecode", -15).arg("Thời lượng (fr)", -15).arg("Loại lỗi", -20).arg("Chi tiết");
-        out << QString(80, '-') << "\n";
-        for (const auto &res : results) {
-            out << QString("%1\t%2\t%3\t%4\n").arg(res.timecode, -15).arg(res.duration, -15).arg(res.errorType, -20).arg(res.details);
-        }
 
-        if (m_currentMediaInfo.width > 0) {
-            out << "\n\n==================== THÔNG TIN FILE ====================\n";
-            out << " File: " << fileInfo.fileName() << "\n";
-            out << m_currentMediaInfo.toFormattedString();
-            out << "\n====================================================\n";
-        }
-
-        f.close();
-        QMessageBox::information(this, "Thành công", "Đã xuất file TXT thành công.");
-    } else {
-        QMessageBox::critical(this, "Lỗi", "Không thể lưu file TXT.");
-    }
+    m_exportToClipboard = false;
+    startExport(makeExportJob(exportFormat, p));
 }
 
 void VideoWidget::onCopyToClipboard()
 {
-    const auto& results = m_resultsWidget->getCurrentResults();
-    if (results.isEmpty()){ 
-        QMessageBox::warning(this, "Không có dữ liệu", "Không có dữ liệu để sao chép."); 
-        return; 
-    }
-    QString s;
-    QTextStream ss(&s);
-    
-    QString sourceFile = !m_currentVideoPath.isEmpty() ? m_currentVideoPath : m_currentReportPath;
-    ss << "File: " << QDir::toNativeSeparators(sourceFile) << "\n\n";
-    ss << "Timecode\tThời lượng (fr)\tLoại lỗi\tChi tiết\n";
-    for (const auto &res : results) {
-        ss << res.timecode << "\t" << res.duration << "\t" << res.errorType << "\t" << res.details << "\n";
+    if (m_resultsWidget->resultCount() == 0) {
+        QMessageBox::warning(this, "Không có dữ liệu", "Không có dữ liệu để sao chép.");
+        return;
     }
+    if (m_exportProgress) return;
+
+    // Clipboard cần toàn bộ nội dung, nhưng việc định dạng vẫn được làm trên luồng xuất
+    m_exportToClipboard = true;
+    startExport(makeExportJob(ExportFormat::Txt, QString()));
+}
 
-    if (m_currentMediaInfo.width > 0) {
-        ss << "\n\n==================== THÔNG TIN FILE ====================\n";
-        ss << " File: " << QFileInfo(sourceFile).fileName() << "\n";
-        ss << m_currentMediaInfo.toFormattedString();
-        ss << "\n====================================================\n";
+ExportJob VideoWidget::makeExportJob(ExportFormat format, const QString &outputPath) const
+{
+    ExportJob job;
+    job.format = format;
+    job.outputPath = outputPath;
+    job.sourceFile = !m_currentVideoPath.isEmpty() ? m_currentVideoPath : m_currentReportPath;
+    job.mediaInfo = m_currentMediaInfo;
+    job.timecode = currentTimecode();
+    job.results = m_resultsWidget->getCurrentResults();
+    return job;
+}
+
+void VideoWidget::startExport(const ExportJob &job)
+{
+    const QString label = job.outputPath.isEmpty()
+        ? QString("Đang chuẩn bị nội dung để sao chép...")
+        : QString("Đang xuất %1 kết quả ra file %2...").arg(job.results.size()).arg(ResultExporter::formatName(job.format));
+    m_exportProgress = new QProgressDialog(label, "Hủy", 0, qMax(1, int(job.results.size())), this);
+    m_exportProgress->setWindowTitle("Xuất báo cáo");
+    m_exportProgress->setWindowModality(Qt::WindowModal);
+    m_exportProgress->setMinimumDuration(400);
+    m_exportProgress->setAutoClose(false);
+    m_exportProgress->setAutoReset(false);
+    m_exportProgress->setValue(0);
+    connect(m_exportProgress, &QProgressDialog::canceled, this, [this]() { m_exporter->requestCancel(); });
+
+    ResultExporter* exporter = m_exporter;
+    exporter->resetCancel();
+    QMetaObject::invokeMethod(exporter, [exporter, job]() { exporter->run(job); }, Qt::QueuedConnection);
+}
+
+void VideoWidget::onExportProgress(int done, int total)
+{
+    if (!m_exportProgress) return;
+    m_exportProgress->setMaximum(qMax(1, total));
+    m_exportProgress->setValue(done);
+}
+
+void VideoWidget::onExportFinished(bool success, const QString &message, const QByteArray &data)
+{
+    const bool canceled = m_exportProgress && m_exportProgress->wasCanceled();
+    if (m_exportProgress) {
+        m_exportProgress->close();
+        m_exportProgress->deleteLater();
+        m_exportProgress = nullptr;
     }
 
-    QApplication::clipboard()->setText(s);
-    QMessageBox::information(this, "Thành công", "Đã sao chép kết quả vào clipboard.");
+    if (success && m_exportToClipboard) {
+        QApplication::clipboard()->setText(QString::fromUtf8(data));
+        QMessageBox::information(this, "Thành công", "Đã sao chép kết quả vào clipboard.");
+    } else if (success) {
+        QMessageBox::information(this, "Thành công", message);
+    } else if (canceled) {
+        updateStatus("Đã hủy xuất báo cáo.");
+    } else {
+        QMessageBox::critical(this, "Lỗi", message);
+    }
+    handleLogMessage(QString(success ? "[INFO] %1" : "[WARNING] %1").arg(success && m_exportToClipboard ? "Đã sao chép kết quả vào clipboard." : message));
+    m_exportToClipboard = false;
 }
 
 
@@ -592,13 +1092,21 @@ void VideoWidget::updateProgress(int value, int max){
     }
 }
 
-void VideoWidget::handleResults(const QList<AnalysisResult> &results){
+void VideoWidget::handleResultsBatch(const QList<AnalysisResult> &batch){
     if (!m_isAnalysisInProgress && m_currentMode == AnalysisMode::IDLE) return;
-    m_resultsWidget->handleResults(results);
+    // Kết quả đến theo từng lô trong lúc phân tích, bảng chỉ chèn thêm dòng
+    m_resultsWidget->appendResults(batch);
 }
 
 void VideoWidget::handleAnalysisFinished(bool success) {
     setAnalysisInProgress(false);
+
+    // Quét keyframe / phân tích vùng là lượt phụ: nút phân tích chính vẫn phân tích cả video
+    const AnalysisMode finishedMode = m_currentMode;
+    if (finishedMode == AnalysisMode::TRIAGE_KEYFRAMES || finishedMode == AnalysisMode::ANALYZE_REGIONS) {
+        m_currentMode = AnalysisMode::ANALYZE_VIDEO;
+        m_analyzeButton->setText("BẮT ĐẦU PHÂN TÍCH");
+    }
     
     if (!success) {
         if(m_stopButton->isEnabled())
@@ -611,8 +1119,45 @@ void VideoWidget::handleAnalysisFinished(bool success) {
     updateStatus("Xử lý hoàn tất!");
     
     QString resultMessage;
-    int errorCount = m_resultsWidget->getCurrentResults().count();
-    if (errorCount == 0) {
+    int errorCount = m_resultsWidget->resultCount();
+    if (finishedMode == AnalysisMode::TRIAGE_KEYFRAMES) {
+        const QString notice = QString("KẾT QUẢ ƯỚC LƯỢNG từ quét keyframe: %1 vùng nghi lỗi. Ranh giới chỉ chính xác tới khoảng cách giữa "
+                                       "hai keyframe, lỗi không chạm keyframe nào và Frame Dư không được tìm.").arg(errorCount);
+        m_resultsWidget->setNotice(notice, errorCount > 0 ? "Phân tích đầy đủ các vùng này" : QString());
+        if (errorCount == 0) {
+            QMessageBox::information(this, "Hoàn tất", "Quét keyframe hoàn tất.\nKhông có keyframe nào bị nghi lỗi (kết quả ước lượng).");
+            return;
+        }
+        QMessageBox msgBox(this);
+        msgBox.setWindowTitle("Hoàn tất");
+        msgBox.setIcon(QMessageBox::Information);
+        msgBox.setText(QString("Quét keyframe hoàn tất.\nTìm thấy %1 vùng nghi lỗi (kết quả ƯỚC LƯỢNG).").arg(errorCount));
+        msgBox.setInformativeText("Bạn có muốn phân tích đầy đủ từng frame trong các vùng này ngay không?");
+        QPushButton *analyzeButton = msgBox.addButton("Phân tích đầy đủ các vùng này", QMessageBox::YesRole);
+        QPushButton *laterButton = msgBox.addButton("Để sau", QMessageBox::NoRole);
+        msgBox.setDefaultButton(laterButton);
+        msgBox.exec();
+        if (msgBox.clickedButton() == analyzeButton) onAnalyzeFlaggedRegions();
+        return;
+    }
+    if (finishedMode == AnalysisMode::ANALYZE_REGIONS) {
+        m_resultsWidget->setNotice(QString("Kết quả phân tích đầy đủ, chỉ trong %1 vùng đã đánh dấu ở lượt quét keyframe.").arg(m_flaggedWindows.size()));
+    }
+    if (m_currentMode == AnalysisMode::COMPARE_REPORTS && !m_comparisonSummary.isEmpty()) {
+        resultMessage = m_comparisonSummary;
+    } else if (m_currentMode == AnalysisMode::EVALUATE_PROFILES) {
+        QStringList names;
+        resultMessage = QString("Đã đánh giá %1 cấu hình trên cùng một báo cáo:").arg(m_profileResults.size());
+        for (const auto& profile : std::as_const(m_profileResults)) {
+            int counts[3] = {0, 0, 0};
+            for (const AnalysisResult& res : profile.second) ++counts[static_cast<int>(res.type)];
+            names << QString("%1 (%2 lỗi)").arg(profile.first).arg(profile.second.size());
+            resultMessage += QString("\n- %1: %2 lỗi (%3 %4, %5 %6, %7 %8)").arg(profile.first).arg(profile.second.size())
+                                 .arg(counts[0]).arg(AppConstants::ERR_BLACK_FRAME).arg(counts[1]).arg(AppConstants::ERR_BLACK_BORDER)
+                                 .arg(counts[2]).arg(AppConstants::ERR_ORPHAN_FRAME);
+        }
+        m_resultsWidget->setProfiles(names);
+    } else if (errorCount == 0) {
         resultMessage = "Quá trình xử lý đã hoàn tất.\nKhông tìm thấy lỗi nào với cấu hình hiện tại.";
     } else {
         resultMessage = QString("Quá trình xử lý đã hoàn tất.\nTìm thấy %1 lỗi.").arg(errorCount);
@@ -656,9 +1201,40 @@ void VideoWidget::handleError(const QString &error) {
 
 void VideoWidget::handleLogMessage(const QString &message)
 {
-    m_logHistory.append(message);
-    if (m_logDialog) {
-        m_logDialog->appendLog(message);
+    m_logSink->appendMessage(message);
+}
+
+void VideoWidget::applyThumbnailSettings()
+{
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    QString ffmpegPath = settings.value(AppConstants::K_FFMPEG_PATH).toString();
+    if (ffmpegPath.isEmpty() || !QFile::exists(ffmpegPath)) {
+        // Không cấu hình: tìm trong PATH, sau đó trong thư mục QCTools
+        ffmpegPath = QStandardPaths::findExecutable("ffmpeg");
+        const QString qctoolsPath = settings.value(AppConstants::K_QCTOOLS_PATH).toString();
+        if (ffmpegPath.isEmpty() && !qctoolsPath.isEmpty()) {
+            const QString candidate = QFileInfo(qctoolsPath).absolutePath() + "/ffmpeg.exe";
+            if (QFile::exists(candidate)) ffmpegPath = candidate;
+        }
+    }
+    m_resultsWidget->setThumbnailSettings(ffmpegPath, settings.value(AppConstants::K_THUMB_DISK_CACHE, true).toBool());
+}
+
+Timecode VideoWidget::currentTimecode() const
+{
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    return Timecode(m_currentMediaInfo.frameRate, settings.value(AppConstants::K_DROP_FRAME_TIMECODE, true).toBool());
+}
+
+void VideoWidget::applyLogSettings()
+{
+    QSettings settings(AppConstants::ORG_NAME, AppConstants::APP_NAME);
+    if (settings.value(AppConstants::K_LOG_TO_FILE, false).toBool()) {
+        const QString logDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/logs";
+        const qint64 maxBytes = settings.value(AppConstants::K_LOG_MAX_FILE_MB, 10).toLongLong() * 1024 * 1024;
+        m_logSink->enableFileSink(logDir + "/VideoQC.log", maxBytes, AppConstants::LOG_FILE_BACKUPS);
+    } else {
+        m_logSink->disableFileSink();
     }
 }
 
@@ -670,8 +1246,8 @@ void VideoWidget::handleBackgroundTaskFinished(const QString &message)
 
 void VideoWidget::handleMediaInfo(const MediaInfo &info)
 {
-    m_currentFps = info.fps;
-    m_resultsWidget->setCurrentFps(info.fps);
+    m_resultsWidget->setMediaInfo(info);
+    m_resultsWidget->setVideoSource(m_currentVideoPath, info.frameRate);
     m_currentMediaInfo = info;
     QString sourceFile = !m_currentVideoPath.isEmpty() ? m_currentVideoPath : m_currentReportPath;
     handleLogMessage("\n==================== THÔNG TIN FILE ====================");
@@ -8,16 +8,21 @@
 #include "core/types.h"
 #include "qctools/QCToolsManager.h"
 #include "core/media_info.h"
+#include "core/ResultExporter.h"
 
 class QLabel;
 class QStackedWidget;
 class QPushButton;
 class QTimer;
+class QProgressDialog;
 class ConfigWidget;
 class ResultsWidget;
 class SettingsDialog;
 class QCToolsController;
 class LogDialog;
+class LogSink;
+class WatchFolderService;
+class JobApiServer;
 
 class VideoWidget : public QWidget
 {
@@ -39,7 +44,15 @@ private slots:
     void onReportSelected(const QString &path);
     void onAnalyzeClicked();
     void onStopClicked();
-    void onExportTxt();
+    void onCompareClicked();
+    void onTriageClicked();
+    // Sau lượt quét keyframe: phân tích đầy đủ chỉ các vùng đã đánh dấu
+    void onAnalyzeFlaggedRegions();
+    void onProfilesSelected(const QVariantList& profiles);
+    void onProfileSelected(int index);
+    void onWatchToggled(bool enabled);
+    void onWatchStatusChanged(int running, int queued);
+    void onExportRequested(int format);
     void onCopyToClipboard();
     void onSettingsClicked();
     void onShowLogClicked();
@@ -50,16 +63,20 @@ private slots:
     // Slots for communication with manager thread
     void updateStatus(const QString &status);
     void updateProgress(int value, int max);
-    void handleResults(const QList<AnalysisResult> &results);
+    void handleResultsBatch(const QList<AnalysisResult> &batch);
     void handleAnalysisFinished(bool success);
     void handleError(const QString &error);
     void handleLogMessage(const QString& message);
     void handleBackgroundTaskFinished(const QString& message);
     void handleMediaInfo(const MediaInfo& info);
+    void handleComparisonFinished(int offset, int newErrors, int changedErrors);
+    void handleProfileResults(int index, const QString& name, const QList<AnalysisResult>& results);
+    void onExportProgress(int done, int total);
+    void onExportFinished(bool success, const QString& message, const QByteArray& data);
 
 
 private:
-    enum class AnalysisMode { IDLE, ANALYZE_VIDEO, VIEW_REPORT };
+    enum class AnalysisMode { IDLE, ANALYZE_VIDEO, VIEW_REPORT, COMPARE_REPORTS, EVALUATE_PROFILES, TRIAGE_KEYFRAMES, ANALYZE_REGIONS };
 
     void setupUI();
     void setupConnections();
@@ -68,8 +85,24 @@ private:
     void promptForPaths();
     
     QString findExistingReport(const QString& videoPath, QCToolsManager::ReportType type) const;
+    QString findVideoForReport(const QString& reportPath) const;
+    // Thiết lập phát hiện lỗi hiện tại + đường dẫn qcli, như map gửi cho QCToolsManager
+    QVariantMap currentAnalysisSettings() const;
     void deleteAssociatedReports(const QString& videoPath);
+    // Đọc nhanh header của video vừa chọn để hiện MediaInfo ngay, không chờ phân tích
+    void probeSelectedFile(const QString& videoPath);
+    // Điểm vào/ra trong ConfigWidget đổi ra [frame đầu, frame cuối] (frame cuối -1: tới hết file).
+    // `range` rỗng: phân tích cả file. false: nhập sai, lý do trong `error`
+    bool analysisRange(QVariantList* range, QString* error) const;
     QString getCurrentDefaultSaveDir() const;
+    void applyLogSettings();
+    void applyThumbnailSettings();
+    // Bật/tắt/khởi động lại dịch vụ job HTTP theo cài đặt
+    void applyApiSettings();
+    void stopApiServer();
+    Timecode currentTimecode() const;
+    ExportJob makeExportJob(ExportFormat format, const QString& outputPath) const;
+    void startExport(const ExportJob& job);
 
     // UI Elements
     ConfigWidget *m_configWidget;
@@ -80,6 +113,9 @@ private:
     QStackedWidget *m_analysisButtonStack;
     QPushButton *m_analyzeButton;
     QPushButton *m_stopButton;
+    QPushButton *m_compareButton;
+    QPushButton *m_triageButton;
+    QPushButton *m_watchButton;
     QLabel *m_statusLabel;
     QTimer* m_statusResetTimer = nullptr;
     
@@ -87,17 +123,36 @@ private:
     QThread *m_analysisThread;
     QCToolsManager *m_qctoolsManager;
     QCToolsController *m_qctoolsController;
+    QThread *m_exportThread;
+    ResultExporter *m_exporter;
+    QProgressDialog *m_exportProgress = nullptr;
+    bool m_exportToClipboard = false;
+    WatchFolderService *m_watchService = nullptr;
+    QThread *m_apiThread = nullptr;
+    JobApiServer *m_apiServer = nullptr;
+    quint16 m_apiPort = 0;
+    int m_apiMaxJobs = 0;
 
     // State
     QString m_currentVideoPath;
     QString m_currentReportPath;
+    QString m_referenceReportPath;     // Chế độ so sánh: báo cáo của bản gốc
+    QString m_comparisonSummary;
+    QVariantList m_evaluatedProfiles;  // Chế độ đánh giá nhiều cấu hình: các cấu hình đã chọn
+    QList<QPair<QString, QList<AnalysisResult>>> m_profileResults;
+    QVariantList m_flaggedWindows;     // Các vùng [frame đầu, frame cuối] do lượt quét keyframe đánh dấu
     AnalysisMode m_currentMode = AnalysisMode::IDLE;
     bool m_isAnalysisInProgress = false;
-    QStringList m_logHistory;
-    double m_currentFps = 0.0;
+    LogSink* m_logSink = nullptr;
     QString m_persistentStatusText;
     
     MediaInfo m_currentMediaInfo;
+    // Kết quả đọc nhanh header của m_probedVideoPath; số frame -1: không biết
+    QString m_probedVideoPath;
+    MediaInfo m_probedMediaInfo;
+    int m_probedFrameCount = -1;
+    // Báo cáo của bản trước khi video được giao lại: lần phân tích kế tiếp chỉ QC lại phần đã đổi (dùng một lần)
+    QString m_incrementalReportPath;
 };
 
 #endif // VIDEOWIDGET_H